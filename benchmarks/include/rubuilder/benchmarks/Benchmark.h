@@ -0,0 +1,179 @@
+#ifndef _rubuilder_benchmarks_Benchmark_h_
+#define _rubuilder_benchmarks_Benchmark_h_
+
+#include <map>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace rubuilder { namespace benchmarks { // namespace rubuilder::benchmarks
+
+  /**
+   * \brief Base class of a micro-benchmark
+   *
+   * A benchmark repeats an operation a given number of times. The
+   * harness measures the wall-clock time of run() only, thus any
+   * preparation not part of the operation goes into setUp().
+   * Benchmarks are registered during static initialization. Thus,
+   * the constructor must not depend on other static objects, and the
+   * data shared by all runs is prepared in initialize() instead.
+   */
+  class Benchmark
+  {
+  public:
+
+    Benchmark(const std::string& name);
+
+    virtual ~Benchmark() {}
+
+    /**
+     * Return the name, e.g. "OneToOneQueue.single"
+     */
+    const std::string& name() const
+    { return name_; }
+
+    /**
+     * Prepare the data used by all runs.
+     * Called once before the first run.
+     */
+    virtual void initialize() {}
+
+    /**
+     * Prepare a run of count operations
+     */
+    virtual void setUp(const uint64_t count) {}
+
+    /**
+     * Execute the operation count times.
+     * Return the number of bytes processed, or 0 if not applicable.
+     */
+    virtual uint64_t run(const uint64_t count) = 0;
+
+    /**
+     * Clean up after a run
+     */
+    virtual void tearDown() {}
+
+
+  private:
+
+    const std::string name_;
+
+  }; // Benchmark
+
+
+  /**
+   * Add the benchmark to the registry, which takes ownership
+   */
+  Benchmark* registerBenchmark(Benchmark*);
+
+
+  /**
+   * \brief Measured performance of one benchmark
+   */
+  struct Result
+  {
+    std::string name;
+    uint64_t operations;
+    double nsPerOp;
+    double megaBytesPerSec;
+    double threshold;             ///< Maximum ns/op, or 0 if none
+    bool regression;
+
+    Result() :
+    operations(0), nsPerOp(0), megaBytesPerSec(0),
+    threshold(0), regression(false) {}
+  };
+
+
+  /**
+   * \brief Runs the registered benchmarks and reports the results
+   */
+  class Runner
+  {
+  public:
+
+    Runner();
+
+    /**
+     * Only run benchmarks whose name contains the filter
+     */
+    void setFilter(const std::string& filter)
+    { filter_ = filter; }
+
+    /**
+     * Run each benchmark for at least minTimeMSec per repetition
+     */
+    void setMinTime(const uint32_t minTimeMSec)
+    { minTimeMSec_ = minTimeMSec; }
+
+    /**
+     * Keep the fastest of the given number of repetitions
+     */
+    void setRepetitions(const uint32_t repetitions)
+    { repetitions_ = repetitions; }
+
+    /**
+     * Read the maximum ns/op per benchmark from the file.
+     * Each line holds a benchmark name and a threshold.
+     * Lines starting with '#' are ignored.
+     */
+    void readThresholds(const std::string& fileName);
+
+    /**
+     * Multiply all thresholds by the factor, e.g. on a slower host
+     */
+    void scaleThresholds(const double factor)
+    { thresholdScale_ = factor; }
+
+    /**
+     * Run the benchmarks and write one line per result.
+     * Returns the number of benchmarks exceeding their threshold.
+     */
+    uint32_t run(std::ostream&);
+
+    /**
+     * Write the names of the registered benchmarks
+     */
+    void list(std::ostream&) const;
+
+
+  private:
+
+    Result measure(Benchmark*) const;
+    static double runOnce(Benchmark*, const uint64_t count, uint64_t& bytes);
+
+    std::string filter_;
+    uint32_t minTimeMSec_;
+    uint32_t repetitions_;
+    double thresholdScale_;
+
+    typedef std::map<std::string,double> Thresholds;
+    Thresholds thresholds_;
+
+  }; // Runner
+
+
+  /**
+   * Prevent the compiler from optimizing away the computation of the value
+   */
+  template <typename T>
+  inline void doNotOptimize(const T& value)
+  {
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+  }
+
+} } // namespace rubuilder::benchmarks
+
+
+#endif // _rubuilder_benchmarks_Benchmark_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,178 @@
+#include "rubuilder/benchmarks/Benchmark.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <time.h>
+
+
+namespace
+{
+  typedef std::vector< boost::shared_ptr<rubuilder::benchmarks::Benchmark> > Registry;
+
+  Registry& getRegistry()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  uint64_t getTimeNSec()
+  {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+  }
+}
+
+
+rubuilder::benchmarks::Benchmark::Benchmark(const std::string& name) :
+name_(name)
+{}
+
+
+rubuilder::benchmarks::Benchmark* rubuilder::benchmarks::registerBenchmark(Benchmark* benchmark)
+{
+  getRegistry().push_back( boost::shared_ptr<Benchmark>(benchmark) );
+  return benchmark;
+}
+
+
+rubuilder::benchmarks::Runner::Runner() :
+minTimeMSec_(200),
+repetitions_(3),
+thresholdScale_(1)
+{}
+
+
+void rubuilder::benchmarks::Runner::readThresholds(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str());
+  if ( ! file.is_open() )
+    throw std::runtime_error("Cannot open threshold file " + fileName);
+
+  std::string line;
+  while ( std::getline(file, line) )
+  {
+    if ( line.empty() || line[0] == '#' ) continue;
+
+    std::istringstream fields(line);
+    std::string name;
+    double threshold;
+    if ( ! (fields >> name >> threshold) )
+      throw std::runtime_error("Malformed line in " + fileName + ": " + line);
+
+    thresholds_[name] = threshold;
+  }
+}
+
+
+uint32_t rubuilder::benchmarks::Runner::run(std::ostream& out)
+{
+  uint32_t regressions = 0;
+
+  out << "# benchmark operations ns/op MB/s threshold status" << std::endl;
+
+  const Registry& registry = getRegistry();
+  for (Registry::const_iterator it = registry.begin(), itEnd = registry.end();
+       it != itEnd; ++it)
+  {
+    if ( (*it)->name().find(filter_) == std::string::npos ) continue;
+
+    Result result = measure(it->get());
+
+    Thresholds::const_iterator pos = thresholds_.find(result.name);
+    if ( pos != thresholds_.end() )
+    {
+      result.threshold = pos->second * thresholdScale_;
+      result.regression = ( result.nsPerOp > result.threshold );
+      if ( result.regression ) ++regressions;
+    }
+
+    out << result.name
+      << " " << result.operations
+      << std::fixed << std::setprecision(2)
+      << " " << result.nsPerOp
+      << " " << result.megaBytesPerSec
+      << " " << result.threshold
+      << " " << ( result.threshold == 0 ? "-" : result.regression ? "REGRESSION" : "ok" )
+      << std::endl;
+  }
+
+  return regressions;
+}
+
+
+void rubuilder::benchmarks::Runner::list(std::ostream& out) const
+{
+  const Registry& registry = getRegistry();
+  for (Registry::const_iterator it = registry.begin(), itEnd = registry.end();
+       it != itEnd; ++it)
+  {
+    out << (*it)->name() << std::endl;
+  }
+}
+
+
+rubuilder::benchmarks::Result rubuilder::benchmarks::Runner::measure(Benchmark* benchmark) const
+{
+  Result result;
+  result.name = benchmark->name();
+
+  benchmark->initialize();
+
+  // Find the number of operations taking about a tenth of the minimum time
+  const double minTimeNSec = minTimeMSec_ * 1e6;
+  uint64_t count = 1;
+  uint64_t bytes = 0;
+  double elapsedNSec = runOnce(benchmark, count, bytes);
+  while ( elapsedNSec < minTimeNSec / 10 && count < (1ULL << 40) )
+  {
+    count *= 2;
+    elapsedNSec = runOnce(benchmark, count, bytes);
+  }
+  count = static_cast<uint64_t>(count * minTimeNSec / (elapsedNSec > 0 ? elapsedNSec : 1)) + 1;
+
+  // Keep the fastest repetition, which is least disturbed by the host
+  for (uint32_t i = 0; i < repetitions_; ++i)
+  {
+    elapsedNSec = runOnce(benchmark, count, bytes);
+    const double nsPerOp = elapsedNSec / count;
+    if ( i == 0 || nsPerOp < result.nsPerOp )
+    {
+      result.operations = count;
+      result.nsPerOp = nsPerOp;
+      result.megaBytesPerSec = bytes / (elapsedNSec / 1e9) / 1e6;
+    }
+  }
+
+  return result;
+}
+
+
+double rubuilder::benchmarks::Runner::runOnce
+(
+  Benchmark* benchmark,
+  const uint64_t count,
+  uint64_t& bytes
+)
+{
+  benchmark->setUp(count);
+  const uint64_t startNSec = getTimeNSec();
+  bytes = benchmark->run(count);
+  const uint64_t stopNSec = getTimeNSec();
+  benchmark->tearDown();
+
+  return static_cast<double>(stopNSec - startNSec);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
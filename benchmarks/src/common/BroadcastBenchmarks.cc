@@ -0,0 +1,167 @@
+#include "rubuilder/benchmarks/Benchmark.h"
+#include "rubuilder/utils/I2OMessages.h"
+#include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LoopbackTransport.h"
+#include "rubuilder/utils/MemoryPools.h"
+#include "rubuilder/utils/RUbroadcaster.h"
+#include "toolbox/mem/MemoryPoolFactory.h"
+#include "xdaq/Application.h"
+#include "xdata/InfoSpace.h"
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <sstream>
+#include <stddef.h>
+#include <string.h>
+
+
+namespace rubuilder { namespace benchmarks { // namespace rubuilder::benchmarks
+
+  namespace
+  {
+    const uint32_t maxNbRUs = 64;
+
+    /**
+     * The EVM and the RUs are shared by all broadcast benchmarks.
+     * The RUs are bound to the loopback transport, which releases
+     * the frames it delivers, as no callbacks are bound.
+     */
+    xdaq::Application* getEVM()
+    {
+      static xdaq::Application* evm = 0;
+      if ( evm ) return evm;
+
+      evm = new xdaq::Application( new xdaq::ApplicationDescriptor("rubuilder::evm::Application", 0) );
+
+      utils::LoopbackTransport::Callbacks noCallbacks;
+      log4cplus::Logger logger("benchmark");
+      for (uint32_t instance = 0; instance < maxNbRUs; ++instance)
+      {
+        xdaq::ApplicationDescriptor* ru = new xdaq::ApplicationDescriptor("rubuilder::ru::Application", instance);
+        evm->getApplicationContext()->getDefaultZone()->addApplicationDescriptor(ru);
+        utils::getLoopbackTransport().bind(ru, noCallbacks, logger);
+      }
+      return evm;
+    }
+  }
+
+
+  /**
+   * Broadcast EvBids messages of the given packing from the EVM
+   * to the given number of RUs. Each RU either gets a copy of the
+   * message, or a copy of the header chained to shared elements.
+   * The time includes the delivery by the loopback transport.
+   */
+  class RUbroadcast : public Benchmark
+  {
+  public:
+
+    RUbroadcast(const uint32_t nbRUs, const uint32_t packing, const bool sharedFrame) :
+    Benchmark(getName(nbRUs, packing, sharedFrame)),
+    nbRUs_(nbRUs),
+    packing_(packing),
+    sharedFrame_(sharedFrame),
+    bufSize_(sizeof(msg::EvBidsMsg) - sizeof(utils::EvBid) + packing * sizeof(utils::EvBid)),
+    pool_(0)
+    {}
+
+    void initialize()
+    {
+      xdaq::Application* evm = getEVM();
+      pool_ = utils::getMemoryPool("benchmark/broadcast", utils::PoolConfiguration(), poolName_);
+      broadcaster_.reset( new utils::RUbroadcaster(evm, pool_) );
+
+      utils::InfoSpaceItems params;
+      broadcaster_->initRuInstances(params);
+      xdata::InfoSpace infoSpace("benchmark/broadcast");
+      params.putIntoInfoSpace(&infoSpace, 0);
+
+      xdata::Vector<xdata::UnsignedInteger32>* ruInstances =
+        dynamic_cast<xdata::Vector<xdata::UnsignedInteger32>*>(infoSpace.find("ruInstances"));
+      ruInstances->clear();
+      for (uint32_t instance = 0; instance < nbRUs_; ++instance)
+        ruInstances->push_back(instance);
+      dynamic_cast<xdata::Boolean*>(infoSpace.find("sharedBroadcastFrame"))->value_ = sharedFrame_;
+
+      broadcaster_->getApplicationDescriptors();
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      const size_t headerSize = offsetof(msg::EvBidsMsg, elements);
+
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        toolbox::mem::Reference* bufRef =
+          toolbox::mem::getMemoryPoolFactory()->getFrame(pool_, bufSize_);
+        msg::EvBidsMsg* evbIdsMsg = (msg::EvBidsMsg*)bufRef->getDataLocation();
+        memset(evbIdsMsg, 0, headerSize);
+        evbIdsMsg->PvtMessageFrame.StdMessageFrame.MessageSize = bufSize_ >> 2;
+        evbIdsMsg->nbElements = packing_;
+        for (uint32_t e = 0; e < packing_; ++e)
+          evbIdsMsg->elements[e] = utils::EvBid(0, i * packing_ + e + 1);
+        bufRef->setDataSize(bufSize_);
+
+        broadcaster_->sendToAllRUs(bufRef, bufSize_, headerSize);
+        bufRef->release();
+      }
+
+      // Wait until the RUs got all messages
+      while ( pool_->getMemoryUsage().getUsed() > 0 )
+        boost::this_thread::yield();
+
+      return count * nbRUs_ * bufSize_;
+    }
+
+
+  private:
+
+    static std::string getName(const uint32_t nbRUs, const uint32_t packing, const bool sharedFrame)
+    {
+      std::ostringstream name;
+      name << "RUbroadcaster." << (sharedFrame ? "shared" : "copies")
+        << "/" << nbRUs << "RUs/" << packing << "EvBids";
+      return name.str();
+    }
+
+    const uint32_t nbRUs_;
+    const uint32_t packing_;
+    const bool sharedFrame_;
+    const size_t bufSize_;
+    toolbox::mem::Pool* pool_;
+    std::string poolName_;
+    boost::scoped_ptr<utils::RUbroadcaster> broadcaster_;
+  };
+
+
+  namespace
+  {
+    Benchmark* registerBroadcastBenchmarks()
+    {
+      const uint32_t nbRUs[] = { 1, 8, maxNbRUs };
+      const uint32_t packings[] = { 8, 256 };
+      Benchmark* benchmark = 0;
+      for (uint32_t p = 0; p < sizeof(packings)/sizeof(packings[0]); ++p)
+      {
+        for (uint32_t r = 0; r < sizeof(nbRUs)/sizeof(nbRUs[0]); ++r)
+        {
+          registerBenchmark( new RUbroadcast(nbRUs[r], packings[p], false) );
+          benchmark = registerBenchmark( new RUbroadcast(nbRUs[r], packings[p], true) );
+        }
+      }
+      return benchmark;
+    }
+
+    Benchmark* broadcastBenchmarks = registerBroadcastBenchmarks();
+  }
+
+} } // namespace rubuilder::benchmarks
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
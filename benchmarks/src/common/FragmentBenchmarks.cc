@@ -0,0 +1,807 @@
+#include "interface/shared/fed_header.h"
+#include "interface/shared/fed_trailer.h"
+#include "interface/shared/frl_header.h"
+#include "rubuilder/benchmarks/Benchmark.h"
+#include "rubuilder/bu/Event.h"
+#include "rubuilder/evm/EoLSHandler.h"
+#include "rubuilder/evm/L1InfoHandler.h"
+#include "rubuilder/evm/TriggerBitCounter.h"
+#include "rubuilder/ru/BUproxy.h"
+#include "rubuilder/ru/SuperFragmentTable.h"
+#include "rubuilder/utils/CRC16.h"
+#include "rubuilder/utils/CRC16Kernels.h"
+#include "rubuilder/utils/EvBidFactory.h"
+#include "rubuilder/utils/FedCRCUpdater.h"
+#include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/SuperFragmentGenerator.h"
+#include "toolbox/mem/MemoryPoolFactory.h"
+#include "xdaq/Application.h"
+#include "xdaq/ApplicationDescriptor.h"
+#include "xdata/InfoSpace.h"
+
+#include <boost/array.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace rubuilder { namespace benchmarks { // namespace rubuilder::benchmarks
+
+  namespace
+  {
+    // Default super-fragment of an RU: 8 FEDs of 2 kB in 4 kB blocks
+    const uint32_t blockSize = 4096;
+    const uint32_t fedPayloadSize = 2048;
+    const uint32_t fedsPerSuperFragment = 8;
+
+    xdata::Vector<xdata::UnsignedInteger32> getFedSourceIds
+    (
+      const uint32_t firstFedId,
+      const uint32_t count
+    )
+    {
+      xdata::Vector<xdata::UnsignedInteger32> fedSourceIds;
+      for (uint32_t i = 0; i < count; ++i)
+        fedSourceIds.push_back(firstFedId + i);
+      return fedSourceIds;
+    }
+
+    typedef std::vector<toolbox::mem::Reference*> Blocks;
+
+    // Unchain the blocks of a super-fragment as they arrive at the BU
+    Blocks splitIntoBlocks(toolbox::mem::Reference* bufRef, const uint32_t superFragmentNb)
+    {
+      Blocks blocks;
+      while (bufRef)
+      {
+        I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block =
+          (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)bufRef->getDataLocation();
+        block->superFragmentNb = superFragmentNb;
+        block->buResourceId = 0;
+        block->runNumber = 1;
+        block->lumiSection = 1;
+
+        toolbox::mem::Reference* next = bufRef->getNextReference();
+        bufRef->setNextReference(0);
+        blocks.push_back(bufRef);
+        bufRef = next;
+      }
+      return blocks;
+    }
+
+    void releaseBlocks(Blocks& blocks)
+    {
+      for (Blocks::const_iterator it = blocks.begin(), itEnd = blocks.end();
+           it != itEnd; ++it)
+      {
+        (*it)->release();
+      }
+      blocks.clear();
+    }
+
+    // Throw if the CRC in the trailer of the contiguous FED
+    // differs from the one calculated over the whole FED
+    void checkFedCRC(const unsigned char* fedPtr, const size_t fedSize, const std::string& what)
+    {
+      std::vector<unsigned char> fed(fedPtr, fedPtr + fedSize);
+      fedt_t* fedTrailer = (fedt_t*)(&fed[0] + fedSize - sizeof(fedt_t));
+      const uint16_t trailerCRC = (fedTrailer->conscheck & FED_CRCS_MASK) >> FED_CRCS_SHIFT;
+      fedTrailer->conscheck = 0;
+      const uint16_t crc = evf::compute_crc(&fed[0], fedSize);
+
+      if ( crc != trailerCRC )
+      {
+        std::ostringstream oss;
+        oss << what << ": the FED trailer holds the CRC 0x" << std::hex << trailerCRC;
+        oss << " instead of 0x" << crc;
+        throw std::runtime_error(oss.str());
+      }
+    }
+
+    // Pseudo-random numbers reproducible across runs
+    uint32_t nextRandom(uint32_t& state)
+    {
+      state = state * 1664525 + 1013904223;
+      return state >> 8;
+    }
+  }
+
+
+  class EvBidFactoryGetEvBid : public Benchmark
+  {
+  public:
+
+    EvBidFactoryGetEvBid() :
+    Benchmark("EvBidFactory.getEvBid")
+    {}
+
+    uint64_t run(const uint64_t count)
+    {
+      utils::EvBidFactory factory;
+      uint32_t eventNumber = 1;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        const utils::EvBid evbId = factory.getEvBid(eventNumber);
+        doNotOptimize(evbId);
+        if (++eventNumber % (1 << 24) == 0) eventNumber = 1;
+      }
+      return 0;
+    }
+  };
+
+
+  class CRC16ComputeCRC : public Benchmark
+  {
+  public:
+
+    CRC16ComputeCRC() :
+    Benchmark("CRC16.compute_crc"),
+    payload_(fedPayloadSize)
+    {
+      for (size_t i = 0; i < payload_.size(); ++i)
+        payload_[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        const unsigned short crc = evf::compute_crc(&payload_[0], payload_.size());
+        doNotOptimize(crc);
+      }
+      return count * payload_.size();
+    }
+
+
+  private:
+
+    std::vector<unsigned char> payload_;
+  };
+
+
+  /**
+   * Calculate the CRC16 over a FED of the given size with one of the
+   * kernels. The MB/s give the throughput of one core.
+   */
+  class CRC16KernelComputeCRC : public Benchmark
+  {
+  public:
+
+    CRC16KernelComputeCRC(const utils::CRC16Kernel kernel, const size_t fedSize) :
+    Benchmark(getName(kernel, fedSize)),
+    kernel_(kernel),
+    fed_(fedSize)
+    {
+      for (size_t i = 0; i < fed_.size(); ++i)
+        fed_[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+
+    void initialize()
+    {
+      // The kernel must give the same CRC as evf::compute_crc for any
+      // size and alignment, also when continuing another CRC
+      std::vector<unsigned char> buffer(4096 + 8);
+      uint32_t random = 3;
+      for (size_t i = 0; i < buffer.size(); ++i)
+        buffer[i] = static_cast<unsigned char>(nextRandom(random));
+
+      for (size_t size = 0; size <= 4096; size += 8)
+      {
+        for (size_t offset = 0; offset < 8; offset += 3)
+        {
+          const unsigned char* data = &buffer[offset];
+          const size_t split = (nextRandom(random) % (size / 8 + 1)) * 8;
+          const uint16_t head = utils::computeFedCRC(kernel_, 0xffff, data, split);
+          if ( utils::computeFedCRC(kernel_, 0xffff, data, size) != evf::compute_crc(data, size) ||
+            utils::computeFedCRC(kernel_, head, data + split, size - split) != evf::compute_crc(data, size) )
+          {
+            std::ostringstream oss;
+            oss << name() << ": wrong CRC over " << size << " bytes at offset " << offset;
+            throw std::runtime_error(oss.str());
+          }
+        }
+      }
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        const uint16_t crc = utils::computeFedCRC(kernel_, 0xffff, &fed_[0], fed_.size());
+        doNotOptimize(crc);
+      }
+      return count * fed_.size();
+    }
+
+
+  private:
+
+    static std::string getName(const utils::CRC16Kernel kernel, const size_t fedSize)
+    {
+      std::ostringstream name;
+      name << "CRC16." << utils::getCRC16KernelName(kernel) << "/" << fedSize;
+      return name.str();
+    }
+
+    const utils::CRC16Kernel kernel_;
+    std::vector<unsigned char> fed_;
+  };
+
+
+  /**
+   * Patch the first word of a FED, which needs
+   * the longest propagation of the CRC change
+   */
+  class FedCRCUpdaterWrite : public Benchmark
+  {
+  public:
+
+    FedCRCUpdaterWrite() :
+    Benchmark("FedCRCUpdater.write"),
+    fed_(sizeof(fedh_t) + fedPayloadSize + sizeof(fedt_t))
+    {}
+
+    void initialize()
+    {
+      uint32_t random = 1;
+      for (size_t i = 0; i < fed_.size(); ++i)
+        fed_[i] = static_cast<unsigned char>(nextRandom(random));
+      setCRC();
+
+      // Compare patches of all sizes and alignments with a full calculation
+      const size_t maxOffset = fed_.size() - sizeof(fedt_t);
+      for (uint32_t i = 0; i < 1000; ++i)
+      {
+        utils::FedCRCUpdater crcUpdater(&fed_[0], fed_.size());
+        switch ( i % 4 )
+        {
+          case 0:
+            crcUpdater.write<uint8_t>(nextRandom(random) % maxOffset, nextRandom(random));
+            break;
+          case 1:
+            crcUpdater.write<uint16_t>(nextRandom(random) % (maxOffset - 1), nextRandom(random));
+            break;
+          case 2:
+            crcUpdater.write<uint32_t>(nextRandom(random) % (maxOffset - 3), nextRandom(random));
+            break;
+          case 3:
+            crcUpdater.write<uint64_t>(nextRandom(random) % (maxOffset - 7),
+              (static_cast<uint64_t>(nextRandom(random)) << 32) | nextRandom(random));
+            break;
+        }
+        crcUpdater.updateTrailer();
+        checkFedCRC(&fed_[0], fed_.size(), name());
+      }
+
+      const unsigned char zeros[8] = {0,0,0,0,0,0,0,0};
+      uint16_t crc = 0xffff;
+      for (size_t nbWords = 0; nbWords < 4096; ++nbWords)
+      {
+        if ( utils::FedCRCUpdater::propagate(0xffff, nbWords) != crc )
+          throw std::runtime_error(name() + ": wrong propagation of the CRC over zero words");
+        crc = evf::compute_crc_64bit(crc, zeros);
+      }
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        utils::FedCRCUpdater crcUpdater(&fed_[0], fed_.size());
+        crcUpdater.write<uint64_t>(0, i);
+        crcUpdater.updateTrailer();
+      }
+      doNotOptimize(fed_[0]);
+      return 0;
+    }
+
+
+  private:
+
+    void setCRC()
+    {
+      fedt_t* fedTrailer = (fedt_t*)(&fed_[0] + fed_.size() - sizeof(fedt_t));
+      fedTrailer->conscheck = 0;
+      fedTrailer->conscheck = (evf::compute_crc(&fed_[0], fed_.size()) << FED_CRCS_SHIFT);
+    }
+
+    std::vector<unsigned char> fed_;
+  };
+
+
+  class SuperFragmentGeneratorGetData : public Benchmark
+  {
+  public:
+
+    SuperFragmentGeneratorGetData(const std::string& name, const uint32_t nbTemplates) :
+    Benchmark(name),
+    generator_("benchmark"),
+    nbTemplates_(nbTemplates)
+    {}
+
+    void initialize()
+    {
+      generator_.configure(getFedSourceIds(1, fedsPerSuperFragment), false, "",
+        blockSize, fedPayloadSize, 0, 0, utils::PoolConfiguration(), nbTemplates_);
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      uint64_t bytes = 0;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        toolbox::mem::Reference* bufRef = 0;
+        generator_.getData(bufRef);
+        for (toolbox::mem::Reference* ref = bufRef; ref; ref = ref->getNextReference())
+          bytes += ref->getDataSize();
+        bufRef->release();
+      }
+      return bytes;
+    }
+
+
+  private:
+
+    utils::SuperFragmentGenerator generator_;
+    const uint32_t nbTemplates_;
+  };
+
+
+  /**
+   * Generate the trigger fragment from a template,
+   * as done by the TA and the trigger handlers of the EVM
+   */
+  class SuperFragmentGeneratorTrigger : public Benchmark
+  {
+  public:
+
+    SuperFragmentGeneratorTrigger() :
+    Benchmark("SuperFragmentGenerator.trigger"),
+    generator_("benchmark/trigger")
+    {}
+
+    void initialize()
+    {
+      generator_.configure(getFedSourceIds(utils::GTP_FED_ID, 1), false, "",
+        blockSize, triggerPayloadSize, 0, 0, utils::PoolConfiguration(), 1);
+
+      // The CRC patched for the event number and the L1 information
+      // must match the one calculated over the whole FED
+      for (uint32_t eventNumber = 1; eventNumber <= 100; ++eventNumber)
+      {
+        toolbox::mem::Reference* bufRef = getData(eventNumber);
+        const unsigned char* fedPtr = (unsigned char*)bufRef->getDataLocation()
+          + sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME) + sizeof(frlh_t);
+        try
+        {
+          checkFedCRC(fedPtr, sizeof(fedh_t) + triggerPayloadSize + sizeof(fedt_t), name());
+        }
+        catch(...)
+        {
+          bufRef->release();
+          throw;
+        }
+        bufRef->release();
+      }
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      uint64_t bytes = 0;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        toolbox::mem::Reference* bufRef = getData(i % (1 << 24) + 1);
+        bytes += bufRef->getDataSize();
+        bufRef->release();
+      }
+      return bytes;
+    }
+
+
+  private:
+
+    toolbox::mem::Reference* getData(const uint32_t eventNumber)
+    {
+      utils::L1Information l1Info;
+      l1Info.lsNumber = eventNumber / 1000;
+      l1Info.orbitNumber = eventNumber * 3;
+      l1Info.bunchCrossing = eventNumber % 3564;
+      l1Info.l1Technical = eventNumber;
+      l1Info.l1Decision_0_63 = ~static_cast<uint64_t>(eventNumber);
+      l1Info.l1Decision_64_127 = static_cast<uint64_t>(eventNumber) << 32;
+
+      toolbox::mem::Reference* bufRef = 0;
+      if ( ! generator_.getData(bufRef, evbIdFactory_.getEvBid(eventNumber), l1Info) )
+        throw std::runtime_error(name() + ": failed to generate the trigger fragment");
+      return bufRef;
+    }
+
+    static const uint32_t triggerPayloadSize = 1024;
+    utils::SuperFragmentGenerator generator_;
+    utils::EvBidFactory evbIdFactory_;
+  };
+
+
+  /**
+   * Assemble and check events of one trigger fragment and
+   * the super-fragments of nbRUs RUs in the BU
+   */
+  class EventParseAndCheckData : public Benchmark
+  {
+  public:
+
+    EventParseAndCheckData() :
+    Benchmark("bu::Event.parseAndCheckData"),
+    bytesPerEvent_(0)
+    {}
+
+    void initialize()
+    {
+      utils::SuperFragmentGenerator trigger("benchmark/trigger");
+      trigger.configure(getFedSourceIds(utils::GTP_FED_ID, 1), false, "",
+        blockSize, 1024, 0);
+      trigger_ = getBlocks(trigger, 0);
+
+      for (uint32_t ru = 1; ru <= nbRUs; ++ru)
+      {
+        utils::SuperFragmentGenerator generator("benchmark/ru");
+        generator.configure(getFedSourceIds(ru * fedsPerSuperFragment, fedsPerSuperFragment),
+          false, "", blockSize, fedPayloadSize, 0);
+        const Blocks blocks = getBlocks(generator, ru);
+        superFragments_.insert(superFragments_.end(), blocks.begin(), blocks.end());
+      }
+    }
+
+    ~EventParseAndCheckData()
+    {
+      releaseBlocks(trigger_);
+      releaseBlocks(superFragments_);
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        bu::Event event(nbRUs, trigger_[0]->duplicate());
+        for (Blocks::const_iterator it = superFragments_.begin(), itEnd = superFragments_.end();
+             it != itEnd; ++it)
+        {
+          event.appendSuperFragment( (*it)->duplicate() );
+        }
+        event.parseAndCheckData();
+      }
+      return count * bytesPerEvent_;
+    }
+
+
+  private:
+
+    Blocks getBlocks(utils::SuperFragmentGenerator& generator, const uint32_t superFragmentNb)
+    {
+      toolbox::mem::Reference* bufRef = 0;
+      generator.getData(bufRef);
+      const Blocks blocks = splitIntoBlocks(bufRef, superFragmentNb);
+      for (Blocks::const_iterator it = blocks.begin(), itEnd = blocks.end();
+           it != itEnd; ++it)
+      {
+        bytesPerEvent_ += (*it)->getDataSize();
+      }
+      return blocks;
+    }
+
+    static const uint32_t nbRUs = 8;
+    Blocks trigger_;
+    Blocks superFragments_;
+    uint64_t bytesPerEvent_;
+  };
+
+
+  /**
+   * Pair super-fragments with BU requests arriving a fixed
+   * number of events later in the RU
+   */
+  class SuperFragmentTablePairing : public Benchmark
+  {
+  public:
+
+    // With a range size of 0, each request follows its super-fragment.
+    // Otherwise, ranges of requests precede the super-fragments.
+    SuperFragmentTablePairing(const std::string& name, const uint32_t rangeSize) :
+    Benchmark(name),
+    rangeSize_(rangeSize),
+    pool_(0)
+    {}
+
+    void initialize()
+    {
+      pool_ = utils::getMemoryPool("benchmark/table", utils::PoolConfiguration(), poolName_);
+      for (uint32_t i = 0; i < nbFrames; ++i)
+      {
+        frames_.push_back( toolbox::mem::getMemoryPoolFactory()->
+          getFrame(pool_, sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME)) );
+      }
+    }
+
+    ~SuperFragmentTablePairing()
+    {
+      releaseBlocks(frames_);
+    }
+
+    void setUp(const uint64_t count)
+    {
+      buProxy_.reset( new ru::BUproxy() );
+      table_.reset( new ru::SuperFragmentTable() );
+      table_->registerBUproxy(buProxy_);
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      ru::SuperFragmentTable::Request request;
+      request.buTid = 0;
+      request.buIndex = 0;
+      request.buResourceId = 0;
+
+      const uint64_t nbEvents = count + window;
+      for (uint64_t i = 0; i < nbEvents; ++i)
+      {
+        if ( rangeSize_ == 0 )
+        {
+          if ( i < count ) addSuperFragment(i + 1);
+          if ( i >= window )
+          {
+            request.evbId = utils::EvBid(0, i - window + 1);
+            table_->addRequest(request);
+          }
+        }
+        else
+        {
+          if ( i < count && i % rangeSize_ == 0 )
+          {
+            request.evbId = utils::EvBid(0, i + 1);
+            request.buResourceId = i;
+            table_->addRequests(request, std::min(static_cast<uint64_t>(rangeSize_), count - i));
+          }
+          if ( i >= window ) addSuperFragment(i - window + 1);
+        }
+      }
+      return 0;
+    }
+
+    void tearDown()
+    {
+      table_.reset();
+      buProxy_.reset();
+    }
+
+
+  private:
+
+    void addSuperFragment(const uint32_t eventNumber)
+    {
+      const utils::EvBid evbId(0, eventNumber);
+      toolbox::mem::Reference* bufRef = frames_[eventNumber % nbFrames];
+      I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block =
+        (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)bufRef->getDataLocation();
+      block->resyncCount = evbId.resyncCount();
+      block->eventNumber = evbId.eventNumber();
+      table_->addEvBidAndBlock(evbId, bufRef);
+    }
+
+    const uint32_t rangeSize_;
+
+    // Super-fragments or requests waiting for their counterpart
+    static const uint32_t window = 128;
+    // The frames are reused once their super-fragment was sent
+    static const uint32_t nbFrames = 2 * window;
+
+    std::string poolName_;
+    toolbox::mem::Pool* pool_;
+    Blocks frames_;
+    boost::shared_ptr<ru::BUproxy> buProxy_;
+    boost::scoped_ptr<ru::SuperFragmentTable> table_;
+  };
+
+
+  class TriggerBitCounterAdd : public Benchmark
+  {
+  public:
+
+    TriggerBitCounterAdd() :
+    Benchmark("evm::TriggerBitCounter.add"),
+    triggerBits_(1024)
+    {
+      // Sparse trigger bits as typically set for physics triggers
+      uint64_t random = 88172645463325252ULL;
+      for (size_t i = 0; i < triggerBits_.size(); ++i)
+      {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        triggerBits_[i] = random & (random >> 5) & (random >> 11);
+      }
+      sums_.assign(0);
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      evm::TriggerBitCounter counter;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        if ( counter.add(triggerBits_[i % triggerBits_.size()]) )
+          counter.flush(sums_);
+      }
+      counter.flush(sums_);
+      doNotOptimize(sums_);
+      return 0;
+    }
+
+
+  private:
+
+    std::vector<uint64_t> triggerBits_;
+    boost::array<uint64_t,utils::TRIGGER_BITS_COUNT> sums_;
+  };
+
+
+  /**
+   * Extract the L1 trigger information from the trigger fragments
+   * received by the EVM. The lumi-section scalers are filled
+   * concurrently by the L1Info workloop of the handler.
+   */
+  class L1InfoHandlerExtractL1Info : public Benchmark
+  {
+  public:
+
+    L1InfoHandlerExtractL1Info() :
+    Benchmark("evm::L1InfoHandler.extractL1Info"),
+    generator_("benchmark/l1Info"),
+    descriptor_("rubuilder::evm::Application", 0),
+    app_(&descriptor_),
+    handler_(0)
+    {}
+
+    ~L1InfoHandlerExtractL1Info()
+    {
+      releaseBlocks(triggers_);
+    }
+
+    void initialize()
+    {
+      std::string poolName;
+      toolbox::mem::Pool* pool =
+        utils::getMemoryPool("benchmark/l1InfoMsg", utils::PoolConfiguration(), poolName);
+
+      // The workloops of the handler are never stopped.
+      // Thus, the handler lives until the end of the process.
+      handler_ = new evm::L1InfoHandler(&app_,
+        boost::shared_ptr<evm::EoLSHandler>( new evm::EoLSHandler() ), pool);
+
+      // Set the capacity of the L1 info FIFO through the info space, as done
+      // by XDAQ, such that the L1Info workloop draining it every ms keeps up
+      utils::InfoSpaceItems params;
+      handler_->appendConfigurationItems(params);
+      xdata::InfoSpace infoSpace("benchmark/l1Info");
+      params.putIntoInfoSpace(&infoSpace, &app_);
+      *dynamic_cast<xdata::UnsignedInteger32*>(infoSpace.find("l1InfoFIFOCapacity")) =
+        l1InfoFIFOCapacity;
+      handler_->configure();
+
+      generator_.configure(getFedSourceIds(utils::GTP_FED_ID, 1), false, "",
+        blockSize, triggerPayloadSize, 0, 0, utils::PoolConfiguration(), 1);
+
+      // All triggers are in the same lumi section, as
+      // the lumi section must not decrease across runs
+      uint32_t random = 1;
+      for (uint32_t eventNumber = 1; eventNumber <= nbTriggers; ++eventNumber)
+      {
+        utils::L1Information l1Info;
+        l1Info.lsNumber = lumiSection - 1;
+        l1Info.orbitNumber = eventNumber * 3;
+        l1Info.bunchCrossing = eventNumber % 3564;
+        l1Info.eventType = 1;
+        l1Info.l1Technical = nextRandom(random) & nextRandom(random);
+        l1Info.l1Decision_0_63 = static_cast<uint64_t>(nextRandom(random)) << 32 | nextRandom(random);
+        l1Info.l1Decision_64_127 = nextRandom(random) & nextRandom(random);
+
+        toolbox::mem::Reference* bufRef = 0;
+        if ( ! generator_.getData(bufRef, evbIdFactory_.getEvBid(eventNumber), l1Info) )
+          throw std::runtime_error(name() + ": failed to generate the trigger fragment");
+        triggers_.push_back(bufRef);
+      }
+
+      if ( handler_->extractL1Info(triggers_[0], runNumber) != lumiSection )
+        throw std::runtime_error(name() + ": failed to extract the L1 information");
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      uint32_t lumiSections = 0;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        lumiSections |= handler_->extractL1Info(triggers_[i % nbTriggers], runNumber);
+      }
+      doNotOptimize(lumiSections);
+      return 0;
+    }
+
+    void tearDown()
+    {
+      // Let the L1Info workloop recycle all L1 information objects
+      while ( ! handler_->empty() ) ::usleep(1000);
+    }
+
+
+  private:
+
+    static const uint32_t nbTriggers = 1024;
+    static const uint32_t triggerPayloadSize = 1024;
+    static const uint32_t l1InfoFIFOCapacity = 65536;
+    static const uint32_t runNumber = 1;
+    static const uint32_t lumiSection = 2;
+
+    utils::SuperFragmentGenerator generator_;
+    utils::EvBidFactory evbIdFactory_;
+    xdaq::ApplicationDescriptor descriptor_;
+    xdaq::Application app_;
+    evm::L1InfoHandler* handler_;
+    Blocks triggers_;
+  };
+
+
+  namespace
+  {
+    Benchmark* evbIdFactory =
+      registerBenchmark( new EvBidFactoryGetEvBid() );
+    Benchmark* crc16 =
+      registerBenchmark( new CRC16ComputeCRC() );
+    // Each kernel supported by the CPU for FED sizes from 256 bytes to 128 kB
+    bool registerCRC16KernelBenchmarks()
+    {
+      const utils::CRC16Kernel kernels[] = {
+        utils::CRC16_BYTEWISE, utils::CRC16_SLICING_BY_8,
+        utils::CRC16_SLICING_BY_16, utils::CRC16_PCLMUL
+      };
+      for (size_t i = 0; i < sizeof(kernels)/sizeof(kernels[0]); ++i)
+      {
+        if ( ! utils::isCRC16KernelSupported(kernels[i]) ) continue;
+
+        for (size_t fedSize = 256; fedSize <= 128*1024; fedSize *= 8)
+          registerBenchmark( new CRC16KernelComputeCRC(kernels[i], fedSize) );
+      }
+      return true;
+    }
+    const bool crc16Kernels = registerCRC16KernelBenchmarks();
+    Benchmark* fedCRCUpdater =
+      registerBenchmark( new FedCRCUpdaterWrite() );
+    Benchmark* superFragmentGenerator =
+      registerBenchmark( new SuperFragmentGeneratorGetData("SuperFragmentGenerator.getData", 0) );
+    Benchmark* superFragmentGeneratorTemplates =
+      registerBenchmark( new SuperFragmentGeneratorGetData("SuperFragmentGenerator.templates", 16) );
+    Benchmark* superFragmentGeneratorTrigger =
+      registerBenchmark( new SuperFragmentGeneratorTrigger() );
+    Benchmark* event =
+      registerBenchmark( new EventParseAndCheckData() );
+    Benchmark* superFragmentTable =
+      registerBenchmark( new SuperFragmentTablePairing("ru::SuperFragmentTable.pairing", 0) );
+    Benchmark* superFragmentTableRanges =
+      registerBenchmark( new SuperFragmentTablePairing("ru::SuperFragmentTable.ranges", 16) );
+    Benchmark* triggerBitCounter =
+      registerBenchmark( new TriggerBitCounterAdd() );
+    Benchmark* l1InfoHandler =
+      registerBenchmark( new L1InfoHandlerExtractL1Info() );
+  }
+
+} } // namespace rubuilder::benchmarks
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,139 @@
+#include "rubuilder/benchmarks/Benchmark.h"
+#include "rubuilder/utils/OneToOneQueue.h"
+#include "rubuilder/utils/OneToOneQueueCollection.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+
+
+namespace rubuilder { namespace benchmarks { // namespace rubuilder::benchmarks
+
+  /**
+   * Transfer elements from a producer thread to the calling thread,
+   * moving up to batchSize elements per queue operation
+   */
+  class OneToOneQueueTransfer : public Benchmark
+  {
+  public:
+
+    OneToOneQueueTransfer(const std::string& name, const uint32_t batchSize) :
+    Benchmark(name),
+    batchSize_(batchSize),
+    queue_("benchmark", 1024)
+    {}
+
+    uint64_t run(const uint64_t count)
+    {
+      boost::thread producer( boost::bind(&OneToOneQueueTransfer::produce, this, count) );
+
+      std::vector<uint32_t> elements(batchSize_);
+      uint64_t received = 0;
+      uint32_t sum = 0;
+      while ( received < count )
+      {
+        uint32_t nbElements;
+        if ( batchSize_ == 1 )
+          nbElements = queue_.deq(elements[0]) ? 1 : 0;
+        else
+          nbElements = queue_.deq(&elements[0], batchSize_);
+
+        if ( nbElements == 0 )
+          boost::this_thread::yield();
+
+        for (uint32_t i = 0; i < nbElements; ++i) sum += elements[i];
+        received += nbElements;
+      }
+      doNotOptimize(sum);
+
+      producer.join();
+      return count * sizeof(uint32_t);
+    }
+
+
+  private:
+
+    void produce(const uint64_t count)
+    {
+      std::vector<uint32_t> elements(batchSize_);
+      uint64_t sent = 0;
+      while ( sent < count )
+      {
+        const uint32_t batchSize = static_cast<uint32_t>(
+          std::min(static_cast<uint64_t>(batchSize_), count - sent) );
+        for (uint32_t i = 0; i < batchSize; ++i) elements[i] = sent + i;
+
+        uint32_t nbElements;
+        if ( batchSize == 1 )
+          nbElements = queue_.enq(elements[0]) ? 1 : 0;
+        else
+          nbElements = queue_.enq(&elements[0], batchSize);
+
+        // Do not spin against the consumer if both share a core
+        if ( nbElements == 0 )
+          boost::this_thread::yield();
+
+        sent += nbElements;
+      }
+    }
+
+    const uint32_t batchSize_;
+    utils::OneToOneQueue<uint32_t> queue_;
+  };
+
+
+  /**
+   * Fill several queues of a collection and drain them round-robin
+   * from the same thread
+   */
+  class OneToOneQueueCollectionRoundRobin : public Benchmark
+  {
+  public:
+
+    OneToOneQueueCollectionRoundRobin() :
+    Benchmark("OneToOneQueueCollection.roundRobin"),
+    collection_("benchmark", 1024)
+    {}
+
+    uint64_t run(const uint64_t count)
+    {
+      uint32_t sum = 0;
+      uint32_t element;
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        collection_.enq(i % nbQueues, i);
+        collection_.deq(element);
+        sum += element;
+      }
+      doNotOptimize(sum);
+      return 0;
+    }
+
+
+  private:
+
+    static const uint32_t nbQueues = 8;
+    utils::OneToOneQueueCollection<uint32_t> collection_;
+  };
+
+
+  namespace
+  {
+    Benchmark* oneToOneQueueSingle =
+      registerBenchmark( new OneToOneQueueTransfer("OneToOneQueue.single", 1) );
+    Benchmark* oneToOneQueueBatched =
+      registerBenchmark( new OneToOneQueueTransfer("OneToOneQueue.batched", 32) );
+    Benchmark* oneToOneQueueCollection =
+      registerBenchmark( new OneToOneQueueCollectionRoundRobin() );
+  }
+
+} } // namespace rubuilder::benchmarks
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,79 @@
+#include "rubuilder/benchmarks/Benchmark.h"
+#include "rubuilder/utils/EvBid.h"
+#include "rubuilder/utils/EventTracer.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <sstream>
+
+
+namespace rubuilder { namespace benchmarks { // namespace rubuilder::benchmarks
+
+  /**
+   * Trace consecutive events at one stage, as done on the hot paths
+   * of the EVM, the RUs and the BUs. A sampling period of 0 disables
+   * the tracing, a period of 1 records every event.
+   */
+  class EventTracerTrace : public Benchmark
+  {
+  public:
+
+    EventTracerTrace(const uint32_t samplingPeriod) :
+    Benchmark(getName(samplingPeriod)),
+    samplingPeriod_(samplingPeriod)
+    {}
+
+    void initialize()
+    {
+      tracer_.reset( new utils::EventTracer() );
+      tracer_->configure(samplingPeriod_, 65536, "/tmp");
+    }
+
+    uint64_t run(const uint64_t count)
+    {
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        const utils::EvBid evbId(0, static_cast<uint32_t>(i % (1 << 24)) + 1);
+        tracer_->trace(evbId, utils::EventTracer::RU_SUPERFRAGMENT_SENT);
+      }
+      return 0;
+    }
+
+
+  private:
+
+    static std::string getName(const uint32_t samplingPeriod)
+    {
+      std::ostringstream name;
+      name << "EventTracer.trace/period" << samplingPeriod;
+      return name.str();
+    }
+
+    const uint32_t samplingPeriod_;
+    boost::scoped_ptr<utils::EventTracer> tracer_;
+  };
+
+
+  namespace
+  {
+    Benchmark* registerTracerBenchmarks()
+    {
+      const uint32_t samplingPeriods[] = { 0, 1024, 1 };
+      Benchmark* benchmark = 0;
+      for (uint32_t i = 0; i < sizeof(samplingPeriods)/sizeof(samplingPeriods[0]); ++i)
+        benchmark = registerBenchmark( new EventTracerTrace(samplingPeriods[i]) );
+      return benchmark;
+    }
+
+    Benchmark* tracerBenchmarks = registerTracerBenchmarks();
+  }
+
+} } // namespace rubuilder::benchmarks
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
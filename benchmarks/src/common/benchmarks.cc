@@ -0,0 +1,76 @@
+// Runs micro-benchmarks of the core data structures of the event builder
+// without XDAQ. The results are written one per line as
+//
+//   benchmark operations ns/op MB/s threshold status
+//
+// where the status is "ok" or "REGRESSION" if a threshold was given for
+// the benchmark, and "-" otherwise. The exit code is 1 if any benchmark
+// is slower than its threshold.
+//
+// Usage: benchmarks [--filter name] [--min-time ms] [--repetitions n]
+//                   [--thresholds file] [--scale factor] [--list]
+
+#include "rubuilder/benchmarks/Benchmark.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+
+
+void usage(const char* program)
+{
+  std::cerr << "Usage: " << program
+    << " [--filter name] [--min-time ms] [--repetitions n]"
+    << " [--thresholds file] [--scale factor] [--list]" << std::endl;
+}
+
+
+int main(int argc, char **argv)
+{
+  rubuilder::benchmarks::Runner runner;
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const bool hasValue = ( i + 1 < argc );
+
+      if ( strcmp(argv[i], "--list") == 0 )
+      {
+        runner.list(std::cout);
+        return 0;
+      }
+      else if ( strcmp(argv[i], "--filter") == 0 && hasValue )
+        runner.setFilter(argv[++i]);
+      else if ( strcmp(argv[i], "--min-time") == 0 && hasValue )
+        runner.setMinTime(atoi(argv[++i]));
+      else if ( strcmp(argv[i], "--repetitions") == 0 && hasValue )
+        runner.setRepetitions(atoi(argv[++i]));
+      else if ( strcmp(argv[i], "--thresholds") == 0 && hasValue )
+        runner.readThresholds(argv[++i]);
+      else if ( strcmp(argv[i], "--scale") == 0 && hasValue )
+        runner.scaleThresholds(atof(argv[++i]));
+      else
+      {
+        usage(argv[0]);
+        return 2;
+      }
+    }
+
+    return ( runner.run(std::cout) > 0 ? 1 : 0 );
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
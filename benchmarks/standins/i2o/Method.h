@@ -0,0 +1,17 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// No I2O callbacks are bound by the benchmarks.
+
+#ifndef _standins_i2o_Method_h_
+#define _standins_i2o_Method_h_
+
+#include "i2o/i2o.h"
+
+#endif // _standins_i2o_Method_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,45 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The I2O frames have the layout of the I2O specification.
+
+#ifndef _standins_i2o_i2o_h_
+#define _standins_i2o_i2o_h_
+
+#include <stdint.h>
+
+
+typedef uint8_t  U8;
+typedef uint16_t U16;
+typedef uint32_t U32;
+
+typedef uint16_t I2O_TID;
+
+#define I2O_PRIVATE_MESSAGE 0xFF
+
+typedef struct _I2O_MESSAGE_FRAME
+{
+  U8  VersionOffset;
+  U8  MsgFlags;
+  U16 MessageSize;
+  U32 TargetAddress : 12;
+  U32 InitiatorAddress : 12;
+  U32 Function : 8;
+  U32 InitiatorContext;
+} I2O_MESSAGE_FRAME, *PI2O_MESSAGE_FRAME;
+
+typedef struct _I2O_PRIVATE_MESSAGE_FRAME
+{
+  I2O_MESSAGE_FRAME StdMessageFrame;
+  U32 TransactionContext;
+  U16 XFunctionCode;
+  U16 OrganizationID;
+} I2O_PRIVATE_MESSAGE_FRAME, *PI2O_PRIVATE_MESSAGE_FRAME;
+
+#endif // _standins_i2o_i2o_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,37 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The I2O address of an application is derived from its instance.
+
+#ifndef _standins_i2o_utils_AddressMap_h_
+#define _standins_i2o_utils_AddressMap_h_
+
+#include "i2o/i2o.h"
+#include "toolbox/string.h"
+#include "xdaq/ApplicationDescriptor.h"
+
+
+namespace i2o { namespace utils {
+
+  class AddressMap
+  {
+  public:
+    I2O_TID getTid(xdaq::ApplicationDescriptor* descriptor) const
+    { return static_cast<I2O_TID>(descriptor->getInstance() + 1); }
+  };
+
+  inline AddressMap* getAddressMap()
+  {
+    static AddressMap addressMap;
+    return &addressMap;
+  }
+
+} } // namespace i2o::utils
+
+#endif // _standins_i2o_utils_AddressMap_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,36 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the event data block exchanged between RU and BU is declared.
+
+#ifndef _standins_interface_evb_i2oEVBMsgs_h_
+#define _standins_interface_evb_i2oEVBMsgs_h_
+
+#include "i2o/i2o.h"
+#include "interface/shared/fed_header.h"
+#include "interface/shared/fed_trailer.h"
+
+
+typedef struct _I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME
+{
+  I2O_PRIVATE_MESSAGE_FRAME PvtMessageFrame;
+  U32 buResourceId;
+  U32 fuTransactionId;
+  U32 nbBlocksInSuperFragment;
+  U32 blockNb;
+  U32 eventNumber;
+  U32 resyncCount;
+  U32 superFragmentNb;
+  U32 nbSuperFragmentsInEvent;
+  U32 runNumber;
+  U32 lumiSection;
+  U32 padding;
+} I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME, *PI2O_EVENT_DATA_BLOCK_MESSAGE_FRAME;
+
+#endif // _standins_interface_evb_i2oEVBMsgs_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
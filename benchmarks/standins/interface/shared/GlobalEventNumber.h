@@ -0,0 +1,117 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The trigger record offsets only need to be self-consistent, as the
+// trigger payload is decoded by the functions below only.
+
+#ifndef _standins_interface_shared_GlobalEventNumber_h_
+#define _standins_interface_shared_GlobalEventNumber_h_
+
+#include "interface/shared/fed_header.h"
+
+#include <stdint.h>
+
+
+namespace evtn {
+
+  const uint32_t SLINK_WORD_SIZE = 8;
+  const uint32_t SLINK_HALFWORD_SIZE = 4;
+
+  const uint32_t EVM_GTFE_BLOCK_V0011 = 6;
+  const uint32_t EVM_GTFE_BLOCK = EVM_GTFE_BLOCK_V0011;
+  const uint32_t EVM_TCS_BLOCK = 5;
+  const uint32_t EVM_FDL_BLOCK = 7;
+  const uint32_t EVM_FDL_NOBX = 3;
+
+  const uint32_t EVM_BOARDID_OFFSET = 0;
+  const uint32_t EVM_BOARDID_SHIFT = 24;
+  const uint32_t EVM_BOARDID_VALUE = 0x11;
+
+  const uint32_t EVM_GTFE_SETUPVERSION_OFFSET = 2;
+  const uint32_t EVM_GTFE_SETUPVERSION_MASK = 0x00000001;
+  const uint32_t EVM_GTFE_FDLMODE_OFFSET = 2;
+  const uint32_t EVM_GTFE_FDLMODE_MASK = 0x00000010;
+  const uint32_t EVM_GTFE_BSTGPS_OFFSET = 4;
+
+  const uint32_t EVM_TCS_BOARDID_OFFSET = 3;
+  const uint32_t EVM_TCS_BOARDID_SHIFT = 16;
+  const uint32_t EVM_TCS_BOARDID_MASK = 0xffff0000;
+  const uint32_t EVM_TCS_BOARDID_VALUE = 0xcc;
+  const uint32_t EVM_TCS_TRIGNR_OFFSET = 5;
+  const uint32_t EVM_TCS_LSBLNR_OFFSET = 0;
+  const uint32_t EVM_TCS_LSBLNR_MASK = 0x0000ffff;
+  const uint32_t EVM_TCS_ORBTNR_OFFSET = 6;
+  const uint32_t EVM_TCS_EVNTYP_SHIFT = 16;
+  const uint32_t EVM_TCS_EVNTYP_MASK = 0x000f0000;
+  const uint32_t EVM_TCS_BCNRIN_MASK = 0x00000fff;
+
+  const uint32_t EVM_FDL_BCNRIN_OFFSET = 1;
+  const uint32_t EVM_FDL_BXINEV_SHIFT = 12;
+  const uint32_t EVM_FDL_BXINEV_MASK = 0x0000f000;
+  const uint32_t EVM_FDL_TECTRG_OFFSET = 2;
+  const uint32_t EVM_FDL_ALGOB1_OFFSET = 4;
+  const uint32_t EVM_FDL_ALGOB2_OFFSET = 8;
+  const uint32_t EVM_FDL_PSCVSN_OFFSET = 13;
+  const uint32_t EVM_FDL_BOARDID_SHIFT = 24;
+  const uint32_t EVM_FDL_BOARDID_MASK = 0xff000000;
+  const uint32_t EVM_FDL_BOARDID_VALUE = 0xfd;
+
+  inline void evm_board_setformat(const uint32_t size) {}
+
+  inline uint32_t evm_halfword(const unsigned char* p, const uint32_t offset)
+  { return *(const uint32_t*)(p + sizeof(fedh_t) + offset * SLINK_HALFWORD_SIZE); }
+
+  inline uint64_t evm_word(const unsigned char* p, const uint32_t offset)
+  { return *(const uint64_t*)(p + sizeof(fedh_t) + offset * SLINK_HALFWORD_SIZE); }
+
+  inline uint32_t evm_fdl_offset()
+  { return (EVM_GTFE_BLOCK + EVM_TCS_BLOCK + EVM_FDL_BLOCK * (EVM_FDL_NOBX/2)) * 2; }
+
+  inline bool set_evm_board_sense(const unsigned char* p)
+  { return ( evm_halfword(p, EVM_BOARDID_OFFSET) >> EVM_BOARDID_SHIFT ) == EVM_BOARDID_VALUE; }
+
+  inline bool has_evm_tcs(const unsigned char* p)
+  {
+    return ( (evm_halfword(p, EVM_GTFE_BLOCK*2 + EVM_TCS_BOARDID_OFFSET) & EVM_TCS_BOARDID_MASK)
+      >> EVM_TCS_BOARDID_SHIFT ) == EVM_TCS_BOARDID_VALUE;
+  }
+
+  inline bool has_evm_fdl(const unsigned char* p)
+  {
+    return ( (evm_halfword(p, evm_fdl_offset() + EVM_FDL_BCNRIN_OFFSET) & EVM_FDL_BOARDID_MASK)
+      >> EVM_FDL_BOARDID_SHIFT ) == EVM_FDL_BOARDID_VALUE;
+  }
+
+  inline uint32_t getfdlbxevt(const unsigned char* p)
+  {
+    return ( evm_halfword(p, evm_fdl_offset() + EVM_FDL_BCNRIN_OFFSET) & EVM_FDL_BXINEV_MASK )
+      >> EVM_FDL_BXINEV_SHIFT;
+  }
+
+  inline uint32_t getlbn(const unsigned char* p)
+  { return evm_halfword(p, EVM_GTFE_BLOCK*2 + EVM_TCS_LSBLNR_OFFSET) & EVM_TCS_LSBLNR_MASK; }
+
+  inline uint32_t getevtyp(const unsigned char* p)
+  {
+    return ( evm_halfword(p, EVM_GTFE_BLOCK*2 + EVM_TCS_LSBLNR_OFFSET) & EVM_TCS_EVNTYP_MASK )
+      >> EVM_TCS_EVNTYP_SHIFT;
+  }
+
+  inline uint64_t getfdlttr(const unsigned char* p)
+  { return evm_word(p, evm_fdl_offset() + EVM_FDL_TECTRG_OFFSET); }
+
+  inline uint64_t getfdlta1(const unsigned char* p)
+  { return evm_word(p, evm_fdl_offset() + EVM_FDL_ALGOB1_OFFSET); }
+
+  inline uint64_t getfdlta2(const unsigned char* p)
+  { return evm_word(p, evm_fdl_offset() + EVM_FDL_ALGOB2_OFFSET); }
+
+} // namespace evtn
+
+#endif // _standins_interface_shared_GlobalEventNumber_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
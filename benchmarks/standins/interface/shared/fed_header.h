@@ -0,0 +1,41 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The FED header follows the CMS DAQ common data format.
+
+#ifndef _standins_interface_shared_fed_header_h_
+#define _standins_interface_shared_fed_header_h_
+
+#include <stdint.h>
+
+
+typedef struct fedh_struct
+{
+  uint32_t sourceid;
+  uint32_t eventid;
+} fedh_t;
+
+#define FED_SLINK_START_MARKER 0x5
+
+#define FED_HCTRLID_WIDTH 0x0000000f
+#define FED_HCTRLID_SHIFT 28
+#define FED_HCTRLID_MASK ( FED_HCTRLID_WIDTH << FED_HCTRLID_SHIFT )
+#define FED_HCTRLID_EXTRACT(a) ( ( (a) >> FED_HCTRLID_SHIFT ) & FED_HCTRLID_WIDTH )
+
+#define FED_LVL1_WIDTH 0x00ffffff
+#define FED_LVL1_SHIFT 0
+#define FED_LVL1_MASK ( FED_LVL1_WIDTH << FED_LVL1_SHIFT )
+#define FED_LVL1_EXTRACT(a) ( ( (a) >> FED_LVL1_SHIFT ) & FED_LVL1_WIDTH )
+
+#define FED_SOID_WIDTH 0x00000fff
+#define FED_SOID_SHIFT 8
+#define FED_SOID_MASK ( FED_SOID_WIDTH << FED_SOID_SHIFT )
+#define FED_SOID_EXTRACT(a) ( ( (a) >> FED_SOID_SHIFT ) & FED_SOID_WIDTH )
+
+#endif // _standins_interface_shared_fed_header_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,41 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The FED trailer follows the CMS DAQ common data format.
+
+#ifndef _standins_interface_shared_fed_trailer_h_
+#define _standins_interface_shared_fed_trailer_h_
+
+#include <stdint.h>
+
+
+typedef struct fedt_struct
+{
+  uint32_t conscheck;
+  uint32_t eventsize;
+} fedt_t;
+
+#define FED_SLINK_END_MARKER 0xa
+
+#define FED_TCTRLID_WIDTH 0x0000000f
+#define FED_TCTRLID_SHIFT 28
+#define FED_TCTRLID_MASK ( FED_TCTRLID_WIDTH << FED_TCTRLID_SHIFT )
+#define FED_TCTRLID_EXTRACT(a) ( ( (a) >> FED_TCTRLID_SHIFT ) & FED_TCTRLID_WIDTH )
+
+#define FED_EVSZ_WIDTH 0x00ffffff
+#define FED_EVSZ_SHIFT 0
+#define FED_EVSZ_MASK ( FED_EVSZ_WIDTH << FED_EVSZ_SHIFT )
+#define FED_EVSZ_EXTRACT(a) ( ( (a) >> FED_EVSZ_SHIFT ) & FED_EVSZ_WIDTH )
+
+#define FED_CRCS_WIDTH 0x0000ffff
+#define FED_CRCS_SHIFT 16
+#define FED_CRCS_MASK ( FED_CRCS_WIDTH << FED_CRCS_SHIFT )
+#define FED_CRCS_EXTRACT(a) ( ( (a) >> FED_CRCS_SHIFT ) & FED_CRCS_WIDTH )
+
+#endif // _standins_interface_shared_fed_trailer_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
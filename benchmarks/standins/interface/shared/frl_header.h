@@ -0,0 +1,29 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The FRL header follows the CMS DAQ FRL format.
+
+#ifndef _standins_interface_shared_frl_header_h_
+#define _standins_interface_shared_frl_header_h_
+
+#include <stdint.h>
+
+
+typedef struct frlh_struct
+{
+  uint32_t trigno;
+  uint32_t segno;
+  uint32_t reserved;
+  uint32_t segsize;
+} frlh_t;
+
+#define FRL_SEGSIZE_MASK 0x0000ffff
+#define FRL_LAST_SEGM    0x80000000
+
+#endif // _standins_interface_shared_frl_header_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,17 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// No I2O messages are sent by the benchmarks.
+
+#ifndef _standins_interface_shared_i2oXFunctionCodes_h_
+#define _standins_interface_shared_i2oXFunctionCodes_h_
+
+#define I2O_SUPER_FRAGMENT_READY 0x36
+
+#endif // _standins_interface_shared_i2oXFunctionCodes_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,43 @@
+// Stand-in for the log4cplus header of the same name used by the benchmarks.
+// Messages are written to the standard error stream.
+
+#ifndef _standins_log4cplus_logger_h_
+#define _standins_log4cplus_logger_h_
+
+#include <iostream>
+#include <string>
+
+
+namespace log4cplus {
+
+  class Logger
+  {
+  public:
+    Logger() {}
+    Logger(const std::string& name) : name_(name) {}
+    std::string getName() const { return name_; }
+  private:
+    std::string name_;
+  };
+
+} // namespace log4cplus
+
+
+#define LOG4CPLUS_STANDIN_LOG(LEVEL, LOGGER, MESSAGE) \
+  do { std::cerr << LEVEL << " " << (LOGGER).getName() << " - " << MESSAGE << std::endl; } while (0)
+
+#define LOG4CPLUS_DEBUG(LOGGER, MESSAGE) do {} while (0)
+#define LOG4CPLUS_INFO(LOGGER, MESSAGE) LOG4CPLUS_STANDIN_LOG("INFO", LOGGER, MESSAGE)
+#define LOG4CPLUS_WARN(LOGGER, MESSAGE) LOG4CPLUS_STANDIN_LOG("WARN", LOGGER, MESSAGE)
+#define LOG4CPLUS_ERROR(LOGGER, MESSAGE) LOG4CPLUS_STANDIN_LOG("ERROR", LOGGER, MESSAGE)
+#define LOG4CPLUS_FATAL(LOGGER, MESSAGE) LOG4CPLUS_STANDIN_LOG("FATAL", LOGGER, MESSAGE)
+
+#endif // _standins_log4cplus_logger_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,39 @@
+// Stand-in for the header of the same name, which is tied to the application.
+// Super-fragments are discarded as if the FU had processed them.
+
+#ifndef _rubuilder_bu_FUproxy_h_
+#define _rubuilder_bu_FUproxy_h_
+
+#include "rubuilder/bu/FuRqstForResource.h"
+#include "toolbox/mem/Reference.h"
+
+#include <stdint.h>
+
+
+namespace rubuilder { namespace bu { // namespace rubuilder::bu
+
+  class FUproxy
+  {
+  public:
+
+    void sendSuperFragment
+    (
+      const FuRqstForResource&,
+      const uint32_t superFragmentNb,
+      const uint32_t nbSuperFragmentsInEvent,
+      toolbox::mem::Reference* bufRef
+    )
+    { bufRef->release(); }
+  };
+
+} } // namespace rubuilder::bu
+
+#endif // _rubuilder_bu_FUproxy_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
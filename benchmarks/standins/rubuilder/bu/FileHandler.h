@@ -0,0 +1,51 @@
+// Stand-in for the header of the same name, which is tied to the application.
+// Events are written to heap memory instead of a file.
+
+#ifndef _rubuilder_bu_FileHandler_h_
+#define _rubuilder_bu_FileHandler_h_
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+namespace rubuilder { namespace bu { // namespace rubuilder::bu
+
+  class FileHandler
+  {
+  public:
+
+    FileHandler() : map_(0), eventCount_(0) {}
+
+    ~FileHandler() { ::free(map_); }
+
+    void* getMemMap(const size_t length)
+    {
+      ::free(map_);
+      map_ = ::malloc(length);
+      return map_;
+    }
+
+    void incrementEventCount()
+    { ++eventCount_; }
+
+  private:
+
+    void* map_;
+    uint32_t eventCount_;
+  };
+
+  typedef boost::shared_ptr<FileHandler> FileHandlerPtr;
+
+} } // namespace rubuilder::bu
+
+#endif // _rubuilder_bu_FileHandler_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
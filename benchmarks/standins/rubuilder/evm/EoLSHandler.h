@@ -0,0 +1,45 @@
+// Stand-in for the header of the same name, which is tied to the application.
+// The end-of-lumi-section signals are only counted.
+
+#ifndef _rubuilder_evm_EoLSHandler_h_
+#define _rubuilder_evm_EoLSHandler_h_
+
+#include <stdint.h>
+
+
+namespace rubuilder { namespace evm { // namespace rubuilder::evm
+
+  class EoLSHandler
+  {
+  public:
+
+    struct LumiSectionPair
+    {
+      uint32_t runNumber;
+      uint32_t lumiSection;
+    };
+
+    EoLSHandler() : sentCount_(0) {}
+
+    void send(const LumiSectionPair&)
+    { ++sentCount_; }
+
+    uint64_t getSentCount() const
+    { return sentCount_; }
+
+  private:
+
+    uint64_t sentCount_;
+  };
+
+} } // namespace rubuilder::evm
+
+#endif // _rubuilder_evm_EoLSHandler_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,40 @@
+// Stand-in for the header of the same name, which is tied to the application.
+// Sent super-fragments are only counted, as the benchmark reuses their frames.
+
+#ifndef _rubuilder_ru_BUproxy_h_
+#define _rubuilder_ru_BUproxy_h_
+
+#include "rubuilder/ru/SuperFragmentTable.h"
+#include "toolbox/mem/Reference.h"
+
+
+namespace rubuilder { namespace ru { // namespace rubuilder::ru
+
+  class BUproxy
+  {
+  public:
+
+    BUproxy() : sentCount_(0) {}
+
+    void sendData(const SuperFragmentTable::Request&, toolbox::mem::Reference*)
+    { ++sentCount_; }
+
+    uint64_t getSentCount() const
+    { return sentCount_; }
+
+  private:
+
+    uint64_t sentCount_;
+  };
+
+} } // namespace rubuilder::ru
+
+#endif // _rubuilder_ru_BUproxy_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
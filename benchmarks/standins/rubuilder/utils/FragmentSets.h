@@ -0,0 +1,39 @@
+// Stand-in for the header of the same name, which needs the XDAQ DOM parser.
+// No fragment sets can be loaded by the benchmarks.
+
+#ifndef _rubuilder_utils_FragmentSets_h_
+#define _rubuilder_utils_FragmentSets_h_
+
+#include "rubuilder/utils/Exception.h"
+
+#include <set>
+#include <string>
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  class FragmentSets
+  {
+  public:
+
+    void init(const std::string& url)
+    { XCEPT_RAISE(exception::Configuration, "Cannot load fragment sets from " + url); }
+
+    std::set<int, std::less<int> > getFragmentSet(const unsigned int)
+    { return std::set<int, std::less<int> >(); }
+
+    std::string getName(const unsigned int)
+    { return ""; }
+  };
+
+} } // namespace rubuilder::utils
+
+#endif // _rubuilder_utils_FragmentSets_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
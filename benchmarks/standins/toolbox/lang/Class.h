@@ -0,0 +1,25 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The base class of the XDAQ objects does not provide anything.
+
+#ifndef _standins_toolbox_lang_Class_h_
+#define _standins_toolbox_lang_Class_h_
+
+namespace toolbox { namespace lang {
+
+  class Class
+  {
+  public:
+    virtual ~Class() {}
+  };
+
+} } // namespace toolbox::lang
+
+#endif // _standins_toolbox_lang_Class_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
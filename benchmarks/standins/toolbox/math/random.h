@@ -0,0 +1,57 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Log-normally distributed sizes are drawn with the C library generator.
+
+#ifndef _standins_toolbox_math_random_h_
+#define _standins_toolbox_math_random_h_
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+
+namespace toolbox { namespace math {
+
+  class LogNormalGen
+  {
+  public:
+
+    LogNormalGen(const uint32_t seed, const double mean, const double stdDev) :
+    mean_(mean), stdDev_(stdDev), seed_(seed)
+    {
+      const double variance = stdDev * stdDev;
+      sigma_ = sqrt( log(1 + variance / (mean * mean)) );
+      mu_ = log(mean) - sigma_ * sigma_ / 2;
+    }
+
+    unsigned long getRawRandomSize()
+    {
+      if ( stdDev_ == 0 ) return static_cast<unsigned long>(mean_);
+
+      // Box-Muller transform of two uniform random numbers
+      const double u1 = (rand_r(&seed_) + 1.0) / (RAND_MAX + 2.0);
+      const double u2 = (rand_r(&seed_) + 1.0) / (RAND_MAX + 2.0);
+      const double normal = sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+      return static_cast<unsigned long>( exp(mu_ + sigma_ * normal) );
+    }
+
+  private:
+
+    double mean_;
+    double stdDev_;
+    double mu_;
+    double sigma_;
+    unsigned int seed_;
+  };
+
+} } // namespace toolbox::math
+
+#endif // _standins_toolbox_math_random_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,47 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The interface matches the XDAQ allocator.
+
+#ifndef _standins_toolbox_mem_Allocator_h_
+#define _standins_toolbox_mem_Allocator_h_
+
+#include "toolbox/mem/Buffer.h"
+#include "toolbox/mem/exception/FailedAllocation.h"
+#include "toolbox/mem/exception/FailedDispose.h"
+
+#include <string>
+
+
+namespace toolbox { namespace mem {
+
+  class Allocator
+  {
+  public:
+
+    virtual ~Allocator() {}
+
+    virtual Buffer* alloc(size_t size, Pool*)
+      throw (exception::FailedAllocation) = 0;
+
+    virtual void free(Buffer*)
+      throw (exception::FailedDispose) = 0;
+
+    virtual std::string type() = 0;
+
+    virtual bool isCommittedSizeSupported() = 0;
+
+    virtual size_t getCommittedSize() = 0;
+
+    virtual size_t getUsed() = 0;
+  };
+
+} } // namespace toolbox::mem
+
+#endif // _standins_toolbox_mem_Allocator_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
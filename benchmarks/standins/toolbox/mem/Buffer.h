@@ -0,0 +1,49 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// A buffer counts the references to it, which may be released by any thread.
+
+#ifndef _standins_toolbox_mem_Buffer_h_
+#define _standins_toolbox_mem_Buffer_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+namespace toolbox { namespace mem {
+
+  class Pool;
+
+  class Buffer
+  {
+  public:
+
+    Buffer(Pool* pool, const size_t size, void* address) :
+    pool_(pool), size_(size), address_(address), refCount_(0) {}
+
+    virtual ~Buffer() {}
+
+    Pool* getPool() const { return pool_; }
+    size_t getSize() const { return size_; }
+    void* getAddress() const { return address_; }
+
+    void addReference() { __sync_add_and_fetch(&refCount_, 1); }
+    bool removeReference() { return ( __sync_sub_and_fetch(&refCount_, 1) == 0 ); }
+
+  private:
+
+    Pool* pool_;
+    size_t size_;
+    void* address_;
+    uint32_t refCount_;
+  };
+
+} } // namespace toolbox::mem
+
+#endif // _standins_toolbox_mem_Buffer_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,61 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Each buffer is allocated from the C library heap.
+
+#ifndef _standins_toolbox_mem_HeapAllocator_h_
+#define _standins_toolbox_mem_HeapAllocator_h_
+
+#include "toolbox/mem/Allocator.h"
+
+#include <stdlib.h>
+
+
+namespace toolbox { namespace mem {
+
+  class HeapAllocator : public Allocator
+  {
+  public:
+
+    HeapAllocator() : used_(0) {}
+
+    Buffer* alloc(size_t size, Pool* pool)
+      throw (exception::FailedAllocation)
+    {
+      void* address = ::malloc(size);
+      if ( address == 0 )
+        XCEPT_RAISE(exception::FailedAllocation, "Out of memory");
+      __sync_add_and_fetch(&used_, size);
+      return new Buffer(pool, size, address);
+    }
+
+    void free(Buffer* buffer)
+      throw (exception::FailedDispose)
+    {
+      __sync_sub_and_fetch(&used_, buffer->getSize());
+      ::free(buffer->getAddress());
+      delete buffer;
+    }
+
+    std::string type() { return "heap"; }
+
+    bool isCommittedSizeSupported() { return false; }
+
+    size_t getCommittedSize() { return 0; }
+
+    size_t getUsed() { return used_; }
+
+  private:
+
+    size_t used_;
+  };
+
+} } // namespace toolbox::mem
+
+#endif // _standins_toolbox_mem_HeapAllocator_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
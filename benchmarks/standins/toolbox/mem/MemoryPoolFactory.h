@@ -0,0 +1,77 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Pools are kept by name.
+
+#ifndef _standins_toolbox_mem_MemoryPoolFactory_h_
+#define _standins_toolbox_mem_MemoryPoolFactory_h_
+
+#include "toolbox/mem/Pool.h"
+#include "toolbox/mem/Reference.h"
+#include "toolbox/mem/exception/DuplicateMemoryPool.h"
+#include "toolbox/mem/exception/MemoryPoolNotFound.h"
+#include "toolbox/net/URN.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+
+
+namespace toolbox { namespace mem {
+
+  class MemoryPoolFactory
+  {
+  public:
+
+    Pool* createPool(const toolbox::net::URN& urn, Allocator* allocator)
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      Pool*& pool = pools_[urn.toString()];
+      if ( pool )
+        XCEPT_RAISE(exception::DuplicateMemoryPool, urn.toString());
+      pool = new Pool(allocator);
+      return pool;
+    }
+
+    Pool* findPool(const toolbox::net::URN& urn)
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      const Pools::const_iterator pos = pools_.find(urn.toString());
+      if ( pos == pools_.end() || pos->second == 0 )
+        XCEPT_RAISE(exception::MemoryPoolNotFound, urn.toString());
+      return pos->second;
+    }
+
+    Reference* getFrame(Pool* pool, const size_t size)
+    {
+      return new Reference( pool->alloc(size) );
+    }
+
+  private:
+
+    typedef std::map<std::string,Pool*> Pools;
+    Pools pools_;
+    boost::mutex mutex_;
+  };
+
+
+  /**
+   * The factory lives until the end of the process,
+   * as frames may be released by static objects.
+   */
+  inline MemoryPoolFactory* getMemoryPoolFactory()
+  {
+    static MemoryPoolFactory* factory = new MemoryPoolFactory();
+    return factory;
+  }
+
+} } // namespace toolbox::mem
+
+#endif // _standins_toolbox_mem_MemoryPoolFactory_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,86 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Buffers are passed through to the allocator, which owns them.
+
+#ifndef _standins_toolbox_mem_Pool_h_
+#define _standins_toolbox_mem_Pool_h_
+
+#include "toolbox/mem/Allocator.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <limits>
+
+
+namespace toolbox { namespace mem {
+
+  class Usage
+  {
+  public:
+    Usage(const size_t used) : used_(used) {}
+    size_t getUsed() const { return used_; }
+  private:
+    size_t used_;
+  };
+
+
+  class Pool
+  {
+  public:
+
+    Pool(Allocator* allocator) :
+    allocator_(allocator),
+    used_(0),
+    highThreshold_(std::numeric_limits<size_t>::max())
+    {}
+
+    Buffer* alloc(const size_t size)
+    {
+      Buffer* buffer = allocator_->alloc(size, this);
+      boost::mutex::scoped_lock sl(mutex_);
+      used_ += buffer->getSize();
+      return buffer;
+    }
+
+    void free(Buffer* buffer)
+    {
+      {
+        boost::mutex::scoped_lock sl(mutex_);
+        used_ -= buffer->getSize();
+      }
+      allocator_->free(buffer);
+    }
+
+    void setHighThreshold(const size_t highThreshold)
+    { highThreshold_ = highThreshold; }
+
+    bool isHighThresholdExceeded()
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      return ( used_ > highThreshold_ );
+    }
+
+    Usage getMemoryUsage()
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      return Usage(used_);
+    }
+
+  private:
+
+    Allocator* allocator_;
+    boost::mutex mutex_;
+    size_t used_;
+    size_t highThreshold_;
+  };
+
+} } // namespace toolbox::mem
+
+#endif // _standins_toolbox_mem_Pool_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,87 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// References are chained and share their buffer when duplicated.
+
+#ifndef _standins_toolbox_mem_Reference_h_
+#define _standins_toolbox_mem_Reference_h_
+
+#include "toolbox/mem/Buffer.h"
+#include "toolbox/mem/Pool.h"
+
+
+namespace toolbox { namespace mem {
+
+  class Reference
+  {
+  public:
+
+    Reference(Buffer* buffer) :
+    buffer_(buffer),
+    dataOffset_(0),
+    dataSize_(buffer->getSize()),
+    next_(0)
+    { buffer_->addReference(); }
+
+    Buffer* getBuffer() const { return buffer_; }
+    void* getDataLocation() const { return static_cast<char*>(buffer_->getAddress()) + dataOffset_; }
+    size_t getDataOffset() const { return dataOffset_; }
+    void setDataOffset(const size_t offset) { dataOffset_ = offset; }
+    size_t getDataSize() const { return dataSize_; }
+    void setDataSize(const size_t size) { dataSize_ = size; }
+    Reference* getNextReference() const { return next_; }
+    void setNextReference(Reference* next) { next_ = next; }
+
+    /**
+     * Return a new chain of references to the buffers of this chain
+     */
+    Reference* duplicate() const
+    {
+      Reference* head = new Reference(buffer_);
+      head->setDataOffset(dataOffset_);
+      head->setDataSize(dataSize_);
+      Reference* tail = head;
+      for (const Reference* ref = next_; ref; ref = ref->next_)
+      {
+        tail->next_ = new Reference(ref->buffer_);
+        tail = tail->next_;
+        tail->setDataOffset(ref->dataOffset_);
+        tail->setDataSize(ref->dataSize_);
+      }
+      return head;
+    }
+
+    /**
+     * Release this reference and all references chained to it.
+     * A buffer returns to its pool once its last reference is released.
+     */
+    void release()
+    {
+      Reference* ref = this;
+      while (ref)
+      {
+        Reference* next = ref->next_;
+        if ( ref->buffer_->removeReference() )
+          ref->buffer_->getPool()->free(ref->buffer_);
+        delete ref;
+        ref = next;
+      }
+    }
+
+  private:
+
+    Buffer* buffer_;
+    size_t dataOffset_;
+    size_t dataSize_;
+    Reference* next_;
+  };
+
+} } // namespace toolbox::mem
+
+#endif // _standins_toolbox_mem_Reference_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
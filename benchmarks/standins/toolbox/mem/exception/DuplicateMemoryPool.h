@@ -0,0 +1,20 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Raised when creating a pool twice.
+
+#ifndef _standins_toolbox_mem_exception_DuplicateMemoryPool_h_
+#define _standins_toolbox_mem_exception_DuplicateMemoryPool_h_
+
+#include "toolbox/mem/exception/Exception.h"
+
+
+TOOLBOX_MEM_DEFINE_EXCEPTION(DuplicateMemoryPool, Exception)
+
+#endif // _standins_toolbox_mem_exception_DuplicateMemoryPool_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
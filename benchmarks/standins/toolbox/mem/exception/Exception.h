@@ -0,0 +1,35 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// All memory pool exceptions derive from this one.
+
+#ifndef _standins_toolbox_mem_exception_Exception_h_
+#define _standins_toolbox_mem_exception_Exception_h_
+
+#include "xcept/Exception.h"
+
+
+#define TOOLBOX_MEM_DEFINE_EXCEPTION(EXCEPTION, BASE) \
+namespace toolbox { namespace mem { namespace exception { \
+  class EXCEPTION : public BASE \
+  { \
+  public: \
+    EXCEPTION(const std::string& name, const std::string& message, \
+      const std::string& module, const int line, const std::string& function) : \
+    BASE(name, message, module, line, function) {} \
+    EXCEPTION(const std::string& name, const std::string& message, \
+      const std::string& module, const int line, const std::string& function, \
+      const xcept::Exception& previous) : \
+    BASE(name, message, module, line, function, previous) {} \
+  }; \
+} } }
+
+TOOLBOX_MEM_DEFINE_EXCEPTION(Exception, xcept::Exception)
+
+#endif // _standins_toolbox_mem_exception_Exception_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,20 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Raised when a buffer cannot be allocated.
+
+#ifndef _standins_toolbox_mem_exception_FailedAllocation_h_
+#define _standins_toolbox_mem_exception_FailedAllocation_h_
+
+#include "toolbox/mem/exception/Exception.h"
+
+
+TOOLBOX_MEM_DEFINE_EXCEPTION(FailedAllocation, Exception)
+
+#endif // _standins_toolbox_mem_exception_FailedAllocation_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
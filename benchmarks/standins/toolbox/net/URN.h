@@ -0,0 +1,32 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the string representation is kept.
+
+#ifndef _standins_toolbox_net_URN_h_
+#define _standins_toolbox_net_URN_h_
+
+#include <string>
+
+
+namespace toolbox { namespace net {
+
+  class URN
+  {
+  public:
+    URN(const std::string& nid, const std::string& nss) :
+    urn_("urn:" + nid + ":" + nss) {}
+    std::string toString() const { return urn_; }
+  private:
+    std::string urn_;
+  };
+
+} } // namespace toolbox::net
+
+#endif // _standins_toolbox_net_URN_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
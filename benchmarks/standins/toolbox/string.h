@@ -0,0 +1,34 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only printf-like formatting is provided.
+
+#ifndef _standins_toolbox_string_h_
+#define _standins_toolbox_string_h_
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string>
+
+
+namespace toolbox {
+
+  inline std::string toString(const char* format, ...)
+  {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return buffer;
+  }
+
+} // namespace toolbox
+
+#endif // _standins_toolbox_string_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,55 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// An action calls the bound member function.
+
+#ifndef _standins_toolbox_task_Action_h_
+#define _standins_toolbox_task_Action_h_
+
+#include <string>
+
+
+namespace toolbox { namespace task {
+
+  class WorkLoop;
+
+  class ActionSignature
+  {
+  public:
+    ActionSignature(const std::string& name) : name_(name) {}
+    virtual ~ActionSignature() {}
+    virtual bool invoke(WorkLoop*) = 0;
+    std::string name() const { return name_; }
+  private:
+    const std::string name_;
+  };
+
+
+  template <class T>
+  class Action : public ActionSignature
+  {
+  public:
+    Action(T* object, bool (T::*func)(WorkLoop*), const std::string& name) :
+    ActionSignature(name), object_(object), func_(func) {}
+    bool invoke(WorkLoop* wl) { return (object_->*func_)(wl); }
+  private:
+    T* object_;
+    bool (T::*func_)(WorkLoop*);
+  };
+
+
+  template <class T>
+  ActionSignature* bind(T* object, bool (T::*func)(WorkLoop*), const std::string& name)
+  {
+    return new Action<T>(object, func, name);
+  }
+
+} } // namespace toolbox::task
+
+#endif // _standins_toolbox_task_Action_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,30 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// All workloops wait for actions to be submitted.
+
+#ifndef _standins_toolbox_task_WaitingWorkLoop_h_
+#define _standins_toolbox_task_WaitingWorkLoop_h_
+
+#include "toolbox/task/WorkLoop.h"
+
+#include <string>
+
+
+namespace toolbox { namespace task {
+
+  class WaitingWorkLoop : public WorkLoop
+  {
+  public:
+    WaitingWorkLoop(const std::string& name) : WorkLoop(name) {}
+  };
+
+} } // namespace toolbox::task
+
+#endif // _standins_toolbox_task_WaitingWorkLoop_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,98 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Once activated, a thread invokes the submitted actions in turn and
+// resubmits each action returning true. The thread is never joined,
+// as workloops are only cancelled at the end of the process.
+
+#ifndef _standins_toolbox_task_WorkLoop_h_
+#define _standins_toolbox_task_WorkLoop_h_
+
+#include "toolbox/task/Action.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <deque>
+#include <string>
+
+
+namespace toolbox { namespace task {
+
+  class WorkLoop
+  {
+  public:
+
+    WorkLoop(const std::string& name) :
+    name_(name), active_(false) {}
+
+    virtual ~WorkLoop() {}
+
+    std::string getName() const
+    { return name_; }
+
+    bool isActive()
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      return active_;
+    }
+
+    void submit(ActionSignature* action)
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      actions_.push_back(action);
+      actionAvailable_.notify_one();
+    }
+
+    void activate()
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      if ( active_ ) return;
+      active_ = true;
+      boost::thread thread( boost::bind(&WorkLoop::process, this) );
+      thread.detach();
+    }
+
+    void cancel()
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      active_ = false;
+      actionAvailable_.notify_one();
+    }
+
+  private:
+
+    void process()
+    {
+      for (;;)
+      {
+        ActionSignature* action;
+        {
+          boost::mutex::scoped_lock sl(mutex_);
+          while ( active_ && actions_.empty() ) actionAvailable_.wait(sl);
+          if ( ! active_ ) return;
+          action = actions_.front();
+          actions_.pop_front();
+        }
+        if ( action->invoke(this) ) submit(action);
+      }
+    }
+
+    const std::string name_;
+    bool active_;
+    std::deque<ActionSignature*> actions_;
+    boost::mutex mutex_;
+    boost::condition_variable actionAvailable_;
+  };
+
+} } // namespace toolbox::task
+
+#endif // _standins_toolbox_task_WorkLoop_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
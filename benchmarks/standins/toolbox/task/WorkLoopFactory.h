@@ -0,0 +1,57 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Workloops are kept by name.
+
+#ifndef _standins_toolbox_task_WorkLoopFactory_h_
+#define _standins_toolbox_task_WorkLoopFactory_h_
+
+#include "toolbox/task/WaitingWorkLoop.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+
+
+namespace toolbox { namespace task {
+
+  class WorkLoopFactory
+  {
+  public:
+
+    WorkLoop* getWorkLoop(const std::string& name, const std::string& type)
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      WorkLoop*& workLoop = workLoops_[name];
+      if ( workLoop == 0 ) workLoop = new WaitingWorkLoop(name);
+      return workLoop;
+    }
+
+  private:
+
+    typedef std::map<std::string,WorkLoop*> WorkLoops;
+    WorkLoops workLoops_;
+    boost::mutex mutex_;
+  };
+
+
+  /**
+   * The factory lives until the end of the process,
+   * as the workloop threads are never joined.
+   */
+  inline WorkLoopFactory* getWorkLoopFactory()
+  {
+    static WorkLoopFactory* factory = new WorkLoopFactory();
+    return factory;
+  }
+
+} } // namespace toolbox::task
+
+#endif // _standins_toolbox_task_WorkLoopFactory_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,94 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Exceptions carry their message only.
+
+#ifndef _standins_xcept_Exception_h_
+#define _standins_xcept_Exception_h_
+
+#include <exception>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace xcept {
+
+  class Exception : public std::exception
+  {
+  public:
+
+    Exception
+    (
+      const std::string& name,
+      const std::string& message,
+      const std::string& module,
+      const int line,
+      const std::string& function
+    ) :
+    message_(name + ": " + message)
+    {}
+
+    Exception
+    (
+      const std::string& name,
+      const std::string& message,
+      const std::string& module,
+      const int line,
+      const std::string& function,
+      const Exception& previous
+    ) :
+    message_(name + ": " + message + " (" + previous.message() + ")")
+    {}
+
+    virtual ~Exception() throw() {}
+
+    const char* what() const throw()
+    { return message_.c_str(); }
+
+    std::string message() const
+    { return message_; }
+
+  private:
+
+    std::string message_;
+  };
+
+} // namespace xcept
+
+
+#define XCEPT_DEFINE_EXCEPTION(NAMESPACE, EXCEPTION) \
+namespace NAMESPACE { namespace exception { \
+  class EXCEPTION : public xcept::Exception \
+  { \
+  public: \
+    EXCEPTION(const std::string& name, const std::string& message, \
+      const std::string& module, const int line, const std::string& function) : \
+    xcept::Exception(name, message, module, line, function) {} \
+    EXCEPTION(const std::string& name, const std::string& message, \
+      const std::string& module, const int line, const std::string& function, \
+      const xcept::Exception& previous) : \
+    xcept::Exception(name, message, module, line, function, previous) {} \
+  }; \
+} }
+
+#define XCEPT_RAISE(EXCEPTION, MESSAGE) \
+  throw EXCEPTION(#EXCEPTION, MESSAGE, __FILE__, __LINE__, __FUNCTION__)
+
+#define XCEPT_RETHROW(EXCEPTION, MESSAGE, PREVIOUS) \
+  throw EXCEPTION(#EXCEPTION, MESSAGE, __FILE__, __LINE__, __FUNCTION__, PREVIOUS)
+
+#define XCEPT_DECLARE(EXCEPTION, VARIABLE, MESSAGE) \
+  EXCEPTION VARIABLE(#EXCEPTION, MESSAGE, __FILE__, __LINE__, __FUNCTION__)
+
+#define XCEPT_DECLARE_NESTED(EXCEPTION, VARIABLE, MESSAGE, PREVIOUS) \
+  EXCEPTION VARIABLE(#EXCEPTION, MESSAGE, __FILE__, __LINE__, __FUNCTION__, PREVIOUS)
+
+#endif // _standins_xcept_Exception_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
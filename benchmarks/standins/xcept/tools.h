@@ -0,0 +1,27 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the formatting of the exception history is provided.
+
+#ifndef _standins_xcept_tools_h_
+#define _standins_xcept_tools_h_
+
+#include "xcept/Exception.h"
+
+#include <string>
+
+
+namespace xcept {
+
+  inline std::string stdformat_exception_history(const Exception& e)
+  { return e.message(); }
+
+} // namespace xcept
+
+#endif // _standins_xcept_tools_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,73 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The application provides the logger, info spaces and the application
+// context to the components under test. Errors notified by the components
+// are logged.
+
+#ifndef _standins_xdaq_Application_h_
+#define _standins_xdaq_Application_h_
+
+#include "log4cplus/logger.h"
+#include "toolbox/net/URN.h"
+#include "xcept/Exception.h"
+#include "xcept/tools.h"
+#include "xdaq/ApplicationContext.h"
+#include "xdaq/ApplicationDescriptor.h"
+#include "xdata/InfoSpace.h"
+
+#include <string>
+
+
+namespace xdaq {
+
+  class Application : public xdata::ActionListener
+  {
+  public:
+
+    Application(ApplicationDescriptor* descriptor) :
+    descriptor_(descriptor),
+    logger_(descriptor->getURN()),
+    infoSpace_(descriptor->getURN())
+    {}
+
+    ApplicationDescriptor* getApplicationDescriptor()
+    { return descriptor_; }
+
+    /**
+     * All applications share the context of the process
+     */
+    ApplicationContext* getApplicationContext()
+    {
+      static ApplicationContext context;
+      return &context;
+    }
+
+    log4cplus::Logger& getApplicationLogger()
+    { return logger_; }
+
+    xdata::InfoSpace* getApplicationInfoSpace()
+    { return &infoSpace_; }
+
+    toolbox::net::URN createQualifiedInfoSpace(const std::string& name)
+    { return toolbox::net::URN(descriptor_->getURN(), name); }
+
+    void notifyQualified(const std::string& severity, xcept::Exception& e)
+    { LOG4CPLUS_ERROR(logger_, severity << ": " << xcept::stdformat_exception_history(e)); }
+
+  private:
+
+    ApplicationDescriptor* descriptor_;
+    log4cplus::Logger logger_;
+    xdata::InfoSpace infoSpace_;
+  };
+
+} // namespace xdaq
+
+#endif // _standins_xdaq_Application_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
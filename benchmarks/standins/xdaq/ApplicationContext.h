@@ -0,0 +1,77 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The default zone holds the descriptors added by the benchmarks. Frames
+// posted to the peer transports are released at once.
+
+#ifndef _standins_xdaq_ApplicationContext_h_
+#define _standins_xdaq_ApplicationContext_h_
+
+#include "toolbox/mem/Reference.h"
+#include "xcept/Exception.h"
+#include "xdaq/ApplicationDescriptor.h"
+
+#include <set>
+#include <string>
+
+
+namespace xdaq {
+
+  class Zone
+  {
+  public:
+
+    void addApplicationDescriptor(ApplicationDescriptor* descriptor)
+    { descriptors_.insert(descriptor); }
+
+    std::set<ApplicationDescriptor*> getApplicationDescriptors(const std::string& className) const
+    {
+      std::set<ApplicationDescriptor*> descriptors;
+      for (std::set<ApplicationDescriptor*>::const_iterator it = descriptors_.begin(),
+             itEnd = descriptors_.end(); it != itEnd; ++it)
+      {
+        if ( (*it)->getClassName() == className ) descriptors.insert(*it);
+      }
+      return descriptors;
+    }
+
+    ApplicationDescriptor* getApplicationDescriptor(const std::string& className, const unsigned int instance) const
+    {
+      for (std::set<ApplicationDescriptor*>::const_iterator it = descriptors_.begin(),
+             itEnd = descriptors_.end(); it != itEnd; ++it)
+      {
+        if ( (*it)->getClassName() == className && (*it)->getInstance() == instance ) return *it;
+      }
+      XCEPT_RAISE(xcept::Exception, "No application " + className);
+    }
+
+  private:
+
+    std::set<ApplicationDescriptor*> descriptors_;
+  };
+
+
+  class ApplicationContext
+  {
+  public:
+
+    Zone* getDefaultZone()
+    { return &zone_; }
+
+    void postFrame(toolbox::mem::Reference* bufRef, ApplicationDescriptor*, ApplicationDescriptor*)
+    { bufRef->release(); }
+
+  private:
+
+    Zone zone_;
+  };
+
+} // namespace xdaq
+
+#endif // _standins_xdaq_ApplicationContext_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,60 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The descriptor only identifies the application.
+
+#ifndef _standins_xdaq_ApplicationDescriptor_h_
+#define _standins_xdaq_ApplicationDescriptor_h_
+
+#include <sstream>
+#include <string>
+
+
+namespace xdaq {
+
+  class ContextDescriptor
+  {
+  public:
+    std::string getURL() const { return "http://localhost:0"; }
+  };
+
+
+  class ApplicationDescriptor
+  {
+  public:
+
+    ApplicationDescriptor(const std::string& className, const unsigned int instance) :
+    className_(className), instance_(instance) {}
+
+    std::string getClassName() const
+    { return className_; }
+
+    unsigned int getInstance() const
+    { return instance_; }
+
+    std::string getURN() const
+    {
+      std::ostringstream urn;
+      urn << "urn:xdaq-application:class=" << className_ << ",instance=" << instance_;
+      return urn.str();
+    }
+
+    ContextDescriptor* getContextDescriptor()
+    { return &contextDescriptor_; }
+
+  private:
+
+    const std::string className_;
+    const unsigned int instance_;
+    ContextDescriptor contextDescriptor_;
+  };
+
+} // namespace xdaq
+
+#endif // _standins_xdaq_ApplicationDescriptor_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,62 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// There is no run control, thus flash lists are only counted.
+
+#ifndef _standins_xdaq2rc_RcmsNotificationSender_h_
+#define _standins_xdaq2rc_RcmsNotificationSender_h_
+
+#include "log4cplus/logger.h"
+#include "xdaq/Application.h"
+#include "xdata/Boolean.h"
+#include "xdata/InfoSpace.h"
+#include "xdata/String.h"
+#include "xdata/Table.h"
+
+#include <stdint.h>
+#include <string>
+
+
+namespace xdaq2rc {
+
+  class RcmsNotificationSender
+  {
+  public:
+
+    RcmsNotificationSender
+    (
+      log4cplus::Logger&,
+      xdaq::ApplicationDescriptor*,
+      xdaq::ApplicationContext*
+    ) :
+    sentCount_(0) {}
+
+    xdata::Serializable* getRcmsNotificationReceiverParameter()
+    { return &receiver_; }
+
+    xdata::Boolean* getFoundRcmsNotificationReceiverParameter()
+    { return &found_; }
+
+    void findRcmsNotificationReceiver() {}
+
+    void subscribeToChangesInRcmsNotificationReceiver(xdata::InfoSpace*) {}
+
+    void sendData(xdata::Table&, const std::string& flashListName)
+    { ++sentCount_; }
+
+  private:
+
+    xdata::String receiver_;
+    xdata::Boolean found_;
+    uint64_t sentCount_;
+  };
+
+} // namespace xdaq2rc
+
+#endif // _standins_xdaq2rc_RcmsNotificationSender_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,33 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the value is kept.
+
+#ifndef _standins_xdata_Boolean_h_
+#define _standins_xdata_Boolean_h_
+
+#include "xdata/Serializable.h"
+
+#include <string>
+
+
+namespace xdata {
+
+  class Boolean : public Serializable
+  {
+  public:
+    Boolean(const bool value = false) : value_(value) {}
+    operator bool() const { return value_; }
+    std::string toString() const { return value_ ? "true" : "false"; }
+    bool value_;
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_Boolean_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,76 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The items are kept by name. Listeners are never called.
+
+#ifndef _standins_xdata_InfoSpace_h_
+#define _standins_xdata_InfoSpace_h_
+
+#include "xdata/Serializable.h"
+#include "xdata/exception/Exception.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+#include <string>
+
+
+namespace xdata {
+
+  class ActionListener
+  {
+  public:
+    virtual ~ActionListener() {}
+  };
+
+
+  class InfoSpace
+  {
+  public:
+
+    InfoSpace(const std::string& name) : name_(name) {}
+
+    std::string name() const
+    { return name_; }
+
+    void lock()
+    { mutex_.lock(); }
+
+    void unlock()
+    { mutex_.unlock(); }
+
+    void fireItemAvailable(const std::string& name, Serializable* item)
+    { items_[name] = item; }
+
+    void addItemChangedListener(const std::string& name, ActionListener*) {}
+
+    void addItemRetrieveListener(const std::string& name, ActionListener*) {}
+
+    void fireItemGroupChanged(std::list<std::string>& names, void* originator) {}
+
+    Serializable* find(const std::string& name)
+    {
+      const Items::const_iterator pos = items_.find(name);
+      if ( pos == items_.end() )
+        XCEPT_RAISE(xdata::exception::Exception, "No item " + name + " in " + name_);
+      return pos->second;
+    }
+
+  private:
+
+    const std::string name_;
+    typedef std::map<std::string,Serializable*> Items;
+    Items items_;
+    boost::mutex mutex_;
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_InfoSpace_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
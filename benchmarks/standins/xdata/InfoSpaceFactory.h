@@ -0,0 +1,57 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Info spaces are created on first use and kept by name.
+
+#ifndef _standins_xdata_InfoSpaceFactory_h_
+#define _standins_xdata_InfoSpaceFactory_h_
+
+#include "xdata/InfoSpace.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+
+
+namespace xdata {
+
+  class InfoSpaceFactory
+  {
+  public:
+
+    InfoSpace* get(const std::string& name)
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      InfoSpace*& infoSpace = infoSpaces_[name];
+      if ( infoSpace == 0 ) infoSpace = new InfoSpace(name);
+      return infoSpace;
+    }
+
+  private:
+
+    typedef std::map<std::string,InfoSpace*> InfoSpaces;
+    InfoSpaces infoSpaces_;
+    boost::mutex mutex_;
+  };
+
+
+  /**
+   * The factory lives until the end of the process,
+   * as the info spaces are used by the workloops.
+   */
+  inline InfoSpaceFactory* getInfoSpaceFactory()
+  {
+    static InfoSpaceFactory* factory = new InfoSpaceFactory();
+    return factory;
+  }
+
+} // namespace xdata
+
+#endif // _standins_xdata_InfoSpaceFactory_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,33 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Items are not serialized by the benchmarks.
+
+#ifndef _standins_xdata_Serializable_h_
+#define _standins_xdata_Serializable_h_
+
+#include "xdata/exception/Exception.h"
+
+#include <string>
+
+
+namespace xdata {
+
+  class Serializable
+  {
+  public:
+    virtual ~Serializable() {}
+
+    virtual std::string toString() const
+    { XCEPT_RAISE(xdata::exception::Exception, "Serialization is not supported"); }
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_Serializable_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,34 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the value is kept.
+
+#ifndef _standins_xdata_String_h_
+#define _standins_xdata_String_h_
+
+#include "xdata/Serializable.h"
+
+#include <string>
+
+
+namespace xdata {
+
+  class String : public Serializable
+  {
+  public:
+    String(const std::string& value = "") : value_(value) {}
+    String(const char* value) : value_(value) {}
+    operator std::string() const { return value_; }
+    std::string toString() const { return value_; }
+    std::string value_;
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_String_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
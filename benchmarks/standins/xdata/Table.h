@@ -0,0 +1,61 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the rows are kept, the fields are not stored.
+
+#ifndef _standins_xdata_Table_h_
+#define _standins_xdata_Table_h_
+
+#include "xdata/Serializable.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace xdata {
+
+  class Table : public Serializable
+  {
+  public:
+
+    class Row
+    {
+    public:
+      void setField(const std::string& name, Serializable&) {}
+    };
+    typedef std::vector<Row>::iterator iterator;
+
+    void reserve(const size_t size)
+    { rows_.reserve(size); }
+
+    void addColumn(const std::string& name, const std::string& type)
+    { columns_[name] = type; }
+
+    iterator append()
+    {
+      rows_.push_back( Row() );
+      return rows_.end() - 1;
+    }
+
+    iterator begin()
+    { return rows_.begin(); }
+
+    iterator end()
+    { return rows_.end(); }
+
+  private:
+
+    std::map<std::string,std::string> columns_;
+    std::vector<Row> rows_;
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_Table_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,17 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The iterator is defined with the table.
+
+#ifndef _standins_xdata_TableIterator_h_
+#define _standins_xdata_TableIterator_h_
+
+#include "xdata/Table.h"
+
+#endif // _standins_xdata_TableIterator_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
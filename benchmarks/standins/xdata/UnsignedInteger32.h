@@ -0,0 +1,32 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the value is kept.
+
+#ifndef _standins_xdata_UnsignedInteger32_h_
+#define _standins_xdata_UnsignedInteger32_h_
+
+#include "xdata/Serializable.h"
+
+#include <stdint.h>
+
+
+namespace xdata {
+
+  class UnsignedInteger32 : public Serializable
+  {
+  public:
+    UnsignedInteger32(const uint32_t value = 0) : value_(value) {}
+    operator uint32_t() const { return value_; }
+    uint32_t value_;
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_UnsignedInteger32_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
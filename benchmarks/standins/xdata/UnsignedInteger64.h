@@ -0,0 +1,32 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// Only the value is kept.
+
+#ifndef _standins_xdata_UnsignedInteger64_h_
+#define _standins_xdata_UnsignedInteger64_h_
+
+#include "xdata/Serializable.h"
+
+#include <stdint.h>
+
+
+namespace xdata {
+
+  class UnsignedInteger64 : public Serializable
+  {
+  public:
+    UnsignedInteger64(const uint64_t value = 0) : value_(value) {}
+    operator uint64_t() const { return value_; }
+    uint64_t value_;
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_UnsignedInteger64_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,31 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The vector is a std::vector.
+
+#ifndef _standins_xdata_Vector_h_
+#define _standins_xdata_Vector_h_
+
+#include "xdata/Serializable.h"
+
+#include <vector>
+
+
+namespace xdata {
+
+  template <class T>
+  class Vector : public std::vector<T>, public Serializable
+  {
+  public:
+    void setSize(const size_t size) { this->resize(size); }
+  };
+
+} // namespace xdata
+
+#endif // _standins_xdata_Vector_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,19 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+
+#ifndef _standins_xdata_exception_Exception_h_
+#define _standins_xdata_exception_Exception_h_
+
+#include "xcept/Exception.h"
+
+
+XCEPT_DEFINE_EXCEPTION(xdata, Exception)
+
+#endif // _standins_xdata_exception_Exception_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,25 @@
+// Stand-in for the XDAQ header of the same name used by the benchmarks.
+// The HTML output is written to a string stream.
+
+#ifndef _standins_xgi_Output_h_
+#define _standins_xgi_Output_h_
+
+#include <sstream>
+
+
+namespace xgi {
+
+  class Output : public std::ostringstream
+  {};
+
+} // namespace xgi
+
+#endif // _standins_xgi_Output_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
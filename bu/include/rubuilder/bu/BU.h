@@ -7,6 +7,7 @@
 #include "rubuilder/utils/InfoSpaceItems.h"
 #include "rubuilder/utils/OneToOneQueue.h"
 #include "rubuilder/utils/PerformanceMonitor.h"
+#include "rubuilder/utils/WakeupSignal.h"
 #include "toolbox/lang/Class.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WaitingWorkLoop.h"
@@ -109,12 +110,14 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     bool oldMsgSenderScheduler(toolbox::task::WorkLoop*);
     bool sendOldMessages(toolbox::task::WorkLoop*);
     bool doWork();
+    bool isWorkPending() const;
 
     xdaq::Application* app_;
     boost::shared_ptr<EVMproxy> evmProxy_;
     boost::shared_ptr<RUproxy> ruProxy_;
     boost::shared_ptr<EventTable> eventTable_;
     boost::shared_ptr<StateMachine> stateMachine_;
+    boost::shared_ptr<utils::WakeupSignal> wakeupSignal_;
 
     uint32_t runNumber_;
     volatile bool doProcessing_;
@@ -129,6 +132,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     toolbox::task::ActionSignature* sendOldMessagesAction_;
 
     xdata::UnsignedInteger32 oldMessageSenderSleepUSec_;
+    xdata::UnsignedInteger32 maxIdleWaitUSec_;
 
     utils::PerformanceMonitor intervalStart_;
     utils::PerformanceMonitor delta_;
@@ -137,7 +141,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     xdata::Double deltaT_;
     xdata::UnsignedInteger32 deltaN_;
     xdata::UnsignedInteger64 deltaSumOfSquares_;
-    xdata::UnsignedInteger32 deltaSumOfSizes_;
+    xdata::UnsignedInteger64 deltaSumOfSizes_;
   };
   
   
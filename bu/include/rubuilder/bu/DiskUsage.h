@@ -8,6 +8,7 @@
 #endif
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <stdint.h>
 #include <sys/statfs.h>
@@ -18,6 +19,11 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
   /**
    * \ingroup xdaqApps
    * \brief Monitor disk usage
+   *
+   * A thread owned by the DiskUsage samples the disk once per second
+   * and estimates the rate at which the used space changes.
+   * The thread is never joined, such that a hanging statfs call
+   * does not block the caller.
    */
  
   class DiskUsage
@@ -34,17 +40,18 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     ~DiskUsage();
 
     /**
-     * Update the information about the disk
-     * Returns false if the disk cannot be accesssed
+     * Return the bandwidth in bytes/s which can be written to the disk.
+     * Returns a negative value if the writing does not need to be limited,
+     * i.e. if the disk usage extrapolated over lookaheadSec stays below the
+     * low-water mark. Returns 0 if the disk is not accessible or if the
+     * high-water mark is reached. Otherwise, it returns the estimated drain
+     * rate plus the space left to the high-water mark spread over lookaheadSec,
+     * such that the allowed bandwidth shrinks proportionally to the headroom.
+     * A lookaheadSec of 0 disables the throttling below the high-water mark.
+     * The writeBandwidth is the bandwidth currently written by the caller
+     * and is used to estimate how fast the disk is drained.
      */
-    bool update();
-
-    /**
-     * Returns true if the disk usage is exceeding the high-water mark.
-     * Once the high-water mark has been exceeded, the lower-water mark
-     * has be be reached before it returns false again.
-     */
-    bool tooHigh();
+    double getAllowedWriteBandwidth(const double writeBandwidth, const uint32_t lookaheadSec);
     
     /**
      * Return the disk size in GB
@@ -56,21 +63,41 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
      */
     double relDiskUsage();
     
+    /**
+     * Return the rate at which the used disk space grows in MB/s.
+     * The rate is negative if the disk is drained.
+     */
+    double fillRateMBps();
+    
     
   private:
     
-    void doStatFs();
+    struct Samples
+    {
+      const boost::filesystem::path path;
+      boost::mutex mutex;
+      int retVal;
+      struct statfs64 statfs;
+      uint64_t lastUpdateUSec;
+      uint64_t usedBytes;
+      double fillRate;
+      bool fillRateValid;
+
+      Samples(const boost::filesystem::path&);
+    };
+    typedef boost::shared_ptr<Samples> SamplesPtr;
+
+    static void monitor(SamplesPtr);
+    static void doStatFs(SamplesPtr);
+    bool isAccessible() const;
+    double getRelDiskUsage() const;
+    double getDiskSize() const;
 
-    const boost::filesystem::path path_;
     const double highWaterMark_; 
     const double lowWaterMark_; 
 
-    boost::mutex mutex_;
-    int retVal_;
-    struct statfs64 statfs_;
-    bool tooHigh_;
-    
-    //  : path(p), highWaterMark(highWaterMark), lowWaterMark(lowWaterMark) {};
+    const SamplesPtr samples_;
+    boost::thread thread_;
   };
     
   typedef boost::shared_ptr<DiskUsage> DiskUsagePtr;
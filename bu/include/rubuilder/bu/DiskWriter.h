@@ -17,7 +17,9 @@
 #include "rubuilder/bu/FileHandler.h"
 #include "rubuilder/bu/LumiHandler.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LatencyHistogram.h"
 #include "rubuilder/utils/OneToOneQueue.h"
+#include "rubuilder/utils/PerThreadCounters.h"
 #include "toolbox/lang/Class.h"
 #include "toolbox/mem/Reference.h"
 #include "toolbox/task/Action.h"
@@ -150,7 +152,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     LumiHandlerPtr getLumiHandler(const uint32_t lumiSection);
     bool writing(toolbox::task::WorkLoop*);
     bool resourceMonitoring(toolbox::task::WorkLoop*);
-    bool checkDiskSize(DiskUsagePtr);
+    double measureWriteBandwidth();
     void writeJSON();
     void defineJSON(const boost::filesystem::path&) const;
     void createWritingWorkLoops();
@@ -216,22 +218,41 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     xdata::UnsignedInteger32 maxEventsPerFile_;
     xdata::UnsignedInteger32 eolsFIFOCapacity_;
     xdata::Boolean tolerateCorruptedEvents_;
+    xdata::UnsignedInteger32 diskThrottleLookaheadSec_;
 
     struct DiskWriterMonitoring
     {
       uint32_t nbFiles;
       uint32_t nbEventsWritten;
       uint32_t nbLumiSections;
-      uint32_t lastEventNumberWritten;
       uint32_t currentLumiSection;
       uint32_t lastEoLS;
       uint32_t nbEventsCorrupted;
-    } diskWriterMonitoring_;
-    boost::mutex diskWriterMonitoringMutex_;
+      uint64_t payloadWritten;
+
+      DiskWriterMonitoring();
+      DiskWriterMonitoring& operator+=(const DiskWriterMonitoring&);
+    };
+    utils::PerThreadCounters<DiskWriterMonitoring> diskWriterMonitoring_;
+    uint32_t lastEventNumberWrittenShared_;
+    utils::LatencyRecorder eventWriteLatency_;
+
+    // Throttling of the event requests by the disk usage.
+    // The bandwidths are in bytes/s, and a negative
+    // allowed bandwidth means that it is not limited.
+    double writeBandwidth_;
+    double allowedWriteBandwidth_;
+    uint64_t lastPayloadWritten_;
+    uint64_t lastBandwidthSampleUSec_;
+    boost::mutex throttleMutex_;
 
     xdata::UnsignedInteger32 nbEvtsWritten_;
     xdata::UnsignedInteger32 nbFilesWritten_;
     xdata::UnsignedInteger32 nbEvtsCorrupted_;
+    xdata::String diskThrottleState_;
+    xdata::Double writeBandwidthMBps_;
+    xdata::Double allowedWriteBandwidthMBps_;
+    xdata::Double rawDataDiskFillRateMBps_;
 
   };
   
@@ -1,6 +1,7 @@
 #ifndef _rubuilder_bu_EVMproxy_h_
 #define _rubuilder_bu_EVMproxy_h_
 
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include <stdint.h>
@@ -9,10 +10,11 @@
 
 #include "interface/evb/i2oEVBMsgs.h"
 #include "rubuilder/utils/ApplicationDescriptorAndTid.h"
+#include "rubuilder/utils/BlockingOneToOneQueue.h"
 #include "rubuilder/utils/I2OMessages.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
-#include "rubuilder/utils/OneToOneQueue.h"
 #include "rubuilder/utils/TimerManager.h"
+#include "rubuilder/utils/WakeupSignal.h"
 #include "toolbox/mem/Pool.h"
 #include "toolbox/mem/Reference.h"
 #include "xdaq/Application.h"
@@ -54,6 +56,18 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
      * Return false if no trigger block is available
      */
     bool getTriggerBlock(toolbox::mem::Reference*&);
+
+    /**
+     * Return true if a trigger block is available
+     */
+    bool hasTriggerBlock() const
+    { return ! triggerFIFO_.empty(); }
+
+    /**
+     * Wake the consumer of the trigger blocks with the given signal
+     */
+    void registerWakeupSignal(boost::shared_ptr<utils::WakeupSignal> signal)
+    { triggerFIFO_.registerWakeupSignal(signal); }
     
     /**
      * Send the request for and/or release of event ids
@@ -145,7 +159,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     uint32_t index_;
     utils::ApplicationDescriptorAndTid evm_;
 
-    typedef utils::OneToOneQueue<toolbox::mem::Reference*> TriggerFIFO;
+    typedef utils::BlockingOneToOneQueue<toolbox::mem::Reference*> TriggerFIFO;
     TriggerFIFO triggerFIFO_;
     
     toolbox::mem::Reference* evtIdRqstsAndOrReleasesBufRef_;
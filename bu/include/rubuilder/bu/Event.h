@@ -94,6 +94,13 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
      */
     size_t payload() const
     { return payload_; }
+
+    /**
+     * Return the monotonic time in micro seconds when
+     * the construction of the event started
+     */
+    uint64_t creationTimeUSec() const
+    { return creationTimeUSec_; }
     
     
   private:
@@ -157,6 +164,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     utils::EvBid evbId_;
     uint32_t eventNumber_;
     size_t payload_;
+    uint64_t creationTimeUSec_;
     
   }; // Event
     
@@ -10,15 +10,20 @@
 #include "rubuilder/bu/Event.h"
 #include "rubuilder/utils/I2OMessages.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LatencyHistogram.h"
 #include "rubuilder/utils/OneToOneQueue.h"
+#include "rubuilder/utils/PerThreadCounters.h"
 #include "rubuilder/utils/PerformanceMonitor.h"
 #include "toolbox/lang/Class.h"
+#include "toolbox/mem/Pool.h"
 #include "toolbox/mem/Reference.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WaitingWorkLoop.h"
 #include "xdaq/Application.h"
 #include "xdata/Boolean.h"
+#include "xdata/Double.h"
 #include "xdata/UnsignedInteger32.h"
+#include "xdata/UnsignedInteger64.h"
 
 
 namespace rubuilder { namespace bu { // namespace rubuilder::bu
@@ -121,6 +126,13 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     void requestEvents(bool val)
     { requestEvents_ = val; }
 
+    /**
+     * Limit the event requests such that the events built
+     * amount to the given bandwidth in bytes/s.
+     * A negative value removes the limit.
+     */
+    void limitRequestBandwidth(const double bytesPerSec);
+
     /**
      * Return event building performance monitoring struct
      */
@@ -177,6 +189,10 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
       const uint32_t buResourceId,
       msg::EvtIdRqstAndOrRelease&
     );
+    bool isMemoryAvailableForEvent();
+    bool isRequestBandwidthAvailable();
+    uint64_t getProjectedMemoryUsage();
+    void updateAverageEventSize(const size_t payload);
     
     // Lookup table of events, indexed by event id
     typedef std::map<uint32_t,EventPtr> Data;
@@ -206,6 +222,28 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
 
     utils::InfoSpaceItems tableParams_;
     xdata::Boolean dropEventData_;
+    xdata::UnsignedInteger32 eventMemoryBudgetMB_;
+    xdata::Double eventMemoryHighWaterMark_;
+    xdata::Boolean eventMemoryCountsPoolUsage_;
+
+    // Bookkeeping of the memory held by events, protected by dataMutex_.
+    // Events not yet complete are accounted with the average event size.
+    // nbResourcesInUse_ is updated atomically, as requests are sent
+    // without the lock when no budget or bandwidth limit is active.
+    uint64_t eventMemoryHighWaterMarkBytes_;
+    uint32_t nbResourcesInUse_;
+    uint32_t nbCompleteEvents_;
+    uint64_t completeEventsPayload_;
+    double eventSizeAverage_;
+    toolbox::mem::Pool* receivePool_;
+
+    // Token bucket limiting the event requests, protected by dataMutex_.
+    // Each request takes the average event size from the credit.
+    double requestBandwidthLimit_;
+    // Set when a budget or limit is active. Read without the lock.
+    bool requestsLimited_;
+    double requestBandwidthCredit_;
+    uint64_t lastRequestCreditUSec_;
 
     struct EventMonitoring
     {
@@ -215,13 +253,19 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
       uint32_t nbEventsDropped;
       uint64_t payload;
       uint64_t payloadSquared;
-    } eventMonitoring_;
-    boost::mutex eventMonitoringMutex_;
+
+      EventMonitoring();
+      EventMonitoring& operator+=(const EventMonitoring&);
+    };
+    utils::PerThreadCounters<EventMonitoring> eventMonitoring_;
+    utils::LatencyRecorder requestToCompleteLatency_;
 
     xdata::UnsignedInteger32 nbEvtsUnderConstruction_;
     xdata::UnsignedInteger32 nbEvtsReady_;
     xdata::UnsignedInteger32 nbEventsInBU_;
     xdata::UnsignedInteger32 nbEvtsBuilt_;
+    xdata::UnsignedInteger64 projectedEventMemory_;
+    xdata::UnsignedInteger32 averageEventSize_;
 
   }; // EventTable
     
@@ -1,19 +1,22 @@
 #ifndef _rubuilder_bu_RUproxy_h_
 #define _rubuilder_bu_RUproxy_h_
 
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include <stdint.h>
 
 #include "log4cplus/logger.h"
 
+#include "rubuilder/utils/BlockingOneToOneQueue.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
-#include "rubuilder/utils/OneToOneQueue.h"
 #include "rubuilder/utils/RUbroadcaster.h"
 #include "rubuilder/utils/TimerManager.h"
+#include "rubuilder/utils/WakeupSignal.h"
 #include "toolbox/mem/Pool.h"
 #include "toolbox/mem/Reference.h"
 #include "xdaq/Application.h"
+#include "xdata/Boolean.h"
 #include "xdata/UnsignedInteger32.h"
 #include "xdata/UnsignedInteger64.h"
 #include "xgi/Output.h"
@@ -51,6 +54,18 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
      */
     bool getDataBlock(toolbox::mem::Reference*&);
 
+    /**
+     * Return true if a data block is available
+     */
+    bool hasDataBlock() const
+    { return ! blockFIFO_.empty(); }
+
+    /**
+     * Wake the consumer of the data blocks with the given signal
+     */
+    void registerWakeupSignal(boost::shared_ptr<utils::WakeupSignal> signal)
+    { blockFIFO_.registerWakeupSignal(signal); }
+
     /**
      * Send request for data fragments to the RUs for
      * the passed trigger message
@@ -114,6 +129,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     
     void createRqstForFrags();
     uint32_t packRqstForFragsMsg(toolbox::mem::Reference*);
+    uint32_t packRqstForFragRangesMsg(toolbox::mem::Reference*);
     void sendRqstForFragsToAllRUs();
 
     void updateBlockCounters(toolbox::mem::Reference*);
@@ -121,7 +137,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     
     uint32_t index_;
 
-    typedef utils::OneToOneQueue<toolbox::mem::Reference*> BlockFIFO;
+    typedef utils::BlockingOneToOneQueue<toolbox::mem::Reference*> BlockFIFO;
     BlockFIFO blockFIFO_;
     
     toolbox::mem::Reference* rqstForFragsBufRef_;
@@ -154,6 +170,7 @@ namespace rubuilder { namespace bu { // namespace rubuilder::bu
     utils::InfoSpaceItems ruParams_;
     xdata::UnsignedInteger32 blockFIFOCapacity_;
     xdata::UnsignedInteger32 I2O_RU_SEND_Packing_;
+    xdata::Boolean rqstForFragRangeEncoding_;
 
     xdata::UnsignedInteger32 lastEventNumberFromRUs_;
     xdata::UnsignedInteger64 i2oBUCacheCount_;
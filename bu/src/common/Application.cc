@@ -169,52 +169,46 @@ void rubuilder::bu::Application::do_handleItemRetrieveEvent(const std::string& i
 
 void rubuilder::bu::Application::bindI2oCallbacks()
 {
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::bu::Application::I2O_BU_CONFIRM_Callback,
-      I2O_BU_CONFIRM,
-      XDAQ_ORGANIZATION_ID
+      I2O_BU_CONFIRM
     );
 
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::bu::Application::I2O_BU_CACHE_Callback,
-      I2O_BU_CACHE,
-      XDAQ_ORGANIZATION_ID
+      I2O_BU_CACHE
     );
 
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::bu::Application::I2O_BU_ALLOCATE_Callback,
-      I2O_BU_ALLOCATE,
-      XDAQ_ORGANIZATION_ID
+      I2O_BU_ALLOCATE
     );
 
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::bu::Application::I2O_BU_COLLECT_Callback,
-      I2O_BU_COLLECT,
-      XDAQ_ORGANIZATION_ID
+      I2O_BU_COLLECT
     );
 
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::bu::Application::I2O_BU_DISCARD_Callback,
-      I2O_BU_DISCARD,
-      XDAQ_ORGANIZATION_ID
+      I2O_BU_DISCARD
     );
 
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::bu::Application::I2O_EVM_LUMISECTION_Callback,
-      I2O_EVM_LUMISECTION,
-      XDAQ_ORGANIZATION_ID
+      I2O_EVM_LUMISECTION
     );
 
 }
@@ -4,9 +4,11 @@
 #include "rubuilder/bu/EventTable.h"
 #include "rubuilder/bu/StateMachine.h"
 #include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 
+#include <boost/bind.hpp>
 #include <math.h>
 
 
@@ -21,11 +23,15 @@ app_(app),
 evmProxy_(evmProxy),
 ruProxy_(ruProxy),
 eventTable_(eventTable),
+wakeupSignal_(new utils::WakeupSignal()),
 runNumber_(0),
 doProcessing_(false),
 processActive_(false),
 sendOldMessagesActionPending_(false)
 {
+  evmProxy_->registerWakeupSignal(wakeupSignal_);
+  ruProxy_->registerWakeupSignal(wakeupSignal_);
+
   resetMonitoringCounters();
   startProcessingWorkLoop();
 }
@@ -34,8 +40,10 @@ sendOldMessagesActionPending_(false)
 void rubuilder::bu::BU::appendConfigurationItems(utils::InfoSpaceItems& params)
 {
   oldMessageSenderSleepUSec_ = 1000000;
+  maxIdleWaitUSec_ = 1000;
 
   params.add("oldMessageSenderSleepUSec", &oldMessageSenderSleepUSec_);
+  params.add("maxIdleWaitUSec", &maxIdleWaitUSec_);
 
   startOldMsgSenderSchedulerWorkLoop();
 }
@@ -102,6 +110,7 @@ void rubuilder::bu::BU::startProcessing(const uint32_t runNumber)
 void rubuilder::bu::BU::stopProcessing()
 {
   doProcessing_ = false;
+  wakeupSignal_->notify();
   while (processActive_) ::usleep(1000);
   while (sendOldMessagesActionPending_) ::usleep(1000);
 }
@@ -135,12 +144,17 @@ void rubuilder::bu::BU::startProcessingWorkLoop()
 
 bool rubuilder::bu::BU::process(toolbox::task::WorkLoop *wl)
 {
-  ::usleep(1000);
+  // Sleep until the EVM or a RU delivers a block. The timeout bounds
+  // the delay of other actions submitted to the processing workloop.
+  wakeupSignal_->waitUntil(
+    boost::bind(&rubuilder::bu::BU::isWorkPending, this),
+    maxIdleWaitUSec_.value_);
 
   processActive_ = true;
   
   try
   {
+    utils::getResourcePlacement().pinCurrentThread(wl->getName());
     while ( doProcessing_ && doWork() ) {};
   }
   catch(xcept::Exception &e)
@@ -184,6 +198,12 @@ bool rubuilder::bu::BU::doWork()
 }
 
 
+bool rubuilder::bu::BU::isWorkPending() const
+{
+  return ( !doProcessing_ || evmProxy_->hasTriggerBlock() || ruProxy_->hasDataBlock() );
+}
+
+
 void rubuilder::bu::BU::startOldMsgSenderSchedulerWorkLoop()
 {
   try
@@ -1,10 +1,29 @@
-#include <iostream>
-
 #include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
-#include <boost/thread.hpp>
 
 #include "rubuilder/bu/DiskUsage.h"
+#include "rubuilder/utils/LatencyHistogram.h"
+
+
+namespace
+{
+  // Interval between two statfs calls
+  const uint32_t samplingIntervalSec = 1;
+
+  // The disk is considered to be inaccessible if the last successful
+  // statfs was started longer ago than this
+  const uint64_t maxSampleAgeUSec = 3000000;
+}
+
+
+rubuilder::bu::DiskUsage::Samples::Samples(const boost::filesystem::path& path) :
+path(path),
+retVal(1),
+lastUpdateUSec(0),
+usedBytes(0),
+fillRate(0),
+fillRateValid(false)
+{}
 
 
 rubuilder::bu::DiskUsage::DiskUsage
@@ -13,77 +32,145 @@ rubuilder::bu::DiskUsage::DiskUsage
   const double highWaterMark,
   const double lowWaterMark
 ) :
-path_(path),
 highWaterMark_(highWaterMark),
 lowWaterMark_(lowWaterMark),
-retVal_(1),
-tooHigh_(true)
+samples_(new Samples(path)),
+thread_( boost::bind(&DiskUsage::monitor, samples_) )
+{}
+
+
+rubuilder::bu::DiskUsage::~DiskUsage()
 {
-  update();
+  // The thread keeps the samples alive until it notices the interruption
+  thread_.interrupt();
+  thread_.detach();
 }
 
 
-rubuilder::bu::DiskUsage::~DiskUsage()
-{}
+void rubuilder::bu::DiskUsage::monitor(SamplesPtr samples)
+{
+  try
+  {
+    while (true)
+    {
+      doStatFs(samples);
+      boost::this_thread::sleep( boost::posix_time::seconds(samplingIntervalSec) );
+    }
+  }
+  catch(boost::thread_interrupted&) {}
+}
 
 
-bool rubuilder::bu::DiskUsage::update()
+void rubuilder::bu::DiskUsage::doStatFs(SamplesPtr samples)
+{
+  const uint64_t startUSec = utils::getMonotonicTimeUSec();
+  struct statfs64 buf;
+  const int retVal = statfs64(samples->path.string().c_str(), &buf);
+  if (samples->path == "/aSlowDiskForUnitTests") ::sleep(5);
+
+  boost::mutex::scoped_lock lock(samples->mutex);
+
+  if ( retVal == 0 )
+  {
+    const uint64_t usedBytes = static_cast<uint64_t>(buf.f_blocks - buf.f_bavail) * buf.f_bsize;
+
+    if ( samples->retVal == 0 && startUSec > samples->lastUpdateUSec )
+    {
+      const double fillRate =
+        ( static_cast<double>(usedBytes) - static_cast<double>(samples->usedBytes) ) * 1e6 /
+        (startUSec - samples->lastUpdateUSec);
+
+      // Exponential moving average over the last 4 samples or so
+      if ( samples->fillRateValid )
+        samples->fillRate += (fillRate - samples->fillRate) / 4;
+      else
+        samples->fillRate = fillRate;
+      samples->fillRateValid = true;
+    }
+
+    samples->statfs = buf;
+    samples->usedBytes = usedBytes;
+    samples->lastUpdateUSec = startUSec;
+  }
+  else
+  {
+    samples->fillRateValid = false;
+  }
+
+  samples->retVal = retVal;
+}
+
+
+bool rubuilder::bu::DiskUsage::isAccessible() const
 {
-  boost::mutex::scoped_lock lock(mutex_, boost::try_to_lock);
-  
-  if ( ! lock ) return false; // don't start another thread if there's already one
-  
-  boost::thread thread(
-    boost::bind( &DiskUsage::doStatFs, this )
-  );
-  
   return (
-    thread.timed_join( boost::posix_time::milliseconds(500) ) &&
-    retVal_ == 0
+    samples_->retVal == 0 &&
+    utils::getMonotonicTimeUSec() < samples_->lastUpdateUSec + maxSampleAgeUSec
   );
 }
 
 
-bool rubuilder::bu::DiskUsage::tooHigh()
+double rubuilder::bu::DiskUsage::getAllowedWriteBandwidth
+(
+  const double writeBandwidth,
+  const uint32_t lookaheadSec
+)
 {
-  const double diskUsage = relDiskUsage();
-  
-  if ( diskUsage < 0 ) return true; //error condition
-
-  // The disk usage is too high if the high water mark is exceeded.
-  // If the disk usage exceeded the high water mark, the usage has to decrease
-  // to the low water mark before setting tooHigh to false again.
-  if ( tooHigh_ )
-    tooHigh_ = ( diskUsage > lowWaterMark_ );
-  else
-    tooHigh_ = ( diskUsage > highWaterMark_ );
+  boost::mutex::scoped_lock lock(samples_->mutex);
+
+  if ( ! isAccessible() ) return 0;
+
+  const double diskSize = getDiskSize();
+  if ( diskSize <= 0 ) return 0;
 
-  return tooHigh_;  
+  const double diskUsage = getRelDiskUsage();
+  if ( diskUsage >= highWaterMark_ ) return 0;
+
+  if ( lookaheadSec == 0 ) return -1;
+
+  const double fillRate = samples_->fillRateValid ? samples_->fillRate : 0;
+  if ( diskUsage + fillRate * lookaheadSec / diskSize < lowWaterMark_ ) return -1;
+
+  // Anything we write which does not fill the disk is drained by someone else
+  const double drainRate = writeBandwidth > fillRate ? writeBandwidth - fillRate : 0;
+
+  return drainRate + (highWaterMark_ - diskUsage) * diskSize / lookaheadSec;
 }
 
 
 double rubuilder::bu::DiskUsage::diskSizeGB()
 {
-  boost::mutex::scoped_lock lock(mutex_, boost::try_to_lock);
-  if ( ! lock ) return -2;
-  
-  return ( retVal_==0 ? static_cast<double>(statfs_.f_blocks * statfs_.f_bsize) / 1024 / 1024 / 1024 : -1 );
+  boost::mutex::scoped_lock lock(samples_->mutex);
+
+  return ( samples_->retVal==0 ? getDiskSize() / 1024 / 1024 / 1024 : -1 );
 }
 
 
 double rubuilder::bu::DiskUsage::relDiskUsage()
 {
-  boost::mutex::scoped_lock lock(mutex_, boost::try_to_lock);
-  if ( ! lock ) return -2;
-  
-  return ( retVal_==0 ? 1 - static_cast<double>(statfs_.f_bavail)/statfs_.f_blocks : -1 );
+  boost::mutex::scoped_lock lock(samples_->mutex);
+
+  return ( samples_->retVal==0 ? getRelDiskUsage() : -1 );
+}
+
+
+double rubuilder::bu::DiskUsage::fillRateMBps()
+{
+  boost::mutex::scoped_lock lock(samples_->mutex);
+
+  return ( samples_->fillRateValid ? samples_->fillRate / 1000000 : 0 );
 }
 
-  
-void rubuilder::bu::DiskUsage::doStatFs()
+
+double rubuilder::bu::DiskUsage::getDiskSize() const
+{
+  return static_cast<double>(samples_->statfs.f_blocks) * samples_->statfs.f_bsize;
+}
+
+
+double rubuilder::bu::DiskUsage::getRelDiskUsage() const
 {
-  retVal_ = statfs64(path_.string().c_str(), &statfs_);
-  if (path_ == "/aSlowDiskForUnitTests") ::sleep(5);
+  return 1 - static_cast<double>(samples_->statfs.f_bavail)/samples_->statfs.f_blocks;
 }
 
 
@@ -4,11 +4,25 @@
 #include "rubuilder/bu/DiskWriter.h"
 #include "rubuilder/bu/EventTable.h"
 #include "rubuilder/bu/StateMachine.h"
+#include "rubuilder/utils/Atomic.h"
 #include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/EventTracer.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "rubuilder/utils/Exception.h"
 #include "toolbox/task/WorkLoopFactory.h"
 
 
+namespace
+{
+  const char* getThrottleState(const double allowedWriteBandwidth)
+  {
+    if ( allowedWriteBandwidth < 0 ) return "Unthrottled";
+    if ( allowedWriteBandwidth == 0 ) return "Stopped";
+    return "Throttled";
+  }
+}
+
+
 rubuilder::bu::DiskWriter::DiskWriter
 (
   xdaq::Application* app
@@ -20,7 +34,12 @@ eolsFIFO_("eolsFIFO"),
 fileHandlerAndEventFIFO_("fileHandlerAndEventFIFO"),
 writingActive_(false),
 doProcessing_(false),
-processActive_(false)
+processActive_(false),
+eventWriteLatency_("eventWriteLatency"),
+writeBandwidth_(0),
+allowedWriteBandwidth_(-1),
+lastPayloadWritten_(0),
+lastBandwidthSampleUSec_(0)
 {
   resetMonitoringCounters();
   startProcessingWorkLoop();
@@ -116,6 +135,13 @@ void rubuilder::bu::DiskWriter::startProcessing(const uint32_t runNumber)
     XCEPT_RAISE(exception::DiskWriting, oss.str());
   }
   
+  {
+    boost::mutex::scoped_lock sl(throttleMutex_);
+    writeBandwidth_ = 0;
+    allowedWriteBandwidth_ = -1;
+    lastBandwidthSampleUSec_ = 0;
+  }
+
   doProcessing_ = true;
   processingWL_->submit(processingAction_);
   resourceMonitoringWL_->submit(resourceMonitoringAction_);
@@ -154,7 +180,7 @@ void rubuilder::bu::DiskWriter::stopProcessing()
 }
 
 
-bool rubuilder::bu::DiskWriter::process(toolbox::task::WorkLoop*)
+bool rubuilder::bu::DiskWriter::process(toolbox::task::WorkLoop* wl)
 {
   ::usleep(1000);
   
@@ -162,6 +188,7 @@ bool rubuilder::bu::DiskWriter::process(toolbox::task::WorkLoop*)
   
   try
   {
+    utils::getResourcePlacement().pinCurrentThread(wl->getName());
     while (
       doProcessing_ && (
         handleEvents() ||
@@ -198,7 +225,7 @@ bool rubuilder::bu::DiskWriter::handleEvents()
   const FileHandlerPtr fileHandler = lumiHandler->getFileHandler(stateMachine_);
   
   if ( fileHandler->getAllocatedEventCount() == 1 )
-    ++diskWriterMonitoring_.nbFiles;
+    ++diskWriterMonitoring_.local().nbFiles;
   
   FileHandlerAndEventPtr fileHandlerAndEvent(
     new FileHandlerAndEvent(fileHandler, event)
@@ -222,9 +249,10 @@ rubuilder::bu::LumiHandlerPtr rubuilder::bu::DiskWriter::getLumiHandler(const ui
         buInstance_, runRawDataDir_, runMetaDataDir_, lumiSection, maxEventsPerFile_, numberOfWriters_));
     pos = lumiHandlers_.insert(pos, LumiHandlers::value_type(lumiSection, lumiHandler));
     
-    boost::mutex::scoped_lock monitorSL(diskWriterMonitoringMutex_);
-    ++diskWriterMonitoring_.nbLumiSections;
-    diskWriterMonitoring_.currentLumiSection = lumiSection;
+    DiskWriterMonitoring& diskWriterMonitoring = diskWriterMonitoring_.local();
+    ++diskWriterMonitoring.nbLumiSections;
+    if ( lumiSection > diskWriterMonitoring.currentLumiSection )
+      diskWriterMonitoring.currentLumiSection = lumiSection;
   }
 
   return pos->second;
@@ -237,12 +265,12 @@ bool rubuilder::bu::DiskWriter::handleEoLS()
   if ( ! eolsFIFO_.deq(lumiSection) ) return false;
   
   boost::mutex::scoped_lock handlerSL(lumiHandlersMutex_);
-  boost::mutex::scoped_lock monitorSL(diskWriterMonitoringMutex_);
+  DiskWriterMonitoring& diskWriterMonitoring = diskWriterMonitoring_.local();
   
   LumiHandlers::iterator pos = lumiHandlers_.find(lumiSection);
   
-  if ( lumiSection > diskWriterMonitoring_.lastEoLS )
-    diskWriterMonitoring_.lastEoLS = lumiSection;
+  if ( lumiSection > diskWriterMonitoring.lastEoLS )
+    diskWriterMonitoring.lastEoLS = lumiSection;
 
   if ( pos == lumiHandlers_.end() )
   {
@@ -250,7 +278,7 @@ bool rubuilder::bu::DiskWriter::handleEoLS()
     // Use a dummy FileHandler to create an empty file
     LumiHandler emptyLumi(buInstance_, runRawDataDir_, runMetaDataDir_, lumiSection, 0, 0);
     emptyLumi.close();
-    ++diskWriterMonitoring_.nbLumiSections;
+    ++diskWriterMonitoring.nbLumiSections;
   }
   else
   {
@@ -262,7 +290,7 @@ bool rubuilder::bu::DiskWriter::handleEoLS()
 }
 
 
-bool rubuilder::bu::DiskWriter::writing(toolbox::task::WorkLoop*)
+bool rubuilder::bu::DiskWriter::writing(toolbox::task::WorkLoop* wl)
 {  
   ::usleep(1000);
 
@@ -270,6 +298,7 @@ bool rubuilder::bu::DiskWriter::writing(toolbox::task::WorkLoop*)
   
   try
   {
+    utils::getResourcePlacement().pinCurrentThread(wl->getName());
     FileHandlerAndEventPtr fileHandlerAndEvent;
     bool gotEvent(false);
     do
@@ -286,8 +315,7 @@ bool rubuilder::bu::DiskWriter::writing(toolbox::task::WorkLoop*)
         }
         catch(exception::SuperFragment &e)
         {
-          boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
-          ++diskWriterMonitoring_.nbEventsCorrupted;
+          ++diskWriterMonitoring_.local().nbEventsCorrupted;
           if ( tolerateCorruptedEvents_ )
           {
             LOG4CPLUS_ERROR(app_->getApplicationLogger(),
@@ -300,14 +328,18 @@ bool rubuilder::bu::DiskWriter::writing(toolbox::task::WorkLoop*)
           }
         }
 
+        const uint64_t writeStartUSec = utils::getMonotonicTimeUSec();
         fileHandlerAndEvent->event->writeToDisk(fileHandlerAndEvent->fileHandler);
+        eventWriteLatency_.recordSince(writeStartUSec);
+        utils::getEventTracer().trace(fileHandlerAndEvent->event->evbId(),
+          utils::EventTracer::BU_EVENT_WRITTEN);
         eventTable_->discardEvent( fileHandlerAndEvent->event->buResourceId() );
 
-        boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
-        ++diskWriterMonitoring_.nbEventsWritten;
-        const uint32_t eventNumber = fileHandlerAndEvent->event->evbId().eventNumber();
-        if ( eventNumber > diskWriterMonitoring_.lastEventNumberWritten )
-          diskWriterMonitoring_.lastEventNumberWritten = eventNumber;
+        DiskWriterMonitoring& diskWriterMonitoring = diskWriterMonitoring_.local();
+        ++diskWriterMonitoring.nbEventsWritten;
+        diskWriterMonitoring.payloadWritten += fileHandlerAndEvent->event->payload();
+        utils::storeRelaxed(lastEventNumberWrittenShared_,
+          fileHandlerAndEvent->event->evbId().eventNumber());
       }
     }
     while (gotEvent);
@@ -326,22 +358,57 @@ bool rubuilder::bu::DiskWriter::writing(toolbox::task::WorkLoop*)
 
 bool rubuilder::bu::DiskWriter::resourceMonitoring(toolbox::task::WorkLoop*)
 {
-  bool allOkay(true);
-
-  allOkay &= checkDiskSize(rawDataDiskUsage_);
-  allOkay &= checkDiskSize(metaDataDiskUsage_);
-
-  eventTable_->requestEvents(allOkay);
+  const double writeBandwidth = measureWriteBandwidth();
+  
+  // Each disk allows a bandwidth in proportion to what we write to it.
+  // The raw-data disk receives all event data, while the meta data
+  // is negligible. Thus, the meta-data disk only stops the requests.
+  double allowedWriteBandwidth =
+    rawDataDiskUsage_->getAllowedWriteBandwidth(writeBandwidth, diskThrottleLookaheadSec_);
+  if ( metaDataDiskUsage_->getAllowedWriteBandwidth(0, diskThrottleLookaheadSec_) == 0 )
+    allowedWriteBandwidth = 0;
   
-  ::sleep(5);
+  eventTable_->requestEvents( allowedWriteBandwidth != 0 );
+  eventTable_->limitRequestBandwidth(allowedWriteBandwidth);
+  
+  {
+    boost::mutex::scoped_lock sl(throttleMutex_);
+    writeBandwidth_ = writeBandwidth;
+    allowedWriteBandwidth_ = allowedWriteBandwidth;
+  }
+  
+  ::sleep(1);
   
   return doProcessing_;
 }
 
 
-bool rubuilder::bu::DiskWriter::checkDiskSize(DiskUsagePtr diskUsage)
+double rubuilder::bu::DiskWriter::measureWriteBandwidth()
 {
-  return ( diskUsage->update() && ! diskUsage->tooHigh() );
+  DiskWriterMonitoring diskWriterMonitoring;
+  diskWriterMonitoring_.snapshot(diskWriterMonitoring);
+  const uint64_t now = utils::getMonotonicTimeUSec();
+  
+  double writeBandwidth = writeBandwidth_;
+  
+  if ( lastBandwidthSampleUSec_ > 0 && now > lastBandwidthSampleUSec_ )
+  {
+    // The counters might have been reset in the meantime
+    const uint64_t payloadWritten =
+      diskWriterMonitoring.payloadWritten >= lastPayloadWritten_ ?
+      diskWriterMonitoring.payloadWritten - lastPayloadWritten_ :
+      diskWriterMonitoring.payloadWritten;
+    const double bandwidth =
+      static_cast<double>(payloadWritten) * 1e6 / (now - lastBandwidthSampleUSec_);
+    
+    // Exponential moving average over the last 4 seconds or so
+    writeBandwidth += (bandwidth - writeBandwidth) / 4;
+  }
+  
+  lastPayloadWritten_ = diskWriterMonitoring.payloadWritten;
+  lastBandwidthSampleUSec_ = now;
+  
+  return writeBandwidth;
 }
 
 
@@ -362,13 +429,14 @@ void rubuilder::bu::DiskWriter::writeJSON()
     XCEPT_RAISE(exception::DiskWriting, oss.str());
   }
   
-  boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+  DiskWriterMonitoring diskWriterMonitoring;
+  diskWriterMonitoring_.snapshot(diskWriterMonitoring);
   
   std::ofstream json(jsonFile.string().c_str());
   json << "{"                                                                           << std::endl;
-  json << "   \"Data\" : [ \""     << diskWriterMonitoring_.nbEventsWritten << "\", \""
-                                   << diskWriterMonitoring_.nbFiles         << "\", \""
-                                   << diskWriterMonitoring_.nbLumiSections  << "\" ],"  << std::endl;
+  json << "   \"Data\" : [ \""     << diskWriterMonitoring.nbEventsWritten << "\", \""
+                                   << diskWriterMonitoring.nbFiles         << "\", \""
+                                   << diskWriterMonitoring.nbLumiSections  << "\" ],"   << std::endl;
   json << "   \"Definition\" : \"" << jsonDefFile.string()  << "\","                    << std::endl;
   json << "   \"Source\" : \"BU-"  << buInstance_   << "\""                             << std::endl;
   json << "}"                                                                           << std::endl;
@@ -413,6 +481,7 @@ void rubuilder::bu::DiskWriter::appendConfigurationItems(utils::InfoSpaceItems&
   maxEventsPerFile_ = 2000;
   eolsFIFOCapacity_ = 1028;
   tolerateCorruptedEvents_ = false;
+  diskThrottleLookaheadSec_ = 60;
   
   diskWriterParams_.add("writeEventsToDisk", &writeEventsToDisk_);
   diskWriterParams_.add("numberOfWriters", &numberOfWriters_);
@@ -425,6 +494,7 @@ void rubuilder::bu::DiskWriter::appendConfigurationItems(utils::InfoSpaceItems&
   diskWriterParams_.add("maxEventsPerFile", &maxEventsPerFile_);
   diskWriterParams_.add("eolsFIFOCapacity", &eolsFIFOCapacity_);
   diskWriterParams_.add("tolerateCorruptedEvents", &tolerateCorruptedEvents_);
+  diskWriterParams_.add("diskThrottleLookaheadSec", &diskThrottleLookaheadSec_);
   
   params.add(diskWriterParams_);
 }
@@ -435,34 +505,79 @@ void rubuilder::bu::DiskWriter::appendMonitoringItems(utils::InfoSpaceItems& ite
   nbEvtsWritten_ = 0;
   nbFilesWritten_ = 0;
   nbEvtsCorrupted_ = 0;
+  diskThrottleState_ = getThrottleState(-1);
+  writeBandwidthMBps_ = 0;
+  allowedWriteBandwidthMBps_ = -1;
+  rawDataDiskFillRateMBps_ = 0;
   
   items.add("nbEvtsWritten", &nbEvtsWritten_);
   items.add("nbFilesWritten", &nbFilesWritten_);
   items.add("nbEvtsCorrupted", &nbEvtsCorrupted_);
+  items.add("diskThrottleState", &diskThrottleState_);
+  items.add("writeBandwidthMBps", &writeBandwidthMBps_);
+  items.add("allowedWriteBandwidthMBps", &allowedWriteBandwidthMBps_);
+  items.add("rawDataDiskFillRateMBps", &rawDataDiskFillRateMBps_);
+
+  eventWriteLatency_.appendMonitoringItems(items);
 }
 
 
 void rubuilder::bu::DiskWriter::updateMonitoringItems()
 {
-  boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+  eventWriteLatency_.updateMonitoringItems();
+
+  DiskWriterMonitoring diskWriterMonitoring;
+  diskWriterMonitoring_.snapshot(diskWriterMonitoring);
   
-  nbEvtsWritten_ = diskWriterMonitoring_.nbEventsWritten;
-  nbFilesWritten_ = diskWriterMonitoring_.nbFiles;
-  nbEvtsCorrupted_ = diskWriterMonitoring_.nbEventsCorrupted;
+  nbEvtsWritten_ = diskWriterMonitoring.nbEventsWritten;
+  nbFilesWritten_ = diskWriterMonitoring.nbFiles;
+  nbEvtsCorrupted_ = diskWriterMonitoring.nbEventsCorrupted;
+  
+  {
+    boost::mutex::scoped_lock sl(throttleMutex_);
+    diskThrottleState_ = getThrottleState(allowedWriteBandwidth_);
+    writeBandwidthMBps_ = writeBandwidth_ / 1000000;
+    allowedWriteBandwidthMBps_ = allowedWriteBandwidth_ < 0 ? -1 : allowedWriteBandwidth_ / 1000000;
+  }
+  
+  if ( rawDataDiskUsage_.get() )
+    rawDataDiskFillRateMBps_ = rawDataDiskUsage_->fillRateMBps();
 }
 
 
 void rubuilder::bu::DiskWriter::resetMonitoringCounters()
 {
-  boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
-  
-  diskWriterMonitoring_.nbFiles = 0;
-  diskWriterMonitoring_.nbEventsWritten = 0;
-  diskWriterMonitoring_.nbLumiSections = 0;
-  diskWriterMonitoring_.lastEventNumberWritten = 0;
-  diskWriterMonitoring_.currentLumiSection = 0;
-  diskWriterMonitoring_.lastEoLS = 0;
-  diskWriterMonitoring_.nbEventsCorrupted = 0;
+  eventWriteLatency_.resetMonitoringCounters();
+
+  diskWriterMonitoring_.reset();
+  utils::storeRelaxed(lastEventNumberWrittenShared_, 0U);
+}
+
+
+rubuilder::bu::DiskWriter::DiskWriterMonitoring::DiskWriterMonitoring() :
+nbFiles(0),
+nbEventsWritten(0),
+nbLumiSections(0),
+currentLumiSection(0),
+lastEoLS(0),
+nbEventsCorrupted(0),
+payloadWritten(0)
+{}
+
+
+rubuilder::bu::DiskWriter::DiskWriterMonitoring&
+rubuilder::bu::DiskWriter::DiskWriterMonitoring::operator+=(const DiskWriterMonitoring& other)
+{
+  nbFiles += other.nbFiles;
+  nbEventsWritten += other.nbEventsWritten;
+  nbLumiSections += other.nbLumiSections;
+  if ( other.currentLumiSection > currentLumiSection )
+    currentLumiSection = other.currentLumiSection;
+  if ( other.lastEoLS > lastEoLS )
+    lastEoLS = other.lastEoLS;
+  nbEventsCorrupted += other.nbEventsCorrupted;
+  payloadWritten += other.payloadWritten;
+  return *this;
 }
 
 
@@ -554,36 +669,38 @@ void rubuilder::bu::DiskWriter::printHtml(xgi::Output *out)
   *out << "</tr>"                                                 << std::endl;
   
   {
-    boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+    DiskWriterMonitoring diskWriterMonitoring;
+    diskWriterMonitoring_.snapshot(diskWriterMonitoring);
     
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>last evt number written</td>"                      << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.lastEventNumberWritten  << "</td>" << std::endl;
+    *out << "<td>" << utils::loadRelaxed(lastEventNumberWrittenShared_) << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td># files written</td>"                              << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.nbFiles << "</td>"      << std::endl;
+    *out << "<td>" << diskWriterMonitoring.nbFiles << "</td>"       << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td># events written</td>"                             << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.nbEventsWritten << "</td>" << std::endl;
+    *out << "<td>" << diskWriterMonitoring.nbEventsWritten << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td># corrupted events</td>"                           << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.nbEventsCorrupted << "</td>" << std::endl;
+    *out << "<td>" << diskWriterMonitoring.nbEventsCorrupted << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
+    eventWriteLatency_.printHtml(out);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td># lumi sections</td>"                              << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.nbLumiSections << "</td>" << std::endl;
+    *out << "<td>" << diskWriterMonitoring.nbLumiSections << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>current lumi section</td>"                         << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.currentLumiSection << "</td>" << std::endl;
+    *out << "<td>" << diskWriterMonitoring.currentLumiSection << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>last EoLS signal</td>"                             << std::endl;
-    *out << "<td>" << diskWriterMonitoring_.lastEoLS << "</td>"     << std::endl;
+    *out << "<td>" << diskWriterMonitoring.lastEoLS << "</td>"      << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
   if ( rawDataDiskUsage_.get() )
@@ -596,6 +713,10 @@ void rubuilder::bu::DiskWriter::printHtml(xgi::Output *out)
     *out << "<td>Raw-data disk usage</td>"                          << std::endl;
     *out << "<td>" << rawDataDiskUsage_->relDiskUsage() << "</td>"  << std::endl;
     *out << "</tr>"                                                 << std::endl;
+    *out << "<tr>"                                                  << std::endl;
+    *out << "<td>Raw-data disk fill rate (MB/s)</td>"               << std::endl;
+    *out << "<td>" << rawDataDiskUsage_->fillRateMBps() << "</td>"  << std::endl;
+    *out << "</tr>"                                                 << std::endl;
   }
   if ( metaDataDiskUsage_.get() )
   {
@@ -607,6 +728,29 @@ void rubuilder::bu::DiskWriter::printHtml(xgi::Output *out)
     *out << "<td>Meta-data disk usage</td>"                         << std::endl;
     *out << "<td>" << metaDataDiskUsage_->relDiskUsage() << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
+    *out << "<tr>"                                                  << std::endl;
+    *out << "<td>Meta-data disk fill rate (MB/s)</td>"              << std::endl;
+    *out << "<td>" << metaDataDiskUsage_->fillRateMBps() << "</td>" << std::endl;
+    *out << "</tr>"                                                 << std::endl;
+  }
+  {
+    boost::mutex::scoped_lock sl(throttleMutex_);
+    
+    *out << "<tr>"                                                  << std::endl;
+    *out << "<td>disk throttle</td>"                                << std::endl;
+    *out << "<td>" << getThrottleState(allowedWriteBandwidth_) << "</td>" << std::endl;
+    *out << "</tr>"                                                 << std::endl;
+    *out << "<tr>"                                                  << std::endl;
+    *out << "<td>write bandwidth (MB/s)</td>"                       << std::endl;
+    *out << "<td>" << writeBandwidth_ / 1000000 << "</td>"          << std::endl;
+    *out << "</tr>"                                                 << std::endl;
+    if ( allowedWriteBandwidth_ > 0 )
+    {
+      *out << "<tr>"                                                << std::endl;
+      *out << "<td>allowed write bandwidth (MB/s)</td>"             << std::endl;
+      *out << "<td>" << allowedWriteBandwidth_ / 1000000 << "</td>" << std::endl;
+      *out << "</tr>"                                               << std::endl;
+    }
   }
   
   *out << "<tr>"                                                  << std::endl;
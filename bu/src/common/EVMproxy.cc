@@ -4,6 +4,7 @@
 #include "rubuilder/bu/EVMproxy.h"
 #include "rubuilder/utils/Constants.h"
 #include "rubuilder/utils/DumpUtility.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xcept/tools.h"
 #include "xdaq/ApplicationDescriptor.h"
@@ -157,15 +158,7 @@ void rubuilder::bu::EVMproxy::sendEvtIdRqstAndOrReleaseToEVM()
   
   try
   {
-    app_->getApplicationContext()->
-      postFrame
-      (
-        evtIdRqstsAndOrReleasesBufRef_,
-        app_->getApplicationDescriptor(),
-        evm_.descriptor //,
-        //i2oExceptionHandler_,
-        //evm_.descriptor
-      );
+    utils::postFrame(app_, evtIdRqstsAndOrReleasesBufRef_, evm_.descriptor);
     evtIdRqstsAndOrReleasesBufRef_ = 0;
   }
   catch(xcept::Exception &e)
@@ -9,9 +9,10 @@
 #include "interface/shared/frl_header.h"
 #include "rubuilder/bu/Event.h"
 #include "rubuilder/bu/FUproxy.h"
-#include "rubuilder/utils/CRC16.h"
+#include "rubuilder/utils/CRC16Kernels.h"
 #include "rubuilder/utils/DumpUtility.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/LatencyHistogram.h"
 #include "interface/evb/i2oEVBMsgs.h"
 #include "xcept/tools.h"
 
@@ -23,7 +24,8 @@ rubuilder::bu::Event::Event
 ) :
 offset_(0),
 nbExpectedSuperFragments_(ruCount+1), // RUs + 1 EVM
-nbCompleteSuperFragments_(1)
+nbCompleteSuperFragments_(1),
+creationTimeUSec_(utils::getMonotonicTimeUSec())
 {  
   const I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block =
     (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)bufRef->getDataLocation();
@@ -345,17 +347,7 @@ uint16_t rubuilder::bu::Event::updateCRC
   for (size_t i = first; i != last; --i)
   {
     const FedLocationPtr loc = fedLocations_[i];
-    const size_t wordCount = loc->length/8;
-    for (size_t w=0; w<wordCount; ++w)
-    {
-      //crc.process_block(&loc->location[w*8+7],&loc->location[w*8]);
-      for (int b=7; b >= 0; --b)
-      {
-        const unsigned char index = (crc >> 8) ^ loc->location[w*8+b];
-        crc <<= 8;
-        crc ^= evf::crc_table[index];
-      }
-    }
+    crc = utils::computeFedCRC(crc, loc->location, loc->length);
   }
   
   return crc; //.checksum();
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 
 #include "rubuilder/bu/DiskWriter.h"
@@ -6,7 +7,10 @@
 #include "rubuilder/bu/FUproxy.h"
 #include "rubuilder/bu/FuRqstForResource.h"
 #include "rubuilder/bu/StateMachine.h"
+#include "rubuilder/utils/Atomic.h"
 #include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/EventTracer.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "rubuilder/utils/Exception.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
@@ -28,7 +32,18 @@ discardFIFO_("discardFIFO"),
 freeResourceIdFIFO_("freeResourceIdFIFO"),
 doProcessing_(false),
 processActive_(false),
-requestEvents_(false)
+requestEvents_(false),
+eventMemoryHighWaterMarkBytes_(0),
+nbResourcesInUse_(0),
+nbCompleteEvents_(0),
+completeEventsPayload_(0),
+eventSizeAverage_(0),
+receivePool_(0),
+requestBandwidthLimit_(-1),
+requestsLimited_(false),
+requestBandwidthCredit_(0),
+lastRequestCreditUSec_(0),
+requestToCompleteLatency_("requestToCompleteLatency")
 {
   resetMonitoringCounters();
   startProcessingWorkLoop();
@@ -73,10 +88,15 @@ void rubuilder::bu::EventTable::startConstruction
     XCEPT_RAISE(exception::EventOrder, oss.str());
   }
 
-  ++eventMonitoring_.nbEventsUnderConstruction;
+  ++eventMonitoring_.local().nbEventsUnderConstruction;
+
+  // All event data is received into the pool of the peer transport
+  if ( receivePool_ == 0 )
+    receivePool_ = bufRef->getBuffer()->getPool();
 
   EventPtr event( new Event(ruCount, bufRef) );
   data_.insert(pos, Data::value_type(block->buResourceId,event));
+  utils::getEventTracer().trace(event->evbId(), utils::EventTracer::BU_EVENT_STARTED);
 
   checkForCompleteEvent(event);
 }
@@ -128,8 +148,17 @@ void rubuilder::bu::EventTable::checkForCompleteEvent(EventPtr event)
 {
   if ( ! event->isComplete() ) return;
   
+  // The requests to the RUs are sent right after the event creation
+  requestToCompleteLatency_.recordSince( event->creationTimeUSec() );
+  utils::getEventTracer().trace(event->evbId(), utils::EventTracer::BU_EVENT_COMPLETE);
   updateEventCounters(event);
 
+  // The size of a complete event is known. It is accounted
+  // until the event is discarded.
+  ++nbCompleteEvents_;
+  completeEventsPayload_ += event->payload();
+  updateAverageEventSize( event->payload() );
+
   if ( dropEventData_ )
   {
     discardEvent( event->buResourceId() );
@@ -143,18 +172,18 @@ void rubuilder::bu::EventTable::checkForCompleteEvent(EventPtr event)
 
 void rubuilder::bu::EventTable::updateEventCounters(EventPtr event)
 {
-  boost::mutex::scoped_lock sl(eventMonitoringMutex_);
+  EventMonitoring& eventMonitoring = eventMonitoring_.local();
   
-  --eventMonitoring_.nbEventsUnderConstruction;
-  ++eventMonitoring_.nbEventsBuilt;
-  ++eventMonitoring_.nbEventsInBU;
+  --eventMonitoring.nbEventsUnderConstruction;
+  ++eventMonitoring.nbEventsBuilt;
+  ++eventMonitoring.nbEventsInBU;
   
   const size_t payload = event->payload();
-  eventMonitoring_.payload += payload;
-  eventMonitoring_.payloadSquared += payload*payload;
+  eventMonitoring.payload += payload;
+  eventMonitoring.payloadSquared += payload*payload;
   
   if ( dropEventData_ )
-    ++eventMonitoring_.nbEventsDropped;
+    ++eventMonitoring.nbEventsDropped;
 }
 
 
@@ -208,7 +237,7 @@ void rubuilder::bu::EventTable::startProcessingWorkLoop()
 }
 
 
-bool rubuilder::bu::EventTable::process(toolbox::task::WorkLoop*)
+bool rubuilder::bu::EventTable::process(toolbox::task::WorkLoop* wl)
 {
   ::usleep(1000);
   
@@ -216,6 +245,7 @@ bool rubuilder::bu::EventTable::process(toolbox::task::WorkLoop*)
   
   try
   {
+    utils::getResourcePlacement().pinCurrentThread(wl->getName());
     while (
       doProcessing_ && (
         sendEvtIdRqsts() ||
@@ -282,8 +312,8 @@ bool rubuilder::bu::EventTable::handleDiscards()
   
   evmProxy_->sendEvtIdRqstAndOrRelease(rqstAndOrRelease);
   
-  boost::mutex::scoped_lock sl(eventMonitoringMutex_);
-  --eventMonitoring_.nbEventsInBU;
+  EventMonitoring& eventMonitoring = eventMonitoring_.local();
+  --eventMonitoring.nbEventsInBU;
   
   return true;
 }
@@ -313,14 +343,111 @@ void rubuilder::bu::EventTable::freeEventAndGetReleaseMsg
   rqstAndOrRelease.evbId       = pos->second->evbId();
   rqstAndOrRelease.resourceId  = buResourceId;
   
-  // Request another event if we want one
-  if ( requestEvents_ )
+  // Free the resource
+  if ( pos->second->isComplete() )
+  {
+    --nbCompleteEvents_;
+    completeEventsPayload_ -= pos->second->payload();
+  }
+  data_.erase(pos);
+  __sync_fetch_and_sub(&nbResourcesInUse_, 1);
+  
+  // Request another event if we want one, it fits into memory,
+  // and the request bandwidth is not exhausted.
+  // The memory check must not count the resource just freed.
+  if ( requestEvents_ && isMemoryAvailableForEvent() && isRequestBandwidthAvailable() )
+  {
     rqstAndOrRelease.requestType |= msg::EvtIdRqstAndOrRelease::REQUEST;
+    __sync_fetch_and_add(&nbResourcesInUse_, 1);
+  }
   else
+  {
     while ( ! freeResourceIdFIFO_.enq(buResourceId) ) { ::usleep(1000); }
+  }
+}
+
+
+bool rubuilder::bu::EventTable::isMemoryAvailableForEvent()
+{
+  // No byte budget: the number of resource ids limits the requests
+  if ( eventMemoryHighWaterMarkBytes_ == 0 ) return true;
   
-  // Free the resource
-  data_.erase(pos);
+  // Always keep one event in flight, even if it exceeds the budget,
+  // and request events until their size is known
+  if ( utils::loadRelaxed(nbResourcesInUse_) == 0 || eventSizeAverage_ == 0 ) return true;
+  
+  return ( getProjectedMemoryUsage() + eventSizeAverage_ <= eventMemoryHighWaterMarkBytes_ );
+}
+
+
+void rubuilder::bu::EventTable::limitRequestBandwidth(const double bytesPerSec)
+{
+  boost::mutex::scoped_lock sl(dataMutex_);
+  
+  // Start with an empty bucket when the limit is imposed
+  if ( requestBandwidthLimit_ < 0 && bytesPerSec >= 0 )
+  {
+    requestBandwidthCredit_ = 0;
+    lastRequestCreditUSec_ = utils::getMonotonicTimeUSec();
+  }
+  requestBandwidthLimit_ = bytesPerSec;
+  utils::storeRelaxed(requestsLimited_,
+    eventMemoryHighWaterMarkBytes_ > 0 || requestBandwidthLimit_ >= 0);
+}
+
+
+bool rubuilder::bu::EventTable::isRequestBandwidthAvailable()
+{
+  if ( requestBandwidthLimit_ < 0 ) return true;
+  
+  const uint64_t now = utils::getMonotonicTimeUSec();
+  requestBandwidthCredit_ += requestBandwidthLimit_ * (now - lastRequestCreditUSec_) / 1e6;
+  lastRequestCreditUSec_ = now;
+  
+  // Do not accumulate more than about one second worth of credit
+  const double maxCredit = std::max(requestBandwidthLimit_, eventSizeAverage_);
+  if ( requestBandwidthCredit_ > maxCredit )
+    requestBandwidthCredit_ = maxCredit;
+  
+  // Request events at any non-zero limit until their size is known
+  if ( eventSizeAverage_ == 0 ) return ( requestBandwidthLimit_ > 0 );
+  
+  if ( requestBandwidthCredit_ < eventSizeAverage_ ) return false;
+  
+  requestBandwidthCredit_ -= eventSizeAverage_;
+  return true;
+}
+
+
+uint64_t rubuilder::bu::EventTable::getProjectedMemoryUsage()
+{
+  // Requested and partially built events will grow to the average size
+  const uint32_t nbResourcesInUse = utils::loadRelaxed(nbResourcesInUse_);
+  const uint32_t nbIncompleteEvents = nbResourcesInUse > nbCompleteEvents_ ?
+    nbResourcesInUse - nbCompleteEvents_ : 0;
+  uint64_t projectedMemoryUsage = completeEventsPayload_ +
+    static_cast<uint64_t>(nbIncompleteEvents * eventSizeAverage_);
+  
+  // The pool also holds fragments of events not yet complete
+  // and possibly data from other sources
+  if ( eventMemoryCountsPoolUsage_.value_ && receivePool_ )
+  {
+    const uint64_t poolUsage = receivePool_->getMemoryUsage().getUsed();
+    if ( poolUsage > projectedMemoryUsage )
+      projectedMemoryUsage = poolUsage;
+  }
+  
+  return projectedMemoryUsage;
+}
+
+
+void rubuilder::bu::EventTable::updateAverageEventSize(const size_t payload)
+{
+  // Exponential moving average over the last 16 events or so
+  if ( eventSizeAverage_ == 0 )
+    eventSizeAverage_ = payload;
+  else
+    eventSizeAverage_ += (static_cast<double>(payload) - eventSizeAverage_) / 16;
 }
 
 
@@ -329,26 +456,45 @@ bool rubuilder::bu::EventTable::sendEvtIdRqsts()
   msg::EvtIdRqstAndOrRelease rqstAndOrRelease;
   uint32_t buResourceId;
   
-  if ( requestEvents_ && freeResourceIdFIFO_.deq(buResourceId) )
+  if ( ! requestEvents_ || freeResourceIdFIFO_.empty() ) return false;
+  
+  if ( utils::loadRelaxed(requestsLimited_) )
   {
-    // Prepare an event id request
-    rqstAndOrRelease.requestType = msg::EvtIdRqstAndOrRelease::REQUEST;
-    rqstAndOrRelease.resourceId  = buResourceId;
+    boost::mutex::scoped_lock sl(dataMutex_);
     
-    evmProxy_->sendEvtIdRqstAndOrRelease(rqstAndOrRelease);
-
-    return true;
+    if ( ! isMemoryAvailableForEvent() ) return false;
+    if ( ! isRequestBandwidthAvailable() ) return false;
+    if ( ! freeResourceIdFIFO_.deq(buResourceId) ) return false;
+    __sync_fetch_and_add(&nbResourcesInUse_, 1);
+  }
+  else
+  {
+    // The number of resource ids is the only limit
+    if ( ! freeResourceIdFIFO_.deq(buResourceId) ) return false;
+    __sync_fetch_and_add(&nbResourcesInUse_, 1);
   }
   
-  return false;
+  // Prepare an event id request
+  rqstAndOrRelease.requestType = msg::EvtIdRqstAndOrRelease::REQUEST;
+  rqstAndOrRelease.resourceId  = buResourceId;
+  
+  evmProxy_->sendEvtIdRqstAndOrRelease(rqstAndOrRelease);
+  
+  return true;
 }
 
 
 void rubuilder::bu::EventTable::appendConfigurationItems(utils::InfoSpaceItems& params)
 {
   dropEventData_ = false;
+  eventMemoryBudgetMB_ = 0;
+  eventMemoryHighWaterMark_ = 0.9;
+  eventMemoryCountsPoolUsage_ = false;
 
   tableParams_.add("dropEventData", &dropEventData_);
+  tableParams_.add("eventMemoryBudgetMB", &eventMemoryBudgetMB_);
+  tableParams_.add("eventMemoryHighWaterMark", &eventMemoryHighWaterMark_);
+  tableParams_.add("eventMemoryCountsPoolUsage", &eventMemoryCountsPoolUsage_);
 
   params.add(tableParams_);
 }
@@ -360,58 +506,108 @@ void rubuilder::bu::EventTable::appendMonitoringItems(utils::InfoSpaceItems& ite
   nbEvtsReady_ = 0;
   nbEventsInBU_ = 0;
   nbEvtsBuilt_ = 0;
+  projectedEventMemory_ = 0;
+  averageEventSize_ = 0;
   
   items.add("nbEvtsUnderConstruction", &nbEvtsUnderConstruction_);
   items.add("nbEvtsReady", &nbEvtsReady_);
   items.add("nbEventsInBU", &nbEventsInBU_);
   items.add("nbEvtsBuilt", &nbEvtsBuilt_);
+  items.add("projectedEventMemory", &projectedEventMemory_);
+  items.add("averageEventSize", &averageEventSize_);
+
+  requestToCompleteLatency_.appendMonitoringItems(items);
 }
 
 
 void rubuilder::bu::EventTable::updateMonitoringItems()
 {
-  boost::mutex::scoped_lock sl(eventMonitoringMutex_);
+  EventMonitoring eventMonitoring;
+  eventMonitoring_.snapshot(eventMonitoring);
   
-  nbEvtsUnderConstruction_ =  eventMonitoring_.nbEventsUnderConstruction;
-  nbEvtsBuilt_ = eventMonitoring_.nbEventsBuilt;
-  nbEventsInBU_ = eventMonitoring_.nbEventsInBU;
+  nbEvtsUnderConstruction_ =  eventMonitoring.nbEventsUnderConstruction;
+  nbEvtsBuilt_ = eventMonitoring.nbEventsBuilt;
+  nbEventsInBU_ = eventMonitoring.nbEventsInBU;
   
   nbEvtsReady_ = completeEventsFIFO_.elements();
+
+  {
+    boost::mutex::scoped_lock sl(dataMutex_);
+    projectedEventMemory_ = getProjectedMemoryUsage();
+    averageEventSize_ = static_cast<uint32_t>(eventSizeAverage_);
+  }
+
+  requestToCompleteLatency_.updateMonitoringItems();
 }
 
 
 void rubuilder::bu::EventTable::resetMonitoringCounters()
 {
-  boost::mutex::scoped_lock sl(eventMonitoringMutex_);
-
-  eventMonitoring_.nbEventsUnderConstruction = 0;
-  eventMonitoring_.nbEventsBuilt = 0;
-  eventMonitoring_.nbEventsInBU = 0;
-  eventMonitoring_.nbEventsDropped = 0;
-  eventMonitoring_.payload = 0;
-  eventMonitoring_.payloadSquared = 0;
+  eventMonitoring_.reset();
+
+  requestToCompleteLatency_.resetMonitoringCounters();
+}
+
+
+rubuilder::bu::EventTable::EventMonitoring::EventMonitoring() :
+nbEventsUnderConstruction(0),
+nbEventsBuilt(0),
+nbEventsInBU(0),
+nbEventsDropped(0),
+payload(0),
+payloadSquared(0)
+{}
+
+
+rubuilder::bu::EventTable::EventMonitoring&
+rubuilder::bu::EventTable::EventMonitoring::operator+=(const EventMonitoring& other)
+{
+  // Events may be counted up and down by different threads. The
+  // unsigned sum is correct even if the count of one thread wraps.
+  nbEventsUnderConstruction += other.nbEventsUnderConstruction;
+  nbEventsBuilt += other.nbEventsBuilt;
+  nbEventsInBU += other.nbEventsInBU;
+  nbEventsDropped += other.nbEventsDropped;
+  payload += other.payload;
+  payloadSquared += other.payloadSquared;
+  return *this;
 }
 
 
 void rubuilder::bu::EventTable::getPerformance(utils::PerformanceMonitor& performanceMonitor)
 {
-  boost::mutex::scoped_lock sl(eventMonitoringMutex_);
+  EventMonitoring eventMonitoring;
+  eventMonitoring_.snapshot(eventMonitoring);
   
-  performanceMonitor.N = eventMonitoring_.nbEventsBuilt;
-  performanceMonitor.sumOfSizes = eventMonitoring_.payload;
-  performanceMonitor.sumOfSquares = eventMonitoring_.payloadSquared;
+  performanceMonitor.N = eventMonitoring.nbEventsBuilt;
+  performanceMonitor.sumOfSizes = eventMonitoring.payload;
+  performanceMonitor.sumOfSquares = eventMonitoring.payloadSquared;
 }
 
 
 void rubuilder::bu::EventTable::configure(const uint32_t maxEvtsUnderConstruction)
 {
+  if ( eventMemoryHighWaterMark_.value_ <= 0 || eventMemoryHighWaterMark_.value_ > 1 )
+  {
+    std::ostringstream oss;
+    
+    oss << "The eventMemoryHighWaterMark must be within ]0,1], but is ";
+    oss << eventMemoryHighWaterMark_.value_;
+    
+    XCEPT_RAISE(exception::Configuration, oss.str());
+  }
+  
   clear();
   
+  eventMemoryHighWaterMarkBytes_ = static_cast<uint64_t>(
+    eventMemoryBudgetMB_.value_ * 0x100000ULL * eventMemoryHighWaterMark_.value_);
+  
   completeEventsFIFO_.resize(maxEvtsUnderConstruction);
   discardFIFO_.resize(maxEvtsUnderConstruction);
   freeResourceIdFIFO_.resize(maxEvtsUnderConstruction);
 
   requestEvents_ = true;
+  limitRequestBandwidth(-1);
 }
 
 
@@ -427,29 +623,61 @@ void rubuilder::bu::EventTable::clear()
   while ( freeResourceIdFIFO_.deq(buResourceId) ) {};
 
   data_.clear();
+
+  utils::storeRelaxed(nbResourcesInUse_, 0U);
+  nbCompleteEvents_ = 0;
+  completeEventsPayload_ = 0;
+  eventSizeAverage_ = 0;
+  receivePool_ = 0;
 }
 
 
 void rubuilder::bu::EventTable::printMonitoringInformation(xgi::Output *out)
 {
-  boost::mutex::scoped_lock sl(eventMonitoringMutex_);
+  EventMonitoring eventMonitoring;
+  eventMonitoring_.snapshot(eventMonitoring);
   
   *out << "<tr>"                                                  << std::endl;
   *out << "<td># events built</td>"                               << std::endl;
-  *out << "<td>" << eventMonitoring_.nbEventsBuilt << "</td>"     << std::endl;
+  *out << "<td>" << eventMonitoring.nbEventsBuilt << "</td>"      << std::endl;
   *out << "</tr>"                                                 << std::endl;
+  requestToCompleteLatency_.printHtml(out);
   *out << "<tr>"                                                  << std::endl;
   *out << "<td># events under construction</td>"                  << std::endl;
-  *out << "<td>" << eventMonitoring_.nbEventsUnderConstruction << "</td>" << std::endl;
+  *out << "<td>" << eventMonitoring.nbEventsUnderConstruction << "</td>" << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td># complete events in BU</td>"                      << std::endl;
-  *out << "<td>" << eventMonitoring_.nbEventsInBU << "</td>"      << std::endl;
+  *out << "<td>" << eventMonitoring.nbEventsInBU << "</td>"       << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td># events dropped</td>"                             << std::endl;
-  *out << "<td>" << eventMonitoring_.nbEventsDropped << "</td>"   << std::endl;
+  *out << "<td>" << eventMonitoring.nbEventsDropped << "</td>"    << std::endl;
   *out << "</tr>"                                                 << std::endl;
+  {
+    boost::mutex::scoped_lock sl(dataMutex_);
+    
+    *out << "<tr>"                                                << std::endl;
+    *out << "<td>average event size (kB)</td>"                    << std::endl;
+    *out << "<td>" << eventSizeAverage_ / 1000 << "</td>"         << std::endl;
+    *out << "</tr>"                                               << std::endl;
+    *out << "<tr>"                                                << std::endl;
+    *out << "<td>projected event memory (MB)</td>"                << std::endl;
+    *out << "<td>" << getProjectedMemoryUsage() / 0x100000;
+    if ( eventMemoryHighWaterMarkBytes_ > 0 )
+      *out << " of " << eventMemoryHighWaterMarkBytes_ / 0x100000;
+    *out << "</td>"                                               << std::endl;
+    *out << "</tr>"                                               << std::endl;
+    *out << "<tr>"                                                << std::endl;
+    *out << "<td>request bandwidth limit (MB/s)</td>"             << std::endl;
+    *out << "<td>";
+    if ( requestBandwidthLimit_ < 0 )
+      *out << "none";
+    else
+      *out << requestBandwidthLimit_ / 1000000;
+    *out << "</td>"                                               << std::endl;
+    *out << "</tr>"                                               << std::endl;
+  }
 }
 
 
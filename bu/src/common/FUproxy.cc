@@ -2,6 +2,7 @@
 #include "interface/shared/i2oXFunctionCodes.h"
 #include "rubuilder/bu/EventTable.h"
 #include "rubuilder/bu/FUproxy.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xcept/tools.h"
 
@@ -206,14 +207,7 @@ void rubuilder::bu::FUproxy::sendSuperFragment
   
   try
   {
-    app_->getApplicationContext()->
-      postFrame(
-        head,
-        app_->getApplicationDescriptor(),
-        fu//,
-        //i2oExceptionHandler_,
-        //fu
-      );
+    utils::postFrame(app_, head, fu);
   }
   catch(xcept::Exception &e)
   {
@@ -514,14 +508,7 @@ void rubuilder::bu::FUproxy::broadcastEoLSmsg(I2O_EVM_END_OF_LUMISECTION_MESSAGE
       // Send the pairs message to the FU
       try
       {
-        app_->getApplicationContext()->
-          postFrame(
-            copyBufRef,
-            app_->getApplicationDescriptor(),
-            fu//,
-            //i2oExceptionHandler_,
-            //fu
-          );
+        utils::postFrame(app_, copyBufRef, fu);
       }
       catch(xcept::Exception &e)
       {
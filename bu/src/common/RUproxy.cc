@@ -5,11 +5,13 @@
 #include "rubuilder/bu/RUproxy.h"
 #include "rubuilder/utils/Constants.h"
 #include "rubuilder/utils/EvBid.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/I2OMessages.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xcept/tools.h"
 #include "xdaq/ApplicationDescriptor.h"
 
+#include <stddef.h>
 #include <string.h>
 
 
@@ -83,9 +85,10 @@ void rubuilder::bu::RUproxy::requestDataForTrigger(toolbox::mem::Reference* bufR
   // Create a request message if one does not exist
   if (rqstForFragsBufRef_ == 0) createRqstForFrags();
   
-  const uint32_t nbElementsPacked = packRqstForFragsMsg(bufRef);
+  const uint32_t nbRequestsPacked = rqstForFragRangeEncoding_ ?
+    packRqstForFragRangesMsg(bufRef) : packRqstForFragsMsg(bufRef);
   
-  if (nbElementsPacked == I2O_RU_SEND_Packing_)
+  if (nbRequestsPacked == I2O_RU_SEND_Packing_)
   {
     sendRqstForFragsToAllRUs();
   }
@@ -112,6 +115,13 @@ void rubuilder::bu::RUproxy::createRqstForFrags()
   msg::RqstForFragsMsg* rqstForFragsMsg = (msg::RqstForFragsMsg*)stdMsg;
   rqstForFragsMsg->srcIndex   = index_;
   rqstForFragsMsg->nbElements = 0;
+
+  if ( rqstForFragRangeEncoding_ )
+  {
+    msg::RqstForFragRangesMsg* rangesMsg = (msg::RqstForFragRangesMsg*)stdMsg;
+    rangesMsg->version    = msg::RQSTS_RANGES;
+    rangesMsg->nbRequests = 0;
+  }
   
   // Start the aging timer
   timerManager_.restartTimer(timerId_);
@@ -130,6 +140,7 @@ uint32_t rubuilder::bu::RUproxy::packRqstForFragsMsg
   rqstForFrag.evbId        = utils::EvBid(block->resyncCount,block->eventNumber);
   rqstForFrag.buResourceId = block->buResourceId;
   rqstForFrag.padding      = 0;
+  utils::getEventTracer().trace(rqstForFrag.evbId, utils::EventTracer::BU_FRAGMENTS_REQUESTED);
   
   msg::RqstForFragsMsg* msg =
     (msg::RqstForFragsMsg*)rqstForFragsBufRef_->getDataLocation();
@@ -152,9 +163,60 @@ uint32_t rubuilder::bu::RUproxy::packRqstForFragsMsg
 }
 
 
+uint32_t rubuilder::bu::RUproxy::packRqstForFragRangesMsg
+(
+  toolbox::mem::Reference* bufRef
+)
+{
+  const I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block =
+    (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)bufRef->getDataLocation();
+  
+  msg::RqstForFragRangesMsg* msg =
+    (msg::RqstForFragRangesMsg*)rqstForFragsBufRef_->getDataLocation();
+
+  utils::getEventTracer().trace(
+    utils::EvBid(block->resyncCount,block->eventNumber),
+    utils::EventTracer::BU_FRAGMENTS_REQUESTED);
+
+  // Extend the last range if both the EvBid and the
+  // BU resource id follow it, otherwise start a new range
+  if ( msg->nbElements > 0 )
+  {
+    msg::RqstForFragRange& lastRange = msg->elements[msg->nbElements - 1];
+    if ( block->resyncCount == lastRange.first.resyncCount() &&
+      block->eventNumber == lastRange.first.eventNumber() + lastRange.count &&
+      block->buResourceId == lastRange.firstBuResourceId + lastRange.count )
+    {
+      ++(lastRange.count);
+      return ++(msg->nbRequests);
+    }
+  }
+
+  msg::RqstForFragRange& range = msg->elements[msg->nbElements];
+  range.first             = utils::EvBid(block->resyncCount,block->eventNumber);
+  range.firstBuResourceId = block->buResourceId;
+  range.count             = 1;
+  msg->nbElements++;
+
+  // Calculate the size of the message with its new range
+  const size_t msgSize = sizeof(msg::RqstForFragRangesMsg) -
+    sizeof(msg::RqstForFragRange) +
+    sizeof(msg::RqstForFragRange) * msg->nbElements;
+
+  // Store the message size in both the I2O header and the reference
+  msg->PvtMessageFrame.StdMessageFrame.MessageSize = msgSize >> 2;
+  rqstForFragsBufRef_->setDataSize(msgSize);
+
+  // Return the number of requests in the message
+  return ++(msg->nbRequests);
+}
+
+
 void rubuilder::bu::RUproxy::sendRqstForFragsToAllRUs()
 {
-  sendToAllRUs(rqstForFragsBufRef_, rqstForFragsBufSize_);
+  const size_t headerSize = rqstForFragRangeEncoding_ ?
+    offsetof(msg::RqstForFragRangesMsg, elements) : offsetof(msg::RqstForFragsMsg, elements);
+  sendToAllRUs(rqstForFragsBufRef_, rqstForFragsBufSize_, headerSize);
   
   updateRequestCounters();
 
@@ -169,12 +231,22 @@ void rubuilder::bu::RUproxy::updateRequestCounters()
 {
   boost::mutex::scoped_lock sl(requestMonitoringMutex_);
   
-  const msg::RqstForFragsMsg* msg =
-    (msg::RqstForFragsMsg*)rqstForFragsBufRef_->getDataLocation();
-  const uint32_t nbElements = msg->nbElements;
+  if ( rqstForFragRangeEncoding_ )
+  {
+    const msg::RqstForFragRangesMsg* msg =
+      (msg::RqstForFragRangesMsg*)rqstForFragsBufRef_->getDataLocation();
+
+    requestMonitoring_.payload += msg->nbElements * sizeof(msg::RqstForFragRange);
+    requestMonitoring_.logicalCount += msg->nbRequests;
+  }
+  else
+  {
+    const msg::RqstForFragsMsg* msg =
+      (msg::RqstForFragsMsg*)rqstForFragsBufRef_->getDataLocation();
 
-  requestMonitoring_.payload += nbElements * sizeof(msg::RqstForFrag);
-  requestMonitoring_.logicalCount += nbElements;
+    requestMonitoring_.payload += msg->nbElements * sizeof(msg::RqstForFrag);
+    requestMonitoring_.logicalCount += msg->nbElements;
+  }
   requestMonitoring_.i2oCount += participatingRUs_.size();
 }
 
@@ -202,9 +274,11 @@ void rubuilder::bu::RUproxy::appendConfigurationItems(utils::InfoSpaceItems& par
 {
   I2O_RU_SEND_Packing_ = 8;
   blockFIFOCapacity_ = 16384;
+  rqstForFragRangeEncoding_ = false;
   
   ruParams_.clear();
   ruParams_.add("I2O_RU_SEND_Packing", &I2O_RU_SEND_Packing_);
+  ruParams_.add("rqstForFragRangeEncoding", &rqstForFragRangeEncoding_);
   ruParams_.add("blockFIFOCapacity", &blockFIFOCapacity_);
   
   initRuInstances(ruParams_);
@@ -267,9 +341,15 @@ void rubuilder::bu::RUproxy::configure(const int msgAgeLimitDtMSec)
 
   blockFIFO_.resize(blockFIFOCapacity_);
 
-  rqstForFragsBufSize_ = sizeof(msg::RqstForFragsMsg) -
-    sizeof(msg::RqstForFrag) +
-    I2O_RU_SEND_Packing_ * sizeof(msg::RqstForFrag);
+  // The ranges layout needs one range per request in the worst case
+  if ( rqstForFragRangeEncoding_ )
+    rqstForFragsBufSize_ = sizeof(msg::RqstForFragRangesMsg) -
+      sizeof(msg::RqstForFragRange) +
+      I2O_RU_SEND_Packing_ * sizeof(msg::RqstForFragRange);
+  else
+    rqstForFragsBufSize_ = sizeof(msg::RqstForFragsMsg) -
+      sizeof(msg::RqstForFrag) +
+      I2O_RU_SEND_Packing_ * sizeof(msg::RqstForFrag);
   timerManager_.initTimer(timerId_, msgAgeLimitDtMSec);
 }
 
@@ -346,6 +426,8 @@ void rubuilder::bu::RUproxy::printHtml(xgi::Output *out)
   *out << "</td>"                                                 << std::endl;
   *out << "</tr>"                                                 << std::endl;
   
+  printBroadcastHtml(out);
+
   ruParams_.printHtml("Configuration", out);
 
   {
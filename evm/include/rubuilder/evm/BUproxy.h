@@ -17,8 +17,10 @@
 #include "rubuilder/utils/EvBid.h"
 #include "rubuilder/utils/I2OMessages.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LatencyHistogram.h"
 #include "rubuilder/utils/OneToOneQueue.h"
 #include "rubuilder/utils/OneToOneQueueCollection.h"
+#include "rubuilder/utils/PerThreadCounters.h"
 #include "toolbox/mem/Reference.h"
 #include "xdaq/Application.h"
 #include "xdata/Boolean.h"
@@ -144,8 +146,7 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
     /**
      * Return the logical count of confirm messages sent to the BUs
      */
-    inline uint64_t getConfirmLogicalCount() const
-    { return confirmCounters_.logicalCount; }
+    uint64_t getConfirmLogicalCount() const;
 
     /**
      * Print monitoring/configuration as HTML snipped
@@ -192,8 +193,14 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
     log4cplus::Logger& logger_;
     uint32_t tid_;
 
-    typedef std::map<utils::EvBid,EoLSHandler::LumiSectionPair> EvBidMap;
+    struct AssignedEvent
+    {
+      EoLSHandler::LumiSectionPair lumiSection;
+      uint64_t assignTimeUSec;
+    };
+    typedef std::map<utils::EvBid,AssignedEvent> EvBidMap;
     EvBidMap evbIdMap_;
+    utils::LatencyRecorder assignToReleaseLatency_;
 
     typedef utils::OneToOneQueue<EventFifoElement> EventFIFO;
     EventFIFO eventFIFO_;
@@ -215,25 +222,35 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
       uint64_t payload;
       uint64_t logicalCount;
       uint64_t i2oCount;
-    } allocateClearCounters_;
-    boost::mutex allocateClearCountersMutex_;
+
+      AllocateClearCounters();
+      AllocateClearCounters& operator+=(const AllocateClearCounters&);
+    };
+    utils::PerThreadCounters<AllocateClearCounters> allocateClearCounters_;
 
     struct ConfirmCounters
     {
       uint64_t payload;
       uint64_t logicalCount;
       uint64_t i2oCount;
-      uint32_t lastEventNumberToBUs;
-    } confirmCounters_;
-    boost::mutex confirmCountersMutex_;
+
+      ConfirmCounters();
+      ConfirmCounters& operator+=(const ConfirmCounters&);
+    };
+    utils::PerThreadCounters<ConfirmCounters> confirmCounters_;
+
+    uint32_t lastEventNumberToBUsShared_;
 
     struct EoLSMonitoring
     {
       uint64_t payload;
       uint64_t msgCount;
       uint64_t i2oCount;
-    } EoLSMonitoring_;
-    boost::mutex EoLSMonitoringMutex_;
+
+      EoLSMonitoring();
+      EoLSMonitoring& operator+=(const EoLSMonitoring&);
+    };
+    utils::PerThreadCounters<EoLSMonitoring> EoLSMonitoring_;
     
     utils::InfoSpaceItems buParams_;
     xdata::UnsignedInteger32 eventFIFOCapacity_;
@@ -151,7 +151,7 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
     xdata::Double deltaT_;
     xdata::UnsignedInteger32 deltaN_;
     xdata::UnsignedInteger64 deltaSumOfSquares_;
-    xdata::UnsignedInteger32 deltaSumOfSizes_;
+    xdata::UnsignedInteger64 deltaSumOfSizes_;
 
     xdata::UnsignedInteger32 runNumber_;
     xdata::UnsignedInteger32 monitoringRunNumber_;
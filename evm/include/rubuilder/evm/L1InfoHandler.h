@@ -25,6 +25,7 @@
 #include "xdata/Vector.h"
 #include "xgi/Output.h"
 
+#include "rubuilder/evm/TriggerBitCounter.h"
 #include "rubuilder/utils/Constants.h"
 #include "rubuilder/utils/EventUtils.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
@@ -154,7 +155,8 @@ class EoLSHandler;
       uint32_t lumiSection,
       uint32_t previousLumiSection
     );
-    toolbox::mem::Reference* getNewL1Information();
+    utils::L1Information* getNewL1Information();
+    void fillL1InformationPool();
     void createL1ScalersInfoSpace();
     void initializeL1ScalersTable();
     void initializeNotificationReceiver();
@@ -170,8 +172,9 @@ class EoLSHandler;
     void processAllAvailableL1Infos();
     void addLumiSectionInfo(const utils::L1Information*);
     void addEventCounts(LumiSectionInfo*, const utils::L1Information*) const;
-    void addTriggerBits(LumiSectionInfo*, const utils::L1Information*) const;
-    void sumBits(const uint64_t& triggerBits, L1TriggerBitsArray& sums) const;
+    void addTriggerBits(LumiSectionInfo*, const utils::L1Information*);
+    void flushTriggerBits(LumiSectionInfo*);
+    void resetTriggerBits();
     void addSkippedLumiSectionsToFIFO(const LumiSectionInfo*);
 
     bool sendL1Scalers(toolbox::task::WorkLoop*);
@@ -188,10 +191,21 @@ class EoLSHandler;
     toolbox::task::WorkLoop* l1ScalersWL_;
     bool idle_;
     
-    typedef utils::OneToOneQueue<toolbox::mem::Reference*> L1InfoFIFO;
+    typedef utils::OneToOneQueue<utils::L1Information*> L1InfoFIFO;
     L1InfoFIFO l1InfoFIFO_;
     xdata::UnsignedInteger32 l1InfoFIFOCapacity_;
 
+    // Preallocated L1Information objects are recycled through the
+    // freeL1InfoFIFO from the L1Info workloop back to the EVM thread
+    typedef std::vector<utils::L1Information> L1InformationPool;
+    L1InformationPool l1InformationPool_;
+    L1InfoFIFO freeL1InfoFIFO_;
+    utils::L1Information* spareL1Info_;
+
+    // Reusable cursor to walk the reference chain of the trigger message
+    typedef std::vector<toolbox::mem::Reference*> ReferenceChain;
+    ReferenceChain trigMsgChain_;
+
     typedef utils::OneToOneQueue<toolbox::mem::Reference*> LumiSectionInfoFIFO;
     LumiSectionInfoFIFO lumiSectionInfoFIFO_;
     xdata::UnsignedInteger32 lumiSectionInfoFIFOCapacity_;
@@ -199,6 +213,9 @@ class EoLSHandler;
     uint32_t lastSeenLumiSection_;   
     toolbox::mem::Reference* currentLumiSectionInfo_;
     boost::mutex currentLumiSectionInfoMutex_;
+    TriggerBitCounter l1TechnicalCounter_;
+    TriggerBitCounter l1Decision_0_63Counter_;
+    TriggerBitCounter l1Decision_64_127Counter_;
 
     xdata::InfoSpace *l1ScalersInfoSpace_;
     utils::InfoSpaceItems l1ScalersParams_;
@@ -4,16 +4,20 @@
 #include <boost/thread/mutex.hpp>
 
 #include <stdint.h>
+#include <vector>
 
 #include "log4cplus/logger.h"
 
 #include "rubuilder/utils/EvBid.h"
 #include "rubuilder/utils/I2OMessages.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LatencyHistogram.h"
+#include "rubuilder/utils/PerThreadCounters.h"
 #include "rubuilder/utils/RUbroadcaster.h"
 #include "rubuilder/utils/TimerManager.h"
 #include "toolbox/mem/Reference.h"
 #include "xdaq/Application.h"
+#include "xdata/Boolean.h"
 #include "xdata/UnsignedInteger32.h"
 #include "xdata/UnsignedInteger64.h"
 #include "xgi/Output.h"
@@ -82,7 +86,8 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
     /**
      * Add the EvBid to the EvBids message for the RU.
      * If the msg packing 'I2O_RU_READOUT_Packing' is reached,
-     * send the message to the RUs.
+     * send the message to the RUs. If 'evbIdRangeEncoding' is
+     * set, consecutive EvBids are sent as ranges.
      */
     void addEvBid(const utils::EvBid&);
 
@@ -97,6 +102,7 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
     
     void sendEvBidsToAllRUs();
     uint32_t packEvBidsMsg(const utils::EvBid&);
+    uint32_t packEvBidRangesMsg(const utils::EvBid&);
     void createNewReadoutMsg();
     void updateCounters();
     
@@ -104,6 +110,10 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
     boost::mutex ruReadoutMutex_;
     size_t ruReadoutBufSize_;
 
+    // Time stamps of the EvBids in the message under construction
+    std::vector<uint64_t> evbIdTimeStamps_;
+    utils::LatencyRecorder triggerToBroadcastLatency_;
+
     utils::TimerManager timerManager_;
     const uint8_t timerId_;
 
@@ -112,13 +122,18 @@ namespace rubuilder { namespace evm { // namespace rubuilder::evm
       uint64_t msgCount;
       uint64_t payload;
       uint64_t i2oCount;
-      uint32_t lastEventNumberToRUs;
-    } ruMonitoring_;
-    boost::mutex ruMonitoringMutex_;
+
+      RUMonitoring();
+      RUMonitoring& operator+=(const RUMonitoring&);
+    };
+    utils::PerThreadCounters<RUMonitoring> ruMonitoring_;
+
+    uint32_t lastEventNumberToRUsShared_;
 
     utils::InfoSpaceItems ruParams_;
     xdata::UnsignedInteger32 I2O_RU_READOUT_Packing_;
     xdata::UnsignedInteger32 msgAgeLimitDtMSec_;
+    xdata::Boolean evbIdRangeEncoding_;
 
     xdata::UnsignedInteger32 lastEventNumberToRUs_;
     xdata::UnsignedInteger64 i2oRUReadoutCount_;
@@ -0,0 +1,97 @@
+#ifndef _rubuilder_evm_TriggerBitCounter_h_
+#define _rubuilder_evm_TriggerBitCounter_h_
+
+#include <stdint.h>
+
+
+namespace rubuilder { namespace evm { // namespace rubuilder::evm
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Bit-sliced counter for the 64 bits of a L1 trigger word
+   *
+   * The counts are kept as vertical counters: plane k holds bit k
+   * of all 64 per-bit counters. Adding a trigger word is a ripple-carry
+   * add over the planes, i.e. a handful of word operations instead
+   * of a branch per trigger bit. The planes overflow after 2^PLANES-1
+   * words and must be flushed into the scalers before that. The scalers
+   * of a lumi section are 32-bit, like its event count which bounds them.
+   */
+  class TriggerBitCounter
+  {
+  public:
+
+    TriggerBitCounter()
+    { reset(); }
+
+    /**
+     * Add the bits of the trigger word to the counters.
+     * Return true if the counter needs to be flushed.
+     */
+    inline bool add(const uint64_t triggerBits)
+    {
+      if (triggerBits == 0) return false;
+
+      uint64_t carry = triggerBits;
+      for (uint16_t k = 0; k < PLANES && carry; ++k)
+      {
+        const uint64_t overflow = planes_[k] & carry;
+        planes_[k] ^= carry;
+        carry = overflow;
+      }
+      return ( ++pending_ == CAPACITY );
+    }
+
+    /**
+     * Add the accumulated counts to the per-bit sums
+     * and reset the counter
+     */
+    template <class BitsArray>
+    void flush(BitsArray& sums)
+    {
+      if (pending_ == 0) return;
+
+      for (uint16_t k = 0; k < PLANES; ++k)
+      {
+        uint64_t plane = planes_[k];
+        while (plane)
+        {
+          sums[ __builtin_ctzll(plane) ] += (1U << k);
+          plane &= plane - 1;
+        }
+      }
+      reset();
+    }
+
+    /**
+     * Discard the accumulated counts
+     */
+    void reset()
+    {
+      for (uint16_t k = 0; k < PLANES; ++k)
+        planes_[k] = 0;
+      pending_ = 0;
+    }
+
+  private:
+
+    static const uint16_t PLANES = 8;
+    static const uint16_t CAPACITY = (1 << PLANES) - 1;
+
+    uint64_t planes_[PLANES];
+    uint16_t pending_;
+
+  }; // TriggerBitCounter
+
+} } // namespace rubuilder::evm
+
+
+#endif // _rubuilder_evm_TriggerBitCounter_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -131,36 +131,32 @@ void rubuilder::evm::Application::do_handleItemRetrieveEvent(const std::string&
 
 void rubuilder::evm::Application::bindI2oCallbacks()
 {
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::evm::Application::I2O_EVM_TRIGGER_Callback,
-      I2O_EVM_TRIGGER,
-      XDAQ_ORGANIZATION_ID
+      I2O_EVM_TRIGGER
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::evm::Application::I2O_EVM_TRIGGER_Callback,
-      I2O_EVMRU_DATA_READY,
-      XDAQ_ORGANIZATION_ID
+      I2O_EVMRU_DATA_READY
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::evm::Application::I2O_EVM_TRIGGER_Callback,
-      I2O_DATA_READY,
-      XDAQ_ORGANIZATION_ID
+      I2O_DATA_READY
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::evm::Application::I2O_EVM_ALLOCATE_CLEAR_Callback,
-      I2O_EVM_ALLOCATE_CLEAR,
-      XDAQ_ORGANIZATION_ID
+      I2O_EVM_ALLOCATE_CLEAR
     );
 }
 
@@ -3,7 +3,10 @@
 #include "interface/shared/i2oXFunctionCodes.h"
 #include "rubuilder/evm/BUproxy.h"
 #include "rubuilder/evm/EoLSHandler.h"
+#include "rubuilder/utils/Atomic.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xcept/Exception.h"
 #include "xcept/tools.h"
@@ -23,7 +26,8 @@ tid_(0),
 eventFIFO_("eventFIFO"),
 requestFIFOs_("requestFIFOs"),
 releasedEvbIdFIFO_("releasedEvbIdFIFO"),
-eolsFIFOs_("eolsFIFOs")
+eolsFIFOs_("eolsFIFOs"),
+assignToReleaseLatency_("assignToReleaseLatency")
 {
   resetMonitoringCounters();
   configure();
@@ -48,11 +52,11 @@ void rubuilder::evm::BUproxy::I2Ocallback(toolbox::mem::Reference* bufRef)
 
 void rubuilder::evm::BUproxy::updateAllocateClearCounters(const uint32_t& nbElements)
 {
-  boost::mutex::scoped_lock sl(allocateClearCountersMutex_);
+  AllocateClearCounters& allocateClearCounters = allocateClearCounters_.local();
 
-  allocateClearCounters_.payload += nbElements * sizeof(msg::EvtIdRqstAndOrRelease);
-  allocateClearCounters_.logicalCount += nbElements;
-  ++allocateClearCounters_.i2oCount;
+  allocateClearCounters.payload += nbElements * sizeof(msg::EvtIdRqstAndOrRelease);
+  allocateClearCounters.logicalCount += nbElements;
+  ++allocateClearCounters.i2oCount;
 }
 
 
@@ -125,7 +129,9 @@ bool rubuilder::evm::BUproxy::processNextReleasedEvent()
       << releasedEvtId;
     XCEPT_RAISE(exception::EventOrder,errorMsg.str());
   }
-  lumiSectionTable_.decrementEventsInRuBuilder(pos->second);
+  lumiSectionTable_.decrementEventsInRuBuilder(pos->second.lumiSection);
+  assignToReleaseLatency_.recordSince(pos->second.assignTimeUSec);
+  utils::getEventTracer().trace(releasedEvtId.evbId, utils::EventTracer::EVM_EVENT_RELEASED);
   evbIdMap_.erase(pos);
 
   return true;
@@ -138,7 +144,10 @@ void rubuilder::evm::BUproxy::addEvent(const EventFifoElement& event)
   ls.runNumber = event.runNumber;
   ls.lumiSection = event.lumiSection;
   lumiSectionTable_.incrementEventsInRuBuilder(ls);
-  if ( ! evbIdMap_.insert(EvBidMap::value_type(event.evbId,ls)).second )
+  AssignedEvent assignedEvent;
+  assignedEvent.lumiSection = ls;
+  assignedEvent.assignTimeUSec = utils::getMonotonicTimeUSec();
+  if ( ! evbIdMap_.insert(EvBidMap::value_type(event.evbId,assignedEvent)).second )
   {
     std::stringstream errorMsg;
     errorMsg << "Cannot add an event with an already existing evb id: "
@@ -197,6 +206,8 @@ bool rubuilder::evm::BUproxy::serviceBuRqst()
   block->lumiSection       = event.lumiSection;
   block->runNumber         = event.runNumber;
   block->buResourceId      = rqst.resourceId;
+
+  utils::getEventTracer().trace(event.evbId, utils::EventTracer::EVM_EVENT_ASSIGNED);
   
   xdaq::ApplicationDescriptor *bu = 0;
   try
@@ -215,14 +226,7 @@ bool rubuilder::evm::BUproxy::serviceBuRqst()
   
   try
   {
-    app_->getApplicationContext()->
-      postFrame(
-        event.trigBufRef,
-        app_->getApplicationDescriptor(),
-        bu//,
-        //i2oExceptionHandler_,
-        //bu
-      );
+    utils::postFrame(app_, event.trigBufRef, bu);
   }
   catch(xcept::Exception &e)
   {
@@ -243,13 +247,13 @@ void rubuilder::evm::BUproxy::updateConfirmCounters(const I2O_MESSAGE_FRAME* std
   I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME *block =
     (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)stdMsg;
 
-  boost::mutex::scoped_lock sl(confirmCountersMutex_);
+  ConfirmCounters& confirmCounters = confirmCounters_.local();
 
-  confirmCounters_.payload += (stdMsg->MessageSize << 2) -
+  confirmCounters.payload += (stdMsg->MessageSize << 2) -
     sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME);
-  ++confirmCounters_.logicalCount;
-  ++confirmCounters_.i2oCount;
-  confirmCounters_.lastEventNumberToBUs = block->eventNumber;
+  ++confirmCounters.logicalCount;
+  ++confirmCounters.i2oCount;
+  utils::storeRelaxed(lastEventNumberToBUsShared_, static_cast<uint32_t>(block->eventNumber));
 }
 
 
@@ -281,49 +285,95 @@ void rubuilder::evm::BUproxy::appendMonitoringItems(utils::InfoSpaceItems& items
   items.add("lastEventNumberToBUs", &lastEventNumberToBUs_);
   items.add("i2oEVMAllocClearCount", &i2oEVMAllocClearCount_);
   items.add("i2oBUConfirmLogicalCount", &i2oBUConfirmLogicalCount_);
+
+  assignToReleaseLatency_.appendMonitoringItems(items);
 }
 
 
 void rubuilder::evm::BUproxy::updateMonitoringItems()
 {
-  {
-    boost::mutex::scoped_lock sl(confirmCountersMutex_);
+  ConfirmCounters confirmCounters;
+  confirmCounters_.snapshot(confirmCounters);
 
-    lastEventNumberToBUs_ = confirmCounters_.lastEventNumberToBUs;
-    i2oBUConfirmLogicalCount_ = confirmCounters_.logicalCount;
-  }
-  
-  {
-    boost::mutex::scoped_lock sl(allocateClearCountersMutex_);
+  lastEventNumberToBUs_ = utils::loadRelaxed(lastEventNumberToBUsShared_);
+  i2oBUConfirmLogicalCount_ = confirmCounters.logicalCount;
 
-    i2oEVMAllocClearCount_ = allocateClearCounters_.logicalCount;
-  }
+  AllocateClearCounters allocateClearCounters;
+  allocateClearCounters_.snapshot(allocateClearCounters);
+
+  i2oEVMAllocClearCount_ = allocateClearCounters.logicalCount;
+
+  assignToReleaseLatency_.updateMonitoringItems();
 }
 
 
 void rubuilder::evm::BUproxy::resetMonitoringCounters()
 {
-  {
-    boost::mutex::scoped_lock sl(confirmCountersMutex_);
-    confirmCounters_.payload = 0;
-    confirmCounters_.logicalCount = 0;
-    confirmCounters_.i2oCount = 0;
-    confirmCounters_.lastEventNumberToBUs = 0;
-  }
+  confirmCounters_.reset();
+  utils::storeRelaxed(lastEventNumberToBUsShared_, 0U);
+  allocateClearCounters_.reset();
+  EoLSMonitoring_.reset();
 
-  {
-    boost::mutex::scoped_lock sl(allocateClearCountersMutex_);
-    allocateClearCounters_.payload = 0;
-    allocateClearCounters_.logicalCount = 0;
-    allocateClearCounters_.i2oCount = 0;
-  }
+  assignToReleaseLatency_.resetMonitoringCounters();
+}
 
-  {
-    boost::mutex::scoped_lock sl(EoLSMonitoringMutex_);
-    EoLSMonitoring_.payload = 0;
-    EoLSMonitoring_.msgCount = 0;
-    EoLSMonitoring_.i2oCount = 0;
-  }
+
+uint64_t rubuilder::evm::BUproxy::getConfirmLogicalCount() const
+{
+  ConfirmCounters confirmCounters;
+  confirmCounters_.snapshot(confirmCounters);
+  return confirmCounters.logicalCount;
+}
+
+
+rubuilder::evm::BUproxy::AllocateClearCounters::AllocateClearCounters() :
+payload(0),
+logicalCount(0),
+i2oCount(0)
+{}
+
+
+rubuilder::evm::BUproxy::AllocateClearCounters&
+rubuilder::evm::BUproxy::AllocateClearCounters::operator+=(const AllocateClearCounters& other)
+{
+  payload += other.payload;
+  logicalCount += other.logicalCount;
+  i2oCount += other.i2oCount;
+  return *this;
+}
+
+
+rubuilder::evm::BUproxy::ConfirmCounters::ConfirmCounters() :
+payload(0),
+logicalCount(0),
+i2oCount(0)
+{}
+
+
+rubuilder::evm::BUproxy::ConfirmCounters&
+rubuilder::evm::BUproxy::ConfirmCounters::operator+=(const ConfirmCounters& other)
+{
+  payload += other.payload;
+  logicalCount += other.logicalCount;
+  i2oCount += other.i2oCount;
+  return *this;
+}
+
+
+rubuilder::evm::BUproxy::EoLSMonitoring::EoLSMonitoring() :
+payload(0),
+msgCount(0),
+i2oCount(0)
+{}
+
+
+rubuilder::evm::BUproxy::EoLSMonitoring&
+rubuilder::evm::BUproxy::EoLSMonitoring::operator+=(const EoLSMonitoring& other)
+{
+  payload += other.payload;
+  msgCount += other.msgCount;
+  i2oCount += other.i2oCount;
+  return *this;
 }
 
 
@@ -367,65 +417,70 @@ void rubuilder::evm::BUproxy::printHtml(xgi::Output *out)
   *out << "<th colspan=\"2\">Monitoring</th>"                     << std::endl;
   *out << "</tr>"                                                 << std::endl;
 
+  ConfirmCounters confirmCounters;
+  confirmCounters_.snapshot(confirmCounters);
+  AllocateClearCounters allocateClearCounters;
+  allocateClearCounters_.snapshot(allocateClearCounters);
+  EoLSMonitoring eolsMonitoring;
+  EoLSMonitoring_.snapshot(eolsMonitoring);
+
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>last evt number to BUs</td>"                       << std::endl;
-  *out << "<td>" << confirmCounters_.lastEventNumberToBUs << "</td>" << std::endl;
+  *out << "<td>" << utils::loadRelaxed(lastEventNumberToBUsShared_) << "</td>" << std::endl;
   *out << "</tr>"                                                 << std::endl;
+  assignToReleaseLatency_.printHtml(out);
   *out << "<tr>"                                                  << std::endl;
   *out << "<td colspan=\"2\" style=\"text-align:center\">BU confirms</td>" << std::endl;
   *out << "</tr>"                                                 << std::endl;
 
   {
-    boost::mutex::scoped_lock sl(confirmCountersMutex_);
     *out << "<tr>"                                                << std::endl;
     *out << "<td>payload (MB)</td>"                               << std::endl;
-    *out << "<td>" << confirmCounters_.payload / 0x100000<< "</td>" << std::endl;
+    *out << "<td>" << confirmCounters.payload / 0x100000<< "</td>" << std::endl;
     *out << "</tr>"                                               << std::endl;
     *out << "<tr>"                                                << std::endl;
     *out << "<td>msg count</td>"                                  << std::endl;
-    *out << "<td>" << confirmCounters_.logicalCount << "</td>"    << std::endl;
+    *out << "<td>" << confirmCounters.logicalCount << "</td>"     << std::endl;
     *out << "</tr>"                                               << std::endl;
     *out << "<tr>"                                                << std::endl;
     *out << "<td>I2O count</td>"                                  << std::endl;
-    *out << "<td>" << confirmCounters_.i2oCount << "</td>"        << std::endl;
+    *out << "<td>" << confirmCounters.i2oCount << "</td>"         << std::endl;
     *out << "</tr>"                                               << std::endl;
   }
 
   {
-    boost::mutex::scoped_lock sl(allocateClearCountersMutex_);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td colspan=\"2\" style=\"text-align:center\">BU allocate/clears</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>payload (kB)</td>"                                << std::endl;
-    *out << "<td>" << allocateClearCounters_.payload / 0x400 << "</td>" << std::endl;
+    *out << "<td>" << allocateClearCounters.payload / 0x400 << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>msg count</td>"                                    << std::endl;
-    *out << "<td>" << allocateClearCounters_.logicalCount << "</td>" << std::endl;
+    *out << "<td>" << allocateClearCounters.logicalCount << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>I2O count</td>"                                    << std::endl;
-    *out << "<td>" << allocateClearCounters_.i2oCount << "</td>"    << std::endl;
+    *out << "<td>" << allocateClearCounters.i2oCount << "</td>"     << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
 
   {
-    boost::mutex::scoped_lock sl(EoLSMonitoringMutex_);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td colspan=\"2\" style=\"text-align:center\">EoLS msg</td>"      << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>payload (bytes)</td>"                              << std::endl;
-    *out << "<td>" << EoLSMonitoring_.payload << "</td>"            << std::endl;
+    *out << "<td>" << eolsMonitoring.payload << "</td>"             << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>msg count</td>"                                    << std::endl;
-    *out << "<td>" << EoLSMonitoring_.msgCount << "</td>"           << std::endl;
+    *out << "<td>" << eolsMonitoring.msgCount << "</td>"            << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>I2O count</td>"                                    << std::endl;
-    *out << "<td>" << EoLSMonitoring_.i2oCount << "</td>"           << std::endl;
+    *out << "<td>" << eolsMonitoring.i2oCount << "</td>"            << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
 
@@ -581,14 +636,7 @@ void rubuilder::evm::BUproxy::sendEoLStoBU
       i2o::utils::getAddressMap()->getApplicationDescriptor(rqstForEvtId.buTid);
     
     // Send the message to the BU
-    app_->getApplicationContext()->
-      postFrame(
-        bufRef,
-        app_->getApplicationDescriptor(),
-        bu//,
-        //i2oExceptionHandler_,
-        //bu
-      );
+    utils::postFrame(app_, bufRef, bu);
   }
   catch(xcept::Exception &e)
   {
@@ -607,10 +655,10 @@ void rubuilder::evm::BUproxy::sendEoLStoBU
   }
   
   {
-    boost::mutex::scoped_lock sl(EoLSMonitoringMutex_);
-    EoLSMonitoring_.payload += sizeof(I2O_EVM_END_OF_LUMISECTION_MESSAGE_FRAME);
-    ++EoLSMonitoring_.msgCount;
-    ++EoLSMonitoring_.i2oCount;
+    EoLSMonitoring& eolsMonitoring = EoLSMonitoring_.local();
+    eolsMonitoring.payload += sizeof(I2O_EVM_END_OF_LUMISECTION_MESSAGE_FRAME);
+    ++eolsMonitoring.msgCount;
+    ++eolsMonitoring.i2oCount;
   }
 }
 
@@ -5,8 +5,10 @@
 #include "rubuilder/evm/StateMachine.h"
 #include "rubuilder/evm/TRGproxy.h"
 #include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/Exception.h"
 #include "rubuilder/utils/I2OMessages.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 
@@ -181,6 +183,7 @@ bool rubuilder::evm::EVM::process(toolbox::task::WorkLoop *wl)
 
   try
   {
+    utils::getResourcePlacement().pinCurrentThread(wl->getName());
     while ( doProcessing_ && doWork() ) {};
   }
   catch(xcept::Exception &e)
@@ -240,6 +243,7 @@ bool rubuilder::evm::EVM::doWork()
     
     // Get the event-builder id
     utils::EvBid evbId = evbIdFactory_.getEvBid(trigMsg->eventNumber);
+    utils::getEventTracer().trace(evbId, utils::EventTracer::EVM_TRIGGER_RECEIVED);
     
     ruProxy_->addEvBid(evbId);
     uint32_t lumiSection = l1InfoHandler_->extractL1Info(trigBufRef, runNumber_);
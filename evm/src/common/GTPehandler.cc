@@ -11,9 +11,13 @@
 void rubuilder::evm::TRGproxyHandlers::GTPehandler::configure(const Configuration& conf)
 {
   orbitsPerLS_ = conf.orbitsPerLS;
+  // A fixed-size trigger FED is copied from a template, where only the
+  // event number and the L1 information are patched and the CRC is updated
+  const uint32_t nbTemplates = conf.dummyFedPayloadStdDev == 0 ? 1 : 0;
   superFragmentGenerator_.configure(
     conf.fedSourceIds, conf.usePlayback, conf.playbackDataFile,
-    conf.dummyBlockSize, conf.dummyFedPayloadSize, conf.dummyFedPayloadStdDev);
+    conf.dummyBlockSize, conf.dummyFedPayloadSize, conf.dummyFedPayloadStdDev,
+    0, utils::PoolConfiguration(), nbTemplates);
 }
 
 
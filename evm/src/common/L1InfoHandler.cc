@@ -31,10 +31,14 @@ logger_(app->getApplicationLogger()),
 rcmsNotifier_(logger_, app->getApplicationDescriptor(), app->getApplicationContext()),
 idle_(true),
 l1InfoFIFO_("l1InfoFIFO"),
+freeL1InfoFIFO_("freeL1InfoFIFO"),
+spareL1Info_(0),
 lumiSectionInfoFIFO_("lumiSectionInfoFIFO"),
 lastSeenLumiSection_(0),
 currentLumiSectionInfo_(0)
 {
+  trigMsgChain_.reserve(16);
+
   resetMonitoringCounters();
   createL1ScalersInfoSpace();
   initializeL1ScalersTable();
@@ -130,13 +134,12 @@ uint32_t rubuilder::evm::L1InfoHandler::extractL1Info
 {
   if ( ! enableL1Info_ ) return 0;
   
-  toolbox::mem::Reference* bufRef = getNewL1Information();
-  utils::L1Information* l1Info = (utils::L1Information*)bufRef->getDataLocation();
+  utils::L1Information* l1Info = getNewL1Information();
   if ( fillL1Info(trigMsg, l1Info) )
   {
     l1Info->runNumber = runNumber;
     verifyLumiSection(l1Info);
-    while ( ! l1InfoFIFO_.enq(bufRef) ) ::usleep(1000);
+    while ( ! l1InfoFIFO_.enq(l1Info) ) ::usleep(1000);
     return l1Info->lsNumber;
   }
   else
@@ -163,7 +166,9 @@ uint32_t rubuilder::evm::L1InfoHandler::extractL1Info
     #endif
 
     lastL1decodeError_ = l1Info->reason;
-    bufRef->release();
+    // Keep the object for the next trigger. Only the L1Info
+    // workloop may enqueue into the free FIFO.
+    spareL1Info_ = l1Info;
     return 0;
   }
 }
@@ -179,6 +184,7 @@ void rubuilder::evm::L1InfoHandler::enqCurrentLumiSectionInfo()
     boost::mutex::scoped_lock sl(currentLumiSectionInfoMutex_);
     if (currentLumiSectionInfo_)
     {
+      flushTriggerBits((LumiSectionInfo*)currentLumiSectionInfo_->getDataLocation());
       while ( ! lumiSectionInfoFIFO_.enq(currentLumiSectionInfo_) ) ::usleep(1000);
       currentLumiSectionInfo_ = 0;
     }
@@ -242,6 +248,30 @@ void rubuilder::evm::L1InfoHandler::configure()
   clear();
   l1InfoFIFO_.resize(l1InfoFIFOCapacity_);
   lumiSectionInfoFIFO_.resize(lumiSectionInfoFIFOCapacity_);
+  fillL1InformationPool();
+}
+
+
+void rubuilder::evm::L1InfoHandler::fillL1InformationPool()
+{
+  // All L1Information objects are back in the free FIFO
+  // once the l1InfoFIFO has been drained by clear()
+  utils::L1Information* l1Info;
+  while ( freeL1InfoFIFO_.deq(l1Info) ) {};
+  spareL1Info_ = 0;
+
+  // One more object than the l1InfoFIFO can hold is needed
+  // for the one being filled by extractL1Info
+  const uint32_t poolSize = l1InfoFIFOCapacity_ + 1;
+  l1InformationPool_.clear();
+  l1InformationPool_.resize(poolSize);
+  freeL1InfoFIFO_.resize(poolSize);
+
+  for (L1InformationPool::iterator it = l1InformationPool_.begin(),
+         itEnd = l1InformationPool_.end(); it != itEnd; ++it)
+  {
+    freeL1InfoFIFO_.enq( &(*it) );
+  }
 }
 
 
@@ -253,6 +283,7 @@ void rubuilder::evm::L1InfoHandler::clear()
 
   lastSeenLumiSection_ = 0;
   lastL1decodeError_.clear();
+  resetTriggerBits();
   
   runnumber_ = 0;
   lsnumber_  = 0;
@@ -333,18 +364,17 @@ bool rubuilder::evm::L1InfoHandler::fillL1Info
   utils::L1Information* l1Info
 )
 {
-  toolbox::mem::Reference* current = trigMsg;
-  std::list< toolbox::mem::Reference* > refList;
-  
-  while (current != 0)
+  // The chain is walked backwards starting from the last block.
+  // The cursor keeps its capacity, i.e. no allocation is done per event.
+  trigMsgChain_.clear();
+  for (toolbox::mem::Reference* current = trigMsg;
+       current != 0; current = current->getNextReference())
   {
-    refList.push_back( current );
-    current = current->getNextReference();
+    trigMsgChain_.push_back( current );
   }
   
-  std::list< toolbox::mem::Reference* >::reverse_iterator rit, ritEnd;
-  rit = refList.rbegin();
-  ritEnd = refList.rend();
+  ReferenceChain::const_reverse_iterator rit = trigMsgChain_.rbegin();
+  const ReferenceChain::const_reverse_iterator ritEnd = trigMsgChain_.rend();
   
   frlh_t* frlh = 0;            // holds the frl header of the current block
   fedt_t* trailer = 0;         // trailer of current fragment
@@ -594,11 +624,11 @@ bool rubuilder::evm::L1InfoHandler::processL1Info(toolbox::task::WorkLoop*)
 
 void rubuilder::evm::L1InfoHandler::processAllAvailableL1Infos()
 {
-  toolbox::mem::Reference* bufRef;
-  while ( l1InfoFIFO_.deq(bufRef) )
+  utils::L1Information* l1Info;
+  while ( l1InfoFIFO_.deq(l1Info) )
   {
-    addLumiSectionInfo((utils::L1Information*)bufRef->getDataLocation());
-    bufRef->release();
+    addLumiSectionInfo(l1Info);
+    while ( ! freeL1InfoFIFO_.enq(l1Info) ) ::usleep(1000);
   }
 }
 
@@ -681,31 +711,17 @@ void rubuilder::evm::L1InfoHandler::addSkippedLumiSectionsToFIFO(const LumiSecti
 }
 
 
-toolbox::mem::Reference* rubuilder::evm::L1InfoHandler::getNewL1Information()
+rubuilder::utils::L1Information* rubuilder::evm::L1InfoHandler::getNewL1Information()
 {
-  toolbox::mem::Reference* bufRef;
-  try
-  {
-    bufRef = toolbox::mem::getMemoryPoolFactory()->
-      getFrame(fastCtrlMsgPool_, sizeof(utils::L1Information));
-  }
-  catch(xcept::Exception &e)
-  {
-    XCEPT_RETHROW(exception::OutOfMemory,
-      "Failed to get buffer for L1 info", e);
-  }
-  catch(...)
-  {
-    XCEPT_RAISE(exception::OutOfMemory,
-      "Failed to get buffer for L1 info : Unknown exception");
-  }
-  
-  bufRef->setDataSize(sizeof(utils::L1Information));
-  
-  utils::L1Information* l1Info = (utils::L1Information*)bufRef->getDataLocation();
+  utils::L1Information* l1Info = spareL1Info_;
+  if ( l1Info )
+    spareL1Info_ = 0;
+  else
+    while ( ! freeL1InfoFIFO_.deq(l1Info) ) ::usleep(1000);
+
   l1Info->reset();
 
-  return bufRef;
+  return l1Info;
 }
 
 
@@ -729,6 +745,7 @@ void rubuilder::evm::L1InfoHandler::addLumiSectionInfo
     // the main thread receiving the trigger information.
     uint32_t lastLumiSectionNumber =
       ((LumiSectionInfo*)currentLumiSectionInfo_->getDataLocation())->lsNumber;
+    flushTriggerBits((LumiSectionInfo*)currentLumiSectionInfo_->getDataLocation());
     while ( ! lumiSectionInfoFIFO_.enq(currentLumiSectionInfo_) ) ::usleep(1000);
     
     currentLumiSectionInfo_ =
@@ -767,28 +784,32 @@ void rubuilder::evm::L1InfoHandler::addTriggerBits
 (
   LumiSectionInfo* lsInfo,
   const utils::L1Information* l1Info
-) const
+)
 {
-  sumBits(l1Info->l1Technical,       lsInfo->l1Technical);
-  sumBits(l1Info->l1Decision_0_63,   lsInfo->l1Decision_0_63);
-  sumBits(l1Info->l1Decision_64_127, lsInfo->l1Decision_64_127);
+  // The bit-sliced counters are flushed into the lumi-section scalers
+  // before they saturate, and whenever the lumi section is closed.
+  if ( l1TechnicalCounter_.add(l1Info->l1Technical) )
+    l1TechnicalCounter_.flush(lsInfo->l1Technical);
+  if ( l1Decision_0_63Counter_.add(l1Info->l1Decision_0_63) )
+    l1Decision_0_63Counter_.flush(lsInfo->l1Decision_0_63);
+  if ( l1Decision_64_127Counter_.add(l1Info->l1Decision_64_127) )
+    l1Decision_64_127Counter_.flush(lsInfo->l1Decision_64_127);
 }
 
 
-void rubuilder::evm::L1InfoHandler::sumBits
-(
-  const uint64_t& triggerBits,
-  L1TriggerBitsArray& sums
-) const
+void rubuilder::evm::L1InfoHandler::flushTriggerBits(LumiSectionInfo* lsInfo)
 {
-  if (triggerBits == 0) return;
-  
-  uint64_t mask = 1;
-  for (uint16_t i = 0; i < utils::TRIGGER_BITS_COUNT; ++i)
-  {
-    if (triggerBits & mask) ++(sums[i]);
-    mask <<= 1;
-  }
+  l1TechnicalCounter_.flush(lsInfo->l1Technical);
+  l1Decision_0_63Counter_.flush(lsInfo->l1Decision_0_63);
+  l1Decision_64_127Counter_.flush(lsInfo->l1Decision_64_127);
+}
+
+
+void rubuilder::evm::L1InfoHandler::resetTriggerBits()
+{
+  l1TechnicalCounter_.reset();
+  l1Decision_0_63Counter_.reset();
+  l1Decision_64_127Counter_.reset();
 }
 
 
@@ -2,11 +2,13 @@
 #include "i2o/utils/AddressMap.h"
 #include "interface/shared/i2oXFunctionCodes.h"
 #include "rubuilder/evm/RUproxy.h"
+#include "rubuilder/utils/Atomic.h"
 #include "rubuilder/utils/Constants.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xcept/tools.h"
 #include "xdaq/ApplicationDescriptor.h"
 
+#include <stddef.h>
 #include <string.h>
 
 
@@ -17,6 +19,7 @@ rubuilder::evm::RUproxy::RUproxy
 ) :
 RUbroadcaster(app,fastCtrlMsgPool),
 ruReadoutBufRef_(0),
+triggerToBroadcastLatency_("triggerToBroadcastLatency"),
 timerId_(timerManager_.getTimer())
 {
   resetMonitoringCounters();
@@ -27,10 +30,12 @@ void rubuilder::evm::RUproxy::appendConfigurationItems(utils::InfoSpaceItems& pa
 {
   I2O_RU_READOUT_Packing_ = 8;
   msgAgeLimitDtMSec_      = utils::DEFAULT_MESSAGE_AGE_LIMIT_MSEC;
+  evbIdRangeEncoding_     = false;
 
   ruParams_.clear();
   ruParams_.add("I2O_RU_READOUT_Packing", &I2O_RU_READOUT_Packing_);
   ruParams_.add("msgAgeLimitDtMSec", &msgAgeLimitDtMSec_);
+  ruParams_.add("evbIdRangeEncoding", &evbIdRangeEncoding_);
 
   initRuInstances(ruParams_);
 
@@ -47,35 +52,65 @@ void rubuilder::evm::RUproxy::appendMonitoringItems(utils::InfoSpaceItems& items
 
   items.add("lastEventNumberToRUs", &lastEventNumberToRUs_);
   items.add("i2oRUReadoutCount", &i2oRUReadoutCount_);
+
+  triggerToBroadcastLatency_.appendMonitoringItems(items);
 }
 
 
 void rubuilder::evm::RUproxy::updateMonitoringItems()
 {
-  boost::mutex::scoped_lock sl(ruMonitoringMutex_);
+  RUMonitoring ruMonitoring;
+  ruMonitoring_.snapshot(ruMonitoring);
+
+  lastEventNumberToRUs_ = utils::loadRelaxed(lastEventNumberToRUsShared_);
+  i2oRUReadoutCount_ = ruMonitoring.msgCount;
 
-  lastEventNumberToRUs_ = ruMonitoring_.lastEventNumberToRUs;
-  i2oRUReadoutCount_ = ruMonitoring_.msgCount;
+  triggerToBroadcastLatency_.updateMonitoringItems();
 }
 
 
 void rubuilder::evm::RUproxy::resetMonitoringCounters()
 {
-  boost::mutex::scoped_lock sl(ruMonitoringMutex_);
+  ruMonitoring_.reset();
+  utils::storeRelaxed(lastEventNumberToRUsShared_, 0U);
 
-  ruMonitoring_.lastEventNumberToRUs = 0;
-  ruMonitoring_.payload = 0;
-  ruMonitoring_.msgCount = 0;
-  ruMonitoring_.i2oCount = 0;
+  triggerToBroadcastLatency_.resetMonitoringCounters();
 }
 
+
+rubuilder::evm::RUproxy::RUMonitoring::RUMonitoring() :
+msgCount(0),
+payload(0),
+i2oCount(0)
+{}
+
+
+rubuilder::evm::RUproxy::RUMonitoring&
+rubuilder::evm::RUproxy::RUMonitoring::operator+=(const RUMonitoring& other)
+{
+  msgCount += other.msgCount;
+  payload += other.payload;
+  i2oCount += other.i2oCount;
+  return *this;
+}
+
+
 void rubuilder::evm::RUproxy::configure()
 {
-  ruReadoutBufSize_ = sizeof(msg::EvBidsMsg) -
-    sizeof(utils::EvBid) +
-    I2O_RU_READOUT_Packing_ * sizeof(utils::EvBid);
+  // The ranges layout needs one range per EvBid in the worst case
+  if ( evbIdRangeEncoding_ )
+    ruReadoutBufSize_ = sizeof(msg::EvBidRangesMsg) -
+      sizeof(msg::EvBidRange) +
+      I2O_RU_READOUT_Packing_ * sizeof(msg::EvBidRange);
+  else
+    ruReadoutBufSize_ = sizeof(msg::EvBidsMsg) -
+      sizeof(utils::EvBid) +
+      I2O_RU_READOUT_Packing_ * sizeof(utils::EvBid);
   
   timerManager_.initTimer(timerId_, msgAgeLimitDtMSec_);
+
+  evbIdTimeStamps_.clear();
+  evbIdTimeStamps_.reserve(I2O_RU_READOUT_Packing_);
 }
 
 
@@ -88,6 +123,7 @@ void rubuilder::evm::RUproxy::clear()
     ruReadoutBufRef_->release();
     ruReadoutBufRef_ = 0;
   }  
+  evbIdTimeStamps_.clear();
 }
 
 
@@ -101,28 +137,32 @@ void rubuilder::evm::RUproxy::printHtml(xgi::Output *out)
   *out << "</tr>"                                                 << std::endl;
 
   {
-    boost::mutex::scoped_lock sl(ruMonitoringMutex_);
+    RUMonitoring ruMonitoring;
+    ruMonitoring_.snapshot(ruMonitoring);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>last evt number to RUs</td>"                       << std::endl;
-    *out << "<td>" << ruMonitoring_.lastEventNumberToRUs << "</td>" << std::endl;
+    *out << "<td>" << utils::loadRelaxed(lastEventNumberToRUsShared_) << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
+    triggerToBroadcastLatency_.printHtml(out);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td colspan=\"2\" style=\"text-align:center\">RU readout</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>payload (kB)</td>"                                 << std::endl;
-    *out << "<td>" << ruMonitoring_.payload / 0x400<< "</td>"       << std::endl;
+    *out << "<td>" << ruMonitoring.payload / 0x400<< "</td>"        << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>msg count</td>"                                    << std::endl;
-    *out << "<td>" << ruMonitoring_.msgCount << "</td>"             << std::endl;
+    *out << "<td>" << ruMonitoring.msgCount << "</td>"              << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>I2O count</td>"                                    << std::endl;
-    *out << "<td>" << ruMonitoring_.i2oCount << "</td>"             << std::endl;
+    *out << "<td>" << ruMonitoring.i2oCount << "</td>"              << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
 
+  printBroadcastHtml(out);
+
   ruParams_.printHtml("Configuration", out);
 
   *out << "</table>"                                              << std::endl;
@@ -133,12 +173,15 @@ void rubuilder::evm::RUproxy::printHtml(xgi::Output *out)
 void rubuilder::evm::RUproxy::addEvBid(const rubuilder::utils::EvBid& evbId)
 {
   boost::mutex::scoped_lock sl(ruReadoutMutex_);
+
+  evbIdTimeStamps_.push_back( utils::getMonotonicTimeUSec() );
   
   // Pack the EvBid for the RUs into the EvBids message under construction
-  uint32_t nbElementsPacked = packEvBidsMsg(evbId);
+  const uint32_t nbEvBidsPacked = evbIdRangeEncoding_ ?
+    packEvBidRangesMsg(evbId) : packEvBidsMsg(evbId);
   
   // Send the EvBids message if it is full
-  if ( nbElementsPacked == I2O_RU_READOUT_Packing_ )
+  if ( nbEvBidsPacked == I2O_RU_READOUT_Packing_ )
   {
     sendEvBidsToAllRUs();
   }
@@ -166,10 +209,21 @@ bool rubuilder::evm::RUproxy::sendOldEvBids()
 
 void rubuilder::evm::RUproxy::sendEvBidsToAllRUs()
 {
-  sendToAllRUs(ruReadoutBufRef_, ruReadoutBufSize_);
+  const size_t headerSize = evbIdRangeEncoding_ ?
+    offsetof(msg::EvBidRangesMsg, elements) : offsetof(msg::EvBidsMsg, elements);
+  sendToAllRUs(ruReadoutBufRef_, ruReadoutBufSize_, headerSize);
 
   updateCounters();
 
+  // Latency from taking the trigger until its EvBid went out to the RUs
+  const uint64_t now = utils::getMonotonicTimeUSec();
+  for (std::vector<uint64_t>::const_iterator it = evbIdTimeStamps_.begin(),
+         itEnd = evbIdTimeStamps_.end(); it != itEnd; ++it)
+  {
+    triggerToBroadcastLatency_.record( now - *it );
+  }
+  evbIdTimeStamps_.clear();
+
   ///////////////////////////////////////////////
   // Free the EvBid message under construction //
   // (its copies were sent not it)             //
@@ -204,6 +258,47 @@ uint32_t rubuilder::evm::RUproxy::packEvBidsMsg(const rubuilder::utils::EvBid& e
   // Return the number of elements in the message
   return evbIdsMsg->nbElements;
 }
+
+
+uint32_t rubuilder::evm::RUproxy::packEvBidRangesMsg(const rubuilder::utils::EvBid& element)
+{
+  // Create an EvBid ranges message if one does not exist
+  if ( ruReadoutBufRef_ == 0 ) createNewReadoutMsg();
+
+  msg::EvBidRangesMsg* rangesMsg =
+    (msg::EvBidRangesMsg*)ruReadoutBufRef_->getDataLocation();
+
+  // Extend the last range if the EvBid follows it,
+  // otherwise start a new range
+  if ( rangesMsg->nbElements > 0 )
+  {
+    msg::EvBidRange& lastRange = rangesMsg->elements[rangesMsg->nbElements - 1];
+    if ( element.resyncCount() == lastRange.first.resyncCount() &&
+      element.eventNumber() == lastRange.first.eventNumber() + lastRange.count )
+    {
+      ++(lastRange.count);
+      return ++(rangesMsg->nbEvBids);
+    }
+  }
+
+  msg::EvBidRange& range = rangesMsg->elements[rangesMsg->nbElements];
+  range.first = element;
+  range.count = 1;
+  range.padding = 0;
+  ++(rangesMsg->nbElements);
+
+  // Calculate the size of the message with its new range
+  size_t msgSize = sizeof(msg::EvBidRangesMsg)
+    - sizeof(msg::EvBidRange) +
+    sizeof(msg::EvBidRange) * rangesMsg->nbElements;
+
+  // Store the message size in both the I2O header and the reference
+  rangesMsg->PvtMessageFrame.StdMessageFrame.MessageSize = msgSize >> 2;
+  ruReadoutBufRef_->setDataSize(msgSize);
+
+  // Return the number of EvBids in the message
+  return ++(rangesMsg->nbEvBids);
+}
     
 
 void rubuilder::evm::RUproxy::createNewReadoutMsg()
@@ -227,6 +322,18 @@ void rubuilder::evm::RUproxy::createNewReadoutMsg()
   pvtMsg->OrganizationID   = XDAQ_ORGANIZATION_ID;
   
   evbIdsMsg->nbElements = 0;
+
+  if ( evbIdRangeEncoding_ )
+  {
+    msg::EvBidRangesMsg* rangesMsg = (msg::EvBidRangesMsg*)evbIdsMsg;
+    rangesMsg->version = msg::EVBIDS_RANGES;
+    rangesMsg->nbEvBids = 0;
+    rangesMsg->padding = 0;
+  }
+  else
+  {
+    evbIdsMsg->version = msg::EVBIDS_LIST;
+  }
   
   // Start the aging timer
   timerManager_.restartTimer(timerId_);
@@ -235,15 +342,28 @@ void rubuilder::evm::RUproxy::createNewReadoutMsg()
 
 void rubuilder::evm::RUproxy::updateCounters()
 {
-  boost::mutex::scoped_lock sl(ruMonitoringMutex_);
+  RUMonitoring& ruMonitoring = ruMonitoring_.local();
 
-  msg::EvBidsMsg *evbIdsMsg =
-    (msg::EvBidsMsg*)ruReadoutBufRef_->getDataLocation();
-  ruMonitoring_.payload += evbIdsMsg->nbElements * sizeof(utils::EvBid);
-  ruMonitoring_.msgCount += evbIdsMsg->nbElements;
-  ruMonitoring_.i2oCount += participatingRUs_.size();
-  ruMonitoring_.lastEventNumberToRUs =
-    evbIdsMsg->elements[evbIdsMsg->nbElements - 1].eventNumber();
+  if ( evbIdRangeEncoding_ )
+  {
+    msg::EvBidRangesMsg *rangesMsg =
+      (msg::EvBidRangesMsg*)ruReadoutBufRef_->getDataLocation();
+    const msg::EvBidRange& lastRange = rangesMsg->elements[rangesMsg->nbElements - 1];
+    ruMonitoring.payload += rangesMsg->nbElements * sizeof(msg::EvBidRange);
+    ruMonitoring.msgCount += rangesMsg->nbEvBids;
+    utils::storeRelaxed(lastEventNumberToRUsShared_,
+      lastRange.first.eventNumber() + lastRange.count - 1);
+  }
+  else
+  {
+    msg::EvBidsMsg *evbIdsMsg =
+      (msg::EvBidsMsg*)ruReadoutBufRef_->getDataLocation();
+    ruMonitoring.payload += evbIdsMsg->nbElements * sizeof(utils::EvBid);
+    ruMonitoring.msgCount += evbIdsMsg->nbElements;
+    utils::storeRelaxed(lastEventNumberToRUsShared_,
+      evbIdsMsg->elements[evbIdsMsg->nbElements - 1].eventNumber());
+  }
+  ruMonitoring.i2oCount += participatingRUs_.size();
 }
 
 
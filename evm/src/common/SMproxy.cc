@@ -2,6 +2,7 @@
 #include "rubuilder/evm/EoLSHandler.h"
 #include "rubuilder/evm/SMproxy.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 
 
@@ -266,14 +267,7 @@ void rubuilder::evm::SMproxy::sendEoLSmsg(const I2O_EVM_END_OF_LUMISECTION_MESSA
     // Send the pairs message to the SM
     try
     {
-      app_->getApplicationContext()->
-        postFrame(
-          copyBufRef,
-          app_->getApplicationDescriptor(),
-          it->descriptor//,
-          //i2oExceptionHandler_,
-          //it->descriptor
-        );
+      utils::postFrame(app_, copyBufRef, it->descriptor);
     }
     catch(xcept::Exception &e)
     {
@@ -5,6 +5,7 @@
 #include "rubuilder/evm/TRGproxyHandlers.h"
 #include "rubuilder/utils/Constants.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 
 
@@ -204,14 +205,7 @@ void rubuilder::evm::TRGproxyHandlers::TAhandler::sendTrigCredits(const uint32_t
   
   try
   {
-    app_->getApplicationContext()->
-      postFrame(
-        bufRef,
-        app_->getApplicationDescriptor(),
-        ta_.descriptor// ,
-        // i2oExceptionHandler_,
-        // ta_.descriptor
-      );
+    utils::postFrame(app_, bufRef, ta_.descriptor);
   }
   catch(xcept::Exception &e)
   {
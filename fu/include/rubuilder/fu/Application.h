@@ -4,11 +4,13 @@
 #include "rubuilder/fu/FedSourceIdSet.h"
 #include "rubuilder/fu/SynchronizedString.h"
 #include "rubuilder/fu/exception/Exception.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "rubuilder/utils/WebUtils.h"
 #include "i2o/i2oDdmLib.h"
 #include "i2o/utils/AddressMap.h"
 #include "toolbox/BSem.h"
 #include "toolbox/fsm/FiniteStateMachine.h"
+#include "toolbox/math/random.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xdaq/ApplicationGroup.h"
 #include "xdaq/WebApplication.h"
@@ -19,7 +21,15 @@
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger32.h"
 
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <deque>
 #include <stdint.h>
+#include <vector>
 
 
 namespace rubuilder { namespace fu { // namespace rubuilder::fu
@@ -58,6 +68,11 @@ private:
      */
     toolbox::exception::HandlerSignature *i2oExceptionHandler_;
 
+    /**
+     * The I2O callbacks indexed by function code for the loopback transport.
+     */
+    rubuilder::utils::LoopbackTransport::Callbacks i2oCallbacks_;
+
     /**
      * The logger of this application.
      */
@@ -201,11 +216,6 @@ private:
     std::vector< std::pair<std::string, xdata::Serializable *> >
         dbgMonitorParams_;
 
-    /**
-     * The set of FED source ids of the current event.
-     */
-    FedSourceIdSet fedSourceIds_;
-
     /**
      * A history of the FED source ids which have been passed to the FU since
      * it was configured.
@@ -234,6 +244,45 @@ private:
      */
     xdata::UnsignedInteger32 nbOutstandingRqsts_;
 
+    /**
+     * Exported read/write parameter - Number of threads checking and
+     * processing the events received from the BU.
+     */
+    xdata::UnsignedInteger32 nbWorkerThreads_;
+
+    /**
+     * Exported read/write parameter - Minimum number of events requested
+     * with one I2O_BU_ALLOCATE message.  Fewer events are requested when
+     * the worker threads run out of events.
+     */
+    xdata::UnsignedInteger32 allocateBatchSize_;
+
+    /**
+     * Exported read/write parameter - Number of events a worker thread
+     * discards with one I2O_BU_DISCARD message.  Fewer events are discarded
+     * when the worker thread runs out of events.
+     */
+    xdata::UnsignedInteger32 discardBatchSize_;
+
+    /**
+     * Exported read/write parameter - Mean CPU time in micro seconds spent
+     * on each event to emulate the processing by a real FU.
+     */
+    xdata::UnsignedInteger32 eventCPUTimeUSec_;
+
+    /**
+     * Exported read/write parameter - Standard deviation of the log-normally
+     * distributed CPU time spent on each event.  The CPU time is constant
+     * if the standard deviation is 0.
+     */
+    xdata::UnsignedInteger32 eventCPUTimeStdDevUSec_;
+
+    /**
+     * Exported read/write parameter - Additional CPU time in micro seconds
+     * spent for each kB of event data.
+     */
+    xdata::Double eventCPUTimeUSecPerKB_;
+
     /**
      * Exported read-only parameter specifying whether or not the FU should
      * sleep between events.
@@ -261,6 +310,24 @@ private:
      */
     xdata::UnsignedInteger32 nbEventsBeforeExit_;
 
+    /**
+     * Exported read/write parameter specifying if I2O frames to and from
+     * applications in the same executive go through the loopback transport
+     */
+    xdata::Boolean i2oLoopback_;
+
+    /**
+     * Exported read/write parameter specifying the huge page size in KB
+     * backing the pool of the I2O messages.  A size of 0 uses the heap.
+     */
+    xdata::UnsignedInteger32 poolHugePageSizeKB_;
+
+    /**
+     * Exported read/write parameter specifying the size in MB pre-faulted
+     * at configure for a huge page backed pool of the I2O messages.
+     */
+    xdata::UnsignedInteger32 poolCommittedSizeMB_;
+
     /////////////////////////////////////////////////////////////
     // End of exported parameters used for configuration       //
     /////////////////////////////////////////////////////////////
@@ -378,19 +445,80 @@ private:
 
 
     /**
-     * Head of super-fragment under-construction.
+     * Head of event under-construction.
+     */
+    toolbox::mem::Reference *eventHead_;
+
+    /**
+     * Tail of event under-construction.
      */
-    toolbox::mem::Reference *superFragmentHead_;
+    toolbox::mem::Reference *eventTail_;
 
     /**
-     * Tail of super-fragment under-construction.
+     * A thread checking events, emulating their processing and returning
+     * them to the BU.
      */
-    toolbox::mem::Reference *superFragmentTail_;
+    struct Worker
+    {
+        /**
+         * The thread executing processEvents().
+         */
+        boost::shared_ptr<boost::thread> thread;
+
+        /**
+         * The set of FED source ids of the event being checked.
+         */
+        FedSourceIdSet fedSourceIds;
+
+        /**
+         * Draws the CPU time spent on an event, or 0 if it is constant.
+         */
+        boost::scoped_ptr<toolbox::math::LogNormalGen> cpuTimeGen;
+
+        /**
+         * The BU resource ids of the processed events not yet discarded.
+         */
+        std::vector<U32> buResourceIds;
+
+        Worker
+        (
+            const uint32_t seed,
+            const uint32_t cpuTimeUSec,
+            const uint32_t cpuTimeStdDevUSec
+        );
+    };
 
     /**
-     * Current block number of the super-fragment under construction.
+     * The worker threads running between configure and halt.
      */
-    unsigned int blockNb_;
+    std::vector< boost::shared_ptr<Worker> > workers_;
+
+    /**
+     * Protects the event queue, the running flag of the workers and the
+     * number of events to be allocated.
+     */
+    boost::mutex eventQueueMutex_;
+
+    /**
+     * Signals the worker threads that there is something to do.
+     */
+    boost::condition_variable eventQueueCondition_;
+
+    /**
+     * Complete events waiting for a worker thread.
+     */
+    std::deque<toolbox::mem::Reference*> eventQueue_;
+
+    /**
+     * Set to false to stop the worker threads.
+     */
+    bool workersRunning_;
+
+    /**
+     * Number of discarded events for which no new event has been requested
+     * from the BU yet.
+     */
+    uint32_t nbEventsToAllocate_;
 
     /**
      * Returns the name to be given to the logger of this application.
@@ -626,35 +754,99 @@ private:
 
     /**
      * Processes the specified data block.
+     *
+     * The block is appended to the event under construction, which is handed
+     * to the worker threads once complete.
      */
     void processDataBlock(toolbox::mem::Reference *bufRef)
     throw (rubuilder::fu::exception::Exception);
 
     /**
-     * Checks the payload sent by the TA.
+     * Appends the specified block to the end of the event under
+     * construction.
      */
-    void checkTAPayload(toolbox::mem::Reference *bufRef)
+    void appendBlockToEvent(toolbox::mem::Reference *bufRef);
+
+    /**
+     * Releases the memory used by the event under construction.
+     */
+    void releaseEvent();
+
+    /**
+     * Starts the worker threads.
+     */
+    void startWorkers();
+
+    /**
+     * Stops the worker threads and releases the events waiting for them.
+     */
+    void stopWorkers();
+
+    /**
+     * Body of a worker thread.
+     */
+    void processEvents(Worker *worker);
+
+    /**
+     * Checks the specified complete event, emulates its processing and
+     * releases it.
+     */
+    void processEvent(Worker *worker, toolbox::mem::Reference *event)
     throw (rubuilder::fu::exception::Exception);
 
     /**
-     * Checks the payload sent by a RUI.
+     * Spends the CPU time given by the configured model on an event with
+     * the specified amount of data.
      */
-    void checkRUIPayload(toolbox::mem::Reference *bufRef)
+    void emulateEventProcessing(Worker *worker, const size_t eventSize);
+
+    /**
+     * Discards the events processed by the specified worker and requests
+     * new events from the BU.  The new events are requested once
+     * allocateBatchSize events have been discarded, or if the worker is idle.
+     */
+    void discardEvents(Worker *worker, const bool idle)
     throw (rubuilder::fu::exception::Exception);
 
     /**
-     * Appends the specified block to the end of the super-fragment under
-     * construction.
+     * Records a fault in the event data and notifies the sentinel.
+     */
+    void reportEventDataFault
+    (
+        const std::string errorMessage,
+        xcept::Exception  &e
+    );
+
+    /**
+     * Checks the payload sent by the TA.
      */
-    void appendBlockToSuperFragment(toolbox::mem::Reference *bufRef);
+    void checkTAPayload(toolbox::mem::Reference *bufRef)
+    throw (rubuilder::fu::exception::Exception);
 
     /**
-     * Checks the current super-fragment under construction.
+     * Checks the payload sent by a RUI.
      *
-     * Note that the super-fragment under constrcution must be complete when
-     * this method is called.
+     * The expected block number of the current super-fragment is
+     * incremented, or reset to 0 at the end of the super-fragment.
      */
-    void checkSuperFragment()
+    void checkRUIPayload
+    (
+        toolbox::mem::Reference *bufRef,
+        unsigned int            &blockNb
+    )
+    throw (rubuilder::fu::exception::Exception);
+
+    /**
+     * Checks the specified complete super-fragment.
+     *
+     * The FED source ids found are added to the specified set of the
+     * current event.
+     */
+    void checkSuperFragment
+    (
+        toolbox::mem::Reference *superFragment,
+        FedSourceIdSet          &fedSourceIds
+    )
     throw (rubuilder::fu::exception::Exception);
 
     /**
@@ -692,15 +884,11 @@ private:
     void checkFedSourceIds
     (
         unsigned char* buf,
-        unsigned int len
+        unsigned int len,
+        FedSourceIdSet &fedSourceIds
     )
     throw (rubuilder::fu::exception::Exception);
 
-    /**
-     * Releases the memory used by the super-fragment under construction.
-     */
-    void releaseSuperFragment();
-
     /**
      * Creates and then sends an I2O_BU_ALLOCATE_MESSAGE_FRAME to the BU.
      */
@@ -724,12 +912,12 @@ private:
     /**
      * Creates and then sends an I2O_BU_DISCARD_MESSAGE_FRAME to the BU.
      */
-    void discardEvent(const U32 buResourceId)
+    void discardNEvents(const std::vector<U32> &buResourceIds)
     throw (rubuilder::fu::exception::Exception);
 
     /**
      * Returns a new I2O_BU_DISCARD_MESSAGE_FRAME representing a request to
-     * discard the event with the specified BU resource id.
+     * discard the events with the specified BU resource ids.
      */
     toolbox::mem::Reference *createBuDiscardMsg
     (
@@ -737,7 +925,7 @@ private:
         toolbox::mem::Pool              *pool,
         const I2O_TID                   taTid,
         const I2O_TID                   buTid,
-        const U32                       buResourceId
+        const std::vector<U32>          &buResourceIds
     )
     throw (rubuilder::fu::exception::Exception);
 
@@ -747,16 +935,6 @@ private:
      */
     std::string createI2oPoolName(const unsigned int  fuInstance);
 
-    /**
-     * Returns a "HeapAllocator" memory pool with the specified name.
-     */
-    toolbox::mem::Pool *createHeapAllocatorMemoryPool
-    (
-        toolbox::mem::MemoryPoolFactory *poolFactory,
-        const std::string               poolName
-    )
-    throw (rubuilder::fu::exception::Exception);
-
     /**
      * Returns the url of the specified application.
      */
@@ -10,11 +10,11 @@
 #include "rubuilder/fu/Constants.h"
 #include "rubuilder/fu/ForceFailedEvent.h"
 #include "rubuilder/fu/version.h"
-#include "rubuilder/utils/CRC16.h"
+#include "rubuilder/utils/CRC16Kernels.h"
+#include "rubuilder/utils/MemoryPools.h"
 #include "rubuilder/utils/XoapUtils.h"
 #include "toolbox/utils.h"
 #include "toolbox/fsm/FailedEvent.h"
-#include "toolbox/mem/HeapAllocator.h"
 #include "xcept/tools.h"
 #include "xdaq/NamespaceURI.h"
 #include "xdaq/exception/ApplicationNotFound.h"
@@ -30,9 +30,32 @@
 #include "xoap/SOAPEnvelope.h"
 
 #include <sstream>
+#include <time.h>
 #include <unistd.h>
 
 
+namespace
+{
+    uint64_t getThreadCPUTimeNSec()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    /**
+     * Keeps the calling thread busy until it has used the specified CPU time.
+     * Unlike sleeping, this occupies a core as a real FU would.
+     */
+    void burnCPUTime(const uint64_t cpuTimeNSec)
+    {
+        const uint64_t startNSec = getThreadCPUTimeNSec();
+
+        while((getThreadCPUTimeNSec() - startNSec) < cpuTimeNSec) {}
+    }
+}
+
+
 rubuilder::fu::Application::Application(xdaq::ApplicationStub *s)
 throw (xdaq::exception::Exception) :
 xdaq::WebApplication(s),
@@ -52,9 +75,8 @@ applicationBSem_(toolbox::BSem::FULL)
     xmlClass_          = appDescriptor_->getClassName();
     instance_          = appDescriptor_->getInstance();
     urn_               = appDescriptor_->getURN();
-    superFragmentHead_ = 0;
-    superFragmentTail_ = 0;
-    blockNb_           = 0;
+    eventHead_         = 0;
+    eventTail_         = 0;
     faultDetected_     = false;
 
     appDescriptor_->setAttribute("icon", APP_ICON);
@@ -70,24 +92,15 @@ applicationBSem_(toolbox::BSem::FULL)
         "onI2oException"
     );
 
-    i2oPoolName_ = createI2oPoolName(instance_);
-
-    try
-    {
-        i2oPool_ = createHeapAllocatorMemoryPool(poolFactory_, i2oPoolName_);
-    }
-    catch(xcept::Exception &e)
-    {
-        std::string s;
-
-        s = "Failed to create " + i2oPoolName_ + " pool";
-
-        XCEPT_RETHROW(xdaq::exception::Exception, s, e);
-    }
+    // The pool is chosen when configuring
+    i2oPool_ = 0;
 
     buDescriptor_ = 0;
     buTid_        = 0;
 
+    workersRunning_     = false;
+    nbEventsToAllocate_ = 0;
+
     try
     {
         defineFsm();
@@ -309,12 +322,21 @@ rubuilder::fu::Application::initAndGetStdConfigParams()
     std::vector< std::pair<std::string, xdata::Serializable*> > params;
 
 
-    buClass_            = "rubuilder::bu::Application";
-    buInstNb_           = 0;
-    nbOutstandingRqsts_ = 80;
-    sleepBetweenEvents_ = false;
-    sleepIntervalUSec_  = 1000; // 1 millisecond
-    nbEventsBeforeExit_ = 0;
+    buClass_                = "rubuilder::bu::Application";
+    buInstNb_               = 0;
+    nbOutstandingRqsts_     = 80;
+    nbWorkerThreads_        = 1;
+    allocateBatchSize_      = 1;
+    discardBatchSize_       = 1;
+    eventCPUTimeUSec_       = 0;
+    eventCPUTimeStdDevUSec_ = 0;
+    eventCPUTimeUSecPerKB_  = 0;
+    sleepBetweenEvents_     = false;
+    sleepIntervalUSec_      = 1000; // 1 millisecond
+    nbEventsBeforeExit_     = 0;
+    i2oLoopback_            = false;
+    poolHugePageSizeKB_     = 0;
+    poolCommittedSizeMB_    = 0;
 
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("buClass", &buClass_));
@@ -322,12 +344,30 @@ rubuilder::fu::Application::initAndGetStdConfigParams()
         ("buInstNb", &buInstNb_));
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("nbOutstandingRqsts", &nbOutstandingRqsts_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("nbWorkerThreads", &nbWorkerThreads_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("allocateBatchSize", &allocateBatchSize_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("discardBatchSize", &discardBatchSize_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("eventCPUTimeUSec", &eventCPUTimeUSec_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("eventCPUTimeStdDevUSec", &eventCPUTimeStdDevUSec_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("eventCPUTimeUSecPerKB", &eventCPUTimeUSecPerKB_));
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("sleepBetweenEvents", &sleepBetweenEvents_));
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("sleepIntervalUSec" , &sleepIntervalUSec_));
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("nbEventsBeforeExit", &nbEventsBeforeExit_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("i2oLoopback", &i2oLoopback_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("poolHugePageSizeKB", &poolHugePageSizeKB_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("poolCommittedSizeMB", &poolCommittedSizeMB_));
 
     return params;
 }
@@ -797,16 +837,36 @@ void rubuilder::fu::Application::configureAction
 )
 throw (toolbox::fsm::exception::Exception)
 {
-    releaseSuperFragment();
-
-    // Reset the current block number of the super-fragment under-construction.
-    blockNb_ = 0;
+    stopWorkers();
+    releaseEvent();
 
     // Clean start
     faultDetected_ = false;
     faultDescription_.setValue("");
     fedSourceIdHistory_.clear();
-    fedSourceIds_.clear();
+
+    if(nbWorkerThreads_.value_ == 0 || allocateBatchSize_.value_ == 0 ||
+        discardBatchSize_.value_ == 0)
+    {
+        XCEPT_RAISE(toolbox::fsm::exception::Exception,
+            "nbWorkerThreads, allocateBatchSize and discardBatchSize"
+            " must be at least 1");
+    }
+
+    try
+    {
+        rubuilder::utils::PoolConfiguration poolConfiguration;
+        poolConfiguration.hugePageSizeKB = poolHugePageSizeKB_.value_;
+        poolConfiguration.committedSizeMB = poolCommittedSizeMB_.value_;
+
+        i2oPool_ = rubuilder::utils::getMemoryPool(createI2oPoolName(instance_),
+            poolConfiguration, i2oPoolName_);
+    }
+    catch(xcept::Exception &e)
+    {
+        XCEPT_RETHROW(toolbox::fsm::exception::Exception,
+            "Failed to get the memory pool for the I2O messages", e);
+    }
 
     try
     {
@@ -847,6 +907,13 @@ throw (toolbox::fsm::exception::Exception)
 
         XCEPT_RAISE(toolbox::fsm::exception::Exception, oss.str());
     }
+
+    startWorkers();
+
+    if ( i2oLoopback_ )
+        rubuilder::utils::getLoopbackTransport().bind(appDescriptor_, i2oCallbacks_, logger_);
+    else
+        rubuilder::utils::getLoopbackTransport().unbind(appDescriptor_);
 }
 
 
@@ -877,7 +944,8 @@ void rubuilder::fu::Application::haltAction
 )
 throw (toolbox::fsm::exception::Exception)
 {
-    // Do nothing
+    stopWorkers();
+    releaseEvent();
 }
 
 
@@ -960,6 +1028,11 @@ void rubuilder::fu::Application::bindI2oCallbacks()
         I2O_EVM_LUMISECTION,
         XDAQ_ORGANIZATION_ID
     );
+
+    i2oCallbacks_[I2O_FU_TAKE] =
+        boost::bind(&rubuilder::fu::Application::I2O_FU_TAKE_Callback, this, _1);
+    i2oCallbacks_[I2O_EVM_LUMISECTION] =
+        boost::bind(&rubuilder::fu::Application::I2O_EVM_LUMISECTION_Callback, this, _1);
 }
 
 
@@ -1286,8 +1359,9 @@ void rubuilder::fu::Application::I2O_FU_TAKE_Callback
 {
     applicationBSem_.take();
 
-    toolbox::fsm::State     state = fsm_.getCurrentState();
-    toolbox::mem::Reference *next = 0;
+    toolbox::fsm::State     state         = fsm_.getCurrentState();
+    toolbox::mem::Reference *next         = 0;
+    bool                    faultDetected = false;
 
 
     switch(state)
@@ -1298,7 +1372,11 @@ void rubuilder::fu::Application::I2O_FU_TAKE_Callback
         break;
     case 'R': // Ready
     case 'E': // Enabled
-        if(faultDetected_)
+        monitoringInfoSpace_->lock(); appInfoSpace_->lock();
+        faultDetected = faultDetected_.value_;
+        monitoringInfoSpace_->unlock(); appInfoSpace_->unlock();
+
+        if(faultDetected)
         {
             bufRef->release();
         }
@@ -1364,7 +1442,6 @@ throw (rubuilder::fu::exception::Exception)
         block->blockNb == (block->nbBlocksInSuperFragment-1);
     bool blockIsLastOfEvent =
         superFragmentIsLastOfEvent && blockIsLastOfSuperFragment;
-    U32 buResourceId = block->buResourceId;
 
     // Update parameters showing message payloads and counts
     monitoringInfoSpace_->lock(); appInfoSpace_->lock();
@@ -1381,155 +1458,411 @@ throw (rubuilder::fu::exception::Exception)
     nbSuperFragmentsInEvent_ = block->nbSuperFragmentsInEvent;
     monitoringInfoSpace_->unlock(); appInfoSpace_->unlock();
 
-    // Check block as an individual
-    try
+    appendBlockToEvent(bufRef);
+
+    if(blockIsLastOfEvent)
     {
-        if(block->superFragmentNb == 0)
-        {
-            checkTAPayload(bufRef);
-        }
-        else
+        // Hand the complete event to the worker threads
         {
-            checkRUIPayload(bufRef);
+            boost::mutex::scoped_lock sl(eventQueueMutex_);
+            eventQueue_.push_back(eventHead_);
         }
+        eventQueueCondition_.notify_one();
+
+        eventHead_ = 0;
+        eventTail_ = 0;
     }
-    catch(xcept::Exception &e)
+}
+
+
+void rubuilder::fu::Application::appendBlockToEvent
+(
+    toolbox::mem::Reference *bufRef
+)
+{
+    if(eventHead_ == 0)
+    {
+        eventHead_ = bufRef;
+        eventTail_ = bufRef;
+    }
+    else
     {
-	std::string errorMessage = "Invalid block";
+        eventTail_->setNextReference(bufRef);
+        eventTail_ = bufRef;
+    }
+}
 
-        faultDetected_ = true;
-        faultDescription_.setValue(errorMessage);
 
-        LOG4CPLUS_ERROR(logger_, errorMessage << " : " 
-			<< xcept::stdformat_exception_history(e));
+void rubuilder::fu::Application::releaseEvent()
+{
+    if(eventHead_ != 0)
+    {
+        eventHead_->release();
+
+        eventHead_ = 0;
+        eventTail_ = 0;
+    }
+}
 
-        // Notify the sentinel
-        XCEPT_DECLARE(rubuilder::fu::exception::Exception, sentinelException,
-        errorMessage);
-        this->notifyQualified("error", sentinelException);
+
+void rubuilder::fu::Application::startWorkers()
+{
+    {
+        boost::mutex::scoped_lock sl(eventQueueMutex_);
+        workersRunning_     = true;
+        nbEventsToAllocate_ = 0;
+    }
+
+    for(unsigned int i=0; i<nbWorkerThreads_.value_; i++)
+    {
+        boost::shared_ptr<Worker> worker(new Worker
+        (
+            time(0) + i,
+            eventCPUTimeUSec_.value_,
+            eventCPUTimeStdDevUSec_.value_
+        ));
+
+        worker->thread.reset(new boost::thread(boost::bind(
+            &rubuilder::fu::Application::processEvents, this, worker.get())));
+
+        workers_.push_back(worker);
+    }
+}
+
+
+void rubuilder::fu::Application::stopWorkers()
+{
+    std::deque<toolbox::mem::Reference*> events;
+
+    {
+        boost::mutex::scoped_lock sl(eventQueueMutex_);
+        workersRunning_ = false;
+    }
+    eventQueueCondition_.notify_all();
+
+    std::vector< boost::shared_ptr<Worker> >::const_iterator itor;
+
+    for(itor=workers_.begin(); itor!=workers_.end(); itor++)
+    {
+        (*itor)->thread->join();
+    }
+    workers_.clear();
+
+    {
+        boost::mutex::scoped_lock sl(eventQueueMutex_);
+        events.swap(eventQueue_);
+        nbEventsToAllocate_ = 0;
+    }
+
+    while(!events.empty())
+    {
+        events.front()->release();
+        events.pop_front();
     }
+}
 
-    appendBlockToSuperFragment(bufRef);
 
-    if(blockIsLastOfSuperFragment)
+void rubuilder::fu::Application::processEvents(Worker *worker)
+{
+    while(true)
     {
+        toolbox::mem::Reference *event = 0;
+
+        {
+            boost::mutex::scoped_lock sl(eventQueueMutex_);
+
+            // Sleep until there is an event, or a batch to be completed
+            while(workersRunning_ && eventQueue_.empty() &&
+                worker->buResourceIds.empty() && nbEventsToAllocate_ == 0)
+            {
+                eventQueueCondition_.wait(sl);
+            }
+
+            if(!workersRunning_) return;
+
+            if(!eventQueue_.empty())
+            {
+                event = eventQueue_.front();
+                eventQueue_.pop_front();
+            }
+        }
+
         try
         {
-            checkSuperFragment();
+            if(event != 0)
+            {
+                processEvent(worker, event);
+
+                if(worker->buResourceIds.size() >= discardBatchSize_.value_)
+                {
+                    discardEvents(worker, false);
+                }
+            }
+            else
+            {
+                // Do not keep events from the BU while waiting for more
+                discardEvents(worker, true);
+            }
         }
         catch(xcept::Exception &e)
         {
-	    std::string errorMessage = "Invalid super-fragment";
+            LOG4CPLUS_ERROR(logger_,
+                "Failed to process event : "
+                << xcept::stdformat_exception_history(e));
+        }
+    }
+}
 
-            faultDetected_ = true;
-            faultDescription_.setValue(errorMessage);
 
-            LOG4CPLUS_ERROR(logger_, errorMessage << " : " 
-			<< xcept::stdformat_exception_history(e));
+void rubuilder::fu::Application::processEvent
+(
+    Worker                  *worker,
+    toolbox::mem::Reference *event
+)
+throw (rubuilder::fu::exception::Exception)
+{
+    I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME *block =
+        (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)event->getDataLocation();
+    U32                     buResourceId       = block->buResourceId;
+    toolbox::mem::Reference *bufRef            = event;
+    toolbox::mem::Reference *next              = 0;
+    toolbox::mem::Reference *superFragmentHead = 0;
+    toolbox::mem::Reference *superFragmentTail = 0;
+    unsigned int            blockNb            = 0;
+    size_t                  eventSize          = 0;
+    uint32_t                nbEventsProcessed  = 0;
+
+
+    // Break the event into its super-fragments and check each of them
+    while(bufRef != 0)
+    {
+        next = bufRef->getNextReference();
+        bufRef->setNextReference(0);
 
-            // Notify the sentinel
-            XCEPT_DECLARE(rubuilder::fu::exception::Exception,
-                sentinelException, errorMessage);
-            this->notifyQualified("error", sentinelException);
-        }
+        block = (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)bufRef->getDataLocation();
+        eventSize += bufRef->getDataSize() -
+            sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME);
 
+        // Check block as an individual
         try
         {
-            releaseSuperFragment();
+            if(block->superFragmentNb == 0)
+            {
+                checkTAPayload(bufRef);
+            }
+            else
+            {
+                checkRUIPayload(bufRef, blockNb);
+            }
         }
         catch(xcept::Exception &e)
         {
-            std::stringstream oss;
+            reportEventDataFault("Invalid block", e);
+        }
 
-            oss << "Failed to release super-fragment with";
-            oss << " BU resource id: " << buResourceId;
+        if(superFragmentHead == 0)
+        {
+            superFragmentHead = bufRef;
+            superFragmentTail = bufRef;
+        }
+        else
+        {
+            superFragmentTail->setNextReference(bufRef);
+            superFragmentTail = bufRef;
+        }
 
-            XCEPT_RETHROW(rubuilder::fu::exception::Exception, oss.str(), e);
+        if(block->blockNb == (block->nbBlocksInSuperFragment - 1))
+        {
+            try
+            {
+                checkSuperFragment(superFragmentHead, worker->fedSourceIds);
+            }
+            catch(xcept::Exception &e)
+            {
+                reportEventDataFault("Invalid super-fragment", e);
+            }
+
+            superFragmentHead->release();
+            superFragmentHead = 0;
+            superFragmentTail = 0;
         }
+
+        bufRef = next;
     }
 
-    if(blockIsLastOfEvent)
+    // An incomplete last super-fragment has already been reported
+    if(superFragmentHead != 0)
     {
-        nbEventsProcessed_.value_++;
+        superFragmentHead->release();
+    }
 
-        // Reset FED source IDs ready for next event
-        fedSourceIds_.clear();
+    // Reset FED source IDs ready for next event
+    worker->fedSourceIds.clear();
+
+    monitoringInfoSpace_->lock(); appInfoSpace_->lock();
+    nbEventsProcessed = ++nbEventsProcessed_.value_;
+    monitoringInfoSpace_->unlock(); appInfoSpace_->unlock();
 
-        // If FU is to emulate a crash
-        if(nbEventsBeforeExit_.value_ > 0)
+    // If FU is to emulate a crash
+    if(nbEventsBeforeExit_.value_ > 0)
+    {
+        if(nbEventsProcessed == nbEventsBeforeExit_.value_)
         {
-            if(nbEventsProcessed_.value_ == nbEventsBeforeExit_.value_)
-            {
-                std::stringstream oss;
+            std::stringstream oss;
 
-                oss << "Emulating crash after " << nbEventsBeforeExit_;
-                oss << " events";
+            oss << "Emulating crash after " << nbEventsBeforeExit_;
+            oss << " events";
 
-                LOG4CPLUS_FATAL(logger_, oss.str());
-                exit(-1);
-            }
+            LOG4CPLUS_FATAL(logger_, oss.str());
+            exit(-1);
         }
+    }
 
-        if(sleepBetweenEvents_.value_)
-        {
-            ::usleep(sleepIntervalUSec_.value_);
-        }
+    emulateEventProcessing(worker, eventSize);
 
+    worker->buResourceIds.push_back(buResourceId);
+}
+
+
+void rubuilder::fu::Application::emulateEventProcessing
+(
+    Worker       *worker,
+    const size_t eventSize
+)
+{
+    double cpuTimeUSec = eventCPUTimeUSec_.value_;
+
+    if(worker->cpuTimeGen)
+    {
+        cpuTimeUSec = worker->cpuTimeGen->getRawRandomSize();
+    }
+
+    cpuTimeUSec += eventCPUTimeUSecPerKB_.value_ * eventSize / 1024;
+
+    if(cpuTimeUSec > 0)
+    {
+        burnCPUTime(static_cast<uint64_t>(cpuTimeUSec * 1000));
+    }
+
+    if(sleepBetweenEvents_.value_)
+    {
+        ::usleep(sleepIntervalUSec_.value_);
+    }
+}
+
+
+void rubuilder::fu::Application::discardEvents
+(
+    Worker     *worker,
+    const bool idle
+)
+throw (rubuilder::fu::exception::Exception)
+{
+    const uint32_t nbEventsDiscarded  = worker->buResourceIds.size();
+    uint32_t       nbEventsToAllocate = 0;
+
+
+    if(nbEventsDiscarded > 0)
+    {
         try
         {
-            discardEvent(buResourceId);
+            discardNEvents(worker->buResourceIds);
         }
         catch(xcept::Exception &e)
         {
             std::stringstream oss;
 
-            oss << "Failed to discard event with";
-            oss << " BU resource id: " << buResourceId;
+            oss << "Failed to discard " << nbEventsDiscarded << " events";
+
+            worker->buResourceIds.clear();
 
             XCEPT_RETHROW(rubuilder::fu::exception::Exception, oss.str(), e);
         }
 
+        worker->buResourceIds.clear();
+    }
+
+    {
+        boost::mutex::scoped_lock sl(eventQueueMutex_);
+
+        nbEventsToAllocate_ += nbEventsDiscarded;
+
+        if(idle || nbEventsToAllocate_ >= allocateBatchSize_.value_)
+        {
+            nbEventsToAllocate  = nbEventsToAllocate_;
+            nbEventsToAllocate_ = 0;
+        }
+    }
+
+    if(nbEventsToAllocate > 0)
+    {
         try
         {
-            allocateNEvents(1);
+            allocateNEvents(nbEventsToAllocate);
         }
         catch(xcept::Exception &e)
         {
-            XCEPT_RETHROW(rubuilder::fu::exception::Exception,
-                "Failed to allocate an event", e);
+            std::stringstream oss;
+
+            oss << "Failed to allocate " << nbEventsToAllocate << " events";
+
+            XCEPT_RETHROW(rubuilder::fu::exception::Exception, oss.str(), e);
         }
     }
 }
 
 
-void rubuilder::fu::Application::appendBlockToSuperFragment
+void rubuilder::fu::Application::reportEventDataFault
 (
-    toolbox::mem::Reference *bufRef
+    const std::string errorMessage,
+    xcept::Exception  &e
 )
 {
-    if(superFragmentHead_ == 0)
-    {
-        superFragmentHead_ = bufRef;
-        superFragmentTail_ = bufRef;
-    }
-    else
+    monitoringInfoSpace_->lock(); appInfoSpace_->lock();
+    faultDetected_ = true;
+    monitoringInfoSpace_->unlock(); appInfoSpace_->unlock();
+
+    faultDescription_.setValue(errorMessage);
+
+    LOG4CPLUS_ERROR(logger_, errorMessage << " : "
+        << xcept::stdformat_exception_history(e));
+
+    // Notify the sentinel
+    XCEPT_DECLARE(rubuilder::fu::exception::Exception, sentinelException,
+        errorMessage);
+    this->notifyQualified("error", sentinelException);
+}
+
+
+rubuilder::fu::Application::Worker::Worker
+(
+    const uint32_t seed,
+    const uint32_t cpuTimeUSec,
+    const uint32_t cpuTimeStdDevUSec
+)
+{
+    if(cpuTimeUSec > 0 && cpuTimeStdDevUSec > 0)
     {
-        superFragmentTail_->setNextReference(bufRef);
-        superFragmentTail_ = bufRef;
+        cpuTimeGen.reset(new toolbox::math::LogNormalGen
+            (seed, cpuTimeUSec, cpuTimeStdDevUSec));
     }
 }
 
 
-void rubuilder::fu::Application::checkSuperFragment()
+void rubuilder::fu::Application::checkSuperFragment
+(
+    toolbox::mem::Reference *superFragment,
+    FedSourceIdSet          &fedSourceIds
+)
 throw (rubuilder::fu::exception::Exception)
 {
-    unsigned int len  = getSumOfFedData(superFragmentHead_);
+    unsigned int len  = getSumOfFedData(superFragment);
     unsigned char* buf = new unsigned char[len];
 
 
     try
     {
-        fillBufferWithSuperFragment(buf, len, superFragmentHead_);
+        fillBufferWithSuperFragment(buf, len, superFragment);
     }
     catch(xcept::Exception &e)
     {
@@ -1549,7 +1882,7 @@ throw (rubuilder::fu::exception::Exception)
 
     try
     {
-        checkFedSourceIds(buf, len);
+        checkFedSourceIds(buf, len, fedSourceIds);
     }
     catch(xcept::Exception &e)
     {
@@ -1691,7 +2024,7 @@ throw (rubuilder::fu::exception::Exception)
         const uint32_t conscheck = fedTrailer->conscheck;
         const uint32_t crc = FED_CRCS_EXTRACT(fedTrailer->conscheck);
         fedTrailer->conscheck = 0;
-        const uint32_t crcChk = evf::compute_crc(fedHeaderAddr, fedSize);
+        const uint32_t crcChk = rubuilder::utils::computeFedCRC(fedHeaderAddr, fedSize);
         if (crc != crcChk) {
             std::ostringstream oss;
             oss << "crc check failed for fedid:" << fedId <<
@@ -1721,7 +2054,8 @@ throw (rubuilder::fu::exception::Exception)
 void rubuilder::fu::Application::checkFedSourceIds
 (
     unsigned char* buf,
-    unsigned int len
+    unsigned int len,
+    FedSourceIdSet &fedSourceIds
 )
 throw (rubuilder::fu::exception::Exception)
 {
@@ -1765,7 +2099,7 @@ throw (rubuilder::fu::exception::Exception)
         fedSourceIdHistory_.insert(fedSourceId);
 
         // Check for duplicate FED source ID
-        if(!fedSourceIds_.insert(fedSourceId))
+        if(!fedSourceIds.insert(fedSourceId))
         {
             std::stringstream oss;
             uint32_t eventid = FED_LVL1_EXTRACT(fedHeader->eventid);
@@ -1793,18 +2127,6 @@ throw (rubuilder::fu::exception::Exception)
 }
 
 
-void rubuilder::fu::Application::releaseSuperFragment()
-{
-    if(superFragmentHead_ != 0)
-    {
-        superFragmentHead_->release();
-
-        superFragmentHead_ = 0;
-        superFragmentTail_ = 0;
-    }
-}
-
-
 void rubuilder::fu::Application::checkTAPayload
 (
     toolbox::mem::Reference *bufRef
@@ -1919,7 +2241,8 @@ throw (rubuilder::fu::exception::Exception)
 
 void rubuilder::fu::Application::checkRUIPayload
 (
-    toolbox::mem::Reference *bufRef
+    toolbox::mem::Reference *bufRef,
+    unsigned int            &blockNb
 )
 throw (rubuilder::fu::exception::Exception)
 {
@@ -1960,12 +2283,12 @@ throw (rubuilder::fu::exception::Exception)
         XCEPT_RAISE(rubuilder::fu::exception::Exception, oss.str());
     }
 
-    if(block->blockNb != blockNb_)
+    if(block->blockNb != blockNb)
     {
         std::stringstream oss;
 
         oss << "Incorrect block number.";
-        oss << " Expected: " << blockNb_;
+        oss << " Expected: " << blockNb;
         oss << " Received: " << block->blockNb;
 
         XCEPT_RAISE(rubuilder::fu::exception::Exception, oss.str());
@@ -2008,11 +2331,11 @@ throw (rubuilder::fu::exception::Exception)
     // If end of super-fragment
     if(block->blockNb == (block->nbBlocksInSuperFragment - 1))
     {
-        blockNb_ = 0;
+        blockNb = 0;
     }
     else
     {
-        blockNb_++;
+        blockNb++;
     }
 }
 
@@ -2041,14 +2364,18 @@ throw (rubuilder::fu::exception::Exception)
 
     try
     {
-        appContext_->postFrame
-        (
-            bufRef,
-            appDescriptor_,
-            buDescriptor_,
-            i2oExceptionHandler_,
-            buDescriptor_
-        );
+        if ( ! rubuilder::utils::getLoopbackTransport().postFrame
+             (bufRef, appDescriptor_, buDescriptor_) )
+        {
+            appContext_->postFrame
+            (
+                bufRef,
+                appDescriptor_,
+                buDescriptor_,
+                i2oExceptionHandler_,
+                buDescriptor_
+            );
+        }
     }
     catch(xcept::Exception &e)
     {
@@ -2120,9 +2447,9 @@ throw (rubuilder::fu::exception::Exception)
 }
 
 
-void rubuilder::fu::Application::discardEvent
+void rubuilder::fu::Application::discardNEvents
 (
-    const U32 buResourceId
+    const std::vector<U32> &buResourceIds
 )
 throw (rubuilder::fu::exception::Exception)
 {
@@ -2132,26 +2459,30 @@ throw (rubuilder::fu::exception::Exception)
         i2oPool_,
         tid_,
         buTid_,
-        buResourceId
+        buResourceIds
     );
 
     // Update parameters showing message payloads and counts
     monitoringInfoSpace_->lock(); appInfoSpace_->lock();
-    I2O_BU_DISCARD_Payload_.value_ += sizeof(U32);
-    I2O_BU_DISCARD_LogicalCount_.value_++;
+    I2O_BU_DISCARD_Payload_.value_ += buResourceIds.size() * sizeof(U32);
+    I2O_BU_DISCARD_LogicalCount_.value_ += buResourceIds.size();
     I2O_BU_DISCARD_I2oCount_.value_++;
     monitoringInfoSpace_->unlock(); appInfoSpace_->unlock();
 
     try
     {
-        appContext_->postFrame
-        (
-            bufRef,
-            appDescriptor_,
-            buDescriptor_,
-            i2oExceptionHandler_,
-            buDescriptor_
-        );
+        if ( ! rubuilder::utils::getLoopbackTransport().postFrame
+             (bufRef, appDescriptor_, buDescriptor_) )
+        {
+            appContext_->postFrame
+            (
+                bufRef,
+                appDescriptor_,
+                buDescriptor_,
+                i2oExceptionHandler_,
+                buDescriptor_
+            );
+        }
     }
     catch(xcept::Exception &e)
     {
@@ -2171,7 +2502,7 @@ toolbox::mem::Reference *rubuilder::fu::Application::createBuDiscardMsg
     toolbox::mem::Pool              *pool,
     const I2O_TID                   taTid,
     const I2O_TID                   buTid,
-    const U32                       buResourceId
+    const std::vector<U32>          &buResourceIds
 )
 throw (rubuilder::fu::exception::Exception)
 {
@@ -2182,7 +2513,8 @@ throw (rubuilder::fu::exception::Exception)
     size_t                        msgSize = 0;
 
 
-    msgSize = sizeof(I2O_BU_DISCARD_MESSAGE_FRAME);
+    msgSize = sizeof(I2O_BU_DISCARD_MESSAGE_FRAME) +
+             (buResourceIds.size() - 1) * sizeof(U32);
 
     try
     {
@@ -2209,44 +2541,16 @@ throw (rubuilder::fu::exception::Exception)
     pvtMsg->XFunctionCode    = I2O_BU_DISCARD;
     pvtMsg->OrganizationID   = XDAQ_ORGANIZATION_ID;
 
-    // It is possible to discard more than one event at a time, hence the
-    // reason for the array of BU resource ids
-    msg->n                   = 1;
-    msg->buResourceId[0]     = buResourceId;
-
-    return bufRef;
-}
-
-
-toolbox::mem::Pool
-*rubuilder::fu::Application::createHeapAllocatorMemoryPool
-(
-    toolbox::mem::MemoryPoolFactory *poolFactory,
-    const std::string               poolName
-)
-throw (rubuilder::fu::exception::Exception)
-{
-    try
-    {
-        toolbox::net::URN urn("toolbox-mem-pool", poolName);
-        toolbox::mem::HeapAllocator* a = new toolbox::mem::HeapAllocator();
-        toolbox::mem::Pool *pool = poolFactory->createPool(urn, a);
+    // Discard all the events in one message, hence the reason for the array
+    // of BU resource ids
+    msg->n                   = buResourceIds.size();
 
-        return pool;
-    }
-    catch(xcept::Exception &e)
+    for(size_t i=0; i<buResourceIds.size(); i++)
     {
-        std::string s = "Failed to create pool: " + poolName;
-
-        XCEPT_RETHROW(rubuilder::fu::exception::Exception, s, e);
+        msg->buResourceId[i] = buResourceIds[i];
     }
-    catch(...)
-    {
-        std::string s = "Failed to create pool: " + poolName +
-                   " : Unknown exception";
 
-        XCEPT_RAISE(rubuilder::fu::exception::Exception, s);
-    }
+    return bufRef;
 }
 
 
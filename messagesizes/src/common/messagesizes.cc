@@ -1,4 +1,5 @@
 #include "interface/evb/i2oEVBMsgs.h"
+#include "rubuilder/utils/I2OMessages.h"
 
 #include <iostream>
 #include <stdint.h>
@@ -68,5 +69,49 @@ int main(int argv, char **argc)
   std::cout << sizeof(RqstForFragsMsg);
   std::cout << std::endl;
 
+  std::cout << std::endl;
+
+  std::cout << "rubuilder::msg::EvBidsMsg          = ";
+  std::cout << sizeof(rubuilder::msg::EvBidsMsg);
+  std::cout << std::endl;
+
+  std::cout << "rubuilder::msg::EvBidRange         = ";
+  std::cout << sizeof(rubuilder::msg::EvBidRange);
+  std::cout << std::endl;
+
+  std::cout << "rubuilder::msg::EvBidRangesMsg     = ";
+  std::cout << sizeof(rubuilder::msg::EvBidRangesMsg);
+  std::cout << std::endl;
+
+  std::cout << "rubuilder::msg::RqstForFragsMsg    = ";
+  std::cout << sizeof(rubuilder::msg::RqstForFragsMsg);
+  std::cout << std::endl;
+
+  std::cout << "rubuilder::msg::RqstForFragRange   = ";
+  std::cout << sizeof(rubuilder::msg::RqstForFragRange);
+  std::cout << std::endl;
+
+  std::cout << "rubuilder::msg::RqstForFragRangesMsg = ";
+  std::cout << sizeof(rubuilder::msg::RqstForFragRangesMsg);
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "EVM to RU message for N consecutive EvBids" << std::endl;
+  std::cout << "       N    EvBidsMsg  EvBidRangesMsg    saved" << std::endl;
+
+  const size_t listHeader =
+    sizeof(rubuilder::msg::EvBidsMsg) - sizeof(rubuilder::utils::EvBid);
+  const size_t rangesMsgSize = sizeof(rubuilder::msg::EvBidRangesMsg);
+
+  for (uint32_t nbEvBids = 1; nbEvBids <= 1024; nbEvBids *= 4)
+  {
+    const size_t listMsgSize = listHeader + nbEvBids * sizeof(rubuilder::utils::EvBid);
+    std::cout.width(8);  std::cout << nbEvBids;
+    std::cout.width(13); std::cout << listMsgSize;
+    std::cout.width(16); std::cout << rangesMsgSize;
+    std::cout.width(9);  std::cout << static_cast<long>(listMsgSize) - static_cast<long>(rangesMsgSize);
+    std::cout << std::endl;
+  }
+
   return 0;
 }
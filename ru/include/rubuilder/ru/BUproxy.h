@@ -1,6 +1,7 @@
 #ifndef _rubuilder_ru_BUproxy_h_
 #define _rubuilder_ru_BUproxy_h_
 
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include <stdint.h>
@@ -12,6 +13,7 @@
 #include "rubuilder/ru/SuperFragmentTable.h"
 #include "rubuilder/utils/I2OMessages.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/PerThreadCounters.h"
 #include "toolbox/mem/Reference.h"
 #include "xdaq/Application.h"
 #include "xdaq/ApplicationDescriptor.h"
@@ -91,8 +93,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
      * Return the logical number of I2O_BU_CACHE messages
      * received since the last call to resetMonitoringCounters
      */
-    uint64_t i2oBUCacheCount() const
-    { return dataMonitoring_.logicalCount; }
+    uint64_t i2oBUCacheCount() const;
   
     /**
      * Print monitoring/configuration as HTML snipped
@@ -103,9 +104,22 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
   private:
     
     void updateRequestCounters(const msg::RqstForFragsMsg*);
-    void handleRequest(const msg::RqstForFragsMsg*);
+    void handleRequest(const msg::RqstForFragsMsg*, const msg::RqstForFrag* elements);
+    void updateRequestCounters(const msg::RqstForFragRangesMsg*);
+    void handleRequest(const msg::RqstForFragRangesMsg*, const msg::RqstForFragRange* elements);
     void getBuInstances();
 
+    struct BUMonitoring
+    {
+      uint64_t logicalCount;
+      uint64_t payload;
+
+      BUMonitoring();
+      BUMonitoring& operator+=(const BUMonitoring&);
+    };
+    typedef utils::PerThreadCounters<BUMonitoring> BUCounters;
+    BUCounters& getBUCounters(const uint32_t buInstance);
+
     xdaq::Application* app_;
     log4cplus::Logger& logger_;
     SuperFragmentTablePtr superFragmentTable_;
@@ -115,25 +129,35 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     BUInstances buInstances_;
     boost::mutex buInstancesMutex_;
 
-    typedef std::map<uint32_t,uint64_t> CountsPerBU;
+    // Indexed by the BU instance. It grows when configuring, but never
+    // shrinks, as the threads keep pointers to their counter slots.
+    typedef boost::shared_ptr<BUCounters> BUCountersPtr;
+    typedef std::vector<BUCountersPtr> BUCountersPerInstance;
+    BUCountersPerInstance buCounters_;
+
     struct RequestMonitoring
     {
       uint64_t logicalCount;
       uint64_t payload;
       uint64_t i2oCount;
-      CountsPerBU logicalCountPerBU;
-    } requestMonitoring_;
-    boost::mutex requestMonitoringMutex_;
+
+      RequestMonitoring();
+      RequestMonitoring& operator+=(const RequestMonitoring&);
+    };
+    utils::PerThreadCounters<RequestMonitoring> requestMonitoring_;
 
     struct DataMonitoring
     {
-      uint32_t lastEventNumberToBUs;
       uint64_t logicalCount;
       uint64_t payload;
       uint64_t i2oCount;
-      CountsPerBU payloadPerBU;
-    } dataMonitoring_;
-    boost::mutex dataMonitoringMutex_;
+
+      DataMonitoring();
+      DataMonitoring& operator+=(const DataMonitoring&);
+    };
+    utils::PerThreadCounters<DataMonitoring> dataMonitoring_;
+
+    uint32_t lastEventNumberToBUsShared_;
 
     xdata::UnsignedInteger32 lastEventNumberToBUs_;
     xdata::UnsignedInteger32 nbSuperFragmentsReady_;
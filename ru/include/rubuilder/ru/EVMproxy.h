@@ -98,8 +98,10 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
 
   private:
     
-    void updateReadoutCounters(const msg::EvBidsMsg*);
-    void handleReadoutMsg(const msg::EvBidsMsg*);
+    void updateReadoutCounters(const msg::EvBidsMsg*, const utils::EvBid* elements);
+    void handleReadoutMsg(const msg::EvBidsMsg*, const utils::EvBid* elements);
+    void updateReadoutCounters(const msg::EvBidRangesMsg*, const msg::EvBidRange* elements);
+    void handleReadoutMsg(const msg::EvBidRangesMsg*, const msg::EvBidRange* elements);
 
     xdaq::Application* app_;
     log4cplus::Logger& logger_;
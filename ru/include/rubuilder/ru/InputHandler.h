@@ -10,9 +10,12 @@
 
 #include "i2o/shared/i2omsg.h"
 #include "rubuilder/ru/SuperFragment.h"
+#include "rubuilder/utils/Atomic.h"
 #include "rubuilder/utils/EvBid.h"
 #include "rubuilder/utils/EvBidFactory.h"
+#include "rubuilder/utils/MemoryPools.h"
 #include "rubuilder/utils/OneToOneQueue.h"
+#include "rubuilder/utils/PerThreadCounters.h"
 #include "rubuilder/utils/SuperFragmentGenerator.h"
 #include "toolbox/mem/Pool.h"
 #include "toolbox/mem/Reference.h"
@@ -29,7 +32,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
   public:
 
     InputHandler(xdaq::Application* app) :
-    app_(app) {};
+    app_(app), lastEventNumberShared_(0) {};
 
     virtual ~InputHandler() {};
     
@@ -54,9 +57,11 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
       uint32_t dummyBlockSize;
       uint32_t dummyFedPayloadSize;
       uint32_t dummyFedPayloadStdDev;
+      uint32_t nbFragmentTemplates;
       xdata::Vector<xdata::UnsignedInteger32> fedSourceIds;
       bool usePlayback;
       std::string playbackDataFile;
+      utils::PoolConfiguration poolConfiguration;
     };
     virtual void configure(const Configuration&) {};
     
@@ -79,26 +84,26 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
      * Return the last event number seen
      */
     inline uint32_t lastEventNumber() const
-    { return inputMonitoring_.lastEventNumber; }
+    { return utils::loadRelaxed(lastEventNumberShared_); }
     
     /**
      * Return the number of received event fragments
      * since the last call to resetMonitoringCounters
      */
     inline uint64_t fragmentsCount() const
-    { return inputMonitoring_.logicalCount; }
+    {
+      InputMonitoring inputMonitoring;
+      inputMonitoring_.snapshot(inputMonitoring);
+      return inputMonitoring.logicalCount;
+    }
     
     /**
      * Reset the monitoring counters
      */
     inline void resetMonitoringCounters()
     {
-      boost::mutex::scoped_lock sl(inputMonitoringMutex_);
-      
-      inputMonitoring_.payload = 0;
-      inputMonitoring_.logicalCount = 0;
-      inputMonitoring_.i2oCount = 0;
-      inputMonitoring_.lastEventNumber = 0;
+      inputMonitoring_.reset();
+      utils::storeRelaxed(lastEventNumberShared_, 0U);
     }
 
   protected:
@@ -110,9 +115,21 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
       uint64_t logicalCount;
       uint64_t payload;
       uint64_t i2oCount;
-      uint32_t lastEventNumber;
-    } inputMonitoring_;
-    boost::mutex inputMonitoringMutex_;
+
+      InputMonitoring() :
+      logicalCount(0), payload(0), i2oCount(0) {}
+
+      InputMonitoring& operator+=(const InputMonitoring& other)
+      {
+        logicalCount += other.logicalCount;
+        payload += other.payload;
+        i2oCount += other.i2oCount;
+        return *this;
+      }
+    };
+    utils::PerThreadCounters<InputMonitoring> inputMonitoring_;
+
+    uint32_t lastEventNumberShared_;
   };
 
 
@@ -152,7 +169,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
   public:
     
     FEROLproxy(xdaq::Application*);
-    virtual ~FEROLproxy() {};
+    virtual ~FEROLproxy();
 
     virtual void I2Ocallback(toolbox::mem::Reference*);
     virtual bool getData(const utils::EvBid&, toolbox::mem::Reference*&);
@@ -171,6 +188,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     typedef std::map<utils::EvBid,SuperFragmentPtr> SuperFragmentMap;
     SuperFragmentMap superFragmentMap_;
     toolbox::mem::Pool* superFragmentPool_;
+    std::string poolName_;
     
     typedef std::map<uint16_t,utils::EvBidFactory> EvBidFactories;
     EvBidFactories evbIdFactories_;
@@ -187,7 +205,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
   public:
     
     FEROL2proxy(xdaq::Application*);
-    virtual ~FEROL2proxy() {};
+    virtual ~FEROL2proxy();
 
     virtual void I2Ocallback(toolbox::mem::Reference*);
     virtual bool getData(const utils::EvBid&, toolbox::mem::Reference*&);
@@ -207,6 +225,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     
     SuperFragment::FEDlist fedList_;
     toolbox::mem::Pool* superFragmentPool_;
+    std::string poolName_;
     
     typedef std::map<uint16_t,utils::EvBidFactory> EvBidFactories;
     EvBidFactories evbIdFactories_;
@@ -8,6 +8,7 @@
 
 #include "rubuilder/ru/SuperFragmentTable.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LatencyHistogram.h"
 #include "rubuilder/utils/PerformanceMonitor.h"
 #include "rubuilder/utils/TimerManager.h"
 #include "toolbox/lang/Class.h"
@@ -132,6 +133,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
 
     utils::TimerManager timerManager_;
     const uint8_t timerId_;
+    utils::LatencyRecorder pairingLatency_;
 
     struct SuperFragmentMonitoring
     {
@@ -148,7 +150,7 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     xdata::Double deltaT_;
     xdata::UnsignedInteger32 deltaN_;
     xdata::UnsignedInteger64 deltaSumOfSquares_;
-    xdata::UnsignedInteger32 deltaSumOfSizes_;
+    xdata::UnsignedInteger64 deltaSumOfSizes_;
 
     xdata::UnsignedInteger32 runNumber_;
     xdata::Integer32 maxPairAgeMSec_;
@@ -138,7 +138,10 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     xdata::UnsignedInteger32 dummyBlockSize_;
     xdata::UnsignedInteger32 dummyFedPayloadSize_;
     xdata::UnsignedInteger32 dummyFedPayloadStdDev_;
+    xdata::UnsignedInteger32 nbFragmentTemplates_;
     xdata::Vector<xdata::UnsignedInteger32> fedSourceIds_;
+    xdata::UnsignedInteger32 poolHugePageSizeKB_;
+    xdata::UnsignedInteger32 poolCommittedSizeMB_;
 
     xdata::UnsignedInteger32 lastEventNumberFromRUI_;
     xdata::UnsignedInteger64 i2oEVMRUDataReadyCount_;
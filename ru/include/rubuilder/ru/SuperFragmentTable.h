@@ -52,6 +52,12 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
      */
     void addRequest(const Request&);
 
+    /**
+     * Add count BU requests for consecutive event numbers and
+     * BU resource ids, starting with the given request
+     */
+    void addRequests(const Request& first, const uint32_t count);
+
     /**
      * Remove all data
      */
@@ -66,6 +72,18 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     
   private:
 
+    // Requests for consecutive event numbers and BU resource ids
+    struct RequestRange
+    {
+      Request first;
+      uint32_t count;
+    };
+
+    static bool isInRange(const utils::EvBid&, const RequestRange&);
+    static Request getRequest(const RequestRange&, const uint32_t offset);
+    void checkRequestsAreNew(const RequestRange&);
+    void storeRequests(const RequestRange&, const uint32_t offset, const uint32_t count);
+    void insertRequests(const RequestRange&);
     void dataReady(const Request&, toolbox::mem::Reference*);
 
     boost::shared_ptr<BUproxy> buProxy_;
@@ -74,8 +92,8 @@ namespace rubuilder { namespace ru { // namespace rubuilder::ru
     typedef std::map<utils::EvBid,toolbox::mem::Reference*> Data;
     Data data_;
 
-    // Lookup table of requests, indexed by event id
-    typedef std::map<utils::EvBid,Request> Requests;
+    // Lookup table of request ranges, indexed by the event id of the first request
+    typedef std::map<utils::EvBid,RequestRange> Requests;
     Requests requests_;
 
     boost::mutex mutex_;
@@ -113,44 +113,39 @@ void rubuilder::ru::Application::do_handleItemRetrieveEvent(const std::string& i
 
 void rubuilder::ru::Application::bindI2oCallbacks()
 {
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::ru::Application::I2O_RU_READOUT_Callback,
-      I2O_RU_READOUT,
-      XDAQ_ORGANIZATION_ID
+      I2O_RU_READOUT
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::ru::Application::I2O_EVMRU_DATA_READY_Callback,
-      I2O_DATA_READY,
-      XDAQ_ORGANIZATION_ID
+      I2O_DATA_READY
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::ru::Application::I2O_EVMRU_DATA_READY_Callback,
-      I2O_EVMRU_DATA_READY,
-      XDAQ_ORGANIZATION_ID
+      I2O_EVMRU_DATA_READY
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::ru::Application::I2O_RU_SEND_Callback,
-      I2O_RU_SEND,
-      XDAQ_ORGANIZATION_ID
+      I2O_RU_SEND
     );
   
-  i2o::bind
+  bindI2oCallback
     (
       this,
       &rubuilder::ru::Application::I2O_DATA_READY_Callback,
-      I2O_DATA_READY,
-      XDAQ_ORGANIZATION_ID
+      I2O_DATA_READY
     );
 }
 
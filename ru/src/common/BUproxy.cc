@@ -3,7 +3,10 @@
 #include "interface/evb/i2oEVBMsgs.h"
 #include "interface/shared/i2oXFunctionCodes.h"
 #include "rubuilder/ru/BUproxy.h"
+#include "rubuilder/utils/Atomic.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "xcept/tools.h"
 
 #include <string.h>
@@ -31,8 +34,31 @@ void rubuilder::ru::BUproxy::I2Ocallback(toolbox::mem::Reference* bufRef)
   msg::RqstForFragsMsg* msg =
     (msg::RqstForFragsMsg*)stdMsg;
   
-  updateRequestCounters(msg);
-  handleRequest(msg);
+  if ( msg->srcIndex >= buCounters_.size() || ! buCounters_[msg->srcIndex] )
+  {
+    std::stringstream oss;
+
+    oss << "Received a request from BU instance " << msg->srcIndex;
+    oss << ", which is not a configured BU";
+
+    bufRef->release();
+    XCEPT_RAISE(exception::Configuration, oss.str());
+  }
+
+  msg::RqstForFragRangesMsg* rangesMsg =
+    (msg::RqstForFragRangesMsg*)stdMsg;
+  
+  // The BU announces range-encoded requests with a magic number
+  if ( rangesMsg->version == msg::RQSTS_RANGES )
+  {
+    updateRequestCounters(rangesMsg);
+    handleRequest(rangesMsg, msg::getBroadcastElements(bufRef, rangesMsg->elements));
+  }
+  else
+  {
+    updateRequestCounters(msg);
+    handleRequest(msg, msg::getBroadcastElements(bufRef, msg->elements));
+  }
   
   bufRef->release();
 }
@@ -40,17 +66,22 @@ void rubuilder::ru::BUproxy::I2Ocallback(toolbox::mem::Reference* bufRef)
 
 void rubuilder::ru::BUproxy::updateRequestCounters(const rubuilder::msg::RqstForFragsMsg* msg)
 {
-  boost::mutex::scoped_lock sl(requestMonitoringMutex_);
+  RequestMonitoring& requestMonitoring = requestMonitoring_.local();
   
   const uint32_t nbElements = msg->nbElements;
-  requestMonitoring_.payload += nbElements * sizeof(msg::RqstForFrag);
-  requestMonitoring_.logicalCount += nbElements;
-  ++requestMonitoring_.i2oCount;
-  requestMonitoring_.logicalCountPerBU[msg->srcIndex] += nbElements;
+  requestMonitoring.payload += nbElements * sizeof(msg::RqstForFrag);
+  requestMonitoring.logicalCount += nbElements;
+  ++requestMonitoring.i2oCount;
+
+  getBUCounters(msg->srcIndex).local().logicalCount += nbElements;
 }
 
 
-void rubuilder::ru::BUproxy::handleRequest(const rubuilder::msg::RqstForFragsMsg* msg)
+void rubuilder::ru::BUproxy::handleRequest
+(
+  const rubuilder::msg::RqstForFragsMsg* msg,
+  const rubuilder::msg::RqstForFrag* elements
+)
 {
   SuperFragmentTable::Request request;
   request.buTid = ((I2O_MESSAGE_FRAME*)msg)->InitiatorAddress;
@@ -59,14 +90,48 @@ void rubuilder::ru::BUproxy::handleRequest(const rubuilder::msg::RqstForFragsMsg
   for (uint32_t i=0; i<msg->nbElements; ++i)
   {
     // these are different for each request
-    request.evbId = msg->elements[i].evbId;
-    request.buResourceId = msg->elements[i].buResourceId;
+    request.evbId = elements[i].evbId;
+    request.buResourceId = elements[i].buResourceId;
     
     superFragmentTable_->addRequest(request);
   }
 }
 
 
+void rubuilder::ru::BUproxy::updateRequestCounters(const rubuilder::msg::RqstForFragRangesMsg* msg)
+{
+  RequestMonitoring& requestMonitoring = requestMonitoring_.local();
+  
+  const uint32_t nbRequests = msg->nbRequests;
+  requestMonitoring.payload += msg->nbElements * sizeof(msg::RqstForFragRange);
+  requestMonitoring.logicalCount += nbRequests;
+  ++requestMonitoring.i2oCount;
+
+  getBUCounters(msg->srcIndex).local().logicalCount += nbRequests;
+}
+
+
+void rubuilder::ru::BUproxy::handleRequest
+(
+  const rubuilder::msg::RqstForFragRangesMsg* msg,
+  const rubuilder::msg::RqstForFragRange* elements
+)
+{
+  SuperFragmentTable::Request request;
+  request.buTid = ((I2O_MESSAGE_FRAME*)msg)->InitiatorAddress;
+  request.buIndex = msg->srcIndex;
+
+  for (uint32_t i=0; i<msg->nbElements; ++i)
+  {
+    // the table keeps the whole range as a single entry
+    request.evbId = elements[i].first;
+    request.buResourceId = elements[i].firstBuResourceId;
+    
+    superFragmentTable_->addRequests(request, elements[i].count);
+  }
+}
+
+
 void rubuilder::ru::BUproxy::sendData
 (
   const SuperFragmentTable::Request& request,
@@ -99,14 +164,14 @@ void rubuilder::ru::BUproxy::sendData
   }
 
   {
-     boost::mutex::scoped_lock sl(dataMonitoringMutex_);
+     DataMonitoring& dataMonitoring = dataMonitoring_.local();
 
-     dataMonitoring_.lastEventNumberToBUs = request.evbId.eventNumber();
-     dataMonitoring_.i2oCount += i2oCount;
-     dataMonitoring_.payload += payload;
-     ++dataMonitoring_.logicalCount;
-     dataMonitoring_.payloadPerBU[request.buIndex] += payload;
+     dataMonitoring.i2oCount += i2oCount;
+     dataMonitoring.payload += payload;
+     ++dataMonitoring.logicalCount;
   }
+  getBUCounters(request.buIndex).local().payload += payload;
+  utils::storeRelaxed(lastEventNumberToBUsShared_, request.evbId.eventNumber());
   
   xdaq::ApplicationDescriptor *bu = 0;
   try
@@ -125,14 +190,7 @@ void rubuilder::ru::BUproxy::sendData
   
   try
   {
-    app_->getApplicationContext()->
-      postFrame(
-        head,
-        app_->getApplicationDescriptor(),
-        bu//,
-        //i2oExceptionHandler_,
-        //bu
-      );
+    utils::postFrame(app_, head, bu);
   }
   catch(xcept::Exception &e)
   {
@@ -143,6 +201,8 @@ void rubuilder::ru::BUproxy::sendData
     
     XCEPT_RETHROW(exception::I2O, oss.str(), e);
   }
+
+  utils::getEventTracer().trace(request.evbId, utils::EventTracer::RU_SUPERFRAGMENT_SENT);
 }
 
 
@@ -206,6 +266,26 @@ void rubuilder::ru::BUproxy::getBuInstances()
   {
     buInstances_.insert((*it)->getInstance());
   }
+
+  // The BU instances are used as index into the per-BU counters
+  const uint32_t maxBuInstance = *buInstances_.rbegin();
+  if ( buCounters_.size() <= maxBuInstance )
+    buCounters_.resize(maxBuInstance + 1);
+
+  for (BUInstances::const_iterator it = buInstances_.begin(),
+         itEnd = buInstances_.end(); it != itEnd; ++it)
+  {
+    if ( ! buCounters_[*it] )
+      buCounters_[*it].reset( new BUCounters() );
+  }
+}
+
+
+rubuilder::ru::BUproxy::BUCounters&
+rubuilder::ru::BUproxy::getBUCounters(const uint32_t buInstance)
+{
+  // The BU index has been checked when the request arrived
+  return *buCounters_[buInstance];
 }
 
 
@@ -234,68 +314,107 @@ void rubuilder::ru::BUproxy::updateMonitoringItems()
 {
   nbSuperFragmentsReady_ = superFragmentTable_->getNbSuperFragmentsReady();
 
+  RequestMonitoring requestMonitoring;
+  requestMonitoring_.snapshot(requestMonitoring);
+  DataMonitoring dataMonitoring;
+  dataMonitoring_.snapshot(dataMonitoring);
+
+  lastEventNumberToBUs_ = utils::loadRelaxed(lastEventNumberToBUsShared_);
+  i2oBUCacheCount_ = dataMonitoring.logicalCount;
+
+  boost::mutex::scoped_lock sl(buInstancesMutex_);
+
+  i2oRUSendCountBU_.clear();
+  i2oRUSendCountBU_.reserve(buInstances_.size());
+  i2oBUCachePayloadBU_.clear();
+  i2oBUCachePayloadBU_.reserve(buInstances_.size());
+
+  BUInstances::const_iterator it, itEnd;
+  for (it=buInstances_.begin(), itEnd = buInstances_.end();
+       it != itEnd; ++it)
   {
-    boost::mutex::scoped_lock sl(requestMonitoringMutex_);
-    
-    i2oRUSendCountBU_.clear();
-    i2oRUSendCountBU_.reserve(requestMonitoring_.logicalCountPerBU.size());
-    CountsPerBU::const_iterator it, itEnd;
-    for (it = requestMonitoring_.logicalCountPerBU.begin(),
-           itEnd = requestMonitoring_.logicalCountPerBU.end();
-         it != itEnd; ++it)
-    {
-      i2oRUSendCountBU_.push_back(it->second);
-    }
-  }
-  {
-    boost::mutex::scoped_lock sl(dataMonitoringMutex_);
-    
-    lastEventNumberToBUs_ = dataMonitoring_.lastEventNumberToBUs;
-    i2oBUCacheCount_ = dataMonitoring_.logicalCount;
-    
-    i2oBUCachePayloadBU_.clear();
-    i2oBUCachePayloadBU_.reserve(dataMonitoring_.payloadPerBU.size());
-    CountsPerBU::const_iterator it, itEnd;
-    for (it = dataMonitoring_.payloadPerBU.begin(),
-           itEnd = dataMonitoring_.payloadPerBU.end();
-         it != itEnd; ++it)
-    {
-      i2oBUCachePayloadBU_.push_back(it->second);
-    }
+    BUMonitoring buMonitoring;
+    buCounters_[*it]->snapshot(buMonitoring);
+
+    i2oRUSendCountBU_.push_back(buMonitoring.logicalCount);
+    i2oBUCachePayloadBU_.push_back(buMonitoring.payload);
   }
 }
 
 
 void rubuilder::ru::BUproxy::resetMonitoringCounters()
 {
-  boost::mutex::scoped_lock rsl(requestMonitoringMutex_);
-  boost::mutex::scoped_lock dsl(dataMonitoringMutex_);
-
-  requestMonitoring_.payload = 0;
-  requestMonitoring_.logicalCount = 0;
-  requestMonitoring_.i2oCount = 0;
-  requestMonitoring_.logicalCountPerBU.clear();
-  
-  dataMonitoring_.lastEventNumberToBUs = 0;
-  dataMonitoring_.payload = 0;
-  dataMonitoring_.logicalCount = 0;
-  dataMonitoring_.i2oCount = 0;
-  dataMonitoring_.payloadPerBU.clear();
+  requestMonitoring_.reset();
+  dataMonitoring_.reset();
+  utils::storeRelaxed(lastEventNumberToBUsShared_, 0U);
 
   boost::mutex::scoped_lock sl(buInstancesMutex_);
-    
-  BUInstances::const_iterator it, itEnd;
-  for (it=buInstances_.begin(), itEnd = buInstances_.end();
-       it != itEnd; ++it)
-  {
-    const uint32_t buInstance = *it;
 
-    requestMonitoring_.logicalCountPerBU[buInstance] = 0;
-    dataMonitoring_.payloadPerBU[buInstance] = 0;
+  for (BUCountersPerInstance::const_iterator it = buCounters_.begin(),
+         itEnd = buCounters_.end(); it != itEnd; ++it)
+  {
+    if ( *it ) (*it)->reset();
   }
 }
 
 
+uint64_t rubuilder::ru::BUproxy::i2oBUCacheCount() const
+{
+  DataMonitoring dataMonitoring;
+  dataMonitoring_.snapshot(dataMonitoring);
+  return dataMonitoring.logicalCount;
+}
+
+
+rubuilder::ru::BUproxy::RequestMonitoring::RequestMonitoring() :
+logicalCount(0),
+payload(0),
+i2oCount(0)
+{}
+
+
+rubuilder::ru::BUproxy::RequestMonitoring&
+rubuilder::ru::BUproxy::RequestMonitoring::operator+=(const RequestMonitoring& other)
+{
+  logicalCount += other.logicalCount;
+  payload += other.payload;
+  i2oCount += other.i2oCount;
+  return *this;
+}
+
+
+rubuilder::ru::BUproxy::DataMonitoring::DataMonitoring() :
+logicalCount(0),
+payload(0),
+i2oCount(0)
+{}
+
+
+rubuilder::ru::BUproxy::DataMonitoring&
+rubuilder::ru::BUproxy::DataMonitoring::operator+=(const DataMonitoring& other)
+{
+  logicalCount += other.logicalCount;
+  payload += other.payload;
+  i2oCount += other.i2oCount;
+  return *this;
+}
+
+
+rubuilder::ru::BUproxy::BUMonitoring::BUMonitoring() :
+logicalCount(0),
+payload(0)
+{}
+
+
+rubuilder::ru::BUproxy::BUMonitoring&
+rubuilder::ru::BUproxy::BUMonitoring::operator+=(const BUMonitoring& other)
+{
+  logicalCount += other.logicalCount;
+  payload += other.payload;
+  return *this;
+}
+
+
 void rubuilder::ru::BUproxy::clear()
 {
 }
@@ -310,12 +429,14 @@ void rubuilder::ru::BUproxy::printHtml(xgi::Output *out)
   *out << "<th colspan=\"2\">Monitoring</th>"                     << std::endl;
   *out << "</tr>"                                                 << std::endl;
 
-  boost::mutex::scoped_lock rsl(requestMonitoringMutex_);
-  boost::mutex::scoped_lock dsl(dataMonitoringMutex_);
+  RequestMonitoring requestMonitoring;
+  requestMonitoring_.snapshot(requestMonitoring);
+  DataMonitoring dataMonitoring;
+  dataMonitoring_.snapshot(dataMonitoring);
 
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>last evt number to BUs</td>"                       << std::endl;
-  *out << "<td>" << dataMonitoring_.lastEventNumberToBUs << "</td>" << std::endl;
+  *out << "<td>" << utils::loadRelaxed(lastEventNumberToBUsShared_) << "</td>" << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td># ready fragments</td>"                            << std::endl;
@@ -327,15 +448,15 @@ void rubuilder::ru::BUproxy::printHtml(xgi::Output *out)
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>payload (kB)</td>"                                 << std::endl;
-  *out << "<td>" << requestMonitoring_.payload / 0x400 << "</td>" << std::endl;
+  *out << "<td>" << requestMonitoring.payload / 0x400 << "</td>" << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>logical count</td>"                                << std::endl;
-  *out << "<td>" << requestMonitoring_.logicalCount << "</td>"    << std::endl;
+  *out << "<td>" << requestMonitoring.logicalCount << "</td>"     << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>I2O count</td>"                                    << std::endl;
-  *out << "<td>" << requestMonitoring_.i2oCount << "</td>"        << std::endl;
+  *out << "<td>" << requestMonitoring.i2oCount << "</td>"         << std::endl;
   *out << "</tr>"                                                 << std::endl;
   
   *out << "<tr>"                                                  << std::endl;
@@ -343,15 +464,15 @@ void rubuilder::ru::BUproxy::printHtml(xgi::Output *out)
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>payload (MB)</td>"                                 << std::endl;
-  *out << "<td>" << dataMonitoring_.payload / 0x100000 << "</td>" << std::endl;
+  *out << "<td>" << dataMonitoring.payload / 0x100000 << "</td>" << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>logical count</td>"                                << std::endl;
-  *out << "<td>" << dataMonitoring_.logicalCount << "</td>"       << std::endl;
+  *out << "<td>" << dataMonitoring.logicalCount << "</td>"        << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>I2O count</td>"                                    << std::endl;
-  *out << "<td>" << dataMonitoring_.i2oCount << "</td>"           << std::endl;
+  *out << "<td>" << dataMonitoring.i2oCount << "</td>"            << std::endl;
   *out << "</tr>"                                                 << std::endl;
 
   *out << "<tr>"                                                  << std::endl;
@@ -372,12 +493,13 @@ void rubuilder::ru::BUproxy::printHtml(xgi::Output *out)
   for (it=buInstances_.begin(), itEnd = buInstances_.end();
        it != itEnd; ++it)
   {
-    const uint32_t buInstance = *it;
+    BUMonitoring buMonitoring;
+    buCounters_[*it]->snapshot(buMonitoring);
 
     *out << "<tr>"                                                << std::endl;
-    *out << "<td>BU_" << buInstance << "</td>"                    << std::endl;
-    *out << "<td>" << requestMonitoring_.logicalCountPerBU[buInstance] << "</td>" << std::endl;
-    *out << "<td>" << dataMonitoring_.payloadPerBU[buInstance] / 0x100000 << "</td>" << std::endl;
+    *out << "<td>BU_" << *it << "</td>"                           << std::endl;
+    *out << "<td>" << buMonitoring.logicalCount << "</td>" << std::endl;
+    *out << "<td>" << buMonitoring.payload / 0x100000 << "</td>" << std::endl;
     *out << "</tr>"                                               << std::endl;
   }
   *out << "</table>"                                              << std::endl;
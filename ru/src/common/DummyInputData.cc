@@ -35,9 +35,10 @@ bool rubuilder::ru::DummyInputData::getData
     const uint32_t payload =
       (stdMsg->MessageSize << 2) - sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME);
 
-    inputMonitoring_.lastEventNumber = evbId.eventNumber();
-    inputMonitoring_.payload += payload;
-    ++inputMonitoring_.logicalCount;
+    InputMonitoring& inputMonitoring = inputMonitoring_.local();
+    utils::storeRelaxed(lastEventNumberShared_, evbId.eventNumber());
+    inputMonitoring.payload += payload;
+    ++inputMonitoring.logicalCount;
     return true;
   }
   return false;
@@ -48,18 +49,22 @@ void rubuilder::ru::DummyInputData::configure(const Configuration& conf)
 {
   superFragmentGenerator_.configure(
     conf.fedSourceIds, conf.usePlayback, conf.playbackDataFile,
-    conf.dummyBlockSize, conf.dummyFedPayloadSize, conf.dummyFedPayloadStdDev);
+    conf.dummyBlockSize, conf.dummyFedPayloadSize, conf.dummyFedPayloadStdDev,
+    0, conf.poolConfiguration, conf.nbFragmentTemplates);
 }
 
 
 void rubuilder::ru::DummyInputData::printHtml(xgi::Output* out)
 {
+  InputMonitoring inputMonitoring;
+  inputMonitoring_.snapshot(inputMonitoring);
+
   *out << "<tr>"                                                  << std::endl;
   *out << "<td>"                                                  << std::endl;
   *out << "Last evt number generated"                             << std::endl;
   *out << "</td>"                                                 << std::endl;
   *out << "<td>"                                                  << std::endl;
-  *out << inputMonitoring_.lastEventNumber                        << std::endl;
+  *out << lastEventNumber()                                       << std::endl;
   *out << "</td>"                                                 << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
@@ -67,7 +72,15 @@ void rubuilder::ru::DummyInputData::printHtml(xgi::Output* out)
   *out << "Generated empty super-fragments"                       << std::endl;
   *out << "</td>"                                                 << std::endl;
   *out << "<td>"                                                  << std::endl;
-  *out << inputMonitoring_.logicalCount                           << std::endl;
+  *out << inputMonitoring.logicalCount                           << std::endl;
+  *out << "</td>"                                                 << std::endl;
+  *out << "</tr>"                                                 << std::endl;
+  *out << "<tr>"                                                  << std::endl;
+  *out << "<td>"                                                  << std::endl;
+  *out << "Super-fragment templates"                              << std::endl;
+  *out << "</td>"                                                 << std::endl;
+  *out << "<td>"                                                  << std::endl;
+  *out << superFragmentGenerator_.getNbTemplates()                << std::endl;
   *out << "</td>"                                                 << std::endl;
   *out << "</tr>"                                                 << std::endl;
   *out << "<tr>"                                                  << std::endl;
@@ -78,6 +91,14 @@ void rubuilder::ru::DummyInputData::printHtml(xgi::Output* out)
   *out << superFragmentGenerator_.getMemoryUsage()/1024           << std::endl;
   *out << "</td>"                                                 << std::endl;
   *out << "</tr>"                                                 << std::endl;
+  *out << "<tr>"                                                  << std::endl;
+  *out << "<td>"                                                  << std::endl;
+  *out << "Memory pool"                                           << std::endl;
+  *out << "</td>"                                                 << std::endl;
+  *out << "<td>"                                                  << std::endl;
+  *out << superFragmentGenerator_.getPoolBacking()                << std::endl;
+  *out << "</td>"                                                 << std::endl;
+  *out << "</tr>"                                                 << std::endl;
 }
 
 
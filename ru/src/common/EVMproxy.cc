@@ -21,8 +21,23 @@ void rubuilder::ru::EVMproxy::I2Ocallback(toolbox::mem::Reference* bufRef)
   msg::EvBidsMsg* msg =
     (msg::EvBidsMsg*)stdMsg;
   
-  updateReadoutCounters(msg);
-  handleReadoutMsg(msg);
+  // The EVM announces the layout of the EvBids in the message
+  if ( msg->version == msg::EVBIDS_RANGES )
+  {
+    msg::EvBidRangesMsg* rangesMsg =
+      (msg::EvBidRangesMsg*)stdMsg;
+    const msg::EvBidRange* elements =
+      msg::getBroadcastElements(bufRef, rangesMsg->elements);
+    updateReadoutCounters(rangesMsg, elements);
+    handleReadoutMsg(rangesMsg, elements);
+  }
+  else
+  {
+    const utils::EvBid* elements =
+      msg::getBroadcastElements(bufRef, msg->elements);
+    updateReadoutCounters(msg, elements);
+    handleReadoutMsg(msg, elements);
+  }
   
   bufRef->release();
 }
@@ -34,23 +49,69 @@ bool rubuilder::ru::EVMproxy::getTrigEvBid(rubuilder::utils::EvBid& evbId)
 }
 
 
-void rubuilder::ru::EVMproxy::updateReadoutCounters(const rubuilder::msg::EvBidsMsg* msg)
+void rubuilder::ru::EVMproxy::updateReadoutCounters
+(
+  const rubuilder::msg::EvBidsMsg* msg,
+  const rubuilder::utils::EvBid* elements
+)
 {
   boost::mutex::scoped_lock sl(evmMonitoringMutex_);
 
   const uint32_t nbElements = msg->nbElements;
-  evmMonitoring_.lastEventNumberFromEVM = msg->elements[nbElements-1].eventNumber();
+  evmMonitoring_.lastEventNumberFromEVM = elements[nbElements-1].eventNumber();
   evmMonitoring_.payload += nbElements * sizeof(utils::EvBid);
   evmMonitoring_.logicalCount += nbElements;
   ++evmMonitoring_.i2oCount;
 }
 
 
-void rubuilder::ru::EVMproxy::handleReadoutMsg(const rubuilder::msg::EvBidsMsg* msg)
+void rubuilder::ru::EVMproxy::handleReadoutMsg
+(
+  const rubuilder::msg::EvBidsMsg* msg,
+  const rubuilder::utils::EvBid* elements
+)
+{
+  for (uint32_t i=0; i<msg->nbElements; ++i)
+  {
+    while ( ! evbIdFIFO_.enq(elements[i]) ) ::usleep(1000);
+  }
+}
+
+
+void rubuilder::ru::EVMproxy::updateReadoutCounters
+(
+  const rubuilder::msg::EvBidRangesMsg* msg,
+  const rubuilder::msg::EvBidRange* elements
+)
+{
+  boost::mutex::scoped_lock sl(evmMonitoringMutex_);
+
+  const msg::EvBidRange& lastRange = elements[msg->nbElements-1];
+  evmMonitoring_.lastEventNumberFromEVM =
+    lastRange.first.eventNumber() + lastRange.count - 1;
+  evmMonitoring_.payload += msg->nbElements * sizeof(msg::EvBidRange);
+  evmMonitoring_.logicalCount += msg->nbEvBids;
+  ++evmMonitoring_.i2oCount;
+}
+
+
+void rubuilder::ru::EVMproxy::handleReadoutMsg
+(
+  const rubuilder::msg::EvBidRangesMsg* msg,
+  const rubuilder::msg::EvBidRange* elements
+)
 {
   for (uint32_t i=0; i<msg->nbElements; ++i)
   {
-    while ( ! evbIdFIFO_.enq(msg->elements[i]) ) ::usleep(1000);
+    const msg::EvBidRange& range = elements[i];
+    const uint32_t resyncCount = range.first.resyncCount();
+    const uint32_t firstEventNumber = range.first.eventNumber();
+
+    for (uint32_t n=0; n<range.count; ++n)
+    {
+      const utils::EvBid evbId(resyncCount, firstEventNumber + n);
+      while ( ! evbIdFIFO_.enq(evbId) ) ::usleep(1000);
+    }
   }
 }
 
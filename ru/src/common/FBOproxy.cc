@@ -40,19 +40,19 @@ void rubuilder::ru::FBOproxy::I2Ocallback(toolbox::mem::Reference* bufRef)
 
 void rubuilder::ru::FBOproxy::updateInputCounters(const I2O_MESSAGE_FRAME* stdMsg)
 {
-  boost::mutex::scoped_lock sl(inputMonitoringMutex_);
+  InputMonitoring& inputMonitoring = inputMonitoring_.local();
 
   const I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block =
     (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)stdMsg;
   const uint32_t payload =
     (stdMsg->MessageSize << 2) - sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME);
 
-  inputMonitoring_.lastEventNumber = block->eventNumber;
-  inputMonitoring_.payload += payload;
-  ++inputMonitoring_.i2oCount;
+  utils::storeRelaxed(lastEventNumberShared_, static_cast<uint32_t>(block->eventNumber));
+  inputMonitoring.payload += payload;
+  ++inputMonitoring.i2oCount;
   if (block->blockNb == (block->nbBlocksInSuperFragment - 1))
   {
-    ++inputMonitoring_.logicalCount;
+    ++inputMonitoring.logicalCount;
   }
 }
 
@@ -155,25 +155,26 @@ void rubuilder::ru::FBOproxy::clear()
 void rubuilder::ru::FBOproxy::printHtml(xgi::Output *out)
 {
   {
-    boost::mutex::scoped_lock sl(inputMonitoringMutex_);
+    InputMonitoring inputMonitoring;
+    inputMonitoring_.snapshot(inputMonitoring);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>last evt number from FBO</td>"                     << std::endl;
-    *out << "<td>" << inputMonitoring_.lastEventNumber << "</td>"   << std::endl;
+    *out << "<td>" << lastEventNumber() << "</td>"    << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td colspan=\"2\" style=\"text-align:center\">RU input</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>payload (MB)</td>"                                 << std::endl;
-    *out << "<td>" << inputMonitoring_.payload / 0x100000<< "</td>" << std::endl;
+    *out << "<td>" << inputMonitoring.payload / 0x100000<< "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>logical count</td>"                                << std::endl;
-    *out << "<td>" << inputMonitoring_.logicalCount << "</td>"      << std::endl;
+    *out << "<td>" << inputMonitoring.logicalCount << "</td>"       << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>I2O count</td>"                                    << std::endl;
-    *out << "<td>" << inputMonitoring_.i2oCount << "</td>"          << std::endl;
+    *out << "<td>" << inputMonitoring.i2oCount << "</td>"           << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
 
@@ -9,43 +9,24 @@
 #include "rubuilder/ru/InputHandler.h"
 #include "rubuilder/utils/Constants.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/MemoryPools.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "toolbox/net/URN.h"
-#include "toolbox/mem/HeapAllocator.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 
 rubuilder::ru::FEROLproxy::FEROLproxy(xdaq::Application* app) :
 InputHandler(app),
+superFragmentPool_(0),
 blockFIFO_("blockFIFO"),
 dropInputData_(false)
 {
-  try
-  {
-    toolbox::net::URN urn("toolbox-mem-pool", "udapl");
-    superFragmentPool_ = toolbox::mem::getMemoryPoolFactory()->findPool(urn);
-  }
-  catch (toolbox::mem::exception::MemoryPoolNotFound)
-  {
-    toolbox::net::URN poolURN("toolbox-mem-pool",app->getApplicationDescriptor()->getURN());
-    try
-    {
-      superFragmentPool_ = toolbox::mem::getMemoryPoolFactory()->
-        createPool(poolURN, new toolbox::mem::HeapAllocator());
-    }
-    catch (toolbox::mem::exception::DuplicateMemoryPool)
-    {
-      // Pool already exists from a previous construction of this class
-      // Note that destroying the pool in the destructor is not working
-      // because the previous instance is destroyed after the new one
-      // is constructed.
-      superFragmentPool_ = toolbox::mem::getMemoryPoolFactory()->
-        findPool(poolURN);
-    }
-  }
-  catch (toolbox::mem::exception::Exception e)
-  {
-    XCEPT_RETHROW(exception::OutOfMemory,
-      "Failed to create memory pool for super-fragments.", e);
-  }
+  utils::getResourcePlacement().addPlaceablePool(app->getApplicationDescriptor()->getURN());
+}
+
+
+rubuilder::ru::FEROLproxy::~FEROLproxy()
+{
+  utils::getResourcePlacement().removePlaceablePool(app_->getApplicationDescriptor()->getURN());
 }
 
 
@@ -72,13 +53,13 @@ void rubuilder::ru::FEROLproxy::I2Ocallback(toolbox::mem::Reference* bufRef)
   // assert( bufRef->getDataSize() == frame->totalLength + sizeof(I2O_DATA_READY_MESSAGE_FRAME) );
 
   {
-    boost::mutex::scoped_lock sl(inputMonitoringMutex_);
+    InputMonitoring& inputMonitoring = inputMonitoring_.local();
     
-    inputMonitoring_.lastEventNumber = eventNumber;
-    inputMonitoring_.payload += frame->totalLength;
-    ++inputMonitoring_.i2oCount;
+    utils::storeRelaxed(lastEventNumberShared_, static_cast<uint32_t>(eventNumber));
+    inputMonitoring.payload += frame->totalLength;
+    ++inputMonitoring.i2oCount;
     if ( FEROL_LASTPACKET_EXTRACT(h0) )
-      ++inputMonitoring_.logicalCount;
+      ++inputMonitoring.logicalCount;
   }
   
   const utils::EvBid evbId = evbIdFactories_[fedId].getEvBid(eventNumber);
@@ -276,6 +257,11 @@ void rubuilder::ru::FEROLproxy::configure(const Configuration& conf)
   blockSize_ = conf.dummyBlockSize;
   dropInputData_ = conf.dropInputData;
 
+  superFragmentPool_ = utils::getMemoryPool(
+    app_->getApplicationDescriptor()->getURN(), conf.poolConfiguration, poolName_);
+  utils::getResourcePlacement().placePool(poolName_, superFragmentPool_,
+    blockSize_, conf.blockFIFOCapacity);
+
   #ifdef FEDLIST_BITSET
   fedList_.reset();
   xdata::Vector<xdata::UnsignedInteger32>::const_iterator it, itEnd;
@@ -337,34 +323,39 @@ void rubuilder::ru::FEROLproxy::clear()
 void rubuilder::ru::FEROLproxy::printHtml(xgi::Output *out)
 {
   {
-    boost::mutex::scoped_lock sl(inputMonitoringMutex_);
+    InputMonitoring inputMonitoring;
+    inputMonitoring_.snapshot(inputMonitoring);
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>last evt number from FEROL</td>"                   << std::endl;
-    *out << "<td>" << inputMonitoring_.lastEventNumber << "</td>"   << std::endl;
+    *out << "<td>" << lastEventNumber() << "</td>"    << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>super fragments under construction</td>"           << std::endl;
     *out << "<td>" << superFragmentMap_.size() << "</td>"           << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
+    *out << "<td>memory pool</td>"                                  << std::endl;
+    *out << "<td>" << utils::getMemoryPoolBacking(poolName_) << "</td>" << std::endl;
+    *out << "</tr>"                                                 << std::endl;
+    *out << "<tr>"                                                  << std::endl;
     *out << "<td colspan=\"2\" style=\"text-align:center\">RU input</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>payload (MB)</td>"                                 << std::endl;
-    *out << "<td>" << inputMonitoring_.payload / 0x100000<< "</td>" << std::endl;
+    *out << "<td>" << inputMonitoring.payload / 0x100000<< "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>logical count</td>"                                << std::endl;
-    *out << "<td>" << inputMonitoring_.logicalCount << "</td>"      << std::endl;
+    *out << "<td>" << inputMonitoring.logicalCount << "</td>"       << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>I2O count</td>"                                    << std::endl;
-    *out << "<td>" << inputMonitoring_.i2oCount << "</td>"          << std::endl;
+    *out << "<td>" << inputMonitoring.i2oCount << "</td>"           << std::endl;
     *out << "</tr>"                                                 << std::endl;
     *out << "<tr>"                                                  << std::endl;
     *out << "<td>FED size (Bytes)</td>"                             << std::endl;
     *out << "<td>" <<
-      (inputMonitoring_.logicalCount>0 ? static_cast<double>(inputMonitoring_.payload) / inputMonitoring_.logicalCount : 0)
+      (inputMonitoring.logicalCount>0 ? static_cast<double>(inputMonitoring.payload) / inputMonitoring.logicalCount : 0)
       << "</td>" << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
@@ -4,8 +4,10 @@
 #include "rubuilder/ru/RUinput.h"
 #include "rubuilder/ru/StateMachine.h"
 #include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/Exception.h"
 #include "rubuilder/utils/I2OMessages.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 
@@ -27,7 +29,8 @@ evmProxy_(evmProxy),
 ruInput_(ruInput),
 doProcessing_(false),
 processActive_(false),
-timerId_(timerManager_.getTimer())
+timerId_(timerManager_.getTimer()),
+pairingLatency_("pairingLatency")
 {
   resetMonitoringCounters();
   startProcessingWorkLoop();
@@ -64,6 +67,8 @@ void rubuilder::ru::RU::appendMonitoringItems(utils::InfoSpaceItems& items)
   items.add("deltaN", &deltaN_);
   items.add("deltaSumOfSquares", &deltaSumOfSquares_);
   items.add("deltaSumOfSizes", &deltaSumOfSizes_);
+
+  pairingLatency_.appendMonitoringItems(items);
 }
 
 
@@ -74,6 +79,8 @@ void rubuilder::ru::RU::updateMonitoringItems()
   nbSuperFragmentsInRU_.value_ = std::max(static_cast<uint64_t>(0),
     ruInput_->fragmentsCount() - buProxy_->i2oBUCacheCount());
 
+  pairingLatency_.updateMonitoringItems();
+
   boost::mutex::scoped_lock sl(performanceMonitorMutex_);
 
   utils::PerformanceMonitor intervalEnd;
@@ -113,6 +120,7 @@ void rubuilder::ru::RU::resetMonitoringCounters()
     superFragmentMonitoring_.payload = 0;
     superFragmentMonitoring_.payloadSquared = 0;
   }
+  pairingLatency_.resetMonitoringCounters();
 }
 
 
@@ -171,30 +179,20 @@ void rubuilder::ru::RU::startProcessingWorkLoop()
 bool rubuilder::ru::RU::process(toolbox::task::WorkLoop *wl)
 {
   processActive_ = true;
-  
-  //fix affinity to core 10
-  // cpu_set_t cpuset;
-  // CPU_ZERO(&cpuset);
-  // CPU_SET(10, &cpuset);
-  // const int status = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
-  // if ( status != 0  )
-  // {
-  //   std::ostringstream oss;
-  //   oss << "Failed to set affinity for RU process workloop: "
-  //     << strerror(status);
-  //   XCEPT_RAISE(exception::Configuration, oss.str());
-  // }
 
   while (doProcessing_)
   {
     try
     {
+      utils::getResourcePlacement().pinCurrentThread(wl->getName());
+
       // Wait for a trigger
       utils::EvBid evbId;
       while ( doProcessing_ && ! evmProxy_->getTrigEvBid(evbId) ) {}; //::usleep(1000);
       
       // Wait for the corresponding event fragment
       timerManager_.restartTimer(timerId_);
+      const uint64_t pairingStartUSec = utils::getMonotonicTimeUSec();
       toolbox::mem::Reference* bufRef = 0;
       while ( doProcessing_ && ! ruInput_->getData(evbId,bufRef) )
       {
@@ -210,6 +208,8 @@ bool rubuilder::ru::RU::process(toolbox::task::WorkLoop *wl)
       
       if (bufRef)
       {
+        pairingLatency_.recordSince(pairingStartUSec);
+        utils::getEventTracer().trace(evbId, utils::EventTracer::RU_FRAGMENT_PAIRED);
         updateSuperFragmentCounters(bufRef);
         superFragmentTable_->addEvBidAndBlock(evbId, bufRef);
       }
@@ -284,6 +284,7 @@ void rubuilder::ru::RU::printHtml(xgi::Output *out, const uint32_t monitoringSle
     *out << "<td>" << superFragmentMonitoring_.count << "</td>"     << std::endl;
     *out << "</tr>"                                                 << std::endl;
   }
+  pairingLatency_.printHtml(out);
   
   {
     boost::mutex::scoped_lock sl(performanceMonitorMutex_);
@@ -96,9 +96,12 @@ void rubuilder::ru::RUinput::configure()
   conf.dummyBlockSize = dummyBlockSize_.value_;
   conf.dummyFedPayloadSize = dummyFedPayloadSize_.value_;
   conf.dummyFedPayloadStdDev = dummyFedPayloadStdDev_.value_;
+  conf.nbFragmentTemplates = nbFragmentTemplates_.value_;
   conf.fedSourceIds = fedSourceIds_;
   conf.usePlayback = usePlayback_.value_;
   conf.playbackDataFile = playbackDataFile_.value_;
+  conf.poolConfiguration.hugePageSizeKB = poolHugePageSizeKB_.value_;
+  conf.poolConfiguration.committedSizeMB = poolCommittedSizeMB_.value_;
   handler_->configure(conf);
 }
 
@@ -122,6 +125,9 @@ void rubuilder::ru::RUinput::appendConfigurationItems(utils::InfoSpaceItems& par
   dummyBlockSize_ = 4096;
   dummyFedPayloadSize_ = 2048;
   dummyFedPayloadStdDev_ = 0;
+  nbFragmentTemplates_ = 0;
+  poolHugePageSizeKB_ = 0;
+  poolCommittedSizeMB_ = 0;
   
   // Default is 8 FEDs per super-fragment
   // Trigger has FED source id 0, RU0 has 1 to 8, RU1 has 9 to 16, etc.
@@ -145,7 +151,10 @@ void rubuilder::ru::RUinput::appendConfigurationItems(utils::InfoSpaceItems& par
   inputParams_.add("dummyBlockSize", &dummyBlockSize_);
   inputParams_.add("dummyFedPayloadSize", &dummyFedPayloadSize_);
   inputParams_.add("dummyFedPayloadStdDev", &dummyFedPayloadStdDev_);
+  inputParams_.add("nbFragmentTemplates", &nbFragmentTemplates_);
   inputParams_.add("fedSourceIds", &fedSourceIds_);
+  inputParams_.add("poolHugePageSizeKB", &poolHugePageSizeKB_);
+  inputParams_.add("poolCommittedSizeMB", &poolCommittedSizeMB_);
 
   params.add(inputParams_);
 }
@@ -52,12 +52,19 @@ void rubuilder::ru::SuperFragmentTable::addEvBidAndBlock
 
   ++nbSuperFragmentsReady_;
 
-  Requests::iterator requestPos = requests_.find(evbId);
-  if ( requestPos != requests_.end() )
+  // The range containing the event id is the last one starting at or before it
+  Requests::iterator requestPos = requests_.upper_bound(evbId);
+  if ( requestPos != requests_.begin() && isInRange(evbId, (--requestPos)->second) )
   {
     // There's already a request for this super fragment
-    dataReady(requestPos->second, bufRef);
+    const RequestRange range = requestPos->second;
+    const uint32_t offset = evbId.eventNumber() - range.first.evbId.eventNumber();
+    dataReady(getRequest(range, offset), bufRef);
+
+    // Keep the requests before and after it
     requests_.erase(requestPos);
+    storeRequests(range, 0, offset);
+    storeRequests(range, offset + 1, range.count - offset - 1);
   }
   else
   {
@@ -69,29 +76,115 @@ void rubuilder::ru::SuperFragmentTable::addEvBidAndBlock
 
 void rubuilder::ru::SuperFragmentTable::addRequest(const Request& request)
 {
+  const RequestRange range = { request, 1 };
+
   boost::mutex::scoped_lock sl(mutex_);
   
-  // Check that the slot in the request table is free
-  Requests::iterator requestPos = requests_.lower_bound(request.evbId);
-  if ( requestPos != requests_.end() && !(requests_.key_comp()(request.evbId,requestPos->first)) )
+  insertRequests(range);
+}
+
+
+void rubuilder::ru::SuperFragmentTable::addRequests
+(
+  const Request& first,
+  const uint32_t count
+)
+{
+  if ( count == 0 ) return;
+
+  const RequestRange range = { first, count };
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  insertRequests(range);
+}
+
+
+bool rubuilder::ru::SuperFragmentTable::isInRange
+(
+  const utils::EvBid& evbId,
+  const RequestRange& range
+)
+{
+  return ( evbId.resyncCount() == range.first.evbId.resyncCount() &&
+    evbId.eventNumber() >= range.first.evbId.eventNumber() &&
+    evbId.eventNumber() - range.first.evbId.eventNumber() < range.count );
+}
+
+
+rubuilder::ru::SuperFragmentTable::Request
+rubuilder::ru::SuperFragmentTable::getRequest
+(
+  const RequestRange& range,
+  const uint32_t offset
+)
+{
+  Request request = range.first;
+  request.evbId = utils::EvBid(range.first.evbId.resyncCount(),
+    range.first.evbId.eventNumber() + offset);
+  request.buResourceId = range.first.buResourceId + offset;
+  return request;
+}
+
+
+void rubuilder::ru::SuperFragmentTable::checkRequestsAreNew(const RequestRange& range)
+{
+  // mutex_ is taken by the calling method
+
+  // Neither the range starting at or before the first request,
+  // nor the next range may overlap with the new requests
+  Requests::const_iterator requestPos = requests_.upper_bound(range.first.evbId);
+  if ( requestPos != requests_.end() && isInRange(requestPos->first, range) )
   {
     std::stringstream oss;
-    oss << "A request is already in the lookup table: " << request.evbId;
+    oss << "A request is already in the lookup table: " << requestPos->first;
     XCEPT_RAISE(exception::EventOrder, oss.str());
   }
-
-  Data::iterator dataPos = data_.find(request.evbId);
-  if ( dataPos != data_.end() )
+  if ( requestPos != requests_.begin() && isInRange(range.first.evbId, (--requestPos)->second) )
   {
-    // The super fragment for this request is already available
-    dataReady(request, dataPos->second);
-    data_.erase(dataPos);
+    std::stringstream oss;
+    oss << "A request is already in the lookup table: " << range.first.evbId;
+    XCEPT_RAISE(exception::EventOrder, oss.str());
   }
-  else
+}
+
+
+void rubuilder::ru::SuperFragmentTable::storeRequests
+(
+  const RequestRange& range,
+  const uint32_t offset,
+  const uint32_t count
+)
+{
+  // mutex_ is taken by the calling method
+
+  if ( count == 0 ) return;
+
+  const RequestRange requests = { getRequest(range, offset), count };
+  requests_.insert(Requests::value_type(requests.first.evbId, requests));
+}
+
+
+void rubuilder::ru::SuperFragmentTable::insertRequests(const RequestRange& range)
+{
+  // mutex_ is taken by the calling method
+
+  checkRequestsAreNew(range);
+
+  // Serve the requests for super fragments which are already available.
+  // The others are kept as ranges until their data arrives.
+  uint32_t pendingOffset = 0;
+  Data::iterator dataPos = data_.lower_bound(range.first.evbId);
+  while ( dataPos != data_.end() && isInRange(dataPos->first, range) )
   {
-    // The request cannot be fulfilled yet
-    requests_.insert(requestPos, Requests::value_type(request.evbId,request));
+    const uint32_t offset = dataPos->first.eventNumber() - range.first.evbId.eventNumber();
+    storeRequests(range, pendingOffset, offset - pendingOffset);
+    pendingOffset = offset + 1;
+
+    dataReady(getRequest(range, offset), dataPos->second);
+    data_.erase(dataPos++);
   }
+  storeRequests(range, pendingOffset, range.count - pendingOffset);
 }
 
 
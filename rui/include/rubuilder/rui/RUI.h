@@ -3,11 +3,14 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <stdint.h>
+#include <vector>
 
 #include "rubuilder/ru/SuperFragmentTable.h"
 #include "rubuilder/utils/ApplicationDescriptorAndTid.h"
+#include "rubuilder/utils/EvBidFactory.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
 #include "rubuilder/utils/OneToOneQueue.h"
 #include "rubuilder/utils/PerformanceMonitor.h"
@@ -16,6 +19,7 @@
 #include "toolbox/mem/Reference.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WaitingWorkLoop.h"
+#include "xcept/Exception.h"
 #include "xdaq/Application.h"
 #include "xdata/Boolean.h"
 #include "xdata/Double.h"
@@ -34,6 +38,16 @@ namespace rubuilder { namespace rui { // namespace rubuilder::rui
   /**
    * \ingroup xdaqApps
    * \brief Core RUI class
+   *
+   * Super-fragments are generated by nbGeneratorThreads threads, each
+   * with its own generator and fragment FIFO. Generator i, counting from 0,
+   * builds the events i+1, i+1+nbGeneratorThreads, ... The sending workloop
+   * takes the super-fragments from the FIFOs in turn, such that the events
+   * are sent in order, optionally limiting the throughput to throughputLimitGBps.
+   * The generator threads are pinned like workloops named "Generating",
+   * "Generating1", "Generating2", ... Playback data can only be sent
+   * with a single generator thread. If a generator fails, the sending
+   * workloop moves the state machine into the failed state.
    */
   
   class RUI : public toolbox::lang::Class
@@ -45,6 +59,12 @@ namespace rubuilder { namespace rui { // namespace rubuilder::rui
 
     virtual ~RUI() {};
     
+    /**
+     * Register the state machine
+     */
+    void registerStateMachine(boost::shared_ptr<StateMachine> stateMachine)
+    { stateMachine_ = stateMachine; }
+    
     /**
      * Append the info space parameters used for the
      * configuration to the InfoSpaceItems
@@ -75,10 +95,9 @@ namespace rubuilder { namespace rui { // namespace rubuilder::rui
     );
 
     /**
-     * Print the content of the fragment FIFO as HTML snipped
+     * Print the content of the fragment FIFOs as HTML snipped
      */
-    inline void printFragmentFIFO(xgi::Output* out)
-    { fragmentFIFO_.printVerticalHtml(out); }
+    void printFragmentFIFO(xgi::Output*);
     
     /**
      * Reset the monitoring counters
@@ -107,30 +126,56 @@ namespace rubuilder { namespace rui { // namespace rubuilder::rui
 
   private:
 
+    typedef utils::OneToOneQueue<toolbox::mem::Reference*> FragmentFIFO;
+
+    struct Generator
+    {
+      const uint32_t index;
+      utils::SuperFragmentGenerator superFragmentGenerator;
+      utils::EvBidFactory evbIdFactory;
+      FragmentFIFO fragmentFIFO;
+      boost::shared_ptr<boost::thread> thread;
+
+      Generator(const uint32_t index, const std::string& poolName);
+    };
+    typedef boost::shared_ptr<Generator> GeneratorPtr;
+    typedef std::vector<GeneratorPtr> Generators;
+
     void getApplicationDescriptors();
     void startWorkLoops();
-    bool generating(toolbox::task::WorkLoop*);
+    void startGenerators();
+    void stopGenerators();
+    void generating(Generator*);
+    void generatorFailed(xcept::Exception&);
+    bool enqueueBlocks(Generator*, toolbox::mem::Reference*);
     bool sending(toolbox::task::WorkLoop*);
+    void limitThroughput(const uint32_t nbBytes);
     void sendData(toolbox::mem::Reference*);
     void getPerformance(utils::PerformanceMonitor&);
     
     xdaq::Application* app_;
+    boost::shared_ptr<StateMachine> stateMachine_;
     uint32_t tid_;
     utils::ApplicationDescriptorAndTid ru_;
     
     volatile bool doProcessing_;
-    volatile bool generatingActive_;
     volatile bool sendingActive_;
 
-    toolbox::task::WorkLoop* generatingWL_;
     toolbox::task::WorkLoop* sendingWL_;
-    toolbox::task::ActionSignature* generatingAction_;
     toolbox::task::ActionSignature* sendingAction_;
 
-    typedef utils::OneToOneQueue<toolbox::mem::Reference*> FragmentFIFO;
-    FragmentFIFO fragmentFIFO_;
+    Generators generators_;
+    uint32_t nextGenerator_;
+
+    // The first failure of a generator thread, reported by the sending workloop
+    boost::shared_ptr<xcept::Exception> generatorException_;
+    volatile bool generatorFailed_;
+    boost::mutex generatorExceptionMutex_;
 
-    utils::SuperFragmentGenerator superFragmentGenerator_;
+    // Earliest time at which the next block may be sent
+    // when limiting the throughput
+    double nextSendNSec_;
+    double nsecPerByte_;
 
     struct DataMonitoring
     {
@@ -158,6 +203,11 @@ namespace rubuilder { namespace rui { // namespace rubuilder::rui
     xdata::Vector<xdata::UnsignedInteger32> fedSourceIds_;
     xdata::UnsignedInteger32 fragmentFIFOCapacity_;
     xdata::UnsignedInteger32 maxFragmentsInMemory_;
+    xdata::UnsignedInteger32 poolHugePageSizeKB_;
+    xdata::UnsignedInteger32 poolCommittedSizeMB_;
+    xdata::UnsignedInteger32 nbGeneratorThreads_;
+    xdata::UnsignedInteger32 nbFragmentTemplates_;
+    xdata::Double throughputLimitGBps_;
   };
   
   
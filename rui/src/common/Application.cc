@@ -10,6 +10,7 @@ utils::RubuilderApplication<StateMachine>(s,rubuilderrui::version,"/rubuilder/im
 {
   rui_.reset( new RUI(this) );
   stateMachine_.reset( new StateMachine(this, rui_) );
+  rui_->registerStateMachine(stateMachine_);
 
   initialize();
 
@@ -6,10 +6,43 @@
 #include "rubuilder/rui/StateMachine.h"
 #include "rubuilder/utils/CreateStrings.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/LoopbackTransport.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 
+#include <boost/bind.hpp>
+
 #include <algorithm>
+#include <errno.h>
+#include <sstream>
+#include <time.h>
+
+
+namespace
+{
+  uint64_t getTimeNSec()
+  {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+  }
+
+  // The first generator keeps the names used with a single generator
+  std::string getGeneratorName(const std::string& name, const uint32_t index)
+  {
+    std::ostringstream oss;
+    oss << name;
+    if ( index > 0 ) oss << index;
+    return oss.str();
+  }
+
+  // Event numbers are 24-bits and start with 1
+  const uint32_t maxEventNumber = (1 << 24) - 1;
+
+  // Bursts allowed by the throughput limit after the sender has been idle
+  const uint64_t maxBurstNSec = 1000000;
+}
 
 
 rubuilder::rui::RUI::RUI
@@ -19,14 +52,27 @@ rubuilder::rui::RUI::RUI
 app_(app),
 tid_(0),
 doProcessing_(false),
-fragmentFIFO_("fragmentFIFO"),
-superFragmentGenerator_(app->getApplicationDescriptor()->getURN())
+sendingActive_(false),
+nextGenerator_(0),
+nextSendNSec_(0),
+nsecPerByte_(0)
 {
   resetMonitoringCounters();
   startWorkLoops();
 }
 
 
+rubuilder::rui::RUI::Generator::Generator
+(
+  const uint32_t index,
+  const std::string& poolName
+) :
+index(index),
+superFragmentGenerator(poolName),
+fragmentFIFO(getGeneratorName("fragmentFIFO", index))
+{}
+
+
 void rubuilder::rui::RUI::appendConfigurationItems(utils::InfoSpaceItems& params)
 {
   destinationClass_ = "rubuilder::ru::Application";
@@ -38,6 +84,11 @@ void rubuilder::rui::RUI::appendConfigurationItems(utils::InfoSpaceItems& params
   dummyFedPayloadStdDev_ = 0;
   fragmentFIFOCapacity_ = 32;
   maxFragmentsInMemory_ = 8192;
+  poolHugePageSizeKB_ = 0;
+  poolCommittedSizeMB_ = 0;
+  nbGeneratorThreads_ = 1;
+  nbFragmentTemplates_ = 0;
+  throughputLimitGBps_ = 0;
   
   // The default has been chosen for simple tests that do not wish to set
   // FED source ids in the configuration file.  The default is 1 FED per
@@ -57,6 +108,11 @@ void rubuilder::rui::RUI::appendConfigurationItems(utils::InfoSpaceItems& params
   ruiParams_.add("fedSourceIds", &fedSourceIds_);
   ruiParams_.add("fragmentFIFOCapacity", &fragmentFIFOCapacity_);
   ruiParams_.add("maxFragmentsInMemory", &maxFragmentsInMemory_);
+  ruiParams_.add("poolHugePageSizeKB", &poolHugePageSizeKB_);
+  ruiParams_.add("poolCommittedSizeMB", &poolCommittedSizeMB_);
+  ruiParams_.add("nbGeneratorThreads", &nbGeneratorThreads_);
+  ruiParams_.add("nbFragmentTemplates", &nbFragmentTemplates_);
+  ruiParams_.add("throughputLimitGBps", &throughputLimitGBps_);
 
   params.add(ruiParams_);
 }
@@ -109,11 +165,56 @@ void rubuilder::rui::RUI::configure()
 {
   clear();
 
-  fragmentFIFO_.resize(fragmentFIFOCapacity_);
+  if ( nbGeneratorThreads_.value_ == 0 )
+  {
+    XCEPT_RAISE(exception::Configuration,
+      "The number of generator threads must be at least 1");
+  }
+
+  if ( usePlayback_.value_ && nbGeneratorThreads_.value_ > 1 )
+  {
+    // Each generator would replay the whole data file
+    XCEPT_RAISE(exception::Configuration,
+      "Playback data can only be sent with a single generator thread");
+  }
+
+  if ( throughputLimitGBps_.value_ < 0 )
+  {
+    XCEPT_RAISE(exception::Configuration,
+      "The throughput limit must not be negative");
+  }
+
+  if ( generators_.size() != nbGeneratorThreads_.value_ )
+  {
+    const std::string urn = app_->getApplicationDescriptor()->getURN();
+
+    generators_.clear();
+    for (uint32_t i = 0; i < nbGeneratorThreads_.value_; ++i)
+    {
+      generators_.push_back( GeneratorPtr(
+          new Generator(i, getGeneratorName(urn + (i > 0 ? "/generator" : ""), i))
+        ) );
+    }
+  }
+
+  utils::PoolConfiguration poolConfiguration;
+  poolConfiguration.hugePageSizeKB = poolHugePageSizeKB_.value_;
+  poolConfiguration.committedSizeMB = poolCommittedSizeMB_.value_;
+
+  // The fragments in memory are shared between the generators
+  const uint32_t maxFragmentsInMemory = maxFragmentsInMemory_.value_ > 0 ?
+    std::max(maxFragmentsInMemory_.value_ / nbGeneratorThreads_.value_, 1U) : 0;
+
+  for (Generators::const_iterator it = generators_.begin(), itEnd = generators_.end();
+       it != itEnd; ++it)
+  {
+    (*it)->fragmentFIFO.resize(fragmentFIFOCapacity_);
 
-  superFragmentGenerator_.configure(
-    fedSourceIds_, usePlayback_, playbackDataFile_,
-    dummyBlockSize_, dummyFedPayloadSize_, dummyFedPayloadStdDev_, maxFragmentsInMemory_);
+    (*it)->superFragmentGenerator.configure(
+      fedSourceIds_, usePlayback_, playbackDataFile_,
+      dummyBlockSize_, dummyFedPayloadSize_, dummyFedPayloadStdDev_, maxFragmentsInMemory,
+      poolConfiguration, nbFragmentTemplates_);
+  }
 
   getApplicationDescriptors();
 }
@@ -167,16 +268,28 @@ void rubuilder::rui::RUI::getApplicationDescriptors()
 
 void rubuilder::rui::RUI::clear()
 {
-  toolbox::mem::Reference* bufRef;
-  while ( fragmentFIFO_.deq(bufRef) ) { bufRef->release(); }
+  for (Generators::const_iterator it = generators_.begin(), itEnd = generators_.end();
+       it != itEnd; ++it)
+  {
+    toolbox::mem::Reference* bufRef;
+    while ( (*it)->fragmentFIFO.deq(bufRef) ) { bufRef->release(); }
+  }
 }
 
 
 void rubuilder::rui::RUI::startProcessing()
 {
+  // Fragments left over from the previous run would break the event order
+  clear();
+
+  nextGenerator_ = 0;
+  nextSendNSec_ = 0;
+  generatorFailed_ = false;
+  generatorException_.reset();
+  nsecPerByte_ = throughputLimitGBps_.value_ > 0 ? 1 / throughputLimitGBps_.value_ : 0;
+
   doProcessing_ = true;
-  superFragmentGenerator_.reset();
-  generatingWL_->submit(generatingAction_);
+  startGenerators();
   sendingWL_->submit(sendingAction_);
 }
 
@@ -184,35 +297,41 @@ void rubuilder::rui::RUI::startProcessing()
 void rubuilder::rui::RUI::stopProcessing()
 {
   doProcessing_ = false;
-  while (generatingActive_) ::usleep(1000);
+  stopGenerators();
   while (sendingActive_) ::usleep(1000);
 }
 
 
-void rubuilder::rui::RUI::startWorkLoops()
+void rubuilder::rui::RUI::startGenerators()
 {
-  try
+  for (Generators::const_iterator it = generators_.begin(), itEnd = generators_.end();
+       it != itEnd; ++it)
   {
-    const std::string identifier = utils::getIdentifier(app_->getApplicationDescriptor());
-    
-    generatingWL_ = toolbox::task::getWorkLoopFactory()->
-      getWorkLoop( identifier + "Generating", "waiting" );
-    
-    if ( ! generatingWL_->isActive() )
-    {
-      generatingAction_ =
-        toolbox::task::bind(this, &rubuilder::rui::RUI::generating,
-          identifier + "generating");
-      
-      generatingWL_->activate();
-    }
+    (*it)->superFragmentGenerator.reset();
+    (*it)->evbIdFactory.reset();
+    (*it)->thread.reset( new boost::thread(
+        boost::bind(&rubuilder::rui::RUI::generating, this, it->get())
+      ) );
   }
-  catch (xcept::Exception& e)
+}
+
+
+void rubuilder::rui::RUI::stopGenerators()
+{
+  for (Generators::const_iterator it = generators_.begin(), itEnd = generators_.end();
+       it != itEnd; ++it)
   {
-    std::string msg = "Failed to start workloop 'Generating'.";
-    XCEPT_RETHROW(exception::WorkLoop, msg, e);
+    if ( (*it)->thread )
+    {
+      (*it)->thread->join();
+      (*it)->thread.reset();
+    }
   }
+}
+
 
+void rubuilder::rui::RUI::startWorkLoops()
+{
   try
   {
     const std::string identifier = utils::getIdentifier(app_->getApplicationDescriptor());
@@ -237,38 +356,142 @@ void rubuilder::rui::RUI::startWorkLoops()
 }
 
 
-bool rubuilder::rui::RUI::generating(toolbox::task::WorkLoop *wl)
+void rubuilder::rui::RUI::generating(Generator* generator)
 {
-  generatingActive_ = true;
-  
-  toolbox::mem::Reference* bufRef = 0;
-  if ( superFragmentGenerator_.getData(bufRef) )
+  const std::string identifier = utils::getIdentifier(app_->getApplicationDescriptor());
+  const uint32_t nbGenerators = generators_.size();
+
+  // Generator i builds the events i+1, i+1+nbGenerators, ...
+  uint32_t eventIndex = generator->index;
+
+  try
   {
-    while (bufRef)
+    utils::getResourcePlacement().pinCurrentThread(
+      getGeneratorName(identifier + "Generating", generator->index));
+
+    while ( doProcessing_ )
     {
-      // Break any chained references
-      toolbox::mem::Reference* nextRef = bufRef->getNextReference();
-      bufRef->setNextReference(0);
-      
-      while ( doProcessing_ && !fragmentFIFO_.enq(bufRef) ) { ::usleep(1000); }
-      
-      bufRef = nextRef;
+      toolbox::mem::Reference* bufRef = 0;
+
+      if ( usePlayback_.value_ )
+      {
+        while ( doProcessing_ && !generator->superFragmentGenerator.getData(bufRef) ) ::usleep(10);
+      }
+      else
+      {
+        const utils::EvBid evbId = generator->evbIdFactory.getEvBid(eventIndex + 1);
+        while ( doProcessing_ && !generator->superFragmentGenerator.getData(bufRef,evbId) ) ::usleep(10);
+        eventIndex = (eventIndex + nbGenerators) % maxEventNumber;
+      }
+
+      if ( bufRef && !enqueueBlocks(generator,bufRef) ) break;
     }
   }
-  
-  generatingActive_ = false;
+  catch(xcept::Exception& e)
+  {
+    std::ostringstream msg;
+    msg << "Generator " << generator->index << " failed";
+    XCEPT_DECLARE_NESTED(exception::SuperFragment,
+      sentinelException, msg.str(), e);
+    generatorFailed(sentinelException);
+  }
+  catch(std::exception& e)
+  {
+    std::ostringstream msg;
+    msg << "Generator " << generator->index << " failed: " << e.what();
+    XCEPT_DECLARE(exception::SuperFragment,
+      sentinelException, msg.str());
+    generatorFailed(sentinelException);
+  }
+  catch(...)
+  {
+    std::ostringstream msg;
+    msg << "Generator " << generator->index << " failed: unknown exception";
+    XCEPT_DECLARE(exception::SuperFragment,
+      sentinelException, msg.str());
+    generatorFailed(sentinelException);
+  }
+}
 
-  return doProcessing_;
+
+void rubuilder::rui::RUI::generatorFailed(xcept::Exception& e)
+{
+  LOG4CPLUS_ERROR(app_->getApplicationLogger(), xcept::stdformat_exception_history(e));
+
+  // The state machine cannot be failed from the generator thread,
+  // as leaving the enabled state joins the generator threads
+  boost::mutex::scoped_lock sl(generatorExceptionMutex_);
+  if ( ! generatorException_ )
+  {
+    generatorException_.reset( new xcept::Exception(e) );
+    generatorFailed_ = true;
+  }
+}
+
+
+bool rubuilder::rui::RUI::enqueueBlocks
+(
+  Generator* generator,
+  toolbox::mem::Reference* bufRef
+)
+{
+  while (bufRef)
+  {
+    // Break any chained references
+    toolbox::mem::Reference* nextRef = bufRef->getNextReference();
+    bufRef->setNextReference(0);
+
+    // Back off only briefly, as the sender empties a FIFO within micro seconds
+    while ( !generator->fragmentFIFO.enq(bufRef) )
+    {
+      if ( ! doProcessing_ )
+      {
+        bufRef->setNextReference(nextRef);
+        bufRef->release();
+        return false;
+      }
+      ::usleep(10);
+    }
+
+    bufRef = nextRef;
+  }
+  return true;
 }
 
 
 bool rubuilder::rui::RUI::sending(toolbox::task::WorkLoop *wl)
 {
   sendingActive_ = true;
+
+  if ( generatorFailed_ )
+  {
+    // The events of the failed generator will never arrive
+    boost::shared_ptr<xcept::Exception> exception;
+    {
+      boost::mutex::scoped_lock sl(generatorExceptionMutex_);
+      exception = generatorException_;
+    }
+    sendingActive_ = false;
+    stateMachine_->processFSMEvent( utils::Fail(*exception) );
+    return false;
+  }
+
+  utils::getResourcePlacement().pinCurrentThread(wl->getName());
   
   toolbox::mem::Reference* bufRef = 0;
-  if ( fragmentFIFO_.deq(bufRef) )
+  if ( generators_[nextGenerator_]->fragmentFIFO.deq(bufRef) )
   {
+    const I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block =
+      (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)bufRef->getDataLocation();
+
+    // The next event is built by the next generator
+    if ( block->blockNb == (block->nbBlocksInSuperFragment - 1) )
+    {
+      if ( ++nextGenerator_ == generators_.size() ) nextGenerator_ = 0;
+    }
+
+    if ( nsecPerByte_ > 0 ) limitThroughput(bufRef->getDataSize());
+
     sendData(bufRef);
   }
  
@@ -278,6 +501,29 @@ bool rubuilder::rui::RUI::sending(toolbox::task::WorkLoop *wl)
 }
 
 
+void rubuilder::rui::RUI::limitThroughput(const uint32_t nbBytes)
+{
+  const uint64_t nowNSec = getTimeNSec();
+
+  if ( nextSendNSec_ + maxBurstNSec < nowNSec )
+  {
+    // Do not catch up for more than the maximum burst after being idle
+    nextSendNSec_ = nowNSec - maxBurstNSec;
+  }
+  else if ( nextSendNSec_ > nowNSec )
+  {
+    const uint64_t wakeUpNSec = static_cast<uint64_t>(nextSendNSec_);
+    struct timespec wakeUp;
+    wakeUp.tv_sec = wakeUpNSec / 1000000000;
+    wakeUp.tv_nsec = wakeUpNSec % 1000000000;
+
+    while ( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, 0) == EINTR ) {}
+  }
+
+  nextSendNSec_ += nbBytes * nsecPerByte_;
+}
+
+
 
 void rubuilder::rui::RUI::sendData(toolbox::mem::Reference* bufRef)
 {
@@ -304,14 +550,17 @@ void rubuilder::rui::RUI::sendData(toolbox::mem::Reference* bufRef)
       ++dataMonitoring_.logicalCount;
   }
  
-  app_->getApplicationContext()->
-    postFrame(
-      bufRef,
-      app_->getApplicationDescriptor(),
-      ru_.descriptor//,
-      //i2oExceptionHandler_,
-      //bu
-    );
+  utils::postFrame(app_, bufRef, ru_.descriptor);
+}
+
+
+void rubuilder::rui::RUI::printFragmentFIFO(xgi::Output* out)
+{
+  for (Generators::const_iterator it = generators_.begin(), itEnd = generators_.end();
+       it != itEnd; ++it)
+  {
+    (*it)->fragmentFIFO.printVerticalHtml(out);
+  }
 }
 
 
@@ -398,11 +647,29 @@ void rubuilder::rui::RUI::printHtml(xgi::Output *out, const uint32_t monitoringS
     out->precision(originalPrecision);
   }
  
-  *out << "<tr>"                                                  << std::endl;
-  *out << "<td style=\"text-align:center\" colspan=\"2\">"        << std::endl;
-  fragmentFIFO_.printHtml(out, app_->getApplicationDescriptor()->getURN());
-  *out << "</td>"                                                 << std::endl;
-  *out << "</tr>"                                                 << std::endl;
+  if ( ! generators_.empty() )
+  {
+    // The fragmentFIFO page shows the FIFOs of all generators
+    *out << "<tr>"                                                  << std::endl;
+    *out << "<td style=\"text-align:center\" colspan=\"2\">"        << std::endl;
+    generators_[0]->fragmentFIFO.printHtml(out, app_->getApplicationDescriptor()->getURN());
+    *out << "</td>"                                                 << std::endl;
+    *out << "</tr>"                                                 << std::endl;
+
+    if ( generators_.size() > 1 )
+    {
+      uint32_t nbBlocks = 0;
+      for (Generators::const_iterator it = generators_.begin(), itEnd = generators_.end();
+           it != itEnd; ++it)
+      {
+        nbBlocks += (*it)->fragmentFIFO.elements();
+      }
+      *out << "<tr>"                                                  << std::endl;
+      *out << "<td>blocks in all fragment FIFOs</td>"                 << std::endl;
+      *out << "<td>" << nbBlocks << "</td>"                           << std::endl;
+      *out << "</tr>"                                                 << std::endl;
+    }
+  }
 
   ruiParams_.printHtml("Configuration", out);
   *out << "<tr>"                                                  << std::endl;
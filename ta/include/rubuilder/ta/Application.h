@@ -1,9 +1,12 @@
 #ifndef _rubuilder_ta_Application_h_
 #define _rubuilder_ta_Application_h_
 
+#include "rubuilder/ta/RateProfile.h"
 #include "rubuilder/ta/SynchronizedString.h"
+#include "rubuilder/ta/TriggerPacer.h"
 #include "rubuilder/ta/exception/Exception.h"
 #include "rubuilder/utils/EvBidFactory.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "rubuilder/utils/SuperFragmentGenerator.h"
 #include "rubuilder/utils/WebUtils.h"
 #include "i2o/i2oDdmLib.h"
@@ -22,6 +25,8 @@
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger32.h"
 
+#include <boost/thread/mutex.hpp>
+
 
 namespace rubuilder { namespace ta { // namespace rubuilder::ta
 
@@ -59,6 +64,11 @@ protected:
      */
     toolbox::exception::HandlerSignature *i2oExceptionHandler_;
 
+    /**
+     * The I2O callbacks indexed by function code for the loopback transport.
+     */
+    rubuilder::utils::LoopbackTransport::Callbacks i2oCallbacks_;
+
     /**
      * The logger of this application.
      */
@@ -157,11 +167,6 @@ protected:
      */
     I2O_TID evmTid_;
 
-    /**
-     * Memory pool from which buffers for dummy triggers are taken.
-     */
-    toolbox::mem::Pool *triggerPool_;
-
     /**
      * The start time of the current trigger simulation interval.
      */
@@ -197,14 +202,21 @@ protected:
     toolbox::task::ActionSignature *triggerActionSignature_;
 
     /**
-     * The start time of the current monitoring interval.
+     * The start time in nano seconds of the current monitoring interval.
      */
-    struct timeval monitoringStartTime_;
+    uint64_t monitoringStartNSec_;
 
     /**
-     * The number of events at the start of the current monitoring interval.
+     * The number of triggers sent at the start of the current monitoring
+     * interval.
      */
-    unsigned int monitoringStartEventNumber_;
+    uint64_t monitoringStartNbTriggersSent_;
+
+    /**
+     * The deadtime in nano seconds at the start of the current monitoring
+     * interval.
+     */
+    uint64_t monitoringStartDeadtimeNSec_;
 
     /**
      * The name of the work loop that executes the action of updating
@@ -308,6 +320,57 @@ protected:
      */
     xdata::Boolean doTriggerSimulation_;
 
+    /**
+     * Exported read/write parameter specifying if I2O frames to and from
+     * applications in the same executive go through the loopback transport
+     */
+    xdata::Boolean i2oLoopback_;
+
+    /**
+     * Exported read/write parameter specifying the mean rate in Hz at which
+     * the trigger simulation generates triggers.  A rate of 0 means that a
+     * trigger is sent for each trigger credit received from the EVM.
+     */
+    xdata::UnsignedInteger32 triggerRate_;
+
+    /**
+     * Exported read/write parameter specifying the arrival profile of the
+     * simulated triggers: "constant", "poisson", "bursty" or "lhc".
+     */
+    xdata::String triggerProfile_;
+
+    /**
+     * Exported read/write parameter specifying the mean number of triggers
+     * in a burst of the "bursty" trigger profile.
+     */
+    xdata::UnsignedInteger32 triggerBurstSize_;
+
+    /**
+     * Exported read/write parameter specifying the time slice in micro
+     * seconds after which the trigger simulation sends the triggers that
+     * arrived in the meantime.
+     */
+    xdata::UnsignedInteger32 triggerTimeSliceUSec_;
+
+    /**
+     * Exported read/write parameter specifying the file of the trigger rate
+     * profile to be replayed by the trigger simulation.  The rate profile
+     * replaces the trigger rate if the file name is not empty.
+     */
+    xdata::String rateProfileFile_;
+
+    /**
+     * Exported read/write parameter specifying the huge page size in KB
+     * backing the pool of the dummy triggers.  A size of 0 uses the heap.
+     */
+    xdata::UnsignedInteger32 poolHugePageSizeKB_;
+
+    /**
+     * Exported read/write parameter specifying the size in MB pre-faulted
+     * at configure for a huge page backed trigger pool.
+     */
+    xdata::UnsignedInteger32 poolCommittedSizeMB_;
+
     ////////////////////////////////////////////////////////
     // End of exported parameters for configuration       //
     ////////////////////////////////////////////////////////
@@ -438,17 +501,66 @@ protected:
      */
     xdata::UnsignedInteger32         skipLS_;
 
+    /**
+     * Number of simulated triggers vetoed because no credit was available
+     */
+    xdata::UnsignedInteger32         vetoedTriggers_;
+
 
     ////////////////////////////////////////////////////////////
     // End of exported parameters of trigger simulation       //
     ////////////////////////////////////////////////////////////
 
     /**
-     * Helper variables for trigger simulation
+     * Protects the trigger credits, the trigger simulation state and the
+     * sending of triggers.  The trigger simulation does not take
+     * applicationBSem_, as the work loop is cancelled while holding it.
      */
-    //uint32_t                         deltaTriggerRate_;
-    uint32_t                         orbitTimeCounter_;
-    timeval                          lsStartTime_;
+    boost::mutex                     triggerMutex_;
+
+    /**
+     * Set to true while triggers of the trigger simulation may be sent
+     */
+    bool                             triggersEnabled_;
+
+    /**
+     * Helper variables for trigger simulation.  Times are given in nano
+     * seconds since the start of the simulation.
+     */
+    TriggerPacer                     triggerPacer_;
+    uint32_t                         pacedTriggerRate_;
+    uint64_t                         simulationStartNSec_;
+    uint64_t                         nextTimeSliceNSec_;
+    uint64_t                         nextTriggerNSec_;
+    uint16_t                         nextBunchCrossing_;
+    uint32_t                         orbitOffset_;
+    uint64_t                         lsStartNSec_;
+
+    /**
+     * Number of triggers sent since the application was configured
+     */
+    uint64_t                         nbTriggersSent_;
+
+    /**
+     * Accumulated deadtime, and start of the ongoing deadtime or
+     * NO_DEADTIME.  The TA is dead from the first vetoed trigger until
+     * credits are received.
+     */
+    uint64_t                         deadtimeNSec_;
+    uint64_t                         deadtimeStartNSec_;
+    static const uint64_t            NO_DEADTIME = ~0ULL;
+
+    /**
+     * The replayed trigger rate profile and its current segment, together
+     * with the lumi section, time and counters at the start of the segment.
+     */
+    RateProfile                      rateProfile_;
+    uint32_t                         rateProfileSegment_;
+    uint32_t                         segmentFirstLumiSection_;
+    uint64_t                         segmentStartNSec_;
+    uint64_t                         segmentStartNbTriggersSent_;
+    uint32_t                         segmentStartVetoedTriggers_;
+    uint64_t                         segmentStartDeadtimeNSec_;
 
     /**
      * Returns the name to be given to the logger of this application.
@@ -592,10 +704,65 @@ protected:
     void stopTriggerSimulation();
 
     /**
-     * Updates monitoring information.
+     * Sends the triggers which arrived during the last time slice.
      */
     bool simulateTrigger(toolbox::task::WorkLoop *wl);
 
+    /**
+     * Returns true if the trigger simulation paces the triggers itself
+     * instead of sending one trigger per credit.
+     */
+    bool isPacingTriggers() const
+    {
+        return doTriggerSimulation_.value_ &&
+            (targetTriggerRate_.value_ > 0 || !rateProfile_.empty());
+    }
+
+    /**
+     * Updates the orbit and lumi section numbers for the specified time.
+     */
+    void updateOrbit(const uint64_t nowNSec);
+
+    /**
+     * Sends or vetoes the triggers arrived up to the specified time.
+     */
+    void paceTriggers(const uint64_t nowNSec)
+    throw (rubuilder::ta::exception::Exception);
+
+    /**
+     * Ends the ongoing deadtime, if any, at the specified time.
+     */
+    void endDeadtime(const uint64_t nowNSec);
+
+    /**
+     * Returns the deadtime accumulated up to the specified time.
+     */
+    uint64_t getDeadtimeNSec(const uint64_t nowNSec) const;
+
+    /**
+     * Switches to the segment of the rate profile of the current lumi
+     * section if it changed.
+     */
+    void updateRateProfileSegment(const uint64_t nowNSec);
+
+    /**
+     * Adds the statistics of the current segment of the rate profile, which
+     * ends at the specified time.
+     */
+    void endRateProfileSegment(const uint64_t nowNSec);
+
+    /**
+     * Prints the planned versus the achieved rates of the segments of the
+     * rate profile.
+     */
+    void printRateProfileTable(xgi::Output *out);
+
+    /**
+     * Returns the time in nano seconds since the start of the trigger
+     * simulation.
+     */
+    uint64_t getSimulationTimeNSec() const;
+
     /**
      * Starts periodic monitoring calculations.
      */
@@ -702,6 +869,17 @@ protected:
     void sendNTriggers(const unsigned int n)
     throw (rubuilder::ta::exception::Exception);
 
+    /**
+     * Sends a trigger for the specified bunch crossing to the EVM.
+     */
+    void sendTrigger
+    (
+        const uint32_t orbit,
+        const uint32_t lumiSection,
+        const uint16_t bunchCrossing
+    )
+    throw (rubuilder::ta::exception::Exception);
+
     /**
      * I2O callback routine invoked when a trigger credit count has been
      * received from the EVM.
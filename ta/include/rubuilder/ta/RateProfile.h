@@ -0,0 +1,134 @@
+#ifndef _rubuilder_ta_RateProfile_h_
+#define _rubuilder_ta_RateProfile_h_
+
+#include "rubuilder/ta/exception/Exception.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace rubuilder { namespace ta { // namespace rubuilder::ta
+
+/**
+ * A trigger rate profile given as a sequence of segments, each lasting a
+ * number of lumi sections, together with the statistics of its replay.
+ *
+ * A rate profile file contains one segment per line:
+ *
+ *   <nbLumiSections> <triggerRate> [<meanBurstSize>]
+ *
+ * where the trigger rate is given in Hz and the optional mean burst size
+ * replaces the configured one of the "bursty" profile during the segment.
+ * Empty lines and lines starting with '#' are ignored.  The profile is
+ * replayed in a loop.
+ */
+class RateProfile
+{
+public:
+
+    struct Segment
+    {
+        uint32_t nbLumiSections;
+        uint32_t triggerRate;
+        uint32_t meanBurstSize;
+
+        /**
+         * Statistics summed over all replays of the segment.
+         */
+        uint32_t nbReplays;
+        uint64_t durationNSec;
+        uint64_t nbTriggersSent;
+        uint64_t nbTriggersVetoed;
+        uint64_t creditStarvationNSec;
+
+        Segment();
+
+        /**
+         * Returns the rate in Hz at which triggers were sent.
+         */
+        double getAchievedRate() const;
+
+        /**
+         * Returns the fraction of the time without trigger credits.
+         */
+        double getCreditStarvationFraction() const;
+    };
+
+    typedef std::vector<Segment> Segments;
+
+    /**
+     * Returned instead of a segment index if the profile is empty.
+     */
+    static const uint32_t NO_SEGMENT = ~0U;
+
+    /**
+     * Constructor.
+     */
+    RateProfile();
+
+    /**
+     * Replaces the segments by the ones read from the specified file.
+     */
+    void load(const std::string fileName)
+    throw (rubuilder::ta::exception::Exception);
+
+    /**
+     * Removes all segments.
+     */
+    void clear();
+
+    /**
+     * Returns true if the profile has no segments.
+     */
+    bool empty() const
+    { return segments_.empty(); }
+
+    /**
+     * Returns the segments together with their statistics.
+     */
+    const Segments& getSegments() const
+    { return segments_; }
+
+    /**
+     * Returns the index of the segment replayed during the specified lumi
+     * section counted from the start of the replay, and sets the lumi
+     * section at which this replay of the segment started.
+     */
+    uint32_t getSegmentIndex
+    (
+        const uint32_t lumiSection,
+        uint32_t       &firstLumiSection
+    ) const;
+
+    /**
+     * Adds the statistics of one replay of the specified segment.
+     */
+    void addReplay
+    (
+        const uint32_t segmentIndex,
+        const uint64_t durationNSec,
+        const uint64_t nbTriggersSent,
+        const uint64_t nbTriggersVetoed,
+        const uint64_t creditStarvationNSec
+    );
+
+    /**
+     * Resets the statistics of all segments.
+     */
+    void resetStatistics();
+
+
+private:
+
+    Segments segments_;
+
+    /**
+     * Total number of lumi sections of the profile.
+     */
+    uint32_t nbLumiSections_;
+};
+
+} } // namespace rubuilder::ta
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef _rubuilder_ta_TriggerPacer_h_
+#define _rubuilder_ta_TriggerPacer_h_
+
+#include "rubuilder/ta/exception/Exception.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace rubuilder { namespace ta { // namespace rubuilder::ta
+
+/**
+ * Generates the arrival times of emulated level 1 triggers.
+ *
+ * The times are given in nano seconds since the start of the run. Each
+ * trigger is assigned to a bunch crossing of the LHC orbit of 3564 bunch
+ * crossings of 25 ns.
+ *
+ * The following arrival profiles are supported:
+ *
+ * "constant" - triggers are equally spaced.
+ *
+ * "poisson"  - triggers arrive independently of each other, i.e. the time
+ *              between two triggers is exponentially distributed.
+ *
+ * "bursty"   - bursts of triggers arrive as a Poisson process.  The number
+ *              of triggers in a burst is geometrically distributed around
+ *              the mean burst size.  The triggers of a burst are separated
+ *              by the minimum trigger spacing of 3 bunch crossings.
+ *
+ * "lhc"      - triggers only occur on filled bunch crossings of the nominal
+ *              25 ns filling scheme, each with the same probability.
+ */
+class TriggerPacer
+{
+public:
+
+    enum Profile
+    {
+        CONSTANT,
+        POISSON,
+        BURSTY,
+        LHC
+    };
+
+    /**
+     * Returns the profile with the specified name.
+     */
+    static Profile getProfile(const std::string name)
+    throw (rubuilder::ta::exception::Exception);
+
+    /**
+     * Returns the name of the specified profile.
+     */
+    static std::string getProfileName(const Profile profile);
+
+    /**
+     * Duration of an LHC orbit in nano seconds.
+     */
+    static const uint64_t ORBIT_NSEC = 3564 * 25;
+
+    /**
+     * Minimum time between two triggers in nano seconds.
+     */
+    static const uint64_t MIN_TRIGGER_SPACING_NSEC = 3 * 25;
+
+    /**
+     * Returned instead of an arrival time if no trigger will arrive.
+     */
+    static const uint64_t NO_TRIGGER = ~0ULL;
+
+    /**
+     * Constructor.
+     */
+    TriggerPacer();
+
+    /**
+     * Restarts the arrival times at 0 with the specified profile.
+     */
+    void configure
+    (
+        const Profile  profile,
+        const double   triggerRate,
+        const uint32_t meanBurstSize,
+        const uint32_t seed
+    );
+
+    /**
+     * Changes the mean trigger rate in Hz from the specified time on.
+     * No triggers are generated for a rate of 0.
+     */
+    void setTriggerRate(const double triggerRate, const uint64_t nowNSec);
+
+    /**
+     * Changes the mean number of triggers in a burst.
+     */
+    void setMeanBurstSize(const uint32_t meanBurstSize);
+
+    /**
+     * Returns the mean trigger rate in Hz.
+     */
+    double getTriggerRate() const
+    { return triggerRate_; }
+
+    /**
+     * Returns the arrival time in nano seconds of the next trigger, and
+     * sets the bunch crossing number (1 to 3564) of this trigger.  Returns
+     * NO_TRIGGER if the trigger rate is 0.
+     */
+    uint64_t getNextTriggerNSec(uint16_t &bunchCrossing);
+
+
+private:
+
+    /**
+     * Returns a uniformly distributed random number in (0,1].
+     */
+    double getUniform();
+
+    /**
+     * Returns an exponentially distributed time with the specified mean.
+     */
+    double getExponential(const double meanNSec);
+
+    /**
+     * Returns the number of failures before the first success of Bernoulli
+     * trials with the specified success probability.
+     */
+    uint64_t getGeometric(const double probability);
+
+    /**
+     * Moves the candidate for the next trigger of the "lhc" profile by the
+     * specified number of filled bunch crossings.
+     */
+    void skipFilledBunches(const uint64_t nbBunches);
+
+    /**
+     * Moves the candidate for the next trigger of the "lhc" profile to the
+     * first filled bunch crossing at or after the specified time.
+     */
+    void moveToFilledBunch(const uint64_t timeNSec);
+
+    Profile  profile_;
+    double   triggerRate_;
+    uint32_t meanBurstSize_;
+    uint64_t random_;
+
+    /**
+     * Arrival time of the last trigger.
+     */
+    double   lastTriggerNSec_;
+
+    /**
+     * Arrival time of the first trigger of the current burst.
+     */
+    double   burstStartNSec_;
+
+    /**
+     * Number of triggers left in the current burst.
+     */
+    uint64_t nbTriggersLeftInBurst_;
+
+    /**
+     * The filled bunch crossings of the LHC orbit.
+     */
+    std::vector<uint16_t> filledBunches_;
+
+    /**
+     * Orbit and index into filledBunches_ of the candidate for the next
+     * trigger of the "lhc" profile.
+     */
+    uint64_t orbit_;
+    uint32_t filledBunchIndex_;
+};
+
+} } // namespace rubuilder::ta
+
+#endif
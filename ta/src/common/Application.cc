@@ -18,7 +18,6 @@
 #include "interface/shared/i2oXFunctionCodes.h"
 #include "toolbox/utils.h"
 #include "toolbox/fsm/FailedEvent.h"
-#include "toolbox/mem/HeapAllocator.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 #include "xdaq/NamespaceURI.h"
@@ -38,7 +37,24 @@
 #include "cgicc/FormEntry.h"
 #include "cgicc/HTMLClasses.h"
 
+#include <algorithm>
+#include <errno.h>
 #include <netinet/in.h>
+#include <time.h>
+
+
+namespace
+{
+    uint64_t getMonotonicTimeNSec()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+}
+
+
+const uint64_t rubuilder::ta::Application::NO_DEADTIME;
 
 
 rubuilder::ta::Application::Application(xdaq::ApplicationStub *s)
@@ -50,7 +66,24 @@ logger_(getApplicationLogger()),
 
 applicationBSem_(toolbox::BSem::FULL),
 superFragmentGenerator_(getApplicationDescriptor()->getURN()),
-soapParameterExtractor_(this)
+soapParameterExtractor_(this),
+triggersEnabled_(false),
+pacedTriggerRate_(0),
+simulationStartNSec_(getMonotonicTimeNSec()),
+nextTimeSliceNSec_(0),
+nextTriggerNSec_(TriggerPacer::NO_TRIGGER),
+nextBunchCrossing_(0),
+orbitOffset_(0),
+lsStartNSec_(0),
+nbTriggersSent_(0),
+deadtimeNSec_(0),
+deadtimeStartNSec_(NO_DEADTIME),
+rateProfileSegment_(RateProfile::NO_SEGMENT),
+segmentFirstLumiSection_(0),
+segmentStartNSec_(0),
+segmentStartNbTriggersSent_(0),
+segmentStartVetoedTriggers_(0),
+segmentStartDeadtimeNSec_(0)
 {
     tid_           = 0;
     i2oAddressMap_ = i2o::utils::getAddressMap();
@@ -78,20 +111,6 @@ soapParameterExtractor_(this)
         "onI2oException"
     );
 
-    // Create a memory pool for dummy triggers
-    try
-    {
-        toolbox::net::URN urn("toolbox-mem-pool", "Dummy trigger pool");
-        toolbox::mem::HeapAllocator* a = new toolbox::mem::HeapAllocator();
-
-        triggerPool_ = poolFactory_->createPool(urn, a);
-    }
-    catch (toolbox::mem::exception::Exception e)
-    {
-        XCEPT_RETHROW(xdaq::exception::Exception,
-            "Failed to create dummy trigger pool", e);
-    }
-
     try
     {
         defineFsm();
@@ -309,6 +328,14 @@ rubuilder::ta::Application::initAndGetStdConfigParams()
     triggerSourceId_ = rubuilder::utils::GTP_FED_ID;
     monitoringSleepSec_ = 1;
     doTriggerSimulation_ = true;
+    i2oLoopback_ = false;
+    triggerRate_ = 0;
+    triggerProfile_ = "constant";
+    triggerBurstSize_ = 16;
+    triggerTimeSliceUSec_ = 100;
+    rateProfileFile_ = "";
+    poolHugePageSizeKB_ = 0;
+    poolCommittedSizeMB_ = 0;
 
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("evmInstance", &evmInstance_));
@@ -318,6 +345,22 @@ rubuilder::ta::Application::initAndGetStdConfigParams()
         ("monitoringSleepSec", &monitoringSleepSec_));
     params.push_back(std::pair<std::string,xdata::Serializable*>
         ("doTriggerSimulation", &doTriggerSimulation_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("i2oLoopback", &i2oLoopback_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("triggerRate", &triggerRate_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("triggerProfile", &triggerProfile_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("triggerBurstSize", &triggerBurstSize_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("triggerTimeSliceUSec", &triggerTimeSliceUSec_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("rateProfileFile", &rateProfileFile_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("poolHugePageSizeKB", &poolHugePageSizeKB_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("poolCommittedSizeMB", &poolCommittedSizeMB_));
 
     return params;
 }
@@ -349,6 +392,7 @@ rubuilder::ta::Application::initAndGetTriggerParams()
     measuredTriggerRate_         = 0;
     deadtimeFraction_            = 0;
     skipLS_                      = 0;
+    vetoedTriggers_              = 0;
 
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("Orbit", &orbit_));
@@ -364,6 +408,8 @@ rubuilder::ta::Application::initAndGetTriggerParams()
         ("DeadtimeFraction", &deadtimeFraction_));
     params.push_back(std::pair<std::string,xdata::Serializable *>
         ("SkipLS", &skipLS_));
+    params.push_back(std::pair<std::string,xdata::Serializable *>
+        ("VetoedTriggers", &vetoedTriggers_));
 
     return params;
 }
@@ -790,6 +836,9 @@ void rubuilder::ta::Application::bindI2oCallbacks()
         I2O_TA_CREDIT,
         XDAQ_ORGANIZATION_ID
     );
+
+    i2oCallbacks_[I2O_TA_CREDIT] =
+        boost::bind(&rubuilder::ta::Application::taCreditMsg, this, _1);
 }
 
 
@@ -913,6 +962,8 @@ throw (xgi::exception::Exception)
         *out << cgicc::input().set("type","text").set("name","skipLS").set("value",skipLS_.toString()) << std::endl;
         *out << cgicc::input().set("type","submit").set("value","DoIt") << std::endl;
         *out << cgicc::form() << std::endl;  
+
+        printRateProfileTable(out);
     }
     catch(xcept::Exception &e)
     {
@@ -943,6 +994,62 @@ throw (xgi::exception::Exception)
 }
 
 
+void rubuilder::ta::Application::printRateProfileTable(xgi::Output *out)
+{
+    boost::mutex::scoped_lock sl(triggerMutex_);
+
+    if(rateProfile_.empty()) return;
+
+    const RateProfile::Segments &segments = rateProfile_.getSegments();
+
+    *out << "<br>"                                                << std::endl;
+    *out << "<table frame=\"void\" rules=\"rows\" class=\"params\">";
+    *out << std::endl;
+
+    *out << "  <tr>"                                              << std::endl;
+    *out << "    <th colspan=8>"                                  << std::endl;
+    *out << "      Rate profile " << rateProfileFile_.toString()  << std::endl;
+    *out << "    </th>"                                           << std::endl;
+    *out << "  </tr>"                                             << std::endl;
+
+    *out << "  <tr>"                                              << std::endl;
+    *out << "    <td>Segment</td>"                                << std::endl;
+    *out << "    <td>LS</td>"                                     << std::endl;
+    *out << "    <td>Planned rate (Hz)</td>"                      << std::endl;
+    *out << "    <td>Burst size</td>"                             << std::endl;
+    *out << "    <td>Replays</td>"                                << std::endl;
+    *out << "    <td>Achieved rate (Hz)</td>"                     << std::endl;
+    *out << "    <td>Credit starvation (s)</td>"                  << std::endl;
+    *out << "    <td>Vetoed triggers</td>"                        << std::endl;
+    *out << "  </tr>"                                             << std::endl;
+
+    for(uint32_t i=0; i<segments.size(); i++)
+    {
+        const RateProfile::Segment &segment = segments[i];
+
+        *out << "  <tr>"                                          << std::endl;
+        *out << "    <td>";
+        if(i == rateProfileSegment_) *out << "&gt; ";
+        *out << i << "</td>"                                      << std::endl;
+        *out << "    <td>" << segment.nbLumiSections << "</td>"   << std::endl;
+        *out << "    <td>" << segment.triggerRate << "</td>"      << std::endl;
+        *out << "    <td>";
+        if(segment.meanBurstSize > 0) *out << segment.meanBurstSize;
+        else *out << "-";
+        *out << "</td>"                                           << std::endl;
+        *out << "    <td>" << segment.nbReplays << "</td>"        << std::endl;
+        *out << "    <td>" << segment.getAchievedRate() << "</td>" << std::endl;
+        *out << "    <td>" << segment.creditStarvationNSec / 1e9;
+        *out << " (" << 100 * segment.getCreditStarvationFraction() << "%)";
+        *out << "</td>"                                           << std::endl;
+        *out << "    <td>" << segment.nbTriggersVetoed << "</td>" << std::endl;
+        *out << "  </tr>"                                         << std::endl;
+    }
+
+    *out << "</table>"                                            << std::endl;
+}
+
+
 void rubuilder::ta::Application::debugWebPage
 (
     xgi::Input  *in,
@@ -1039,7 +1146,11 @@ xoap::MessageReference rubuilder::ta::Application::resetMonitoringCountersMsg
 throw (xoap::exception::Exception)
 {
     applicationBSem_.take();
-    resetCounters(monitorCounters_);
+    {
+        boost::mutex::scoped_lock sl(triggerMutex_);
+        resetCounters(monitorCounters_);
+        rateProfile_.resetStatistics();
+    }
     applicationBSem_.give();
 
     std::string responseString = "resetMonitoringCountersResponse";
@@ -1079,6 +1190,11 @@ throw (toolbox::fsm::exception::Exception)
         XCEPT_RETHROW(toolbox::fsm::exception::Exception,
             "Failed to get application descriptors and tids", e);
     }
+
+    if ( i2oLoopback_ )
+        utils::getLoopbackTransport().bind(appDescriptor_, i2oCallbacks_, logger_);
+    else
+        utils::getLoopbackTransport().unbind(appDescriptor_);
     
     xdata::Vector<xdata::UnsignedInteger32> fedSourceIds;
     fedSourceIds.push_back(triggerSourceId_);
@@ -1094,7 +1210,64 @@ throw (toolbox::fsm::exception::Exception)
         fedPayloadSize                             + // FED payload
         sizeof(fedt_t);                              // FED trailer
     
-    superFragmentGenerator_.configure(fedSourceIds,false,"",blockSize,fedPayloadSize,0);
+    // The triggers are taken from the pool chosen by the pool configuration
+    rubuilder::utils::PoolConfiguration poolConfiguration;
+    poolConfiguration.hugePageSizeKB = poolHugePageSizeKB_.value_;
+    poolConfiguration.committedSizeMB = poolCommittedSizeMB_.value_;
+
+    // The trigger FED is copied from a single template, where only the event
+    // number and the L1 information are patched and the CRC is updated
+    try
+    {
+        superFragmentGenerator_.configure(fedSourceIds,false,"",blockSize,fedPayloadSize,0,
+            0,poolConfiguration,1);
+    }
+    catch(xcept::Exception &e)
+    {
+        XCEPT_RETHROW(toolbox::fsm::exception::Exception,
+            "Failed to configure the dummy trigger generator", e);
+    }
+
+    if(triggerTimeSliceUSec_.value_ == 0)
+    {
+        XCEPT_RAISE(toolbox::fsm::exception::Exception,
+            "The trigger time slice must be at least 1 micro second");
+    }
+
+    TriggerPacer::Profile triggerProfile;
+    try
+    {
+        triggerProfile = TriggerPacer::getProfile(triggerProfile_.value_);
+    }
+    catch(xcept::Exception &e)
+    {
+        XCEPT_RETHROW(toolbox::fsm::exception::Exception,
+            "Failed to configure the trigger simulation", e);
+    }
+
+    RateProfile rateProfile;
+    if(rateProfileFile_.value_ != "")
+    {
+        try
+        {
+            rateProfile.load(rateProfileFile_.value_);
+        }
+        catch(xcept::Exception &e)
+        {
+            XCEPT_RETHROW(toolbox::fsm::exception::Exception,
+                "Failed to load the trigger rate profile", e);
+        }
+    }
+
+    boost::mutex::scoped_lock sl(triggerMutex_);
+
+    rateProfile_        = rateProfile;
+    rateProfileSegment_ = RateProfile::NO_SEGMENT;
+
+    triggerPacer_.configure(triggerProfile, 0, triggerBurstSize_.value_,
+        static_cast<uint32_t>(time(0)) ^ instance_);
+    targetTriggerRate_ = triggerRate_;
+    vetoedTriggers_    = 0;
 }
 
 
@@ -1177,10 +1350,23 @@ throw (rubuilder::ta::exception::Exception)
 void rubuilder::ta::Application::enableAction(toolbox::Event::Reference e)
 throw (toolbox::fsm::exception::Exception)
 {
-    startTriggerSimulation();
+    try
+    {
+        startTriggerSimulation();
+    }
+    catch(xcept::Exception &e)
+    {
+        XCEPT_RETHROW(toolbox::fsm::exception::Exception,
+            "Failed to start the trigger simulation", e);
+    }
+
+    boost::mutex::scoped_lock sl(triggerMutex_);
 
-    // If there are some held credits
-    if(nbCreditsHeld_.value_ != 0)
+    triggersEnabled_ = true;
+
+    // If there are some held credits which are not left to the trigger
+    // simulation
+    if(nbCreditsHeld_.value_ != 0 && !isPacingTriggers())
     {
         // Send triggers for the held credits
         try
@@ -1204,15 +1390,22 @@ throw (toolbox::fsm::exception::Exception)
 void rubuilder::ta::Application::suspendAction(toolbox::Event::Reference e)
 throw (toolbox::fsm::exception::Exception)
 {
-    // Do nothing
+    boost::mutex::scoped_lock sl(triggerMutex_);
+
+    triggersEnabled_ = false;
 }
 
 
 void rubuilder::ta::Application::resumeAction(toolbox::Event::Reference e)
 throw (toolbox::fsm::exception::Exception)
 {
-    // If there are some held credits
-    if(nbCreditsHeld_.value_ != 0)
+    boost::mutex::scoped_lock sl(triggerMutex_);
+
+    triggersEnabled_ = true;
+
+    // If there are some held credits which are not left to the trigger
+    // simulation
+    if(nbCreditsHeld_.value_ != 0 && !isPacingTriggers())
     {
         // Send triggers for the held credits
         try
@@ -1236,13 +1429,40 @@ throw (toolbox::fsm::exception::Exception)
 void rubuilder::ta::Application::haltAction(toolbox::Event::Reference e)
 throw (toolbox::fsm::exception::Exception)
 {
+    // The work loop must be stopped before taking the trigger mutex, as the
+    // trigger simulation takes it
+    try
+    {
+        stopTriggerSimulation();
+    }
+    catch(xcept::Exception &e)
+    {
+        XCEPT_RETHROW(toolbox::fsm::exception::Exception,
+            "Failed to stop the trigger simulation", e);
+    }
+
+    boost::mutex::scoped_lock sl(triggerMutex_);
+
+    triggersEnabled_ = false;
+
     // Reset the dummy event number
     eventNumber_ = 1;
 
     // Reset the number of credits held
     nbCreditsHeld_ = 0;
 
-    stopTriggerSimulation();
+    const uint64_t nowNSec = getSimulationTimeNSec();
+
+    if(rateProfileSegment_ != RateProfile::NO_SEGMENT)
+    {
+        endRateProfileSegment(nowNSec);
+    }
+
+    // The deadtime ends when the TA is halted
+    if(deadtimeStartNSec_ != NO_DEADTIME)
+    {
+        endDeadtime(nowNSec);
+    }
 }
 
 
@@ -1308,40 +1528,57 @@ throw (toolbox::fsm::exception::Exception)
 void rubuilder::ta::Application::sendNTriggers(const unsigned int n)
 throw (rubuilder::ta::exception::Exception)
 {
-    toolbox::mem::Reference *bufRef = 0;
-    unsigned int            i       = 0;
+    unsigned int i = 0;
 
     for(i=0; i<n; i++)
     {
-        utils::L1Information l1Info;
-        l1Info.bunchCrossing = 0x123;
-        l1Info.eventType = 1;
-        l1Info.orbitNumber = orbit_.value_;
-        l1Info.lsNumber = lumiSection_.value_;
-        utils::setFakeTriggerBits(-1, l1Info);
+        sendTrigger(orbit_.value_, lumiSection_.value_, 0x123);
+    }
+}
+
+
+void rubuilder::ta::Application::sendTrigger
+(
+    const uint32_t orbit,
+    const uint32_t lumiSection,
+    const uint16_t bunchCrossing
+)
+throw (rubuilder::ta::exception::Exception)
+{
+    toolbox::mem::Reference *bufRef = 0;
 
-        utils::EvBid evbId = evbIdFactory_.getEvBid(eventNumber_);
-        if ( superFragmentGenerator_.getData(bufRef,evbId,l1Info) )
+    utils::L1Information l1Info;
+    l1Info.bunchCrossing = bunchCrossing;
+    l1Info.eventType = 1;
+    l1Info.orbitNumber = orbit;
+    l1Info.lsNumber = lumiSection;
+    utils::setFakeTriggerBits(-1, l1Info);
+
+    utils::EvBid evbId = evbIdFactory_.getEvBid(eventNumber_);
+    if ( superFragmentGenerator_.getData(bufRef,evbId,l1Info) )
+    {
+        // Add I2O routing information
+        I2O_MESSAGE_FRAME* stdMsg = (I2O_MESSAGE_FRAME*)bufRef->getDataLocation();
+        I2O_PRIVATE_MESSAGE_FRAME* pvtMsg = (I2O_PRIVATE_MESSAGE_FRAME*)stdMsg;
+        
+        stdMsg->InitiatorAddress = tid_;
+        stdMsg->TargetAddress    = evmTid_;
+        
+        pvtMsg->XFunctionCode    = I2O_EVM_TRIGGER;
+        pvtMsg->OrganizationID   = XDAQ_ORGANIZATION_ID;
+        
+        // Update parameters showing message payloads and counts
         {
-            // Add I2O routing information
-            I2O_MESSAGE_FRAME* stdMsg = (I2O_MESSAGE_FRAME*)bufRef->getDataLocation();
-            I2O_PRIVATE_MESSAGE_FRAME* pvtMsg = (I2O_PRIVATE_MESSAGE_FRAME*)stdMsg;
-            
-            stdMsg->InitiatorAddress = tid_;
-            stdMsg->TargetAddress    = evmTid_;
-            
-            pvtMsg->XFunctionCode    = I2O_EVM_TRIGGER;
-            pvtMsg->OrganizationID   = XDAQ_ORGANIZATION_ID;
-            
-            // Update parameters showing message payloads and counts
-            {
-                I2O_EVM_TRIGGER_Payload_.value_ += (stdMsg->MessageSize << 2) -
-                    sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME);
-                I2O_EVM_TRIGGER_LogicalCount_.value_++;
-                I2O_EVM_TRIGGER_I2oCount_.value_++;
-            }
-            
-            try
+            I2O_EVM_TRIGGER_Payload_.value_ += (stdMsg->MessageSize << 2) -
+                sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME);
+            I2O_EVM_TRIGGER_LogicalCount_.value_++;
+            I2O_EVM_TRIGGER_I2oCount_.value_++;
+        }
+        
+        try
+        {
+            if ( ! utils::getLoopbackTransport().postFrame
+                 (bufRef, appDescriptor_, evmDescriptor_) )
             {
                 appContext_->postFrame
                     (
@@ -1352,29 +1589,31 @@ throw (rubuilder::ta::exception::Exception)
                         evmDescriptor_
                     );
             }
-            catch(xcept::Exception &e)
-            {
-                std::stringstream oss;
-                
-                oss << "Failed to send dummy trigger";
-                oss << " (eventNumber=" << eventNumber_ << ")";
-                
-                XCEPT_RETHROW(rubuilder::ta::exception::Exception, oss.str(), e);
-            }
-            catch(...)
-            {
-                std::stringstream oss;
-                
-                oss << "Failed to send dummy trigger";
-                oss << " (eventNumber=" << eventNumber_ << ")";
-                oss << " : Unknown exception";
-                
-                XCEPT_RAISE(rubuilder::ta::exception::Exception, oss.str());
-            }
-
-            // Increment the event number
-            if (++eventNumber_.value_ % (1 << 24) == 0) eventNumber_.value_ = 1;
         }
+        catch(xcept::Exception &e)
+        {
+            std::stringstream oss;
+            
+            oss << "Failed to send dummy trigger";
+            oss << " (eventNumber=" << eventNumber_ << ")";
+            
+            XCEPT_RETHROW(rubuilder::ta::exception::Exception, oss.str(), e);
+        }
+        catch(...)
+        {
+            std::stringstream oss;
+            
+            oss << "Failed to send dummy trigger";
+            oss << " (eventNumber=" << eventNumber_ << ")";
+            oss << " : Unknown exception";
+            
+            XCEPT_RAISE(rubuilder::ta::exception::Exception, oss.str());
+        }
+
+        ++nbTriggersSent_;
+
+        // Increment the event number
+        if (++eventNumber_.value_ % (1 << 24) == 0) eventNumber_.value_ = 1;
     }
 }
 
@@ -1395,13 +1634,29 @@ void rubuilder::ta::Application::taCreditMsg(toolbox::mem::Reference *bufRef)
 
     try
     {
+        boost::mutex::scoped_lock sl(triggerMutex_);
+
+        // A deadtime caused by the lack of credits ends with new credits
+        if(msg->nbCredits > 0 && deadtimeStartNSec_ != NO_DEADTIME)
+        {
+            endDeadtime(getSimulationTimeNSec());
+        }
+
         switch(fsm_.getCurrentState())
         {
         case 'H': // Halted
         case 'F': // Failed
             break;
         case 'E': // Enabled
-            sendNTriggers(msg->nbCredits);
+            if(isPacingTriggers())
+            {
+                // The trigger simulation sends the triggers
+                nbCreditsHeld_.value_ += msg->nbCredits;
+            }
+            else
+            {
+                sendNTriggers(msg->nbCredits);
+            }
             break;
         case 'R': // Ready
         case 'S': // Suspended
@@ -1519,19 +1774,21 @@ void rubuilder::ta::Application::startTriggerSimulation()
             e);
     }
 
-    timeval before,after;
-    const uint32_t testRange = 1<<31;
-    volatile uint32_t counter;
-    gettimeofday(&before, 0);
-    for (uint32_t i=0; i<testRange; ++i)
-        ++counter;
-    gettimeofday(&after, 0);
-    orbitTimeCounter_ = (uint32_t)(3564*25e-9 // 3564 bunches every 25 ns (2808 bunches filled)
-        /  rubuilder::utils::calcDeltaTime(&before, &after)
-        * testRange);
-    lsStartTime_ = after;
-    orbit_ = 0;
-    lumiSection_ = 0;
+    {
+        boost::mutex::scoped_lock sl(triggerMutex_);
+
+        // The trigger pacer restarts from the new time origin with the
+        // first time slice
+        simulationStartNSec_ = getMonotonicTimeNSec();
+        nextTimeSliceNSec_   = 0;
+        pacedTriggerRate_    = 0;
+        nextTriggerNSec_     = TriggerPacer::NO_TRIGGER;
+        orbitOffset_         = 0;
+        lsStartNSec_         = 0;
+        orbit_               = 0;
+        lumiSection_         = 0;
+        rateProfileSegment_  = RateProfile::NO_SEGMENT;
+    }
 
     try
     {
@@ -1567,31 +1824,191 @@ bool rubuilder::ta::Application::simulateTrigger
     toolbox::task::WorkLoop *wl
 )
 {
-    volatile uint32_t dummyCounter;
-    for (uint32_t i = 0; i < orbitTimeCounter_; ++i)
-        ++dummyCounter;
+    // Sleep until the end of the current time slice
+    nextTimeSliceNSec_ += triggerTimeSliceUSec_.value_ * 1000ULL;
+
+    const uint64_t wakeUpNSec = simulationStartNSec_ + nextTimeSliceNSec_;
+    struct timespec wakeUp;
+    wakeUp.tv_sec  = wakeUpNSec / 1000000000;
+    wakeUp.tv_nsec = wakeUpNSec % 1000000000;
+    while ( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, 0) == EINTR ) {}
+
+    const uint64_t nowNSec = getSimulationTimeNSec();
 
-    ++orbit_.value_;
+    // Do not try to catch up with time slices missed on a loaded host.
+    // The triggers of the missed slices are sent with the current one.
+    if ( nowNSec > nextTimeSliceNSec_ ) nextTimeSliceNSec_ = nowNSec;
+
+    boost::mutex::scoped_lock sl(triggerMutex_);
+
+    updateOrbit(nowNSec);
+
+    try
+    {
+        paceTriggers(nowNSec);
+    }
+    catch(xcept::Exception &e)
+    {
+        LOG4CPLUS_ERROR(logger_,
+            "Failed to send simulated triggers : "
+             << stdformat_exception_history(e));
+    }
+
+    return continueTriggerSimulation_;
+}
+
+
+void rubuilder::ta::Application::updateOrbit(const uint64_t nowNSec)
+{
     if (skipLS_.value_ > 0)
-    { 
-        orbit_.value_ += (skipLS_.value_+1)*orbitsPerLS_;
+    {
+        orbitOffset_ += (skipLS_.value_+1)*orbitsPerLS_;
         skipLS_.value_ = 0;
     }
 
-    uint32_t lsn = orbit_.value_/orbitsPerLS_;
-    
+    orbit_.value_ = orbitOffset_ + nowNSec / TriggerPacer::ORBIT_NSEC;
+
+    const uint32_t lsn = orbit_.value_/orbitsPerLS_;
+
     if ( lsn != lumiSection_.value_ )
     {
-        timeval now;
-        gettimeofday(&now,0);
-
         lumiSection_.value_ = lsn;
-        previousLumiSectionDuration_ =
-            rubuilder::utils::calcDeltaTime(&lsStartTime_, &now);
-        lsStartTime_ = now;
+        previousLumiSectionDuration_ = (nowNSec - lsStartNSec_) / 1e9;
+        lsStartNSec_ = nowNSec;
     }
- 
-    return continueTriggerSimulation_;
+
+    if ( ! rateProfile_.empty() ) updateRateProfileSegment(nowNSec);
+}
+
+
+void rubuilder::ta::Application::updateRateProfileSegment(const uint64_t nowNSec)
+{
+    uint32_t firstLumiSection = 0;
+    const uint32_t segmentIndex =
+        rateProfile_.getSegmentIndex(lumiSection_.value_, firstLumiSection);
+
+    if ( segmentIndex == rateProfileSegment_ &&
+         firstLumiSection == segmentFirstLumiSection_ ) return;
+
+    if ( rateProfileSegment_ != RateProfile::NO_SEGMENT )
+        endRateProfileSegment(nowNSec);
+
+    const RateProfile::Segment &segment =
+        rateProfile_.getSegments()[segmentIndex];
+
+    rateProfileSegment_         = segmentIndex;
+    segmentFirstLumiSection_    = firstLumiSection;
+    segmentStartNSec_           = nowNSec;
+    segmentStartNbTriggersSent_ = nbTriggersSent_;
+    segmentStartVetoedTriggers_ = vetoedTriggers_.value_;
+    segmentStartDeadtimeNSec_   = getDeadtimeNSec(nowNSec);
+
+    // The new rate is picked up by the trigger pacer in this time slice
+    targetTriggerRate_ = segment.triggerRate;
+    triggerPacer_.setMeanBurstSize(segment.meanBurstSize > 0 ?
+        segment.meanBurstSize : triggerBurstSize_.value_);
+}
+
+
+void rubuilder::ta::Application::endRateProfileSegment(const uint64_t nowNSec)
+{
+    const RateProfile::Segment &segment =
+        rateProfile_.getSegments()[rateProfileSegment_];
+    const uint64_t durationNSec     = nowNSec - segmentStartNSec_;
+    const uint64_t nbTriggersSent   = nbTriggersSent_ - segmentStartNbTriggersSent_;
+    const uint32_t nbTriggersVetoed = vetoedTriggers_.value_ - segmentStartVetoedTriggers_;
+    const uint64_t starvationNSec   = getDeadtimeNSec(nowNSec) - segmentStartDeadtimeNSec_;
+
+    rateProfile_.addReplay(rateProfileSegment_, durationNSec,
+        nbTriggersSent, nbTriggersVetoed, starvationNSec);
+
+    LOG4CPLUS_INFO(logger_, "Rate profile segment " << rateProfileSegment_
+        << " (LS " << segmentFirstLumiSection_ << ")"
+        << ": planned " << segment.triggerRate << " Hz"
+        << ", achieved " << (durationNSec > 0 ? nbTriggersSent / (durationNSec / 1e9) : 0) << " Hz"
+        << ", credit starvation " << starvationNSec / 1e9 << " s"
+        << ", " << nbTriggersVetoed << " triggers vetoed");
+
+    rateProfileSegment_ = RateProfile::NO_SEGMENT;
+}
+
+
+void rubuilder::ta::Application::paceTriggers(const uint64_t nowNSec)
+throw (rubuilder::ta::exception::Exception)
+{
+    const uint32_t triggerRate = targetTriggerRate_.value_;
+
+    if ( triggerRate != pacedTriggerRate_ )
+    {
+        triggerPacer_.setTriggerRate(triggerRate, nowNSec);
+        pacedTriggerRate_ = triggerRate;
+        nextTriggerNSec_ = triggerPacer_.getNextTriggerNSec(nextBunchCrossing_);
+    }
+
+    // Triggers arriving while the TA is not enabled are lost
+    if ( ! triggersEnabled_ )
+    {
+        while ( nextTriggerNSec_ <= nowNSec )
+            nextTriggerNSec_ = triggerPacer_.getNextTriggerNSec(nextBunchCrossing_);
+        return;
+    }
+
+    // Send the credits held while pacing if the triggers are no longer
+    // paced, i.e. the rate has been set to 0 without a rate profile
+    if ( ! isPacingTriggers() )
+    {
+        if ( nbCreditsHeld_.value_ != 0 )
+        {
+            const uint32_t nbCredits = nbCreditsHeld_.value_;
+            nbCreditsHeld_ = 0;
+            sendNTriggers(nbCredits);
+        }
+        return;
+    }
+
+    while ( nextTriggerNSec_ <= nowNSec )
+    {
+        if ( nbCreditsHeld_.value_ > 0 )
+        {
+            const uint32_t orbit = orbitOffset_ +
+                nextTriggerNSec_ / TriggerPacer::ORBIT_NSEC;
+
+            sendTrigger(orbit, orbit/orbitsPerLS_, nextBunchCrossing_);
+            --nbCreditsHeld_.value_;
+        }
+        else
+        {
+            ++vetoedTriggers_.value_;
+            if ( deadtimeStartNSec_ == NO_DEADTIME )
+                deadtimeStartNSec_ = nextTriggerNSec_;
+        }
+
+        nextTriggerNSec_ = triggerPacer_.getNextTriggerNSec(nextBunchCrossing_);
+    }
+}
+
+
+void rubuilder::ta::Application::endDeadtime(const uint64_t nowNSec)
+{
+    if ( nowNSec > deadtimeStartNSec_ )
+        deadtimeNSec_ += nowNSec - deadtimeStartNSec_;
+
+    deadtimeStartNSec_ = NO_DEADTIME;
+}
+
+
+uint64_t rubuilder::ta::Application::getDeadtimeNSec(const uint64_t nowNSec) const
+{
+    if ( deadtimeStartNSec_ != NO_DEADTIME && nowNSec > deadtimeStartNSec_ )
+        return deadtimeNSec_ + (nowNSec - deadtimeStartNSec_);
+
+    return deadtimeNSec_;
+}
+
+
+uint64_t rubuilder::ta::Application::getSimulationTimeNSec() const
+{
+    return getMonotonicTimeNSec() - simulationStartNSec_;
 }
 
 void rubuilder::ta::Application::startMonitoringCalculations()
@@ -1615,9 +2032,13 @@ void rubuilder::ta::Application::startMonitoringCalculations()
         monitoringActionName_
     );
 
-    struct timezone timezone;
-    gettimeofday(&monitoringStartTime_, &timezone);
-    monitoringStartEventNumber_ = eventNumber_.value_;
+    {
+        boost::mutex::scoped_lock sl(triggerMutex_);
+
+        monitoringStartNSec_           = getMonotonicTimeNSec();
+        monitoringStartNbTriggersSent_ = nbTriggersSent_;
+        monitoringStartDeadtimeNSec_   = deadtimeNSec_;
+    }
 
     try
     {
@@ -1651,19 +2072,34 @@ bool rubuilder::ta::Application::updateMonitoringInfo
 
     try
     {
-        struct   timeval  monitoringEndTime;
-        struct   timezone timezone;
-        
-        // Sample
-        gettimeofday(&monitoringEndTime, &timezone);
-        
+        uint64_t monitoringEndNSec;
+        uint64_t monitoringEndNbTriggersSent;
+        uint64_t monitoringEndDeadtimeNSec;
+
+        // Sample, including the ongoing deadtime
+        {
+            boost::mutex::scoped_lock sl(triggerMutex_);
+
+            monitoringEndNSec           = getMonotonicTimeNSec();
+            monitoringEndNbTriggersSent = nbTriggersSent_;
+            monitoringEndDeadtimeNSec   =
+                getDeadtimeNSec(monitoringEndNSec - simulationStartNSec_);
+        }
+
         // Calculate the delta time and prepare for the next monitoring interval
-        double deltaT = rubuilder::utils::calcDeltaTime(&monitoringStartTime_, &monitoringEndTime);
-        monitoringStartTime_ = monitoringEndTime;
-        
-        unsigned int monitoringEndEventNumber = eventNumber_.value_;
-        measuredTriggerRate_.value_ = (monitoringEndEventNumber - monitoringStartEventNumber_)/deltaT;
-        monitoringStartEventNumber_ = monitoringEndEventNumber;
+        const double deltaT = (monitoringEndNSec - monitoringStartNSec_) / 1e9;
+
+        if ( deltaT > 0 )
+        {
+            measuredTriggerRate_.value_ =
+                (monitoringEndNbTriggersSent - monitoringStartNbTriggersSent_) / deltaT;
+            deadtimeFraction_.value_ = std::min(1.0,
+                (monitoringEndDeadtimeNSec - monitoringStartDeadtimeNSec_) / 1e9 / deltaT);
+        }
+
+        monitoringStartNSec_           = monitoringEndNSec;
+        monitoringStartNbTriggersSent_ = monitoringEndNbTriggersSent;
+        monitoringStartDeadtimeNSec_   = monitoringEndDeadtimeNSec;
         
     }
     catch(...)
@@ -0,0 +1,168 @@
+#include "rubuilder/ta/RateProfile.h"
+
+#include <fstream>
+#include <sstream>
+
+
+const uint32_t rubuilder::ta::RateProfile::NO_SEGMENT;
+
+
+rubuilder::ta::RateProfile::Segment::Segment() :
+nbLumiSections(0),
+triggerRate(0),
+meanBurstSize(0),
+nbReplays(0),
+durationNSec(0),
+nbTriggersSent(0),
+nbTriggersVetoed(0),
+creditStarvationNSec(0)
+{
+}
+
+
+double rubuilder::ta::RateProfile::Segment::getAchievedRate() const
+{
+    if(durationNSec == 0) return 0;
+
+    return nbTriggersSent / (durationNSec / 1e9);
+}
+
+
+double rubuilder::ta::RateProfile::Segment::getCreditStarvationFraction() const
+{
+    if(durationNSec == 0) return 0;
+
+    return static_cast<double>(creditStarvationNSec) / durationNSec;
+}
+
+
+rubuilder::ta::RateProfile::RateProfile() :
+nbLumiSections_(0)
+{
+}
+
+
+void rubuilder::ta::RateProfile::load(const std::string fileName)
+throw (rubuilder::ta::exception::Exception)
+{
+    std::ifstream file(fileName.c_str());
+
+    if(!file.is_open())
+    {
+        XCEPT_RAISE(rubuilder::ta::exception::Exception,
+            "Failed to open rate profile file " + fileName);
+    }
+
+    Segments segments;
+    uint32_t nbLumiSections = 0;
+    std::string line;
+
+    while(std::getline(file, line))
+    {
+        if(line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        Segment segment;
+        if(!(fields >> segment.nbLumiSections))
+        {
+            // Ignore lines containing only white space
+            if(fields.eof()) continue;
+
+            XCEPT_RAISE(rubuilder::ta::exception::Exception,
+                "Malformed line in rate profile file " + fileName +
+                ": " + line);
+        }
+
+        if(!(fields >> segment.triggerRate) ||
+            (!(fields >> segment.meanBurstSize) && !fields.eof()) ||
+            segment.nbLumiSections == 0)
+        {
+            XCEPT_RAISE(rubuilder::ta::exception::Exception,
+                "Malformed line in rate profile file " + fileName +
+                ": " + line);
+        }
+
+        segments.push_back(segment);
+        nbLumiSections += segment.nbLumiSections;
+    }
+
+    if(segments.empty())
+    {
+        XCEPT_RAISE(rubuilder::ta::exception::Exception,
+            "Rate profile file " + fileName + " contains no segments");
+    }
+
+    segments_.swap(segments);
+    nbLumiSections_ = nbLumiSections;
+}
+
+
+void rubuilder::ta::RateProfile::clear()
+{
+    segments_.clear();
+    nbLumiSections_ = 0;
+}
+
+
+uint32_t rubuilder::ta::RateProfile::getSegmentIndex
+(
+    const uint32_t lumiSection,
+    uint32_t       &firstLumiSection
+) const
+{
+    if(segments_.empty()) return NO_SEGMENT;
+
+    // Position within the current replay of the whole profile
+    uint32_t position = lumiSection % nbLumiSections_;
+
+    firstLumiSection = lumiSection - position;
+
+    for(uint32_t i=0; i<segments_.size(); i++)
+    {
+        if(position < segments_[i].nbLumiSections) return i;
+
+        position         -= segments_[i].nbLumiSections;
+        firstLumiSection += segments_[i].nbLumiSections;
+    }
+
+    // Not reached, as the position is less than the total number of lumi
+    // sections
+    return NO_SEGMENT;
+}
+
+
+void rubuilder::ta::RateProfile::addReplay
+(
+    const uint32_t segmentIndex,
+    const uint64_t durationNSec,
+    const uint64_t nbTriggersSent,
+    const uint64_t nbTriggersVetoed,
+    const uint64_t creditStarvationNSec
+)
+{
+    if(segmentIndex >= segments_.size()) return;
+
+    Segment &segment = segments_[segmentIndex];
+
+    segment.nbReplays++;
+    segment.durationNSec         += durationNSec;
+    segment.nbTriggersSent       += nbTriggersSent;
+    segment.nbTriggersVetoed     += nbTriggersVetoed;
+    segment.creditStarvationNSec += creditStarvationNSec;
+}
+
+
+void rubuilder::ta::RateProfile::resetStatistics()
+{
+    for(Segments::iterator itor=segments_.begin(); itor!=segments_.end(); itor++)
+    {
+        const Segment &segment = *itor;
+        Segment reset;
+
+        reset.nbLumiSections = segment.nbLumiSections;
+        reset.triggerRate    = segment.triggerRate;
+        reset.meanBurstSize  = segment.meanBurstSize;
+
+        *itor = reset;
+    }
+}
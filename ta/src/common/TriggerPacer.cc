@@ -0,0 +1,241 @@
+#include "rubuilder/ta/TriggerPacer.h"
+
+#include <algorithm>
+#include <math.h>
+
+
+namespace
+{
+    // Nominal 25 ns filling scheme: 39 trains of 72 bunches followed by the
+    // abort gap
+    const uint32_t NB_TRAINS            = 39;
+    const uint32_t NB_BUNCHES_PER_TRAIN = 72;
+    const uint32_t TRAIN_SPACING        = 88;
+}
+
+
+const uint64_t rubuilder::ta::TriggerPacer::ORBIT_NSEC;
+const uint64_t rubuilder::ta::TriggerPacer::MIN_TRIGGER_SPACING_NSEC;
+const uint64_t rubuilder::ta::TriggerPacer::NO_TRIGGER;
+
+
+rubuilder::ta::TriggerPacer::Profile rubuilder::ta::TriggerPacer::getProfile
+(
+    const std::string name
+)
+throw (rubuilder::ta::exception::Exception)
+{
+    if(name == "constant") return CONSTANT;
+    if(name == "poisson" ) return POISSON;
+    if(name == "bursty"  ) return BURSTY;
+    if(name == "lhc"     ) return LHC;
+
+    XCEPT_RAISE(rubuilder::ta::exception::Exception,
+        "Unknown trigger profile \"" + name + "\"."
+        " Valid profiles are constant, poisson, bursty and lhc");
+}
+
+
+std::string rubuilder::ta::TriggerPacer::getProfileName
+(
+    const Profile profile
+)
+{
+    switch(profile)
+    {
+    case CONSTANT: return "constant";
+    case POISSON:  return "poisson";
+    case BURSTY:   return "bursty";
+    case LHC:      return "lhc";
+    }
+
+    return "unknown";
+}
+
+
+rubuilder::ta::TriggerPacer::TriggerPacer() :
+profile_(CONSTANT),
+triggerRate_(0),
+meanBurstSize_(1),
+random_(1),
+lastTriggerNSec_(0),
+burstStartNSec_(0),
+nbTriggersLeftInBurst_(0),
+orbit_(0),
+filledBunchIndex_(0)
+{
+    for(uint32_t train=0; train<NB_TRAINS; train++)
+    {
+        for(uint32_t bunch=0; bunch<NB_BUNCHES_PER_TRAIN; bunch++)
+        {
+            filledBunches_.push_back(train * TRAIN_SPACING + bunch);
+        }
+    }
+}
+
+
+void rubuilder::ta::TriggerPacer::configure
+(
+    const Profile  profile,
+    const double   triggerRate,
+    const uint32_t meanBurstSize,
+    const uint32_t seed
+)
+{
+    profile_               = profile;
+    triggerRate_           = triggerRate;
+    meanBurstSize_         = std::max(meanBurstSize, 1U);
+    random_                = (static_cast<uint64_t>(seed) << 32) ^
+                             0x9E3779B97F4A7C15ULL;
+    lastTriggerNSec_       = 0;
+    burstStartNSec_        = 0;
+    nbTriggersLeftInBurst_ = 0;
+    orbit_                 = 0;
+    filledBunchIndex_      = 0;
+}
+
+
+void rubuilder::ta::TriggerPacer::setTriggerRate
+(
+    const double   triggerRate,
+    const uint64_t nowNSec
+)
+{
+    triggerRate_           = triggerRate;
+    lastTriggerNSec_       = nowNSec;
+    burstStartNSec_        = nowNSec;
+    nbTriggersLeftInBurst_ = 0;
+
+    moveToFilledBunch(nowNSec);
+}
+
+
+void rubuilder::ta::TriggerPacer::setMeanBurstSize
+(
+    const uint32_t meanBurstSize
+)
+{
+    meanBurstSize_ = std::max(meanBurstSize, 1U);
+}
+
+
+uint64_t rubuilder::ta::TriggerPacer::getNextTriggerNSec
+(
+    uint16_t &bunchCrossing
+)
+{
+    if(triggerRate_ <= 0) return NO_TRIGGER;
+
+    const double meanSpacingNSec = 1e9 / triggerRate_;
+
+    switch(profile_)
+    {
+    case CONSTANT:
+        lastTriggerNSec_ += meanSpacingNSec;
+        break;
+
+    case POISSON:
+        lastTriggerNSec_ += getExponential(meanSpacingNSec);
+        break;
+
+    case BURSTY:
+        if(nbTriggersLeftInBurst_ > 0)
+        {
+            nbTriggersLeftInBurst_--;
+            lastTriggerNSec_ += MIN_TRIGGER_SPACING_NSEC;
+        }
+        else
+        {
+            // The bursts start independently of the length of the previous
+            // burst, which keeps the mean rate at the requested one
+            burstStartNSec_ += getExponential(meanSpacingNSec * meanBurstSize_);
+            lastTriggerNSec_ = std::max(burstStartNSec_,
+                lastTriggerNSec_ + MIN_TRIGGER_SPACING_NSEC);
+            nbTriggersLeftInBurst_ = getGeometric(1.0 / meanBurstSize_);
+        }
+        break;
+
+    case LHC:
+        {
+            const double orbitsPerSec = 1e9 / ORBIT_NSEC;
+            const double probability =
+                triggerRate_ / (filledBunches_.size() * orbitsPerSec);
+
+            // Above one trigger per filled bunch crossing every one fires
+            if(probability < 1)
+            {
+                skipFilledBunches(getGeometric(probability));
+            }
+
+            bunchCrossing = filledBunches_[filledBunchIndex_] + 1;
+            const uint64_t triggerNSec = orbit_ * ORBIT_NSEC +
+                filledBunches_[filledBunchIndex_] * 25;
+
+            skipFilledBunches(1);
+
+            return triggerNSec;
+        }
+    }
+
+    const uint64_t triggerNSec = static_cast<uint64_t>(lastTriggerNSec_);
+    bunchCrossing = (triggerNSec % ORBIT_NSEC) / 25 + 1;
+
+    return triggerNSec;
+}
+
+
+double rubuilder::ta::TriggerPacer::getUniform()
+{
+    // xorshift64* generator
+    random_ ^= random_ >> 12;
+    random_ ^= random_ << 25;
+    random_ ^= random_ >> 27;
+
+    const uint64_t bits = (random_ * 2685821657736338717ULL) >> 11;
+
+    return (bits + 1) / 9007199254740992.0; // 2^53
+}
+
+
+double rubuilder::ta::TriggerPacer::getExponential(const double meanNSec)
+{
+    return -log(getUniform()) * meanNSec;
+}
+
+
+uint64_t rubuilder::ta::TriggerPacer::getGeometric(const double probability)
+{
+    if(probability >= 1) return 0;
+
+    return static_cast<uint64_t>(log(getUniform()) / log1p(-probability));
+}
+
+
+void rubuilder::ta::TriggerPacer::skipFilledBunches(const uint64_t nbBunches)
+{
+    const uint64_t index = filledBunchIndex_ + nbBunches;
+
+    orbit_            += index / filledBunches_.size();
+    filledBunchIndex_  = index % filledBunches_.size();
+}
+
+
+void rubuilder::ta::TriggerPacer::moveToFilledBunch(const uint64_t timeNSec)
+{
+    const uint16_t bunch = (timeNSec % ORBIT_NSEC) / 25;
+
+    orbit_ = timeNSec / ORBIT_NSEC;
+
+    std::vector<uint16_t>::const_iterator pos = std::lower_bound
+        (filledBunches_.begin(), filledBunches_.end(), bunch);
+
+    if(pos == filledBunches_.end())
+    {
+        orbit_++;
+        filledBunchIndex_ = 0;
+    }
+    else
+    {
+        filledBunchIndex_ = pos - filledBunches_.begin();
+    }
+}
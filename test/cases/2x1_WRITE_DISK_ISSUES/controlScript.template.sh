@@ -45,6 +45,8 @@ setParam BU0_SOAP_HOST_NAME BU0_SOAP_PORT rubuilder::bu::Application 0 rawDataDi
 setParam BU0_SOAP_HOST_NAME BU0_SOAP_PORT rubuilder::bu::Application 0 metaDataDir string $testDir
 setParam BU0_SOAP_HOST_NAME BU0_SOAP_PORT rubuilder::bu::Application 0 rawDataLowWaterMark double $lowWaterMark
 setParam BU0_SOAP_HOST_NAME BU0_SOAP_PORT rubuilder::bu::Application 0 rawDataHighWaterMark double $highWaterMark
+# Stop the requests at the high-water mark without throttling them before
+setParam BU0_SOAP_HOST_NAME BU0_SOAP_PORT rubuilder::bu::Application 0 diskThrottleLookaheadSec unsignedInt 0
 
 # Configure and enable ptatcp
 sendSimpleCmdToApp EVM0_SOAP_HOST_NAME EVM0_SOAP_PORT pt::atcp::PeerTransportATCP 0 Configure
@@ -0,0 +1,88 @@
+#!/bin/sh
+
+# Launch executive processes
+sendCmdToLauncher EVM0_SOAP_HOST_NAME EVM0_LAUNCHER_PORT STARTXDAQEVM0_SOAP_PORT
+sendCmdToLauncher RU0_SOAP_HOST_NAME  RU0_LAUNCHER_PORT STARTXDAQRU0_SOAP_PORT
+sendCmdToLauncher RU1_SOAP_HOST_NAME  RU1_LAUNCHER_PORT STARTXDAQRU1_SOAP_PORT
+sendCmdToLauncher BU0_SOAP_HOST_NAME  BU0_LAUNCHER_PORT STARTXDAQBU0_SOAP_PORT
+sendCmdToLauncher BU1_SOAP_HOST_NAME  BU1_LAUNCHER_PORT STARTXDAQBU1_SOAP_PORT
+
+# Check that executives are listening
+if ! webPingXDAQ EVM0_SOAP_HOST_NAME EVM0_SOAP_PORT 5
+then
+  echo "Test failed"
+  exit 1
+fi
+if ! webPingXDAQ RU0_SOAP_HOST_NAME RU0_SOAP_PORT 5
+then
+  echo "Test failed"
+  exit 1
+fi
+if ! webPingXDAQ RU1_SOAP_HOST_NAME RU1_SOAP_PORT 5
+then
+  echo "Test failed"
+  exit 1
+fi
+if ! webPingXDAQ BU0_SOAP_HOST_NAME BU0_SOAP_PORT 5
+then
+  echo "Test failed"
+  exit 1
+fi
+if ! webPingXDAQ BU1_SOAP_HOST_NAME BU1_SOAP_PORT 5
+then
+  echo "Test failed"
+  exit 1
+fi
+
+# Configure all executives
+sendCmdToExecutive EVM0_SOAP_HOST_NAME EVM0_SOAP_PORT configure.cmd.xml
+sendCmdToExecutive RU0_SOAP_HOST_NAME  RU0_SOAP_PORT configure.cmd.xml
+sendCmdToExecutive RU1_SOAP_HOST_NAME  RU1_SOAP_PORT configure.cmd.xml
+sendCmdToExecutive BU0_SOAP_HOST_NAME  BU0_SOAP_PORT configure.cmd.xml
+sendCmdToExecutive BU1_SOAP_HOST_NAME  BU1_SOAP_PORT configure.cmd.xml
+
+# Scan the packing factors with one and two BUs
+rm -f /tmp/2x2_TESTER_SCAN.csv /tmp/2x2_TESTER_SCAN.json
+curl http://EVM0_SOAP_HOST_NAME:EVM0_SOAP_PORT/urn:xdaq-application:lid=12/control?command=scan &> /dev/null
+
+echo "Scanning 4 points"
+for i in `seq 1 120`
+do
+  sleep 1
+  scanState=`getParam EVM0_SOAP_HOST_NAME EVM0_SOAP_PORT rubuilder::tester::Application 0 scanState xsd:string`
+  if test "$scanState" != "Running"
+  then
+    break
+  fi
+done
+
+echo "Scan state: $scanState"
+
+if test "$scanState" != "Done"
+then
+  echo "Test failed"
+  exit 1
+fi
+
+# The header and one line per point
+nbLines=`cat /tmp/2x2_TESTER_SCAN.csv | wc -l`
+echo "Result lines: $nbLines"
+cat /tmp/2x2_TESTER_SCAN.csv
+
+if test $nbLines -ne 5
+then
+  echo "Test failed"
+  exit 1
+fi
+
+# Every point has built events
+nbEmptyPoints=`tail -n +2 /tmp/2x2_TESTER_SCAN.csv | awk -F, '$6 <= 0' | wc -l`
+
+if test $nbEmptyPoints -ne 0
+then
+  echo "Test failed"
+  exit 1
+fi
+
+echo "Test succeeded"
+exit 0
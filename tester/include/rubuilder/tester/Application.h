@@ -3,13 +3,16 @@
 
 #include "rubuilder/utils/ApplicationInstanceLess.h"
 #include "rubuilder/tester/exception/Exception.h"
+#include "rubuilder/tester/ThroughputScan.h"
 #include "rubuilder/utils/WebUtils.h"
 #include "i2o/i2oDdmLib.h"
 #include "i2o/utils/AddressMap.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
+#include "toolbox/task/WorkLoop.h"
 #include "xdaq/ApplicationGroup.h"
 #include "xdaq/WebApplication.h"
 #include "xdata/Boolean.h"
+#include "xdata/Double.h"
 #include "xdata/InfoSpace.h"
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger32.h"
@@ -178,12 +181,53 @@ private:
         rubuilder::utils::ApplicationInstanceLess
     > taDescriptors_;
 
+    /**
+     * The application descriptors of the BU applications taking part in
+     * the test.  These are all BUs, unless a throughput scan restricts
+     * them to the first ones.
+     */
+    std::set
+    <
+        xdaq::ApplicationDescriptor*,
+        rubuilder::utils::ApplicationInstanceLess
+    > activeBuDescriptors_;
+
     /**
      * True if the test of the RU builder applications has been started, else
      * false.
      */
     bool testStarted_;
 
+    /**
+     * The points and results of the current throughput scan.
+     */
+    ThroughputScan scan_;
+
+    /**
+     * True while a throughput scan is running.
+     */
+    volatile bool scanRunning_;
+
+    /**
+     * Cleared to abort the running throughput scan.
+     */
+    volatile bool continueScan_;
+
+    /**
+     * The name of the work loop running the throughput scan.
+     */
+    std::string scanWorkLoopName_;
+
+    /**
+     * The work loop running the throughput scan.
+     */
+    toolbox::task::WorkLoop *scanWorkLoop_;
+
+    /**
+     * The action running the throughput scan.
+     */
+    toolbox::task::ActionSignature *scanActionSignature_;
+
 
     ////////////////////////////////////////////////////////
     // Beginning of exported parameters for configuration //
@@ -201,6 +245,77 @@ private:
      */
     xdata::UnsignedInteger32 stateChangeNotificationsWindowSize_;
 
+    /**
+     * Exported read/write parameter specifying the comma separated list of
+     * dummy FED payload sizes in bytes to be scanned.  An empty list leaves
+     * the payload size unchanged.
+     */
+    xdata::String scanFedPayloadSizes_;
+
+    /**
+     * Exported read/write parameter specifying the comma separated list of
+     * packing factors of the I2O messages sent by the EVM and the BUs to be
+     * scanned.
+     */
+    xdata::String scanPackings_;
+
+    /**
+     * Exported read/write parameter specifying the comma separated list of
+     * the numbers of BUs to be scanned.
+     */
+    xdata::String scanNbBUs_;
+
+    /**
+     * Exported read/write parameter specifying the comma separated list of
+     * the numbers of writer threads per BU to be scanned.
+     */
+    xdata::String scanNbWriters_;
+
+    /**
+     * Exported read/write parameter specifying the comma separated list of
+     * trigger rates in Hz to be scanned.  Requires a TA.
+     */
+    xdata::String scanTriggerRates_;
+
+    /**
+     * Exported read/write parameter specifying the number of seconds to wait
+     * after starting a scan point before the first sample is taken.
+     */
+    xdata::UnsignedInteger32 scanSettleSec_;
+
+    /**
+     * Exported read/write parameter specifying the number of seconds between
+     * two samples of the BU monitoring.
+     */
+    xdata::UnsignedInteger32 scanSampleSec_;
+
+    /**
+     * Exported read/write parameter specifying the number of consecutive
+     * samples which have to agree within the tolerance for the event rate
+     * to be steady.  These samples are averaged.
+     */
+    xdata::UnsignedInteger32 scanNbSamples_;
+
+    /**
+     * Exported read/write parameter specifying the maximum number of seconds
+     * to wait for a steady event rate before the last samples are taken
+     * as they are.
+     */
+    xdata::UnsignedInteger32 scanMaxSettleSec_;
+
+    /**
+     * Exported read/write parameter specifying the maximum relative deviation
+     * of a sample from the mean of the samples for a steady event rate.
+     */
+    xdata::Double scanSteadyStateTolerance_;
+
+    /**
+     * Exported read/write parameter specifying the path of the result files
+     * without extension.  The results are written to <path>.csv and
+     * <path>.json after each scan point.
+     */
+    xdata::String scanResultFile_;
+
     ////////////////////////////////////////////////////////
     // End of exported parameters for configuration       //
     ////////////////////////////////////////////////////////
@@ -228,6 +343,24 @@ private:
      */
     xdata::UnsignedInteger32 nbStateChangeNotifications_;
 
+    /**
+     * Exported read-only parameter specifying the state of the throughput
+     * scan: Idle, Running, Done, Aborted or Failed.
+     */
+    xdata::String scanState_;
+
+    /**
+     * Exported read-only parameter specifying the number of scan points
+     * which have been measured.
+     */
+    xdata::UnsignedInteger32 scanPointsDone_;
+
+    /**
+     * Exported read-only parameter specifying the total number of points of
+     * the throughput scan.
+     */
+    xdata::UnsignedInteger32 scanPointsTotal_;
+
     /////////////////////////////////////////////////////
     // End of exported parameters for monitoring       //
     /////////////////////////////////////////////////////
@@ -582,6 +715,65 @@ private:
     void stopFilterFarm()
     throw (rubuilder::tester::exception::Exception);
 
+    /**
+     * Starts the throughput scan in its own work loop.
+     */
+    void startScan()
+    throw (rubuilder::tester::exception::Exception);
+
+    /**
+     * Action of the scan work loop measuring all points of the scan.
+     */
+    bool runScan(toolbox::task::WorkLoop *wl);
+
+    /**
+     * Starts the test with the parameters of the specified scan point, waits
+     * for a steady event rate and returns the averaged samples.
+     */
+    ThroughputScan::Result measureScanPoint(const ThroughputScan::Point&)
+    throw (rubuilder::tester::exception::Exception);
+
+    /**
+     * Sets the parameters of the specified scan point in the applications.
+     * The test must be stopped.
+     */
+    void applyScanPoint(const ThroughputScan::Point&)
+    throw (rubuilder::tester::exception::Exception);
+
+    /**
+     * Sets the specified parameter of all specified applications.
+     */
+    void setScalarParamOfApps
+    (
+        std::set
+        <
+            xdaq::ApplicationDescriptor*,
+            rubuilder::utils::ApplicationInstanceLess
+        > &appDescriptors,
+        const std::string paramName,
+        const std::string paramType,
+        const uint32_t    paramValue
+    )
+    throw (rubuilder::tester::exception::Exception);
+
+    /**
+     * Sleeps the specified number of seconds in steps of one second and
+     * returns early if the scan is stopped.  Returns the seconds slept.
+     */
+    uint32_t sleepWhileScanning(const uint32_t seconds);
+
+    /**
+     * Samples the event rate and throughput summed over the active BUs.
+     */
+    void sampleBUs(double &eventRate, double &throughputMBps)
+    throw (rubuilder::tester::exception::Exception);
+
+    /**
+     * Writes the results of the throughput scan measured so far.
+     */
+    void writeScanResults()
+    throw (rubuilder::tester::exception::Exception);
+
     /**
      * Sends the specified FSM event as a SOAP message to the specified
      * application.  An exception is raised if the application does not reply
@@ -0,0 +1,159 @@
+#ifndef _rubuilder_tester_ThroughputScan_h_
+#define _rubuilder_tester_ThroughputScan_h_
+
+#include "rubuilder/tester/exception/Exception.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace rubuilder { namespace tester { // namespace rubuilder::tester
+
+/**
+ * The points and results of a throughput scan.
+ *
+ * Each scanned parameter is given as a comma separated list of values,
+ * e.g. "1024,2048,4096".  The points of the scan are all combinations of
+ * the values, where the last parameter varies fastest.  An empty list
+ * leaves the parameter at its configured value, which is represented by 0.
+ */
+class ThroughputScan
+{
+public:
+
+    struct Point
+    {
+        uint32_t fedPayloadSize;
+        uint32_t packing;
+        uint32_t nbBUs;
+        uint32_t nbWriters;
+        uint32_t triggerRate;
+
+        Point();
+    };
+
+    typedef std::vector<Point> Points;
+
+    struct Result
+    {
+        Point    point;
+
+        /**
+         * Rate of events built summed over all BUs.
+         */
+        double   eventRate;
+
+        /**
+         * Throughput in MB/s summed over all BUs.
+         */
+        double   throughputMBps;
+
+        /**
+         * Average event size in kB.
+         */
+        double   eventSizeKB;
+
+        /**
+         * Number of samples averaged.
+         */
+        uint32_t nbSamples;
+
+        /**
+         * Time in seconds until the rate was steady.
+         */
+        double   settlingSec;
+
+        /**
+         * False if the rate was not steady within the maximum settling time.
+         */
+        bool     steady;
+
+        /**
+         * Description of the failure if the point could not be measured.
+         */
+        std::string error;
+
+        Result();
+    };
+
+    typedef std::vector<Result> Results;
+
+    /**
+     * Replaces the points by all combinations of the specified values.
+     */
+    void configure
+    (
+        const std::string fedPayloadSizes,
+        const std::string packings,
+        const std::string nbBUs,
+        const std::string nbWriters,
+        const std::string triggerRates
+    )
+    throw (rubuilder::tester::exception::Exception);
+
+    /**
+     * Returns the points of the scan.
+     */
+    const Points& getPoints() const
+    { return points_; }
+
+    /**
+     * Returns the results measured so far.
+     */
+    const Results& getResults() const
+    { return results_; }
+
+    /**
+     * Adds the result of the next point.
+     */
+    void addResult(const Result&);
+
+    /**
+     * Removes all results.
+     */
+    void clearResults();
+
+    /**
+     * Writes the results as comma separated values with a header line.
+     */
+    void writeCSV(std::ostream&) const;
+
+    /**
+     * Writes the results as a JSON array of objects.
+     */
+    void writeJSON(std::ostream&) const;
+
+    /**
+     * Returns true if the last nbSamples rates differ from their mean by
+     * less than the specified fraction of the mean.
+     */
+    static bool isSteady
+    (
+        const std::vector<double> &rates,
+        const uint32_t            nbSamples,
+        const double              tolerance
+    );
+
+
+private:
+
+    /**
+     * Returns the values of a comma separated list, or a single 0 if the
+     * list is empty.
+     */
+    static std::vector<uint32_t> parseValues
+    (
+        const std::string name,
+        const std::string values
+    )
+    throw (rubuilder::tester::exception::Exception);
+
+    Points  points_;
+    Results results_;
+};
+
+} } // namespace rubuilder::tester
+
+#endif
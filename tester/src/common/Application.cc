@@ -1,9 +1,11 @@
 #include "cgicc/HTTPHTMLHeader.h"
 #include "cgicc/HTTPPlainHeader.h"
 #include "rubuilder/utils/Constants.h"
+#include "rubuilder/utils/CreateStrings.h"
 #include "rubuilder/utils/TimerManager.h"
 #include "rubuilder/tester/Application.h"
 #include "rubuilder/tester/Constants.h"
+#include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 #include "xdaq/NamespaceURI.h"
 #include "xdaq/exception/ApplicationNotFound.h"
@@ -19,6 +21,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <fstream>
+#include <iterator>
 #include <stdlib.h>
 
 
@@ -53,7 +57,13 @@ logger_(getApplicationLogger())
     initAppDescriptors(ruiDescriptors_ , "rubuilder::rui::Application"      );
     initAppDescriptors(taDescriptors_  , "rubuilder::ta::Application"       );
 
-    testStarted_ = false;
+    activeBuDescriptors_ = buDescriptors_;
+
+    testStarted_         = false;
+    scanRunning_         = false;
+    continueScan_        = false;
+    scanWorkLoop_        = 0;
+    scanActionSignature_ = 0;
 
     bindXgiCallbacks();
 
@@ -927,7 +937,7 @@ rubuilder::tester::Application::getStats
     double       deltaT                     = 0.0;
     unsigned int deltaN                     = 0;
     double       deltaSumOfSquares          = 0.0;
-    unsigned int deltaSumOfSizes            = 0;
+    double       deltaSumOfSizes            = 0.0;
     bool         retrievedDeltaT            = false;
     bool         retrievedDeltaN            = false;
     bool         retrievedDeltaSumOfSquares = false;
@@ -1010,8 +1020,8 @@ rubuilder::tester::Application::getStats
 
     try
     {
-        s = getScalarParam(appDescriptor, "deltaSumOfSizes", "unsignedInt");
-        deltaSumOfSizes = atoi(s.c_str());
+        s = getScalarParam(appDescriptor, "deltaSumOfSizes", "unsignedLong");
+        deltaSumOfSizes = atof(s.c_str());
         retrievedDeltaSumOfSizes = true;
     }
     catch(xcept::Exception e)
@@ -1211,7 +1221,11 @@ throw (xgi::exception::Exception)
     *out << " type=\"submit\""                                    << std::endl;
     *out << " name=\"command\""                                   << std::endl;
 
-    if(testStarted_)
+    if(scanRunning_)
+    {
+        *out << " value=\"abortScan\""                            << std::endl;
+    }
+    else if(testStarted_)
     {
         *out << " value=\"stop\""                                 << std::endl;
     }
@@ -1222,7 +1236,23 @@ throw (xgi::exception::Exception)
 
     *out << "/>"                                                  << std::endl;
 
+    if(!scanRunning_ && !testStarted_)
+    {
+        *out << "<input"                                          << std::endl;
+        *out << " type=\"submit\""                                << std::endl;
+        *out << " name=\"command\""                               << std::endl;
+        *out << " value=\"scan\""                                 << std::endl;
+        *out << "/>"                                              << std::endl;
+    }
+
     *out << "</form>"                                             << std::endl;
+
+    *out << "<p>"                                                 << std::endl;
+    *out << "Throughput scan: " << scanState_.toString();
+    *out << " (" << scanPointsDone_.value_ << " of ";
+    *out << scanPointsTotal_.value_;
+    *out << " points)"                                            << std::endl;
+    *out << "</p>"                                                << std::endl;
     *out << "</body>"                                             << std::endl;
 
     *out << "</html>"                                             << std::endl;
@@ -1245,7 +1275,27 @@ throw (xgi::exception::Exception)
     {
         cmdName = (*cmdElement).getValue();
 
-        if((cmdName == "start") && (!testStarted_))
+        // The scan work loop owns the test while the scan is running
+        if(scanRunning_)
+        {
+            if(cmdName == "abortScan")
+            {
+                continueScan_ = false;
+            }
+        }
+        else if((cmdName == "scan") && (!testStarted_))
+        {
+            try
+            {
+                startScan();
+            }
+            catch(xcept::Exception e)
+            {
+                XCEPT_RETHROW(xgi::exception::Exception,
+                    "Failed to start throughput scan", e);
+            }
+        }
+        else if((cmdName == "start") && (!testStarted_))
         {
             try
             {
@@ -1660,7 +1710,8 @@ throw (rubuilder::tester::exception::Exception)
     >::const_iterator itor;
 
 
-    for(itor = buDescriptors_.begin(); itor != buDescriptors_.end(); itor++)
+    for(itor = activeBuDescriptors_.begin();
+        itor != activeBuDescriptors_.end(); itor++)
     {
         xdaq::ApplicationDescriptor *appDescriptor = *itor;
 
@@ -1736,7 +1787,8 @@ throw (rubuilder::tester::exception::Exception)
     // Configure BUs //
     ///////////////////
 
-    for(itor=buDescriptors_.begin(); itor!= buDescriptors_.end(); itor++)
+    for(itor=activeBuDescriptors_.begin();
+        itor!=activeBuDescriptors_.end(); itor++)
     {
         sendFSMEventToApp("Configure", *itor);
     }
@@ -1777,7 +1829,8 @@ throw (rubuilder::tester::exception::Exception)
     // Enable BUs //
     ////////////////
 
-    for(itor=buDescriptors_.begin(); itor!=buDescriptors_.end(); itor++)
+    for(itor=activeBuDescriptors_.begin();
+        itor!=activeBuDescriptors_.end(); itor++)
     {
         sendFSMEventToApp("Enable", *itor);
     }
@@ -1928,7 +1981,8 @@ throw (rubuilder::tester::exception::Exception)
     // Halt BUs //
     //////////////
 
-    for(itor=buDescriptors_.begin(); itor!=buDescriptors_.end(); itor++)
+    for(itor=activeBuDescriptors_.begin();
+        itor!=activeBuDescriptors_.end(); itor++)
     {
         sendFSMEventToApp("Halt", *itor);
     }
@@ -2008,6 +2062,499 @@ throw (rubuilder::tester::exception::Exception)
 }
 
 
+void rubuilder::tester::Application::startScan()
+throw (rubuilder::tester::exception::Exception)
+{
+    try
+    {
+        scan_.configure
+        (
+            scanFedPayloadSizes_.value_,
+            scanPackings_.value_,
+            scanNbBUs_.value_,
+            scanNbWriters_.value_,
+            scanTriggerRates_.value_
+        );
+    }
+    catch(xcept::Exception e)
+    {
+        XCEPT_RETHROW(rubuilder::tester::exception::Exception,
+            "Invalid throughput scan parameters", e);
+    }
+
+    if((scanSampleSec_.value_ == 0) || (scanNbSamples_.value_ == 0))
+    {
+        XCEPT_RAISE(rubuilder::tester::exception::Exception,
+            "scanSampleSec and scanNbSamples must be larger than 0");
+    }
+
+    const ThroughputScan::Points &points = scan_.getPoints();
+    ThroughputScan::Points::const_iterator itor;
+
+    for(itor=points.begin(); itor!=points.end(); itor++)
+    {
+        if(itor->nbBUs > buDescriptors_.size())
+        {
+            std::stringstream oss;
+
+            oss << "Cannot scan " << itor->nbBUs << " BUs";
+            oss << " with only " << buDescriptors_.size() << " BUs";
+
+            XCEPT_RAISE(rubuilder::tester::exception::Exception, oss.str());
+        }
+
+        if((itor->triggerRate != 0) && (taDescriptors_.size() == 0))
+        {
+            XCEPT_RAISE(rubuilder::tester::exception::Exception,
+                "Scanning the trigger rate requires a TA");
+        }
+    }
+
+    scanPointsTotal_ = points.size();
+    scanPointsDone_  = 0;
+    scanState_       = "Running";
+    continueScan_    = true;
+    scanRunning_     = true;
+
+    try
+    {
+        if(scanWorkLoop_ == 0)
+        {
+            scanWorkLoopName_ =
+                rubuilder::utils::generateWorkLoopName(xmlClass_, instance_);
+
+            scanWorkLoop_ = toolbox::task::getWorkLoopFactory()->getWorkLoop
+            (
+                scanWorkLoopName_,
+                "waiting"
+            );
+
+            scanActionSignature_ = toolbox::task::bind
+            (
+                this,
+                &rubuilder::tester::Application::runScan,
+                rubuilder::utils::generateWorkLoopActionName(xmlClass_,
+                    instance_)
+            );
+        }
+
+        scanWorkLoop_->submit(scanActionSignature_);
+
+        if(!scanWorkLoop_->isActive())
+        {
+            scanWorkLoop_->activate();
+        }
+    }
+    catch(xcept::Exception &e)
+    {
+        scanRunning_ = false;
+        scanState_   = "Failed";
+
+        XCEPT_RETHROW(rubuilder::tester::exception::Exception,
+            "Failed to start work loop: " + scanWorkLoopName_, e);
+    }
+}
+
+
+bool rubuilder::tester::Application::runScan
+(
+    toolbox::task::WorkLoop *wl
+)
+{
+    const ThroughputScan::Points &points = scan_.getPoints();
+    ThroughputScan::Points::const_iterator itor;
+    bool failed = false;
+
+
+    for(itor=points.begin(); (itor!=points.end()) && continueScan_; itor++)
+    {
+        ThroughputScan::Result result;
+
+        try
+        {
+            result = measureScanPoint(*itor);
+        }
+        catch(xcept::Exception e)
+        {
+            result.point = *itor;
+            result.error = e.message();
+
+            LOG4CPLUS_ERROR(logger_, "Failed to measure throughput scan point"
+                << " : " << xcept::stdformat_exception_history(e));
+        }
+
+        scan_.addResult(result);
+        scanPointsDone_ = scan_.getResults().size();
+
+        try
+        {
+            writeScanResults();
+        }
+        catch(xcept::Exception e)
+        {
+            LOG4CPLUS_ERROR(logger_, "Failed to write throughput scan results"
+                << " : " << xcept::stdformat_exception_history(e));
+
+            failed = true;
+            break;
+        }
+    }
+
+    // Leave the test stopped with all BUs, as it was before the scan
+    if(testStarted_)
+    {
+        try
+        {
+            stopTest();
+            testStarted_ = false;
+        }
+        catch(xcept::Exception e)
+        {
+            LOG4CPLUS_ERROR(logger_, "Failed to stop test after scan"
+                << " : " << xcept::stdformat_exception_history(e));
+
+            failed = true;
+        }
+    }
+
+    if(!testStarted_)
+    {
+        activeBuDescriptors_ = buDescriptors_;
+    }
+
+    if(failed)
+    {
+        scanState_ = "Failed";
+    }
+    else if(!continueScan_)
+    {
+        scanState_ = "Aborted";
+    }
+    else
+    {
+        scanState_ = "Done";
+    }
+
+    scanRunning_ = false;
+
+    // The scan is done once
+    return false;
+}
+
+
+rubuilder::tester::ThroughputScan::Result
+rubuilder::tester::Application::measureScanPoint
+(
+    const ThroughputScan::Point &point
+)
+throw (rubuilder::tester::exception::Exception)
+{
+    ThroughputScan::Result result;
+    std::vector<double>    eventRates;
+    std::vector<double>    throughputs;
+    const uint32_t         nbSamples = scanNbSamples_.value_;
+    uint32_t               elapsedSec = 0;
+
+
+    result.point = point;
+
+    // The parameters are only taken into account when configuring
+    if(testStarted_)
+    {
+        try
+        {
+            stopTest();
+            testStarted_ = false;
+        }
+        catch(xcept::Exception e)
+        {
+            XCEPT_RETHROW(rubuilder::tester::exception::Exception,
+                "Failed to stop test", e);
+        }
+    }
+
+    try
+    {
+        applyScanPoint(point);
+    }
+    catch(xcept::Exception e)
+    {
+        XCEPT_RETHROW(rubuilder::tester::exception::Exception,
+            "Failed to apply parameters of scan point", e);
+    }
+
+    try
+    {
+        startTest();
+        testStarted_ = true;
+    }
+    catch(xcept::Exception e)
+    {
+        XCEPT_RETHROW(rubuilder::tester::exception::Exception,
+            "Failed to start test", e);
+    }
+
+    elapsedSec = sleepWhileScanning(scanSettleSec_.value_);
+
+    // Sample until the last samples agree or the maximum settling time is
+    // reached
+    do
+    {
+        double eventRate      = 0.0;
+        double throughputMBps = 0.0;
+
+        elapsedSec += sleepWhileScanning(scanSampleSec_.value_);
+
+        sampleBUs(eventRate, throughputMBps);
+        eventRates.push_back(eventRate);
+        throughputs.push_back(throughputMBps);
+
+        result.steady = ThroughputScan::isSteady(eventRates, nbSamples,
+            scanSteadyStateTolerance_.value_);
+    }
+    while(!result.steady && (elapsedSec < scanMaxSettleSec_.value_) &&
+        continueScan_);
+
+    const size_t first =
+        (eventRates.size() > nbSamples) ? eventRates.size() - nbSamples : 0;
+
+    for(size_t i=first; i<eventRates.size(); i++)
+    {
+        result.eventRate      += eventRates[i];
+        result.throughputMBps += throughputs[i];
+    }
+
+    result.nbSamples       = eventRates.size() - first;
+    result.eventRate      /= result.nbSamples;
+    result.throughputMBps /= result.nbSamples;
+    result.settlingSec     =
+        elapsedSec - result.nbSamples * scanSampleSec_.value_;
+
+    if(result.eventRate > 0)
+    {
+        result.eventSizeKB = result.throughputMBps * 1000.0 / result.eventRate;
+    }
+
+    try
+    {
+        stopTest();
+        testStarted_ = false;
+    }
+    catch(xcept::Exception e)
+    {
+        XCEPT_RETHROW(rubuilder::tester::exception::Exception,
+            "Failed to stop test", e);
+    }
+
+    return result;
+}
+
+
+void rubuilder::tester::Application::applyScanPoint
+(
+    const ThroughputScan::Point &point
+)
+throw (rubuilder::tester::exception::Exception)
+{
+    if(point.fedPayloadSize != 0)
+    {
+        // The RUs only generate the FED fragments if there are no RUIs
+        if(ruiDescriptors_.size() > 0)
+        {
+            setScalarParamOfApps(ruiDescriptors_, "dummyFedPayloadSize",
+                "unsignedInt", point.fedPayloadSize);
+        }
+        else
+        {
+            setScalarParamOfApps(ruDescriptors_, "dummyFedPayloadSize",
+                "unsignedInt", point.fedPayloadSize);
+        }
+    }
+
+    if(point.packing != 0)
+    {
+        setScalarParamOfApps(evmDescriptors_, "I2O_RU_READOUT_Packing",
+            "unsignedInt", point.packing);
+        setScalarParamOfApps(evmDescriptors_, "I2O_TA_CREDIT_Packing",
+            "unsignedInt", point.packing);
+        setScalarParamOfApps(buDescriptors_, "I2O_EVM_ALLOCATE_CLEAR_Packing",
+            "unsignedInt", point.packing);
+    }
+
+    if(point.nbWriters != 0)
+    {
+        setScalarParamOfApps(buDescriptors_, "numberOfWriters",
+            "unsignedInt", point.nbWriters);
+    }
+
+    if(point.triggerRate != 0)
+    {
+        setScalarParamOfApps(taDescriptors_, "triggerRate",
+            "unsignedInt", point.triggerRate);
+    }
+
+    // Only the first BUs take part in the test
+    activeBuDescriptors_ = buDescriptors_;
+
+    if(point.nbBUs != 0)
+    {
+        std::set
+        <
+            xdaq::ApplicationDescriptor*,
+            rubuilder::utils::ApplicationInstanceLess
+        >::iterator itor = activeBuDescriptors_.begin();
+
+        std::advance(itor, point.nbBUs);
+        activeBuDescriptors_.erase(itor, activeBuDescriptors_.end());
+    }
+}
+
+
+void rubuilder::tester::Application::setScalarParamOfApps
+(
+    std::set
+    <
+        xdaq::ApplicationDescriptor*,
+        rubuilder::utils::ApplicationInstanceLess
+    > &appDescriptors,
+    const std::string paramName,
+    const std::string paramType,
+    const uint32_t    paramValue
+)
+throw (rubuilder::tester::exception::Exception)
+{
+    std::set
+    <
+        xdaq::ApplicationDescriptor*,
+        rubuilder::utils::ApplicationInstanceLess
+    >::const_iterator itor;
+    std::stringstream value;
+
+
+    value << paramValue;
+
+    for(itor=appDescriptors.begin(); itor!=appDescriptors.end(); itor++)
+    {
+        xdaq::ApplicationDescriptor *appDescriptor = *itor;
+
+        try
+        {
+            setScalarParam(appDescriptor, paramName, paramType, value.str());
+        }
+        catch(xcept::Exception e)
+        {
+            std::stringstream oss;
+
+            oss << "Failed to set " << paramName << " of ";
+            oss << appDescriptor->getClassName();
+            oss << appDescriptor->getInstance();
+            oss << " to " << paramValue;
+
+            XCEPT_RETHROW(rubuilder::tester::exception::Exception, oss.str(), e);
+        }
+    }
+}
+
+
+uint32_t rubuilder::tester::Application::sleepWhileScanning
+(
+    const uint32_t seconds
+)
+{
+    uint32_t elapsedSec = 0;
+
+    while((elapsedSec < seconds) && continueScan_)
+    {
+        ::sleep(1);
+        elapsedSec++;
+    }
+
+    return elapsedSec;
+}
+
+
+void rubuilder::tester::Application::sampleBUs
+(
+    double &eventRate,
+    double &throughputMBps
+)
+throw (rubuilder::tester::exception::Exception)
+{
+    std::set
+    <
+        xdaq::ApplicationDescriptor*,
+        rubuilder::utils::ApplicationInstanceLess
+    >::const_iterator itor;
+
+
+    eventRate      = 0.0;
+    throughputMBps = 0.0;
+
+    for(itor=activeBuDescriptors_.begin();
+        itor!=activeBuDescriptors_.end(); itor++)
+    {
+        xdaq::ApplicationDescriptor *appDescriptor = *itor;
+        double deltaT          = 0.0;
+        double deltaN          = 0.0;
+        double deltaSumOfSizes = 0.0;
+
+        try
+        {
+            deltaT = atof(getScalarParam(appDescriptor, "deltaT",
+                "double").c_str());
+            deltaN = atof(getScalarParam(appDescriptor, "deltaN",
+                "unsignedInt").c_str());
+            deltaSumOfSizes = atof(getScalarParam(appDescriptor,
+                "deltaSumOfSizes", "unsignedLong").c_str());
+        }
+        catch(xcept::Exception e)
+        {
+            std::stringstream oss;
+
+            oss << "Failed to get the monitoring counters of ";
+            oss << appDescriptor->getClassName();
+            oss << appDescriptor->getInstance();
+
+            XCEPT_RETHROW(rubuilder::tester::exception::Exception, oss.str(), e);
+        }
+
+        if(deltaT > 0)
+        {
+            eventRate      += deltaN / deltaT;
+            throughputMBps += deltaSumOfSizes / deltaT / 1000000.0;
+        }
+    }
+}
+
+
+void rubuilder::tester::Application::writeScanResults()
+throw (rubuilder::tester::exception::Exception)
+{
+    const std::string csvFileName  = scanResultFile_.value_ + ".csv";
+    const std::string jsonFileName = scanResultFile_.value_ + ".json";
+
+    std::ofstream csvFile(csvFileName.c_str());
+    scan_.writeCSV(csvFile);
+    csvFile.close();
+
+    if(csvFile.fail())
+    {
+        XCEPT_RAISE(rubuilder::tester::exception::Exception,
+            "Failed to write " + csvFileName);
+    }
+
+    std::ofstream jsonFile(jsonFileName.c_str());
+    scan_.writeJSON(jsonFile);
+    jsonFile.close();
+
+    if(jsonFile.fail())
+    {
+        XCEPT_RAISE(rubuilder::tester::exception::Exception,
+            "Failed to write " + jsonFileName);
+    }
+}
+
+
 void rubuilder::tester::Application::sendFSMEventToApp
 (
     const std::string            eventName,
@@ -2368,12 +2915,45 @@ throw (rubuilder::tester::exception::Exception)
 
     exceptionsWindowSize_         = 100;
     stateChangeNotificationsWindowSize_ = 100;
+    scanFedPayloadSizes_          = "";
+    scanPackings_                 = "";
+    scanNbBUs_                    = "";
+    scanNbWriters_                = "";
+    scanTriggerRates_             = "";
+    scanSettleSec_                = 10;
+    scanSampleSec_                = 5;
+    scanNbSamples_                = 3;
+    scanMaxSettleSec_             = 120;
+    scanSteadyStateTolerance_     = 0.05;
+    scanResultFile_               = "/tmp/rubuilderThroughputScan";
 
     params.push_back(std::pair<std::string,xdata::Serializable*>
         ("exceptionsWindowSize", &exceptionsWindowSize_));
     params.push_back(std::pair<std::string,xdata::Serializable*>
         ("stateChangeNotificationsWindowSize",
         &stateChangeNotificationsWindowSize_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanFedPayloadSizes", &scanFedPayloadSizes_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanPackings", &scanPackings_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanNbBUs", &scanNbBUs_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanNbWriters", &scanNbWriters_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanTriggerRates", &scanTriggerRates_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanSettleSec", &scanSettleSec_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanSampleSec", &scanSampleSec_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanNbSamples", &scanNbSamples_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanMaxSettleSec", &scanMaxSettleSec_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanSteadyStateTolerance", &scanSteadyStateTolerance_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanResultFile", &scanResultFile_));
 
     return params;
 }
@@ -2389,6 +2969,9 @@ throw (rubuilder::tester::exception::Exception)
     stateName_                  = "Enabled";
     nbExceptions_               = 0;
     nbStateChangeNotifications_ = 0;
+    scanState_                  = "Idle";
+    scanPointsDone_             = 0;
+    scanPointsTotal_            = 0;
 
     params.push_back(std::pair<std::string,xdata::Serializable*>
         ("stateName", &stateName_));
@@ -2396,6 +2979,12 @@ throw (rubuilder::tester::exception::Exception)
         ("nbExceptions", &nbExceptions_));
     params.push_back(std::pair<std::string,xdata::Serializable*>
         ("nbStateChangeNotifications", &nbStateChangeNotifications_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanState", &scanState_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanPointsDone", &scanPointsDone_));
+    params.push_back(std::pair<std::string,xdata::Serializable*>
+        ("scanPointsTotal", &scanPointsTotal_));
 
     return params;
 }
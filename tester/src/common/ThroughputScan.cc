@@ -0,0 +1,230 @@
+#include "rubuilder/tester/ThroughputScan.h"
+
+#include <math.h>
+#include <sstream>
+#include <stdlib.h>
+
+
+rubuilder::tester::ThroughputScan::Point::Point() :
+fedPayloadSize(0),
+packing(0),
+nbBUs(0),
+nbWriters(0),
+triggerRate(0)
+{
+}
+
+
+rubuilder::tester::ThroughputScan::Result::Result() :
+eventRate(0),
+throughputMBps(0),
+eventSizeKB(0),
+nbSamples(0),
+settlingSec(0),
+steady(false)
+{
+}
+
+
+void rubuilder::tester::ThroughputScan::configure
+(
+    const std::string fedPayloadSizes,
+    const std::string packings,
+    const std::string nbBUs,
+    const std::string nbWriters,
+    const std::string triggerRates
+)
+throw (rubuilder::tester::exception::Exception)
+{
+    const std::vector<uint32_t> sizeValues =
+        parseValues("fedPayloadSizes", fedPayloadSizes);
+    const std::vector<uint32_t> packingValues =
+        parseValues("packings", packings);
+    const std::vector<uint32_t> buValues =
+        parseValues("nbBUs", nbBUs);
+    const std::vector<uint32_t> writerValues =
+        parseValues("nbWriters", nbWriters);
+    const std::vector<uint32_t> rateValues =
+        parseValues("triggerRates", triggerRates);
+
+    Points points;
+    Point  point;
+
+    for(uint32_t s=0; s<sizeValues.size(); s++)
+    {
+        point.fedPayloadSize = sizeValues[s];
+
+        for(uint32_t p=0; p<packingValues.size(); p++)
+        {
+            point.packing = packingValues[p];
+
+            for(uint32_t b=0; b<buValues.size(); b++)
+            {
+                point.nbBUs = buValues[b];
+
+                for(uint32_t w=0; w<writerValues.size(); w++)
+                {
+                    point.nbWriters = writerValues[w];
+
+                    for(uint32_t r=0; r<rateValues.size(); r++)
+                    {
+                        point.triggerRate = rateValues[r];
+                        points.push_back(point);
+                    }
+                }
+            }
+        }
+    }
+
+    points_.swap(points);
+    results_.clear();
+}
+
+
+std::vector<uint32_t> rubuilder::tester::ThroughputScan::parseValues
+(
+    const std::string name,
+    const std::string values
+)
+throw (rubuilder::tester::exception::Exception)
+{
+    std::vector<uint32_t> parsed;
+    std::istringstream    fields(values);
+    std::string           field;
+
+    while(std::getline(fields, field, ','))
+    {
+        // Ignore white space around the values
+        const std::string::size_type first = field.find_first_not_of(" \t");
+        if(first == std::string::npos) continue;
+        const std::string::size_type last = field.find_last_not_of(" \t");
+        const std::string value = field.substr(first, last - first + 1);
+
+        char *end = 0;
+        const unsigned long number = strtoul(value.c_str(), &end, 10);
+
+        if(*end != '\0' || number == 0 || number > 0xffffffffUL ||
+            value[0] == '-')
+        {
+            XCEPT_RAISE(rubuilder::tester::exception::Exception,
+                "Invalid value \"" + value + "\" in the list of " + name +
+                ". Expected a comma separated list of positive integers");
+        }
+
+        parsed.push_back(number);
+    }
+
+    if(parsed.empty()) parsed.push_back(0);
+
+    return parsed;
+}
+
+
+void rubuilder::tester::ThroughputScan::addResult(const Result &result)
+{
+    results_.push_back(result);
+}
+
+
+void rubuilder::tester::ThroughputScan::clearResults()
+{
+    results_.clear();
+}
+
+
+void rubuilder::tester::ThroughputScan::writeCSV(std::ostream &out) const
+{
+    out << "fedPayloadSize,packing,nbBUs,nbWriters,triggerRate,"
+        "eventRate,throughputMBps,eventSizeKB,nbSamples,settlingSec,"
+        "steady,error" << std::endl;
+
+    for(Results::const_iterator itor=results_.begin();
+        itor!=results_.end(); itor++)
+    {
+        // Commas and quotes would break the columns of the error message
+        std::string error = itor->error;
+        for(std::string::iterator c=error.begin(); c!=error.end(); c++)
+        {
+            if(*c == ',' || *c == '"' || *c == '\n') *c = ' ';
+        }
+
+        out << itor->point.fedPayloadSize
+            << "," << itor->point.packing
+            << "," << itor->point.nbBUs
+            << "," << itor->point.nbWriters
+            << "," << itor->point.triggerRate
+            << "," << itor->eventRate
+            << "," << itor->throughputMBps
+            << "," << itor->eventSizeKB
+            << "," << itor->nbSamples
+            << "," << itor->settlingSec
+            << "," << (itor->steady ? "true" : "false")
+            << "," << error
+            << std::endl;
+    }
+}
+
+
+void rubuilder::tester::ThroughputScan::writeJSON(std::ostream &out) const
+{
+    out << "[" << std::endl;
+
+    for(Results::const_iterator itor=results_.begin();
+        itor!=results_.end(); itor++)
+    {
+        std::string error;
+        for(std::string::const_iterator c=itor->error.begin();
+            c!=itor->error.end(); c++)
+        {
+            if(*c == '"' || *c == '\\') error += '\\';
+            error += (*c == '\n') ? ' ' : *c;
+        }
+
+        out << "  {";
+        out << "\"fedPayloadSize\": " << itor->point.fedPayloadSize;
+        out << ", \"packing\": "      << itor->point.packing;
+        out << ", \"nbBUs\": "        << itor->point.nbBUs;
+        out << ", \"nbWriters\": "    << itor->point.nbWriters;
+        out << ", \"triggerRate\": "  << itor->point.triggerRate;
+        out << ", \"eventRate\": "    << itor->eventRate;
+        out << ", \"throughputMBps\": " << itor->throughputMBps;
+        out << ", \"eventSizeKB\": "  << itor->eventSizeKB;
+        out << ", \"nbSamples\": "    << itor->nbSamples;
+        out << ", \"settlingSec\": "  << itor->settlingSec;
+        out << ", \"steady\": "       << (itor->steady ? "true" : "false");
+        out << ", \"error\": \""      << error << "\"";
+        out << "}";
+        if(itor+1 != results_.end()) out << ",";
+        out << std::endl;
+    }
+
+    out << "]" << std::endl;
+}
+
+
+bool rubuilder::tester::ThroughputScan::isSteady
+(
+    const std::vector<double> &rates,
+    const uint32_t            nbSamples,
+    const double              tolerance
+)
+{
+    if(nbSamples == 0 || rates.size() < nbSamples) return false;
+
+    double mean = 0;
+    for(uint32_t i=rates.size()-nbSamples; i<rates.size(); i++)
+    {
+        mean += rates[i];
+    }
+    mean /= nbSamples;
+
+    // No events are built at all
+    if(mean == 0) return false;
+
+    for(uint32_t i=rates.size()-nbSamples; i<rates.size(); i++)
+    {
+        if(fabs(rates[i] - mean) > tolerance * mean) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,184 @@
+// Reconstructs the per-stage latency distributions from the event trace
+// dumps written by rubuilder::utils::EventTracer. The dumps of all
+// applications taking part in a run can be given at once, as the events
+// are identified by their resync count and event number.
+//
+// Usage: tracereader file.trace [file.trace ...]
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rubuilder/utils/EventTracer.h"
+
+
+typedef std::pair<uint32_t,uint32_t> EventId; // resync count, event number
+typedef std::map<std::string,uint64_t> StageTimes;
+typedef std::map<EventId,StageTimes> Events;
+// Signed, as the clocks of different hosts may be slightly off
+typedef std::map<std::string, std::vector<int64_t> > Latencies;
+
+
+bool readTraceFile(const char* fileName, Events& events)
+{
+  std::ifstream file(fileName);
+  if ( ! file.is_open() )
+  {
+    std::cerr << "Cannot open " << fileName << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while ( std::getline(file, line) )
+  {
+    if ( line.empty() || line[0] == '#' ) continue;
+
+    std::istringstream fields(line);
+    uint64_t timeNSec;
+    uint32_t resyncCount, eventNumber, threadId;
+    std::string stage;
+    if ( ! (fields >> timeNSec >> resyncCount >> eventNumber >> stage >> threadId) )
+    {
+      std::cerr << "Skipping malformed line in " << fileName << ": " << line << std::endl;
+      continue;
+    }
+
+    // A stage reached by several RUs is complete once the last one got there
+    uint64_t& stageTime = events[ EventId(resyncCount,eventNumber) ][stage];
+    stageTime = std::max(stageTime, timeNSec);
+  }
+  return true;
+}
+
+
+// Position of the stage in the path of an event. Stages unknown
+// to this build of the tool are placed after all known ones.
+uint32_t getStageOrder(const std::string& stage)
+{
+  using rubuilder::utils::EventTracer;
+
+  for (uint32_t i = 0; i < EventTracer::STAGE_COUNT; ++i)
+  {
+    if ( stage == EventTracer::getStageName(i) ) return i;
+  }
+  return EventTracer::STAGE_COUNT;
+}
+
+
+struct Stage
+{
+  uint32_t order;
+  uint64_t timeNSec;
+  std::string name;
+};
+
+
+bool isEarlierStage(const Stage& a, const Stage& b)
+{
+  if ( a.order != b.order ) return a.order < b.order;
+  return a.timeNSec < b.timeNSec;
+}
+
+
+void collectLatencies(const Events& events, Latencies& latencies)
+{
+  for (Events::const_iterator event = events.begin(), eventEnd = events.end();
+       event != eventEnd; ++event)
+  {
+    std::vector<Stage> stages;
+    for (StageTimes::const_iterator it = event->second.begin(), itEnd = event->second.end();
+         it != itEnd; ++it)
+    {
+      Stage stage;
+      stage.order = getStageOrder(it->first);
+      stage.timeNSec = it->second;
+      stage.name = it->first;
+      stages.push_back(stage);
+    }
+    if ( stages.size() < 2 ) continue;
+
+    // Follow the path of the event, which does not depend on the clocks
+    std::sort(stages.begin(), stages.end(), isEarlierStage);
+
+    for (size_t i = 1; i < stages.size(); ++i)
+    {
+      const std::string transition = stages[i-1].name + " -> " + stages[i].name;
+      latencies[transition].push_back(
+        static_cast<int64_t>(stages[i].timeNSec - stages[i-1].timeNSec) );
+    }
+    latencies["TOTAL " + stages.front().name + " -> " + stages.back().name]
+      .push_back( static_cast<int64_t>(stages.back().timeNSec - stages.front().timeNSec) );
+  }
+}
+
+
+int64_t percentile(const std::vector<int64_t>& sorted, const double percent)
+{
+  const size_t index = static_cast<size_t>(percent / 100 * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+
+void printLatencies(Latencies& latencies)
+{
+  std::cout << std::setw(10) << "count"
+    << std::setw(12) << "p50 (us)"
+    << std::setw(12) << "p90 (us)"
+    << std::setw(12) << "p99 (us)"
+    << std::setw(12) << "max (us)"
+    << "  transition" << std::endl;
+
+  for (Latencies::iterator it = latencies.begin(), itEnd = latencies.end();
+       it != itEnd; ++it)
+  {
+    std::vector<int64_t>& values = it->second;
+    std::sort(values.begin(), values.end());
+
+    std::cout << std::setw(10) << values.size()
+      << std::setw(12) << percentile(values, 50) / 1000
+      << std::setw(12) << percentile(values, 90) / 1000
+      << std::setw(12) << percentile(values, 99) / 1000
+      << std::setw(12) << values.back() / 1000
+      << "  " << it->first << std::endl;
+  }
+}
+
+
+int main(int argc, char **argv)
+{
+  if ( argc < 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " file.trace [file.trace ...]" << std::endl;
+    return 1;
+  }
+
+  Events events;
+  for (int i = 1; i < argc; ++i)
+  {
+    if ( ! readTraceFile(argv[i], events) ) return 1;
+  }
+
+  Latencies latencies;
+  collectLatencies(events, latencies);
+
+  std::cout << "Traced events: " << events.size() << std::endl;
+  std::cout << std::endl;
+  printLatencies(latencies);
+
+  return 0;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,74 @@
+#ifndef _rubuilder_utils_Atomic_h_
+#define _rubuilder_utils_Atomic_h_
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * Load the value with acquire semantics, i.e. no memory access
+   * following the load can be reordered before it.
+   */
+  template <typename T>
+  inline T loadAcquire(const T& value)
+  {
+    #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)
+    return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+    #else
+    const T result = *static_cast<const volatile T*>(&value);
+    __sync_synchronize();
+    return result;
+    #endif
+  }
+
+  /**
+   * Store the value with release semantics, i.e. no memory access
+   * preceding the store can be reordered after it.
+   */
+  template <typename T>
+  inline void storeRelease(T& value, const T newValue)
+  {
+    #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)
+    __atomic_store_n(&value, newValue, __ATOMIC_RELEASE);
+    #else
+    __sync_synchronize();
+    *static_cast<volatile T*>(&value) = newValue;
+    #endif
+  }
+
+  /**
+   * Load the value without ordering constraints, but free of tearing.
+   */
+  template <typename T>
+  inline T loadRelaxed(const T& value)
+  {
+    #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)
+    return __atomic_load_n(&value, __ATOMIC_RELAXED);
+    #else
+    return *static_cast<const volatile T*>(&value);
+    #endif
+  }
+
+  /**
+   * Store the value without ordering constraints, but free of tearing.
+   */
+  template <typename T>
+  inline void storeRelaxed(T& value, const T newValue)
+  {
+    #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)
+    __atomic_store_n(&value, newValue, __ATOMIC_RELAXED);
+    #else
+    *static_cast<volatile T*>(&value) = newValue;
+    #endif
+  }
+
+} } // namespace rubuilder::utils
+
+#endif // _rubuilder_utils_Atomic_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
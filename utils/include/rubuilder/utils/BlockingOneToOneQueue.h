@@ -0,0 +1,168 @@
+#ifndef _rubuilder_utils_BlockingOneToOneQueue_h_
+#define _rubuilder_utils_BlockingOneToOneQueue_h_
+
+#include <stdint.h>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include "rubuilder/utils/OneToOneQueue.h"
+#include "rubuilder/utils/WakeupSignal.h"
+#include "xgi/Output.h"
+
+
+namespace rubuilder { namespace utils
+{
+
+  /**
+   * \ingroup xdaqApps
+   * \brief A OneToOneQueue whose consumer can sleep until data arrives
+   *
+   * The producer notifies the WakeupSignal after each successful
+   * enqueue. The signal can be shared with other queues by passing
+   * it to registerWakeupSignal, in which case the consumer can wait
+   * on the signal directly for any of the queues to receive data.
+   */
+
+  template <class T>
+  class BlockingOneToOneQueue
+  {
+  public:
+
+    BlockingOneToOneQueue(const std::string& name);
+    BlockingOneToOneQueue(const std::string& name, const uint32_t size);
+
+    /**
+     * Use the given signal to wake the consumer.
+     * Must not be called while the queue is in use.
+     */
+    void registerWakeupSignal(boost::shared_ptr<WakeupSignal> signal)
+    { wakeupSignal_ = signal; }
+
+    /**
+     * Return the signal used to wake the consumer
+     */
+    boost::shared_ptr<WakeupSignal> getWakeupSignal() const
+    { return wakeupSignal_; }
+
+    /**
+     * Enqueue the element and wake the consumer if it sleeps.
+     * Returns false if the element cannot be enqueued
+     */
+    bool enq(const T&);
+
+    /**
+     * Enqueue up to count elements from the array and wake
+     * the consumer if it sleeps.
+     * Returns the number of elements enqueued.
+     */
+    uint32_t enq(const T* elements, const uint32_t count);
+
+    /**
+     * Dequeue an element.
+     * Return false if no element can be dequeued.
+     */
+    bool deq(T& element)
+    { return queue_.deq(element); }
+
+    /**
+     * Dequeue an element. Wait at most timeoutUSec for an
+     * element to arrive if the queue is empty.
+     * Return false if no element can be dequeued.
+     */
+    bool deq(T&, const uint32_t timeoutUSec);
+
+    /**
+     * Dequeue up to maxCount elements into the array.
+     * Returns the number of elements dequeued.
+     */
+    uint32_t deq(T* elements, const uint32_t maxCount)
+    { return queue_.deq(elements, maxCount); }
+
+    uint32_t elements() const { return queue_.elements(); }
+    uint32_t size() const { return queue_.size(); }
+    bool empty() const { return queue_.empty(); }
+    bool full() const { return queue_.full(); }
+    void resize(const uint32_t size) { queue_.resize(size); }
+
+    void printHtml(xgi::Output* out, const std::string& urn)
+    { queue_.printHtml(out, urn); }
+    void printHorizontalHtml(xgi::Output* out)
+    { queue_.printHorizontalHtml(out); }
+    void printHorizontalHtml(xgi::Output* out, const uint32_t nbElementsToPrint)
+    { queue_.printHorizontalHtml(out, nbElementsToPrint); }
+    void printVerticalHtml(xgi::Output* out)
+    { queue_.printVerticalHtml(out); }
+    void printVerticalHtml(xgi::Output* out, const uint32_t nbElementsToPrint)
+    { queue_.printVerticalHtml(out, nbElementsToPrint); }
+
+
+  private:
+
+    struct NotEmpty
+    {
+      const OneToOneQueue<T>& queue;
+      NotEmpty(const OneToOneQueue<T>& q) : queue(q) {}
+      bool operator()() const { return !queue.empty(); }
+    };
+
+    OneToOneQueue<T> queue_;
+    boost::shared_ptr<WakeupSignal> wakeupSignal_;
+  };
+
+
+  //------------------------------------------------------------------
+  // Implementation follows
+  //------------------------------------------------------------------
+
+  template <class T>
+  BlockingOneToOneQueue<T>::BlockingOneToOneQueue(const std::string& name) :
+  queue_(name),
+  wakeupSignal_(new WakeupSignal())
+  {}
+
+
+  template <class T>
+  BlockingOneToOneQueue<T>::BlockingOneToOneQueue(const std::string& name, const uint32_t size) :
+  queue_(name, size),
+  wakeupSignal_(new WakeupSignal())
+  {}
+
+
+  template <class T>
+  bool BlockingOneToOneQueue<T>::enq(const T& element)
+  {
+    if ( ! queue_.enq(element) ) return false;
+    wakeupSignal_->notify();
+    return true;
+  }
+
+
+  template <class T>
+  uint32_t BlockingOneToOneQueue<T>::enq(const T* elements, const uint32_t count)
+  {
+    const uint32_t nbElements = queue_.enq(elements, count);
+    if ( nbElements > 0 ) wakeupSignal_->notify();
+    return nbElements;
+  }
+
+
+  template <class T>
+  bool BlockingOneToOneQueue<T>::deq(T& element, const uint32_t timeoutUSec)
+  {
+    if ( queue_.deq(element) ) return true;
+    wakeupSignal_->waitUntil(NotEmpty(queue_), timeoutUSec);
+    return queue_.deq(element);
+  }
+
+
+}} // namespace rubuilder::utils
+
+#endif // _rubuilder_utils_BlockingOneToOneQueue_h_
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
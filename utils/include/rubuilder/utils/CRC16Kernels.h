@@ -0,0 +1,87 @@
+#ifndef _rubuilder_utils_CRC16Kernels_h_
+#define _rubuilder_utils_CRC16Kernels_h_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "rubuilder/utils/Exception.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * Implementations of the FED CRC16 calculated by evf::compute_crc.
+   * All of them give bit-identical results:
+   *
+   * CRC16_BYTEWISE      - one lookup into evf::crc_table per byte,
+   *                       as done by evf::compute_crc
+   * CRC16_SLICING_BY_8  - one lookup into each of 8 tables per 64-bit word
+   * CRC16_SLICING_BY_16 - one lookup into each of 16 tables per two words
+   * CRC16_PCLMUL        - folding of 4x128 bits in parallel with the
+   *                       carry-less multiplication of x86_64 CPUs
+   */
+  enum CRC16Kernel
+  {
+    CRC16_BYTEWISE,
+    CRC16_SLICING_BY_8,
+    CRC16_SLICING_BY_16,
+    CRC16_PCLMUL
+  };
+
+  /**
+   * Return the CRC16 of the buffer, whose size must be a multiple
+   * of 8 bytes, using the fastest kernel supported by the CPU
+   */
+  uint16_t computeFedCRC(const unsigned char* buffer, const size_t bufSize);
+
+  /**
+   * Return the CRC16 continuing the given one over the buffer
+   */
+  uint16_t computeFedCRC(const uint16_t crc, const unsigned char* buffer, const size_t bufSize);
+
+  /**
+   * Return the CRC16 continuing the given one over the buffer
+   * using the given kernel, which must be supported by the CPU
+   */
+  uint16_t computeFedCRC
+  (
+    const CRC16Kernel,
+    const uint16_t crc,
+    const unsigned char* buffer,
+    const size_t bufSize
+  );
+
+  /**
+   * Return true if the CPU supports the kernel
+   */
+  bool isCRC16KernelSupported(const CRC16Kernel);
+
+  /**
+   * Return the kernel used by computeFedCRC.
+   * It is the fastest one supported by the CPU, unless set otherwise.
+   */
+  CRC16Kernel getCRC16Kernel();
+
+  /**
+   * Use the kernel for all subsequent calls to computeFedCRC.
+   * Raises an exception if the CPU does not support the kernel.
+   */
+  void setCRC16Kernel(const CRC16Kernel);
+
+  /**
+   * Return the name of the kernel, e.g. "slicingBy8"
+   */
+  const char* getCRC16KernelName(const CRC16Kernel);
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_CRC16Kernels_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
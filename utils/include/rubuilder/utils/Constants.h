@@ -15,6 +15,7 @@ const uint32_t DEFAULT_MESSAGE_AGE_LIMIT_MSEC =  1000;
 const uint16_t TRIGGER_BITS_COUNT             =    64;
 const unsigned int GTP_FED_ID                 =   812; //0x32c
 const uint16_t FED_COUNT                      =  1024;
+const size_t CACHE_LINE_SIZE                  =    64;
 
 const std::string HYPERDAQ_ICON = "/hyperdaq/images/HyperDAQ.jpg";
 
@@ -87,6 +87,17 @@ std::string generateOldMsgSenderActionName
     const unsigned int  appInstance
 );
 
+/**
+ * Returns the prefix of the event trace files of the specified application.
+ * The characters of the class name which are not valid in file names are
+ * replaced by underscores.
+ */
+std::string generateTraceFilePrefix
+(
+    const std::string   appClass,
+    const unsigned int  appInstance
+);
+
 /**
  * Returns the url of the specified application.
  */
@@ -0,0 +1,179 @@
+#ifndef _rubuilder_utils_EventTracer_h_
+#define _rubuilder_utils_EventTracer_h_
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "rubuilder/utils/Atomic.h"
+#include "rubuilder/utils/Constants.h"
+#include "rubuilder/utils/EvBid.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Flight recorder of the path of sampled events through the event builder
+   *
+   * Each thread records the stages reached by an event into its own ring
+   * buffer, which keeps the most recent records. Only events whose number
+   * is a multiple of the sampling period are recorded. As the decision only
+   * depends on the event number, the same events are traced in the EVM, the
+   * RUs and the BUs. The time stamps are taken from CLOCK_REALTIME such that
+   * dumps from different hosts can be combined by the tracereader tool.
+   */
+  class EventTracer : private boost::noncopyable
+  {
+  public:
+
+    // In the order in which an event passes the stages
+    enum Stage
+    {
+      EVM_TRIGGER_RECEIVED,
+      EVM_EVENT_ASSIGNED,
+      RU_FRAGMENT_PAIRED,
+      RU_SUPERFRAGMENT_SENT,
+      BU_EVENT_STARTED,
+      BU_FRAGMENTS_REQUESTED,
+      BU_EVENT_COMPLETE,
+      BU_EVENT_WRITTEN,
+      EVM_EVENT_RELEASED,
+      STAGE_COUNT
+    };
+
+    struct Record
+    {
+      uint64_t timeNSec;
+      uint32_t resyncCount;
+      uint32_t eventNumber;
+      uint32_t stage;
+      uint32_t threadId;
+    };
+
+    EventTracer();
+
+    /**
+     * Trace every samplingPeriod-th event, which is rounded up to a power
+     * of two. A period of 0 disables the tracing. The buffer size is the
+     * number of records kept per thread. It only applies to threads
+     * which record their first event afterwards. Dumps to file are
+     * written into the dump directory.
+     */
+    void configure
+    (
+      const uint32_t samplingPeriod,
+      const uint32_t bufferSize,
+      const std::string& dumpDirectory
+    );
+
+    /**
+     * Return true if events are being traced
+     */
+    bool isEnabled() const
+    { return loadRelaxed(enabled_); }
+
+    /**
+     * Record that the event reached the stage if the event is sampled
+     */
+    inline void trace(const EvBid& evbId, const Stage stage)
+    {
+      if ( ! loadRelaxed(enabled_) ) return;
+      if ( evbId.eventNumber() & loadRelaxed(samplingMask_) ) return;
+      record(evbId, stage);
+    }
+
+    /**
+     * Write the records of all threads ordered by time to the stream
+     */
+    void dump(std::ostream&) const;
+
+    /**
+     * Write the records into a new file in the dump directory
+     * whose name starts with the prefix. Returns the file name.
+     */
+    std::string dumpToFile(const std::string& prefix) const;
+
+    /**
+     * Return the name of the stage
+     */
+    static const char* getStageName(const uint32_t stage);
+
+
+  private:
+
+    struct Ring
+    {
+      uint64_t writeIndex;
+      uint64_t mask;
+      uint32_t threadId;
+      char padding[CACHE_LINE_SIZE];
+      std::vector<Record> records;
+    };
+
+    void record(const EvBid&, const Stage);
+    Ring* registerThread();
+    static void noCleanup(Ring*) {}
+
+    boost::thread_specific_ptr<Ring> threadRing_;
+
+    typedef std::vector< boost::shared_ptr<Ring> > Rings;
+    Rings rings_;
+    mutable boost::mutex ringsMutex_;
+
+    bool enabled_;
+    uint32_t samplingMask_;
+    uint32_t bufferSize_;
+    std::string dumpDirectory_;
+
+  }; // EventTracer
+
+
+  /**
+   * Return the event tracer of this process
+   */
+  EventTracer& getEventTracer();
+
+
+  //------------------------------------------------------------------
+  // Implementation follows
+  //------------------------------------------------------------------
+
+  // Inline such that the tracereader tool can use it without the library
+  inline const char* EventTracer::getStageName(const uint32_t stage)
+  {
+    static const char* const stageNames[STAGE_COUNT] =
+    {
+      "EVM_TRIGGER_RECEIVED",
+      "EVM_EVENT_ASSIGNED",
+      "RU_FRAGMENT_PAIRED",
+      "RU_SUPERFRAGMENT_SENT",
+      "BU_EVENT_STARTED",
+      "BU_FRAGMENTS_REQUESTED",
+      "BU_EVENT_COMPLETE",
+      "BU_EVENT_WRITTEN",
+      "EVM_EVENT_RELEASED"
+    };
+
+    if ( stage >= STAGE_COUNT ) return "UNKNOWN";
+    return stageNames[stage];
+  }
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_EventTracer_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,113 @@
+#ifndef _rubuilder_utils_FedCRCUpdater_h_
+#define _rubuilder_utils_FedCRCUpdater_h_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <boost/static_assert.hpp>
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Incremental update of the CRC16 of a FED
+   *
+   * The FED CRC16 is linear: when some words of a FED change, its CRC
+   * changes by the CRC, started from 0, over the changed bits followed by
+   * zeros up to the end of the FED. Running a CRC over n zero words is a
+   * linear map, which is tabulated for n being a power of 2. Thus, the new
+   * CRC is obtained from the known one with a few table lookups per changed
+   * word, independent of the FED size.
+   *
+   * The FED must be contiguous in memory and its trailer must hold the CRC
+   * of the unchanged FED, as calculated by evf::compute_crc.
+   */
+  class FedCRCUpdater
+  {
+  public:
+
+    /**
+     * Return the CRC obtained by continuing the given CRC over the given
+     * number of 64-bit words of zeros
+     */
+    static uint16_t propagate(uint16_t crc, size_t nbZeroWords);
+
+    /**
+     * Return the CRC of a FED after one of its 64-bit words changed from
+     * oldWord to newWord. The changed word is followed by nbFollowingWords
+     * up to and including the FED trailer.
+     */
+    static uint16_t update
+    (
+      const uint16_t crc,
+      const unsigned char* oldWord,
+      const unsigned char* newWord,
+      const size_t nbFollowingWords
+    );
+
+    /**
+     * Track the changes written to the FED of fedSize bytes at fedPtr
+     */
+    FedCRCUpdater(unsigned char* fedPtr, const size_t fedSize);
+
+    /**
+     * Write the value at the given byte offset from the start of the FED.
+     * The value may span two 64-bit words, but must not touch the CRC
+     * in the FED trailer.
+     */
+    template<typename T>
+    void write(const size_t offset, const T value);
+
+    /**
+     * Store the CRC of the changed FED into its trailer
+     */
+    void updateTrailer() const;
+
+    /**
+     * Return the CRC of the changed FED
+     */
+    uint16_t getCRC() const
+    { return crc_; }
+
+
+  private:
+
+    void changeWord(const size_t wordNb, const unsigned char* oldWord);
+
+    unsigned char* const fedPtr_;
+    const size_t nbWords_;
+    uint16_t crc_;
+
+  }; // FedCRCUpdater
+
+
+  template<typename T>
+  void FedCRCUpdater::write(const size_t offset, const T value)
+  {
+    BOOST_STATIC_ASSERT( sizeof(T) <= 8 );
+
+    const size_t firstWord = offset / 8;
+    const size_t lastWord = (offset + sizeof(T) - 1) / 8;
+
+    unsigned char oldWords[16];
+    memcpy(oldWords, fedPtr_ + firstWord*8, (lastWord - firstWord + 1) * 8);
+    memcpy(fedPtr_ + offset, &value, sizeof(T));
+
+    for (size_t wordNb = firstWord; wordNb <= lastWord; ++wordNb)
+      changeWord(wordNb, &oldWords[(wordNb - firstWord) * 8]);
+  }
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_FedCRCUpdater_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
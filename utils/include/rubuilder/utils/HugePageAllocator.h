@@ -0,0 +1,120 @@
+#ifndef _rubuilder_utils_HugePageAllocator_h_
+#define _rubuilder_utils_HugePageAllocator_h_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "toolbox/mem/Allocator.h"
+#include "toolbox/mem/Buffer.h"
+#include "toolbox/mem/Pool.h"
+#include "toolbox/mem/exception/FailedAllocation.h"
+#include "toolbox/mem/exception/FailedDispose.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Memory pool allocator backed by pre-faulted huge pages
+   *
+   * The allocator maps the committed size at construction, preferably
+   * with MAP_HUGETLB pages of the requested size. If no huge pages of
+   * that size are reserved on the host, it falls back to an anonymous
+   * mapping using transparent huge pages. If a NUMA node is given, the
+   * whole mapping is bound to it. All pages are touched before the
+   * constructor returns, such that no page faults occur while taking
+   * data and the pages are allocated on the bound node.
+   *
+   * Buffers are carved from the mapping in power-of-two size classes,
+   * i.e. a request may use up to twice its size. Released buffers are
+   * kept per size class for reuse and are never merged again. Once the
+   * mapping is used up, a free buffer of a larger class is split to
+   * serve a smaller request.
+   */
+  class HugePageAllocator : public toolbox::mem::Allocator
+  {
+  public:
+
+    /**
+     * A negative NUMA node leaves the placement to the kernel
+     */
+    HugePageAllocator
+    (
+      const size_t committedSize,
+      const size_t hugePageSize,
+      const int32_t numaNode = -1
+    );
+
+    virtual ~HugePageAllocator();
+
+    toolbox::mem::Buffer* alloc(size_t size, toolbox::mem::Pool*)
+      throw (toolbox::mem::exception::FailedAllocation);
+
+    void free(toolbox::mem::Buffer*)
+      throw (toolbox::mem::exception::FailedDispose);
+
+    std::string type();
+
+    bool isCommittedSizeSupported();
+
+    size_t getCommittedSize();
+
+    size_t getUsed();
+
+    /**
+     * Return a description of the pages backing the allocator
+     */
+    std::string getBacking() const;
+
+    /**
+     * Return the time in milliseconds spent pre-faulting the pages
+     */
+    uint32_t getPrefaultTimeMSec() const
+    { return prefaultTimeMSec_; }
+
+    /**
+     * Return the NUMA node the pages are bound to, or -1
+     */
+    int32_t getNUMAnode() const
+    { return numaNode_; }
+
+
+  private:
+
+    void mapRegion(const size_t hugePageSize);
+    void bindRegion();
+    void prefault();
+    static uint32_t getSizeClass(const size_t size);
+    static size_t getClassSize(const uint32_t sizeClass);
+    char* splitLargerBuffer(const uint32_t sizeClass);
+
+    size_t committedSize_;
+    const int32_t numaNode_;
+    char* region_;
+    size_t regionSize_;
+    size_t nextFree_;
+    size_t used_;
+    std::string backing_;
+    uint32_t prefaultTimeMSec_;
+
+    typedef std::vector<char*> FreeList;
+    std::vector<FreeList> freeLists_;
+    boost::mutex mutex_;
+
+  }; // HugePageAllocator
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_HugePageAllocator_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -6,6 +6,7 @@
 
 #include "i2o/i2o.h"
 #include "rubuilder/utils/EvBid.h"
+#include "toolbox/mem/Reference.h"
 
 
 namespace rubuilder { namespace msg { // namespace rubuilder::msg
@@ -40,6 +41,21 @@ namespace rubuilder { namespace msg { // namespace rubuilder::msg
   } EvtIdRqstsAndOrReleasesMsg;
 
 
+  /**
+   * Layout of the EvBids in the EVM to RU message.
+   * The version takes the place of a padding word which older EVMs
+   * never initialized. Thus RUs treat any value other than EVBIDS_RANGES
+   * as EVBIDS_LIST, and EVBIDS_RANGES is a magic number which a stale
+   * word cannot plausibly hold. Range encoding must only be enabled
+   * in the EVM once all RUs understand it.
+   */
+  enum EvBidsMsgVersion
+  {
+    EVBIDS_LIST   = 0,         // EvBidsMsg: one element per EvBid
+    EVBIDS_RANGES = 0x45425247 // EvBidRangesMsg: one element per run of consecutive EvBids
+  };
+
+
   /**
    * EVM to RU meesage that contains one or more EvBids.
    */
@@ -47,12 +63,42 @@ namespace rubuilder { namespace msg { // namespace rubuilder::msg
   {
     I2O_PRIVATE_MESSAGE_FRAME PvtMessageFrame; // I2O information.
     uint32_t nbElements;                       // Number of EvB ids.
-    uint32_t padding;                          // Padding for 64-bit alignment.
+    uint32_t version;                          // EvBidsMsgVersion, EVBIDS_LIST
     utils::EvBid elements[1];                  // The list of EvB ids.
     
   } EvBidsMsg;
 
 
+  /**
+   * A run of consecutive EvBids, i.e. EvBids with the same resync count
+   * and consecutive event numbers starting at first.
+   */
+  typedef struct
+  {
+    utils::EvBid first; // First EvB id of the run.
+    uint32_t count;     // Number of consecutive EvB ids.
+    uint32_t padding;   // Padding for 64-bit alignment.
+
+  } EvBidRange;
+
+
+  /**
+   * EVM to RU meesage that contains one or more EvBids encoded as
+   * ranges. Any gap in the event numbers or a resync starts a new range.
+   * The header up to and including the version is identical to EvBidsMsg.
+   */
+  typedef struct
+  {
+    I2O_PRIVATE_MESSAGE_FRAME PvtMessageFrame; // I2O information.
+    uint32_t nbElements;                       // Number of ranges.
+    uint32_t version;                          // EvBidsMsgVersion, EVBIDS_RANGES
+    uint32_t nbEvBids;                         // Total number of EvB ids in all ranges.
+    uint32_t padding;                          // Padding for 64-bit alignment.
+    EvBidRange elements[1];                    // The list of ranges.
+
+  } EvBidRangesMsg;
+
+
   /**
    * Contains the event id and trigger event number of the event fragment
    * wanted and the id of the resource that will be used to assemble the whole
@@ -67,6 +113,19 @@ namespace rubuilder { namespace msg { // namespace rubuilder::msg
   } RqstForFrag;
 
 
+  /**
+   * Marks a BU to RU message as RqstForFragRangesMsg. A RqstForFragsMsg,
+   * whose layout is unchanged, holds the resync count of its first request
+   * at the same position. RQSTS_RANGES is a magic number which a resync
+   * count never reaches. Range encoding must only be enabled in the BUs
+   * once all RUs understand it.
+   */
+  enum RqstForFragsMsgVersion
+  {
+    RQSTS_RANGES = 0x52515247 // RqstForFragRangesMsg: one element per run of consecutive requests
+  };
+
+
   /**
    * BU to RU message that contains one or more requests for event
    * fragments, where each request is represented by the event id of the event
@@ -83,6 +142,57 @@ namespace rubuilder { namespace msg { // namespace rubuilder::msg
   } RqstForFragsMsg;
 
 
+  /**
+   * A run of consecutive requests: the n-th request of the run asks for
+   * the EvBid following first by n event numbers (same resync count),
+   * to be assembled in the BU resource firstBuResourceId + n.
+   */
+  typedef struct
+  {
+    utils::EvBid first;         // Event builder id of the first event.
+    uint32_t firstBuResourceId; // Id of the BU resource of the first event.
+    uint32_t count;             // Number of consecutive requests.
+
+  } RqstForFragRange;
+
+
+  /**
+   * BU to RU message that contains one or more requests for event
+   * fragments encoded as ranges. Any gap in the event numbers or
+   * BU resource ids starts a new range. The header up to and including
+   * nbElements is identical to RqstForFragsMsg.
+   */
+  typedef struct
+  {
+    I2O_PRIVATE_MESSAGE_FRAME PvtMessageFrame; // I2O information.
+    uint32_t srcIndex;                         // Index of the source application.
+    uint32_t nbElements;                       // Number of ranges
+    uint32_t version;                          // RqstForFragsMsgVersion, RQSTS_RANGES
+    uint32_t nbRequests;                       // Total number of requests in all ranges
+    RqstForFragRange elements[1];              // Ranges of requests
+
+  } RqstForFragRangesMsg;
+
+
+  /**
+   * Return the elements of a message broadcast to the RUs.
+   * They follow the header in the frame, unless the header was
+   * sent in a frame of its own chained to the elements shared
+   * by all RUs (see utils::RUbroadcaster::sendToAllRUs).
+   */
+  template <typename Element>
+  inline const Element* getBroadcastElements
+  (
+    toolbox::mem::Reference* bufRef,
+    const Element* elementsInFrame
+  )
+  {
+    toolbox::mem::Reference* elementsBufRef = bufRef->getNextReference();
+    if ( elementsBufRef == 0 ) return elementsInFrame;
+    return static_cast<const Element*>(elementsBufRef->getDataLocation());
+  }
+
+
 } } // namespace rubuilder::msg
 
 std::ostream& operator<<
@@ -103,6 +213,18 @@ std::ostream& operator<<
   const rubuilder::msg::EvBidsMsg*
 );
 
+std::ostream& operator<<
+(
+  std::ostream&,
+  const rubuilder::msg::EvBidRange&
+);
+
+std::ostream& operator<<
+(
+  std::ostream&,
+  const rubuilder::msg::EvBidRangesMsg*
+);
+
 std::ostream& operator<<
 (
   std::ostream&,
@@ -115,6 +237,18 @@ std::ostream& operator<<
   const rubuilder::msg::RqstForFragsMsg*
 );
 
+std::ostream& operator<<
+(
+  std::ostream&,
+  const rubuilder::msg::RqstForFragRange&
+);
+
+std::ostream& operator<<
+(
+  std::ostream&,
+  const rubuilder::msg::RqstForFragRangesMsg*
+);
+
 
 #endif // _rubuilder_utils_I2OMessages_h_
 
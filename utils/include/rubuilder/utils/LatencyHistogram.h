@@ -0,0 +1,203 @@
+#ifndef _rubuilder_utils_LatencyHistogram_h_
+#define _rubuilder_utils_LatencyHistogram_h_
+
+#include <stdint.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "rubuilder/utils/Atomic.h"
+#include "rubuilder/utils/InfoSpaceItems.h"
+#include "xdata/UnsignedInteger64.h"
+#include "xgi/Output.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * Return a monotonic time stamp in micro seconds
+   */
+  inline uint64_t getMonotonicTimeUSec()
+  {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+  }
+
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Log-linear histogram of latencies in the spirit of HdrHistogram
+   *
+   * Values below 2*SUB_BUCKET_COUNT are counted exactly. Above, each
+   * power of two is split into SUB_BUCKET_COUNT linear buckets, giving
+   * a relative precision of 1/SUB_BUCKET_COUNT over the full range.
+   * The histogram must only be written by one thread at a time, but
+   * may be read concurrently.
+   */
+  class LatencyHistogram
+  {
+  public:
+
+    static const uint32_t SUB_BUCKET_BITS = 5;
+    static const uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const uint32_t MAX_VALUE_BITS = 38;
+    static const uint32_t BUCKET_COUNT =
+      (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    LatencyHistogram();
+
+    /**
+     * Count the value. Values beyond the range are clamped.
+     */
+    inline void record(const uint64_t value)
+    {
+      uint64_t& count = counts_[ bucketIndex(value) ];
+      storeRelaxed(count, count + 1);
+    }
+
+    /**
+     * Add the counts of the other histogram
+     */
+    void add(const LatencyHistogram&);
+
+    /**
+     * Subtract the counts of the other histogram
+     */
+    void subtract(const LatencyHistogram&);
+
+    /**
+     * Set all counts to zero
+     */
+    void reset();
+
+    /**
+     * Return the number of recorded values
+     */
+    uint64_t getCount() const;
+
+    /**
+     * Return the highest value equivalent to the value
+     * below which the given percentage of the values lie
+     */
+    uint64_t getValueAtPercentile(const double percentile) const;
+
+    /**
+     * Return the highest value equivalent to the largest recorded value
+     */
+    uint64_t getMax() const;
+
+
+  private:
+
+    static inline uint32_t bucketIndex(uint64_t value)
+    {
+      if ( value < 2*SUB_BUCKET_COUNT ) return value;
+      if ( value >> MAX_VALUE_BITS ) value = (1ULL << MAX_VALUE_BITS) - 1;
+      const uint32_t shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+      return shift * SUB_BUCKET_COUNT + (value >> shift);
+    }
+
+    static uint64_t highestEquivalentValue(const uint32_t index);
+
+    std::vector<uint64_t> counts_;
+
+  }; // LatencyHistogram
+
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Records a latency from any number of threads
+   *
+   * Each recording thread gets its own LatencyHistogram on first use,
+   * such that record() neither locks nor shares cache lines. The
+   * monitoring merges the per-thread histograms and publishes the
+   * percentiles of the values recorded since the previous update.
+   */
+  class LatencyRecorder : private boost::noncopyable
+  {
+  public:
+
+    LatencyRecorder(const std::string& name);
+
+    /**
+     * Record the latency in micro seconds
+     */
+    inline void record(const uint64_t latencyUSec)
+    {
+      LatencyHistogram* histogram = threadHistogram_.get();
+      if ( histogram == 0 ) histogram = registerThread();
+      histogram->record(latencyUSec);
+    }
+
+    /**
+     * Record the time elapsed since the given time stamp
+     */
+    inline void recordSince(const uint64_t startUSec)
+    {
+      const uint64_t now = getMonotonicTimeUSec();
+      record( now > startUSec ? now - startUSec : 0 );
+    }
+
+    /**
+     * Append the percentile items to be published in the
+     * monitoring info space to the InfoSpaceItems
+     */
+    void appendMonitoringItems(InfoSpaceItems&);
+
+    /**
+     * Update the published percentiles with the latencies
+     * recorded since the previous update
+     */
+    void updateMonitoringItems();
+
+    /**
+     * Forget the latencies recorded so far
+     */
+    void resetMonitoringCounters();
+
+    /**
+     * Print the percentiles as HTML table rows
+     */
+    void printHtml(xgi::Output*);
+
+
+  private:
+
+    LatencyHistogram* registerThread();
+    static void noCleanup(LatencyHistogram*) {}
+    void mergeThreadHistograms(LatencyHistogram&);
+
+    const std::string name_;
+    boost::thread_specific_ptr<LatencyHistogram> threadHistogram_;
+
+    typedef std::vector< boost::shared_ptr<LatencyHistogram> > ThreadHistograms;
+    ThreadHistograms threadHistograms_;
+    LatencyHistogram lastTotal_;
+    boost::mutex mutex_;
+
+    xdata::UnsignedInteger64 count_;
+    xdata::UnsignedInteger64 p50_;
+    xdata::UnsignedInteger64 p99_;
+    xdata::UnsignedInteger64 p999_;
+    xdata::UnsignedInteger64 max_;
+
+  }; // LatencyRecorder
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_LatencyHistogram_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
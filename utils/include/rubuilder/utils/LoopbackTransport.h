@@ -0,0 +1,198 @@
+#ifndef _rubuilder_utils_LoopbackTransport_h_
+#define _rubuilder_utils_LoopbackTransport_h_
+
+#include <deque>
+#include <map>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "log4cplus/logger.h"
+#include "rubuilder/utils/Atomic.h"
+#include "toolbox/mem/Reference.h"
+#include "xdaq/Application.h"
+#include "xdaq/ApplicationDescriptor.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief In-process transport of I2O frames between applications
+   *
+   * Applications running in the same executive bind their I2O callbacks
+   * to the transport. A frame posted to a bound application is queued and
+   * handed to its callback by a dispatcher thread owned by the destination,
+   * as if it had arrived over the network. Frames to any other application
+   * are left to the peer transports of the application context.
+   *
+   * The transport counts the frames and bytes sent and received by each
+   * application, and the CPU time spent in its callbacks. This allows to run
+   * a whole builder in one process and to measure the CPU cost of each
+   * component without network effects.
+   */
+  class LoopbackTransport : private boost::noncopyable
+  {
+  public:
+
+    typedef boost::function<void(toolbox::mem::Reference*)> Callback;
+    typedef std::map<uint16_t,Callback> Callbacks;
+
+    LoopbackTransport();
+
+    ~LoopbackTransport();
+
+    /**
+     * Deliver frames for the application to the callbacks, which are
+     * indexed by the I2O private function code. Starts the dispatcher
+     * thread of the application and resets its statistics.
+     */
+    void bind
+    (
+      xdaq::ApplicationDescriptor*,
+      const Callbacks&,
+      log4cplus::Logger&
+    );
+
+    /**
+     * Stop delivering frames to the application.
+     * Frames still queued for it are released.
+     */
+    void unbind(xdaq::ApplicationDescriptor*);
+
+    /**
+     * Return true if frames for the application are delivered by the transport
+     */
+    bool isBound(xdaq::ApplicationDescriptor*) const;
+
+    /**
+     * Queue the frame for the destination if it is bound to the transport,
+     * and return true. Otherwise, return false leaving the frame to the caller.
+     */
+    inline bool postFrame
+    (
+      toolbox::mem::Reference* bufRef,
+      xdaq::ApplicationDescriptor* source,
+      xdaq::ApplicationDescriptor* destination
+    )
+    {
+      if ( loadRelaxed(boundCount_) == 0 ) return false;
+      return queueFrame(bufRef, source, destination);
+    }
+
+    /**
+     * Write one line per application with its throughput. The rates are
+     * calculated between the first and the last frame of each direction.
+     */
+    void printStatistics(std::ostream&) const;
+
+
+  private:
+
+    struct Statistics
+    {
+      uint64_t frames;
+      uint64_t bytes;
+      uint64_t firstNSec;
+      uint64_t lastNSec;
+
+      Statistics() : frames(0), bytes(0), firstNSec(0), lastNSec(0) {}
+
+      void add(const uint32_t frameCount, const uint64_t byteCount, const uint64_t nowNSec);
+      double getFrameRate() const;
+      double getBandwidth() const;
+    };
+
+    struct Component
+    {
+      const std::string name;
+
+      // Protected by the mutex of the component
+      mutable boost::mutex mutex;
+      boost::condition_variable frameAvailable;
+      std::deque<toolbox::mem::Reference*> frames;
+      Callbacks callbacks;
+      boost::shared_ptr<boost::thread> dispatcher;
+      bool dispatching;
+      Statistics sent;
+      Statistics received;
+      uint64_t callbackCPUTimeNSec;
+      uint64_t unhandledFrames;
+      log4cplus::Logger logger;
+
+      Component(const std::string& name);
+    };
+    typedef boost::shared_ptr<Component> ComponentPtr;
+
+    bool queueFrame
+    (
+      toolbox::mem::Reference*,
+      xdaq::ApplicationDescriptor* source,
+      xdaq::ApplicationDescriptor* destination
+    );
+    Component* findComponent(xdaq::ApplicationDescriptor*) const;
+    Component* getComponent(xdaq::ApplicationDescriptor*);
+    void stopDispatcher(Component*);
+    void dispatch(Component*);
+    static bool deliver(Component*, toolbox::mem::Reference*);
+    static void getFrameCountAndSize(toolbox::mem::Reference*, uint32_t& frameCount, uint64_t& byteCount);
+    static void releaseFrames(std::deque<toolbox::mem::Reference*>&);
+
+    // Components are never removed, thus pointers to them stay valid.
+    // Posting a frame looks up the components without locking: a new
+    // component is added to a copy of the map which then replaces the
+    // current one. The previous maps are kept, as they might still be read.
+    typedef std::map<xdaq::ApplicationDescriptor*,ComponentPtr> Components;
+    typedef boost::shared_ptr<const Components> ComponentsPtr;
+    const Components* components_;
+    std::vector<ComponentsPtr> componentMaps_;
+    boost::mutex mutex_; // serializes adding components
+
+    // Serializes the binding. It is never taken while posting frames,
+    // thus a dispatcher can be joined while holding it.
+    boost::mutex bindMutex_;
+
+    uint32_t boundCount_;
+
+  }; // LoopbackTransport
+
+
+  /**
+   * Return the loopback transport of this process
+   */
+  LoopbackTransport& getLoopbackTransport();
+
+
+  /**
+   * Post the frame from the application to the destination. The frame
+   * goes through the loopback transport if the destination is bound to
+   * it, and through the peer transports of the application context otherwise.
+   */
+  void postFrame
+  (
+    xdaq::Application*,
+    toolbox::mem::Reference*,
+    xdaq::ApplicationDescriptor* destination
+  );
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_LoopbackTransport_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,55 @@
+#ifndef _rubuilder_utils_MemoryPools_h_
+#define _rubuilder_utils_MemoryPools_h_
+
+#include <stdint.h>
+#include <string>
+
+#include "toolbox/mem/Pool.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * Choice of the memory backing a pool
+   */
+  struct PoolConfiguration
+  {
+    uint32_t hugePageSizeKB;  // 0 uses the plain heap allocator
+    uint32_t committedSizeMB; // size pre-faulted for huge page pools
+
+    PoolConfiguration() : hugePageSizeKB(0), committedSizeMB(0) {}
+  };
+
+  /**
+   * Return the memory pool to be used for event data. The udapl pool is
+   * used if it exists. Otherwise, a pool named after the base name is
+   * created on first use, backed either by the heap or by pre-faulted
+   * huge pages. The name of the pool is returned in poolName.
+   * A huge page pool is bound to the NUMA node configured for it in
+   * the ResourcePlacement. It keeps its committed size and its node
+   * once created.
+   */
+  toolbox::mem::Pool* getMemoryPool
+  (
+    const std::string& baseName,
+    const PoolConfiguration&,
+    std::string& poolName
+  );
+
+  /**
+   * Return a description of the memory backing the named pool
+   */
+  std::string getMemoryPoolBacking(const std::string& poolName);
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_MemoryPools_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
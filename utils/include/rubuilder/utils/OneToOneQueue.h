@@ -1,11 +1,17 @@
 #ifndef _rubuilder_utils_OneToOneQueue_h_
 #define _rubuilder_utils_OneToOneQueue_h_
 
+#include <boost/type_traits/has_trivial_destructor.hpp>
+
+#include <algorithm>
 #include <stdexcept>
 #include <stdint.h>
 #include <vector>
 
 #include "interface/evb/i2oEVBMsgs.h"
+#include "rubuilder/utils/Atomic.h"
+#include "rubuilder/utils/Constants.h"
+#include "rubuilder/utils/EventUtils.h"
 #include "rubuilder/utils/Exception.h"
 #include "toolbox/mem/Reference.h"
 #include "xgi/Output.h"
@@ -18,6 +24,12 @@ namespace rubuilder { namespace utils
    * \ingroup xdaqApps
    * \brief A lock-free queue which is threadsafe if 
    * there is only one producer and one consumer.
+   *
+   * The read and write indices run freely and are mapped onto a
+   * power-of-two sized container. Each side keeps its own index and
+   * a cached copy of the other side's index on a separate cache line.
+   * The remote index is only re-read when the cached copy indicates
+   * an empty (consumer) or full (producer) queue.
    */
 
   template <class T>
@@ -34,12 +46,24 @@ namespace rubuilder { namespace utils
      */
     bool enq(const T&);
 
+    /**
+     * Enqueue up to count elements from the array.
+     * Returns the number of elements enqueued.
+     */
+    uint32_t enq(const T* elements, const uint32_t count);
+
     /**
      * Dequeue an element.
      * Return false if no element can be dequeued.
      */
     bool deq(T&);
 
+    /**
+     * Dequeue up to maxCount elements into the array.
+     * Returns the number of elements dequeued.
+     */
+    uint32_t deq(T* elements, const uint32_t maxCount);
+
     /**
      * Return the number of elements in the queue.
      */
@@ -98,12 +122,27 @@ namespace rubuilder { namespace utils
      * Format passed element information into the ostringstream.
      */    
     void formatter(T&, std::ostringstream*);
+
+    /**
+     * Release any resource held by the slot once it has been dequeued.
+     */
+    void clearSlot(const uint32_t index);
     
     const std::string name_;
-    volatile uint32_t readPointer_;
-    volatile uint32_t writePointer_;
     std::vector<T> container_;
-    volatile uint32_t size_;
+    uint32_t capacity_;
+    uint32_t mask_;
+
+    // Consumer side
+    char paddingConsumer_[CACHE_LINE_SIZE];
+    uint32_t readIndex_;
+    uint32_t cachedWriteIndex_;
+
+    // Producer side
+    char paddingProducer_[CACHE_LINE_SIZE - 2*sizeof(uint32_t)];
+    uint32_t writeIndex_;
+    uint32_t cachedReadIndex_;
+    char paddingEnd_[CACHE_LINE_SIZE - 2*sizeof(uint32_t)];
   };
 
   
@@ -114,8 +153,12 @@ namespace rubuilder { namespace utils
   template <class T>
   OneToOneQueue<T>::OneToOneQueue(const std::string& name) :
   name_(name),
-  readPointer_(0),
-  writePointer_(0)
+  capacity_(0),
+  mask_(0),
+  readIndex_(0),
+  cachedWriteIndex_(0),
+  writeIndex_(0),
+  cachedReadIndex_(0)
   {
     resize(1);
   }
@@ -124,8 +167,12 @@ namespace rubuilder { namespace utils
   template <class T>
   OneToOneQueue<T>::OneToOneQueue(const std::string& name, const uint32_t size) :
   name_(name),
-  readPointer_(0),
-  writePointer_(0)
+  capacity_(0),
+  mask_(0),
+  readIndex_(0),
+  cachedWriteIndex_(0),
+  writeIndex_(0),
+  cachedReadIndex_(0)
   {
     resize(size);
   }
@@ -134,30 +181,27 @@ namespace rubuilder { namespace utils
   template <class T>
   inline uint32_t OneToOneQueue<T>::elements() const
   {
-    volatile const uint32_t cachedWritePointer = writePointer_; 
-    volatile const uint32_t cachedReadPointer = readPointer_; 
-    const uint32_t elements = cachedWritePointer < cachedReadPointer ?
-      cachedWritePointer + size_ - cachedReadPointer :
-      cachedWritePointer - cachedReadPointer;
-    return elements;
+    const uint32_t cachedReadIndex = loadAcquire(readIndex_);
+    const uint32_t cachedWriteIndex = loadAcquire(writeIndex_);
+    return ( cachedWriteIndex - cachedReadIndex );
   }
 
 
   template <class T>
   inline uint32_t OneToOneQueue<T>::size() const
   {
-    return (size_ - 1);  
+    return capacity_;
   }
 
 
   template <class T>
   bool OneToOneQueue<T>::empty() const
-  { return (readPointer_ == writePointer_); }
+  { return ( loadAcquire(readIndex_) == loadAcquire(writeIndex_) ); }
 
 
   template <class T>
   bool OneToOneQueue<T>::full() const
-  { return ( (writePointer_ + 1) % size_ == readPointer_); }
+  { return ( elements() >= capacity_ ); }
   
   
   template <class T>
@@ -168,35 +212,99 @@ namespace rubuilder { namespace utils
       XCEPT_RAISE(rubuilder::exception::FIFO,
         "Cannot resize the non-empty queue " + name_);
     }
+
+    uint32_t containerSize = 1;
+    while ( containerSize < size ) containerSize <<= 1;
+
     container_.clear();
-    readPointer_ = writePointer_ = 0;
-    size_ = size+1;
-    container_.resize(size_);
+    container_.resize(containerSize);
+    capacity_ = size;
+    mask_ = containerSize - 1;
+    readIndex_ = cachedWriteIndex_ = 0;
+    writeIndex_ = cachedReadIndex_ = 0;
   }
   
   
   template <class T>
   bool OneToOneQueue<T>::enq(const T& element)
   {
-    volatile const uint32_t nextElement = (writePointer_ + 1) % size_;
-    if ( nextElement == readPointer_ ) return false;
-    container_[writePointer_] = element;
-    writePointer_ = nextElement;
+    const uint32_t writeIndex = writeIndex_;
+    if ( writeIndex - cachedReadIndex_ >= capacity_ )
+    {
+      cachedReadIndex_ = loadAcquire(readIndex_);
+      if ( writeIndex - cachedReadIndex_ >= capacity_ ) return false;
+    }
+    container_[writeIndex & mask_] = element;
+    storeRelease(writeIndex_, writeIndex + 1);
     return true;
   }
   
   
+  template <class T>
+  uint32_t OneToOneQueue<T>::enq(const T* elements, const uint32_t count)
+  {
+    const uint32_t writeIndex = writeIndex_;
+    uint32_t freeSlots = capacity_ - (writeIndex - cachedReadIndex_);
+    if ( freeSlots < count )
+    {
+      cachedReadIndex_ = loadAcquire(readIndex_);
+      freeSlots = capacity_ - (writeIndex - cachedReadIndex_);
+    }
+    const uint32_t nbElements = std::min(count, freeSlots);
+    for (uint32_t i = 0; i < nbElements; ++i)
+    {
+      container_[(writeIndex + i) & mask_] = elements[i];
+    }
+    if ( nbElements > 0 ) storeRelease(writeIndex_, writeIndex + nbElements);
+    return nbElements;
+  }
+  
+  
   template <class T>
   bool OneToOneQueue<T>::deq(T& element)
   {
-    if ( empty() ) return false;
-
-    volatile const uint32_t nextElement = (readPointer_ + 1) % size_;
-    element = container_[readPointer_];
-    container_[readPointer_] = T();
-    readPointer_ = nextElement;
+    const uint32_t readIndex = readIndex_;
+    if ( readIndex == cachedWriteIndex_ )
+    {
+      cachedWriteIndex_ = loadAcquire(writeIndex_);
+      if ( readIndex == cachedWriteIndex_ ) return false;
+    }
+    element = container_[readIndex & mask_];
+    clearSlot(readIndex);
+    storeRelease(readIndex_, readIndex + 1);
     return true;
   }
+  
+  
+  template <class T>
+  uint32_t OneToOneQueue<T>::deq(T* elements, const uint32_t maxCount)
+  {
+    const uint32_t readIndex = readIndex_;
+    uint32_t available = cachedWriteIndex_ - readIndex;
+    if ( available < maxCount )
+    {
+      cachedWriteIndex_ = loadAcquire(writeIndex_);
+      available = cachedWriteIndex_ - readIndex;
+    }
+    const uint32_t nbElements = std::min(maxCount, available);
+    for (uint32_t i = 0; i < nbElements; ++i)
+    {
+      elements[i] = container_[(readIndex + i) & mask_];
+      clearSlot(readIndex + i);
+    }
+    if ( nbElements > 0 ) storeRelease(readIndex_, readIndex + nbElements);
+    return nbElements;
+  }
+
+
+  template <class T>
+  inline void OneToOneQueue<T>::clearSlot(const uint32_t index)
+  {
+    // Only elements owning resources, e.g. shared pointers,
+    // need to be reset. Plain values are simply overwritten.
+    if ( ! boost::has_trivial_destructor<T>::value )
+      container_[index & mask_] = T();
+  }
 
 
   template <class T>
@@ -262,8 +370,8 @@ namespace rubuilder { namespace utils
     // Note: we do not want to lock the queue for the debug 
     // printout. Thus, be prepared that some elements are no
     // longer there when we want to print them.
-    const uint32_t cachedReadPointer = readPointer_;
-    const uint32_t cachedWritePointer = writePointer_;
+    const uint32_t cachedReadIndex = loadAcquire(readIndex_);
+    const uint32_t cachedWriteIndex = loadAcquire(writeIndex_);
     const uint32_t cachedSize = size();
     const uint32_t nbElements = std::min(nbElementsToPrint, cachedSize);
 
@@ -272,9 +380,9 @@ namespace rubuilder { namespace utils
     
     *out << "<tr>" << std::endl;
     
-    for (uint32_t i=cachedReadPointer; i < cachedReadPointer+nbElements; ++i)
+    for (uint32_t i=cachedReadIndex; i != cachedReadIndex+nbElements; ++i)
     {
-      uint32_t pos = i % cachedSize;
+      const uint32_t pos = i & mask_;
       *out << "  <th>" << pos << "</th>" << std::endl;
     }
     
@@ -282,12 +390,11 @@ namespace rubuilder { namespace utils
     
     *out << "<tr>" << std::endl;
 
-    for (uint32_t i=cachedReadPointer; i < cachedReadPointer+nbElements; ++i)
+    for (uint32_t i=cachedReadIndex; i != cachedReadIndex+nbElements; ++i)
     {
-      uint32_t pos = i % cachedSize;
+      const uint32_t pos = i & mask_;
       
-      if ( ( cachedWritePointer >= cachedReadPointer && i < cachedWritePointer ) ||
-           ( cachedWritePointer < cachedReadPointer && i < cachedWritePointer + cachedSize) )
+      if ( i - cachedReadIndex < cachedWriteIndex - cachedReadIndex )
       {
         *out << "  <td style=\"background:#51ef9e\">";
         try
@@ -333,8 +440,8 @@ namespace rubuilder { namespace utils
     // Note: we do not want to lock the queue for the debug 
     // printout. Thus, be prepared that some elements are no
     // longer there when we want to print them.
-    const uint32_t cachedReadPointer = readPointer_;
-    const uint32_t cachedWritePointer = writePointer_;
+    const uint32_t cachedReadIndex = loadAcquire(readIndex_);
+    const uint32_t cachedWriteIndex = loadAcquire(writeIndex_);
     const uint32_t cachedElements = elements();
     const uint32_t cachedSize = size();
     const uint32_t nbElements = std::min(nbElementsToPrint, cachedSize);
@@ -346,22 +453,21 @@ namespace rubuilder { namespace utils
     *out << "  <th colspan=\"2\">";
     *out << name_;
     *out << "<br/>";
-    *out << " read="     << cachedReadPointer;
-    *out << " write="    << cachedWritePointer;
+    *out << " read="     << (cachedReadIndex & mask_);
+    *out << " write="    << (cachedWriteIndex & mask_);
     *out << " size="     << cachedSize;
     *out << " elements=" << cachedElements;
     *out << "</th>" << std::endl;
     *out << "</tr>" << std::endl;
 
-    for (uint32_t i=cachedReadPointer; i < cachedReadPointer+nbElements; ++i)
+    for (uint32_t i=cachedReadIndex; i != cachedReadIndex+nbElements; ++i)
     {
-      uint32_t pos = i % cachedSize;
+      const uint32_t pos = i & mask_;
       
       *out << "<tr>" << std::endl;
       *out << "  <th>" << pos << "</th>" << std::endl;
       
-      if ( ( cachedWritePointer >= cachedReadPointer && i < cachedWritePointer ) ||
-           ( cachedWritePointer < cachedReadPointer && i < cachedWritePointer + cachedSize) )
+      if ( i - cachedReadIndex < cachedWriteIndex - cachedReadIndex )
       {
         *out << "  <td style=\"background-color:#51ef9e\">";
         try
@@ -420,6 +526,24 @@ namespace rubuilder { namespace utils
     }
   }
   
+
+  template <>
+  inline
+  void OneToOneQueue<L1Information*>::formatter(L1Information*& element, std::ostringstream* out)
+  {
+    if ( element )
+    {
+      *out << "runNumber="   << element->runNumber << " ";
+      *out << "lsNumber="    << element->lsNumber  << " ";
+      *out << "eventType="   << element->eventType << " ";
+      *out << "isValid="     << element->isValid;
+    }
+    else
+    {
+      *out << "n/a";
+    }
+  }
+  
     
   template <class T>
   inline void OneToOneQueue<T>::formatter(T& element, std::ostringstream* out)
@@ -0,0 +1,175 @@
+#ifndef _rubuilder_utils_PerThreadCounters_h_
+#define _rubuilder_utils_PerThreadCounters_h_
+
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "rubuilder/utils/Atomic.h"
+#include "rubuilder/utils/Constants.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Monitoring counters updated from any number of threads without locking
+   *
+   * Each updating thread gets its own copy of the counter struct T on
+   * first use, allocated on separate cache lines. The hot path modifies
+   * its copy through local() without locks or atomic instructions.
+   * The monitoring merges all copies with snapshot().
+   *
+   * T must be default constructible with all counters set to zero and
+   * provide T& operator+=(const T&) which merges the counts of another
+   * thread, typically by adding them up. A last event number cannot be
+   * merged once it wrapped around and is better kept as a single value.
+   * T must not own memory, as it is copied while being updated.
+   */
+  template <class T>
+  class PerThreadCounters : private boost::noncopyable
+  {
+  public:
+
+    PerThreadCounters();
+    ~PerThreadCounters();
+
+    /**
+     * Return the counters of the calling thread
+     */
+    inline T& local()
+    {
+      Slot* slot = threadSlot_.get();
+      if ( slot == 0 ) slot = registerThread();
+
+      const uint32_t generation = loadRelaxed(generation_);
+      if ( slot->generation != generation )
+      {
+        // A reset happened since the last update from this thread
+        slot->counters = T();
+        storeRelease(slot->generation, generation);
+      }
+      return slot->counters;
+    }
+
+    /**
+     * Merge the counters of all threads into the given struct
+     */
+    void snapshot(T&) const;
+
+    /**
+     * Set the counters of all threads to zero
+     */
+    void reset();
+
+
+  private:
+
+    struct Slot
+    {
+      T counters;
+      uint32_t generation;
+    };
+
+    Slot* registerThread();
+    static void noCleanup(Slot*) {}
+
+    boost::thread_specific_ptr<Slot> threadSlot_;
+
+    typedef std::vector<Slot*> Slots;
+    Slots slots_;
+    mutable boost::mutex mutex_;
+
+    uint32_t generation_;
+  };
+
+
+  //------------------------------------------------------------------
+  // Implementation follows
+  //------------------------------------------------------------------
+
+  template <class T>
+  PerThreadCounters<T>::PerThreadCounters() :
+  threadSlot_(&PerThreadCounters<T>::noCleanup),
+  generation_(0)
+  {}
+
+
+  template <class T>
+  PerThreadCounters<T>::~PerThreadCounters()
+  {
+    for (typename Slots::const_iterator it = slots_.begin(), itEnd = slots_.end();
+         it != itEnd; ++it)
+    {
+      (*it)->~Slot();
+      ::free(*it);
+    }
+  }
+
+
+  template <class T>
+  typename PerThreadCounters<T>::Slot* PerThreadCounters<T>::registerThread()
+  {
+    // Round up to whole cache lines such that no two threads share one
+    const size_t slotSize =
+      (sizeof(Slot) + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+
+    void* memory = 0;
+    if ( ::posix_memalign(&memory, CACHE_LINE_SIZE, slotSize) != 0 )
+      throw std::bad_alloc();
+
+    Slot* slot = new (memory) Slot();
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      slot->generation = generation_;
+      slots_.push_back(slot);
+    }
+    threadSlot_.reset(slot);
+    return slot;
+  }
+
+
+  template <class T>
+  void PerThreadCounters<T>::snapshot(T& total) const
+  {
+    total = T();
+
+    boost::mutex::scoped_lock sl(mutex_);
+
+    for (typename Slots::const_iterator it = slots_.begin(), itEnd = slots_.end();
+         it != itEnd; ++it)
+    {
+      // Counters of a thread which did not update since the
+      // last reset still hold the values from before
+      if ( loadAcquire((*it)->generation) == generation_ )
+        total += (*it)->counters;
+    }
+  }
+
+
+  template <class T>
+  void PerThreadCounters<T>::reset()
+  {
+    boost::mutex::scoped_lock sl(mutex_);
+
+    // The slots are owned by their threads, which
+    // clear them on their next update
+    storeRelease(generation_, generation_ + 1);
+  }
+
+} } // namespace rubuilder::utils
+
+#endif // _rubuilder_utils_PerThreadCounters_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -21,6 +21,7 @@
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger32.h"
 #include "xdata/Vector.h"
+#include "xgi/Output.h"
 
 
 
@@ -51,7 +52,8 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
     void initRuInstances(InfoSpaceItems&);
     
     /**
-     * Find the application descriptors of the participating RUs.
+     * Find the application descriptors of the participating RUs
+     * and choose how messages are broadcast to them.
      *
      * By default, all RUs in the zone will participate.
      * This can be overwritten by setting either the instances
@@ -63,12 +65,27 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
 
     /**
      * Send the data contained in the reference to all RUs.
+     * The message consists of a header of headerSize bytes
+     * followed by elements which are the same for all RUs.
+     *
+     * If 'sharedBroadcastFrame' is set and all participating RUs were
+     * bound to the loopback transport at configure, each RU is sent a small
+     * frame holding its copy of the header, chained to a duplicated
+     * reference to the elements of the message. The elements are thus
+     * never copied. Peer transports deliver each frame of a chain
+     * separately, thus otherwise each RU is sent a copy of the whole message.
      */
     void sendToAllRUs
     (
       toolbox::mem::Reference*,
-      const size_t bufSize
+      const size_t bufSize,
+      const size_t headerSize
     );
+
+    /**
+     * Print the broadcast statistics as HTML table rows
+     */
+    void printBroadcastHtml(xgi::Output*);
     
     /**
      * Return the number of RUs participating in the event building
@@ -94,6 +111,11 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
     void fillParticipatingRUsUsingFragmentSet();
     void fillParticipatingRUsUsingRuInstances();
     void fillRUInstance(xdata::UnsignedInteger32);
+    void chooseBroadcastMode();
+    void sendCopiesToAllRUs(toolbox::mem::Reference*, const size_t bufSize);
+    void sendSharedFrameToAllRUs(toolbox::mem::Reference*, const size_t bufSize, const size_t headerSize);
+    void sendCopyToRU(toolbox::mem::Reference*, const size_t bufSize, const ApplicationDescriptorAndTid&);
+    void postFrameToRU(toolbox::mem::Reference*, const ApplicationDescriptorAndTid&);
 
     typedef xdata::Vector<xdata::UnsignedInteger32> RUInstances;
     RUInstances ruInstances_;
@@ -103,6 +125,16 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
     xdata::Boolean useFragmentSet_;
     xdata::String fragmentSetsUrl_;
     xdata::UnsignedInteger32 fragmentSetId_;
+    xdata::Boolean sharedBroadcastFrame_;
+    bool useSharedFrame_;
+
+    struct BroadcastMonitoring
+    {
+      uint64_t broadcastCount;
+      uint64_t frameCount;
+      uint64_t cpuTimeNSec;
+    } broadcastMonitoring_;
+    boost::mutex broadcastMonitoringMutex_;
   };
   
   
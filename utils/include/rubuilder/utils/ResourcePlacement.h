@@ -0,0 +1,174 @@
+#ifndef _rubuilder_utils_ResourcePlacement_h_
+#define _rubuilder_utils_ResourcePlacement_h_
+
+#include <map>
+#include <sched.h>
+#include <set>
+#include <stdint.h>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "rubuilder/utils/Atomic.h"
+#include "toolbox/mem/Pool.h"
+#include "xdata/String.h"
+#include "xdata/Vector.h"
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Placement of workloops on CPUs and of memory pools on NUMA nodes
+   *
+   * Workloops are pinned to a set of CPUs given as "name:cpuList", where the
+   * name is the workloop name without the application identifier, e.g.
+   * "Processing:2-5,8". The workloop pins itself when it calls
+   * pinCurrentThread from its action.
+   *
+   * Memory pools are bound to a NUMA node given as "poolName:node". The
+   * owner of a heap pool calls placePool at configure, which takes frames
+   * from the pool, binds their pages to the node with mbind and touches
+   * them. The pages stay on the node when the pool recycles the frames.
+   * Huge page pools are bound as a whole by their allocator when they
+   * are created, and placePool leaves them alone. Only the pools of owners
+   * which announced them with addPlaceablePool can be placed. Any other
+   * pool name is rejected at Configure.
+   */
+  class ResourcePlacement : private boost::noncopyable
+  {
+  public:
+
+    typedef xdata::Vector<xdata::String> Mapping;
+
+    ResourcePlacement();
+
+    /**
+     * Replace the placement of the workloops of the application
+     * with the given identifier and of the given pools
+     */
+    void configure
+    (
+      const std::string& identifier,
+      const Mapping& workLoopCPUs,
+      const Mapping& poolNUMAnodes
+    );
+
+    /**
+     * Pin the calling thread to the CPUs configured for the workloop.
+     * Only the first call after a configure has any effect.
+     */
+    inline void pinCurrentThread(const std::string& workLoopName)
+    {
+      uint32_t* threadGeneration = threadGeneration_.get();
+      if ( threadGeneration && *threadGeneration == loadRelaxed(generation_) ) return;
+      applyToCurrentThread(workLoopName);
+    }
+
+    /**
+     * Bind the memory of blockCount frames of blockSize bytes from
+     * the pool to the NUMA node configured for the pool name.
+     * Does nothing if no node is configured,
+     * or if the allocator of the pool has bound it.
+     */
+    void placePool
+    (
+      const std::string& poolName,
+      toolbox::mem::Pool*,
+      const size_t blockSize,
+      const uint32_t blockCount
+    );
+
+    /**
+     * Announce that the owner of the pool with the given base name places
+     * its heap pool with placePool. The huge page pool of the same owner
+     * is placed by its allocator.
+     */
+    void addPlaceablePool(const std::string& baseName);
+
+    /**
+     * Withdraw an announcement made with addPlaceablePool
+     */
+    void removePlaceablePool(const std::string& baseName);
+
+    /**
+     * Raise exception::Configuration if a pool in the given placement
+     * does not belong to an owner which announced it as placeable
+     */
+    void checkPoolNames(const Mapping& poolNUMAnodes) const;
+
+    /**
+     * Return true and set node if a NUMA node is configured for the pool
+     */
+    bool getPoolNode(const std::string& poolName, uint32_t& node) const;
+
+    /**
+     * Record that the allocator of the pool has bound its memory
+     * of the given size to the NUMA node
+     */
+    void setAllocatorPlacement
+    (
+      const std::string& poolName,
+      const uint32_t node,
+      const size_t size
+    );
+
+    /**
+     * Return a summary of the CPUs used by the pinned workloops
+     */
+    std::string getWorkLoopPlacement() const;
+
+    /**
+     * Return a summary of the NUMA nodes used by the placed pools
+     */
+    std::string getPoolPlacement() const;
+
+
+  private:
+
+    void applyToCurrentThread(const std::string& workLoopName);
+    static void parseCPUList(const std::string& cpuList, cpu_set_t&);
+    static std::string formatCPUSet(const cpu_set_t&);
+    static void splitEntry(const std::string& entry, std::string& name, std::string& value);
+
+    typedef std::map<std::string,cpu_set_t> WorkLoopCPUs;
+    WorkLoopCPUs workLoopCPUs_;
+    typedef std::map<std::string,uint32_t> PoolNodes;
+    PoolNodes poolNodes_;
+
+    typedef std::map<std::string,std::string> Placements;
+    Placements workLoopPlacements_;
+    Placements poolPlacements_;
+    typedef std::set<std::string> PoolNames;
+    PoolNames poolsPlacedByAllocator_;
+    // Owners come and go when the input source changes
+    typedef std::multiset<std::string> PlaceablePools;
+    PlaceablePools placeablePools_;
+
+    mutable boost::mutex mutex_;
+
+    boost::thread_specific_ptr<uint32_t> threadGeneration_;
+    uint32_t generation_;
+
+  }; // ResourcePlacement
+
+
+  /**
+   * Return the resource placement of this process
+   */
+  ResourcePlacement& getResourcePlacement();
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_ResourcePlacement_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
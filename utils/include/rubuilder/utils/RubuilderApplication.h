@@ -9,7 +9,10 @@
 
 #include "rubuilder/utils/Exception.h"
 #include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
+#include "rubuilder/utils/LoopbackTransport.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "rubuilder/utils/RubuilderStateMachine.h"
 #include "rubuilder/utils/TimerManager.h"
 #include "toolbox/mem/HeapAllocator.h"
@@ -20,6 +23,8 @@
 #include "toolbox/task/WorkLoop.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/Exception.h"
+#include "i2o/Method.h"
+#include "interface/shared/i2oXFunctionCodes.h"
 #include "xcept/tools.h"
 #include "xdaq/ApplicationDescriptor.h"
 #include "xdaq/ApplicationStub.h"
@@ -28,6 +33,7 @@
 #include "xdaq2rc/SOAPParameterExtractor.hh"
 #include "xdata/ActionListener.h"
 #include "xdata/InfoSpace.h"
+#include "xdata/Boolean.h"
 #include "xdata/InfoSpaceFactory.h"
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger32.h"
@@ -80,6 +86,18 @@ protected:
 
   virtual void bindI2oCallbacks() {};
 
+  /**
+   * Bind the I2O callback for the private function code,
+   * and remember it for the loopback transport
+   */
+  template<class Listener>
+  void bindI2oCallback
+  (
+    Listener*,
+    void (Listener::*callback)(toolbox::mem::Reference*),
+    const uint16_t xFunctionCode
+  );
+
   virtual void bindNonDefaultXgiCallbacks() {};
   virtual void do_defaultWebPage(xgi::Output*) = 0;
 
@@ -115,6 +133,15 @@ protected:
   xdata::String stateName_;
   
   xdata::UnsignedInteger32 monitoringSleepSec_;
+  xdata::UnsignedInteger32 traceSamplingPeriod_;
+  xdata::UnsignedInteger32 traceBufferSize_;
+  xdata::String traceDirectory_;
+  ResourcePlacement::Mapping workLoopCPUs_;
+  ResourcePlacement::Mapping poolNUMAnodes_;
+  xdata::Boolean i2oLoopback_;
+
+  xdata::String workLoopPlacement_;
+  xdata::String poolPlacement_;
   
   
 private:
@@ -134,8 +161,16 @@ private:
   void actionPerformed(xdata::Event&);
   void handleItemChangedEvent(const std::string& item);
   void handleItemRetrieveEvent(const std::string& item);
+  void configureEventTracer();
+  void configureResourcePlacement();
+  void configureLoopbackTransport();
 
   void defaultWebPage(xgi::Input*, xgi::Output*);
+  void traceDump(xgi::Input*, xgi::Output*);
+  void traceDumpToFile(xgi::Input*, xgi::Output*);
+  void loopbackStatistics(xgi::Input*, xgi::Output*);
+
+  LoopbackTransport::Callbacks i2oCallbacks_;
 
 }; // template class RubuilderApplication
 
@@ -215,9 +250,19 @@ void rubuilder::utils::RubuilderApplication<StateMachine>::appendApplicationInfo
 {
   stateName_ = "Halted";
   monitoringSleepSec_ = 1;
+  traceSamplingPeriod_ = 0;
+  traceBufferSize_ = 65536;
+  traceDirectory_ = "/tmp";
+  i2oLoopback_ = false;
 
   params.add("stateName", &stateName_, utils::InfoSpaceItems::retrieve);
   params.add("monitoringSleepSec", &monitoringSleepSec_);
+  params.add("traceSamplingPeriod", &traceSamplingPeriod_, utils::InfoSpaceItems::change);
+  params.add("traceBufferSize", &traceBufferSize_, utils::InfoSpaceItems::change);
+  params.add("traceDirectory", &traceDirectory_, utils::InfoSpaceItems::change);
+  params.add("workLoopCPUs", &workLoopCPUs_, utils::InfoSpaceItems::change);
+  params.add("poolNUMAnodes", &poolNUMAnodes_, utils::InfoSpaceItems::change);
+  params.add("i2oLoopback", &i2oLoopback_, utils::InfoSpaceItems::change);
 
   do_appendApplicationInfoSpaceItems(params);
 }
@@ -261,6 +306,12 @@ void rubuilder::utils::RubuilderApplication<StateMachine>::appendMonitoringInfoS
   InfoSpaceItems& items
 )
 {
+  workLoopPlacement_ = "";
+  poolPlacement_ = "";
+
+  items.add("workLoopPlacement", &workLoopPlacement_);
+  items.add("poolPlacement", &poolPlacement_);
+
   do_appendMonitoringInfoSpaceItems(items);
 }
 
@@ -298,7 +349,60 @@ void rubuilder::utils::RubuilderApplication<StateMachine>::actionPerformed(xdata
 template<class StateMachine>
 void rubuilder::utils::RubuilderApplication<StateMachine>::handleItemChangedEvent(const std::string& item)
 {
-  do_handleItemChangedEvent(item);
+  if (item == "traceSamplingPeriod" ||
+    item == "traceBufferSize" ||
+    item == "traceDirectory")
+  {
+    configureEventTracer();
+  }
+  else if (item == "workLoopCPUs" || item == "poolNUMAnodes")
+  {
+    configureResourcePlacement();
+  }
+  else if (item == "i2oLoopback")
+  {
+    configureLoopbackTransport();
+  }
+  else
+  {
+    do_handleItemChangedEvent(item);
+  }
+}
+
+
+template<class StateMachine>
+void rubuilder::utils::RubuilderApplication<StateMachine>::configureEventTracer()
+{
+  // The tracer is shared by all applications in this executive
+  getEventTracer().configure
+    (
+      traceSamplingPeriod_.value_,
+      traceBufferSize_.value_,
+      traceDirectory_.toString()
+    );
+}
+
+
+template<class StateMachine>
+void rubuilder::utils::RubuilderApplication<StateMachine>::configureResourcePlacement()
+{
+  getResourcePlacement().configure
+    (
+      getIdentifier(getApplicationDescriptor()),
+      workLoopCPUs_,
+      poolNUMAnodes_
+    );
+}
+
+
+template<class StateMachine>
+void rubuilder::utils::RubuilderApplication<StateMachine>::configureLoopbackTransport()
+{
+  // Applications in the same executive exchange their frames in-process
+  if ( i2oLoopback_ )
+    getLoopbackTransport().bind(getApplicationDescriptor(), i2oCallbacks_, logger_);
+  else
+    getLoopbackTransport().unbind(getApplicationDescriptor());
 }
 
 
@@ -357,6 +461,25 @@ xoap::MessageReference rubuilder::utils::RubuilderApplication<StateMachine>::pro
     newState = stateMachine_->processFSMEvent( Fail(sentinelException) );
   }
 
+  // Pick up trace, placement and transport parameters set in the configuration
+  if ( event == "Configure" )
+  {
+    try
+    {
+      configureEventTracer();
+      configureResourcePlacement();
+      // All pool owners announced their pools when they were constructed
+      getResourcePlacement().checkPoolNames(poolNUMAnodes_);
+      configureLoopbackTransport();
+    }
+    catch(xcept::Exception &e)
+    {
+      XCEPT_DECLARE_NESTED(exception::Configuration, sentinelException,
+        "Failed to configure the event tracer, the resource placement or the loopback transport", e);
+      newState = stateMachine_->processFSMEvent( Fail(sentinelException) );
+    }
+  }
+
   stateMachine_->processSoapEvent(event, newState);
 
   return createFsmSoapResponseMsg(event, newState);
@@ -437,8 +560,12 @@ bool rubuilder::utils::RubuilderApplication<StateMachine>::updateMonitoringInfo
   try
   {
     monitoringInfoSpace_->lock();
+
+    getResourcePlacement().pinCurrentThread(wl->getName());
     
     stateMachine_->updateMonitoringItems();
+    workLoopPlacement_ = getResourcePlacement().getWorkLoopPlacement();
+    poolPlacement_ = getResourcePlacement().getPoolPlacement();
     do_updateMonitoringInfo();
     
     monitoringInfoSpace_->unlock();
@@ -496,6 +623,27 @@ void rubuilder::utils::RubuilderApplication<StateMachine>::bindXgiCallbacks()
       "Default"
     );
 
+  xgi::bind
+    (
+      this,
+      &rubuilder::utils::RubuilderApplication<StateMachine>::traceDump,
+      "traceDump"
+    );
+
+  xgi::bind
+    (
+      this,
+      &rubuilder::utils::RubuilderApplication<StateMachine>::traceDumpToFile,
+      "traceDumpToFile"
+    );
+
+  xgi::bind
+    (
+      this,
+      &rubuilder::utils::RubuilderApplication<StateMachine>::loopbackStatistics,
+      "loopbackStatistics"
+    );
+
   bindNonDefaultXgiCallbacks();
 }
 
@@ -536,6 +684,64 @@ void rubuilder::utils::RubuilderApplication<StateMachine>::defaultWebPage
 }
 
 
+template<class StateMachine>
+void rubuilder::utils::RubuilderApplication<StateMachine>::traceDump
+(
+  xgi::Input  *in,
+  xgi::Output *out
+)
+{
+  out->getHTTPResponseHeader().addHeader("Content-Type", "text/plain");
+  getEventTracer().dump(*out);
+}
+
+
+template<class StateMachine>
+void rubuilder::utils::RubuilderApplication<StateMachine>::traceDumpToFile
+(
+  xgi::Input  *in,
+  xgi::Output *out
+)
+{
+  out->getHTTPResponseHeader().addHeader("Content-Type", "text/plain");
+  try
+  {
+    *out << getEventTracer().dumpToFile(
+      generateTraceFilePrefix(xmlClass_, instance_) ) << std::endl;
+  }
+  catch(xcept::Exception &e)
+  {
+    *out << xcept::stdformat_exception_history(e) << std::endl;
+  }
+}
+
+
+template<class StateMachine>
+void rubuilder::utils::RubuilderApplication<StateMachine>::loopbackStatistics
+(
+  xgi::Input  *in,
+  xgi::Output *out
+)
+{
+  out->getHTTPResponseHeader().addHeader("Content-Type", "text/plain");
+  getLoopbackTransport().printStatistics(*out);
+}
+
+
+template<class StateMachine>
+template<class Listener>
+void rubuilder::utils::RubuilderApplication<StateMachine>::bindI2oCallback
+(
+  Listener* listener,
+  void (Listener::*callback)(toolbox::mem::Reference*),
+  const uint16_t xFunctionCode
+)
+{
+  i2o::bind(listener, callback, xFunctionCode, XDAQ_ORGANIZATION_ID);
+  i2oCallbacks_[xFunctionCode] = boost::bind(callback, listener, _1);
+}
+
+
 template<class StateMachine>
 xoap::MessageReference rubuilder::utils::RubuilderApplication<StateMachine>::createFsmSoapResponseMsg
 (
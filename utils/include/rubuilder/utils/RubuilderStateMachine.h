@@ -14,6 +14,8 @@
 #include <boost/thread/shared_mutex.hpp>
 #endif
 
+#include "rubuilder/utils/CreateStrings.h"
+#include "rubuilder/utils/EventTracer.h"
 #include "rubuilder/utils/Exception.h"
 #include "rubuilder/utils/InfoSpaceItems.h"
 #include "xcept/tools.h"
@@ -389,6 +391,24 @@ void rubuilder::utils::RubuilderStateMachine<MostDerived,InitialState>::failEven
 
   app_->notifyQualified("fatal", evt.getException());
 
+  if ( getEventTracer().isEnabled() )
+  {
+    try
+    {
+      const std::string fileName = getEventTracer().dumpToFile(
+        generateTraceFilePrefix(
+          app_->getApplicationDescriptor()->getClassName(),
+          app_->getApplicationDescriptor()->getInstance()) );
+      LOG4CPLUS_INFO(app_->getApplicationLogger(),
+        "Wrote event trace to " << fileName);
+    }
+    catch(xcept::Exception& e)
+    {
+      LOG4CPLUS_ERROR(app_->getApplicationLogger(),
+        "Failed to write event trace: " << xcept::stdformat_exception_history(e));
+    }
+  }
+
   #ifdef RUBUILDER_BOOST
   boost::mutex::scoped_lock stateNameLock(stateNameMutex_);
   #else
@@ -11,6 +11,7 @@
 #include "rubuilder/utils/EvBid.h"
 #include "rubuilder/utils/EvBidFactory.h"
 #include "rubuilder/utils/EventUtils.h"
+#include "rubuilder/utils/MemoryPools.h"
 #include "rubuilder/utils/SuperFragmentTracker.h"
 #include "toolbox/mem/Pool.h"
 #include "toolbox/mem/Reference.h"
@@ -33,7 +34,7 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
 
     SuperFragmentGenerator(const std::string& poolName);
     
-    ~SuperFragmentGenerator() {};
+    ~SuperFragmentGenerator();
 
     /**
      * Configure the super-fragment generator.
@@ -41,6 +42,12 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
      * If usePlayback is set to true, the data is read from the playbackDataFile,
      * otherwise, dummy data is generated according to the dummyFedPayloadSize.
      * The dummyBlockSize specifies the size of the data blocks.
+     * The memory pool is chosen according to the pool configuration
+     * when configuring for the first time.
+     * If nbTemplates is non-zero, the given number of dummy super-fragments
+     * is built once. Each event is then a copy of the next template, where
+     * only the event number in the headers is patched and the FED CRCs are
+     * updated incrementally.
      */
     void configure
     (
@@ -50,7 +57,9 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
       const uint32_t dummyBlockSize,
       const uint32_t dummyFedPayloadSize,
       const uint32_t dummyFedPayloadStdDev,
-      const uint32_t maxFragmentsInMemory = 0
+      const uint32_t maxFragmentsInMemory = 0,
+      const PoolConfiguration& = PoolConfiguration(),
+      const uint32_t nbTemplates = 0
     );
 
     /**
@@ -91,9 +100,41 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
      */
     size_t getMemoryUsage() const;
 
+    /**
+     * Return a description of the memory backing the pool
+     */
+    std::string getPoolBacking() const
+    { return getMemoryPoolBacking(poolName_); }
+
+    /**
+     * Return the number of super-fragment templates
+     */
+    uint32_t getNbTemplates() const
+    { return templates_.size(); }
+
     
   private:
 
+    // Position of a FED within the blocks of a super-fragment
+    struct FedLocation
+    {
+      uint16_t headerBlockNb;
+      uint32_t headerOffset;
+      uint16_t trailerBlockNb;
+      uint32_t trailerOffset;
+
+      // Number of 64-bit words following the FED header
+      uint32_t nbWordsAfterHeader;
+    };
+    typedef std::vector<FedLocation> FedLocations;
+
+    struct SuperFragmentTemplate
+    {
+      toolbox::mem::Reference* bufRef;
+      FedLocations fedLocations;
+    };
+    typedef std::vector<SuperFragmentTemplate> SuperFragmentTemplates;
+
     void cacheData(const std::string& playbackDataFile);
     bool getFragmentFromPlayback(toolbox::mem::Reference*&, const EvBid&);
     bool getSuperFragment
@@ -101,11 +142,30 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
       toolbox::mem::Reference*&,
       const EvBid&
     );
+    bool buildSuperFragment
+    (
+      toolbox::mem::Reference*&,
+      const EvBid&,
+      FedLocations* = 0
+    );
+    bool getSuperFragmentFromTemplate
+    (
+      toolbox::mem::Reference*&,
+      const EvBid&
+    );
+    void buildTemplates(const uint32_t nbTemplates);
+    void releaseTemplates();
+    void updateEventNumber
+    (
+      const FedLocation&,
+      const uint32_t eventNumber
+    ) const;
     void fillBlock
     (
       toolbox::mem::Reference*,
       uint16_t blockNb,
-      const EvBid&
+      const EvBid&,
+      FedLocations*
     );
     void insertFedComponent
     (
@@ -133,13 +193,11 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
       const uint32_t eventNumber,
       const L1Information&
     ) const;
-    void updateCRC
-    (
-      const unsigned char* fedPtr
-    ) const;
     toolbox::mem::Reference* clone(toolbox::mem::Reference*) const;
     
+    const std::string poolBaseName_;
     toolbox::mem::Pool* dummySuperFragmentPool_;
+    std::string poolName_;
     SuperFragmentTracker::FedSourceIds fedSourceIds_;
     EvBidFactory evbIdFactory_;
     uint32_t dummyBlockSize_;
@@ -154,6 +212,10 @@ namespace rubuilder { namespace utils { // namespace rubuilder::utils
     PlaybackData playbackData_;
     PlaybackData::const_iterator playbackDataPos_;
 
+    SuperFragmentTemplates templates_;
+    uint32_t nextTemplate_;
+    std::vector<unsigned char*> templateBlocks_;
+
   };
   
 } } //namespace rubuilder::utils
@@ -2,69 +2,104 @@
 #define _rubuilder_utils_TimerManager_h_
 
 #include <string>
+#include <stdint.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
+#include <vector>
 
 
 namespace rubuilder { namespace utils { // namespace rubuilder::utils
 
-class TimerManager
-{
-private:
-
-    struct TimerTime
-    {
-        unsigned int  hi, lo;
-
-        TimerTime() :
-        hi(0),
-        lo(0)
-        {
-        }
-    };
-
-    struct Timer
-    {
-        bool isFired;
-        TimerTime deltaTime;
-        TimerTime startTime;
-
-        Timer() :
-        isFired(true)
-        {
-        }
-    };
-
-    int            timerListMax;
-    int            nextFreeTimer;
-    struct timeval theTimeOfDay;
-    TimerTime      theTime;
-
-    Timer *timerList;
-
-
-public:
+  /**
+   * \ingroup xdaqApps
+   * \brief Millisecond timers checked from busy loops
+   *
+   * Time is read from CLOCK_MONOTONIC_COARSE, which is served from the
+   * vDSO without a syscall or TSC read. If a timer is shorter than ten
+   * times the resolution of the coarse clock, the manager falls back to
+   * CLOCK_MONOTONIC. Armed timers live in a hierarchical timer wheel
+   * with 1 ms ticks. Advancing the time jumps from one occupied slot or
+   * cascade boundary to the next, independent of the number of timers.
+   * Checking a timer which has not expired compares the clock against
+   * its expiry without touching the wheel, and checking a timer which
+   * has already fired does not read the clock at all.
+   */
+  class TimerManager
+  {
+  public:
 
     TimerManager();
 
-    ~TimerManager();
-
+    /**
+     * Allocate a new timer and return its handle
+     */
     int getTimer();
 
+    /**
+     * Set the duration of the timer.
+     * A timer which has not been restarted since counts as fired.
+     */
     void initTimer(int handle, int dt_msec);
 
+    /**
+     * (Re-)start the timer from now
+     */
     void restartTimer(int handle);
 
+    /**
+     * Return true if the timer duration has elapsed since the last restart
+     */
     bool isFired(int handle);
 
 
-private:
+  private:
+
+    static const uint32_t WHEEL_BITS = 8;
+    static const uint32_t WHEEL_SIZE = 1 << WHEEL_BITS;
+    static const uint32_t WHEEL_MASK = WHEEL_SIZE - 1;
+    static const uint32_t WHEEL_LEVELS = 4;
+
+    struct Timer
+    {
+      uint32_t deltaMSec;
+      uint64_t expiry;
+      bool isArmed;
+      bool isFired;
+      uint32_t level;
+      uint32_t index;
+      int next;
+      int prev;
+
+      Timer() :
+      deltaMSec(0),
+      expiry(0),
+      isArmed(false),
+      isFired(true),
+      level(0),
+      index(0),
+      next(-1),
+      prev(-1)
+      {}
+    };
 
-    void expandTimerList();
+    void checkHandle(const int handle) const;
+    uint64_t nowMSec() const;
+    void advance(const uint64_t nowTick);
+    uint64_t nextEventTick() const;
+    void cascade(const uint32_t level);
+    void schedule(const int handle);
+    void unschedule(const int handle);
+    int& slotFor(Timer&);
 
-    int get_cpu_khz();
+    std::vector<Timer> timers_;
+    int wheel_[WHEEL_LEVELS][WHEEL_SIZE];
+    uint64_t occupiedSlots_[WHEEL_SIZE/64]; // bitmap of the lowest level
+    uint64_t currentTick_;
+    uint32_t armedTimers_;
+    clockid_t clockId_;
 
-}; // class TimerManage
+  }; // class TimerManager
 
 
 /**
@@ -84,3 +119,11 @@ std::string getCurrentTimeUTC();
 } } // namespace rubuilder::utils
 
 #endif
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
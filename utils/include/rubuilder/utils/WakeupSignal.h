@@ -0,0 +1,92 @@
+#ifndef _rubuilder_utils_WakeupSignal_h_
+#define _rubuilder_utils_WakeupSignal_h_
+
+#include <stdint.h>
+
+#include <boost/noncopyable.hpp>
+
+
+namespace rubuilder { namespace utils { // namespace rubuilder::utils
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Lets a consumer sleep until one of its producers signals new data
+   *
+   * The signal is an event count on a futex word. A consumer announces
+   * that it is about to sleep, re-checks its queues and only then blocks
+   * in the kernel. Producers call notify() after publishing an element,
+   * which only costs a load as long as no consumer is waiting.
+   * Several queues may share a signal such that a consumer can wait
+   * for any of them to receive data.
+   */
+  class WakeupSignal : private boost::noncopyable
+  {
+  public:
+
+    WakeupSignal();
+
+    /**
+     * Wake all waiting consumers.
+     * Does not enter the kernel if nobody is waiting.
+     */
+    inline void notify()
+    {
+      // Order the publication of the element by the caller
+      // before the check for waiting consumers
+      __sync_synchronize();
+      if ( waiters_ != 0 ) wakeAll();
+    }
+
+    /**
+     * Block until hasWork returns true, the signal is notified,
+     * or the timeout expires. The predicate is evaluated after the
+     * consumer has been registered as waiter, thus a notification
+     * cannot get lost. Return true if the predicate was true or
+     * a notification was received before the timeout.
+     */
+    template <class Predicate>
+    bool waitUntil(Predicate hasWork, const uint32_t timeoutUSec)
+    {
+      if ( hasWork() ) return true;
+
+      const uint32_t ticket = prepareWait();
+      if ( hasWork() )
+      {
+        cancelWait();
+        return true;
+      }
+      return wait(ticket, timeoutUSec);
+    }
+
+    /**
+     * Return the number of kernel wakeups issued by notify
+     */
+    uint64_t getWakeupCount() const
+    { return wakeupCount_; }
+
+
+  private:
+
+    uint32_t prepareWait();
+    void cancelWait();
+    bool wait(const uint32_t ticket, const uint32_t timeoutUSec);
+    void wakeAll();
+
+    volatile uint32_t sequence_;
+    volatile uint32_t waiters_;
+    volatile uint64_t wakeupCount_;
+
+  }; // WakeupSignal
+
+} } // namespace rubuilder::utils
+
+
+#endif // _rubuilder_utils_WakeupSignal_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
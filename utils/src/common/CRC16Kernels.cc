@@ -0,0 +1,335 @@
+#include "rubuilder/utils/CRC16.h"
+#include "rubuilder/utils/CRC16Kernels.h"
+
+#include <assert.h>
+#include <sstream>
+#include <string.h>
+
+#if defined(__x86_64__)
+#define RUBUILDER_CRC16_PCLMUL
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+
+namespace
+{
+  // evf::compute_crc_64bit runs over the bytes of a word from p[7] down
+  // to p[0], i.e. from the most to the least significant byte of the word
+  // read as little-endian integer.
+  inline uint64_t loadWord(const unsigned char* p)
+  {
+    uint64_t word;
+    memcpy(&word,p,8);
+    #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+    #endif
+    return word;
+  }
+
+  // Return x^n modulo the CRC polynomial x^16 + x^15 + x^2 + 1
+  uint64_t getPowerOfX(const uint32_t n)
+  {
+    uint32_t remainder = 1;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      remainder <<= 1;
+      if ( remainder & 0x10000 ) remainder ^= 0x18005;
+    }
+    return remainder;
+  }
+
+  struct Tables
+  {
+    // slicing[k][b] is the CRC, started from 0,
+    // over the byte b followed by k zero bytes
+    uint16_t slicing[16][256];
+
+    // Constants to fold the upper and lower half of 128 bits
+    // over 512, 128, or 64 bits for the carry-less multiplication
+    uint64_t fold512[2];
+    uint64_t fold128[2];
+    uint64_t fold64[2];
+
+    Tables()
+    {
+      for (uint32_t byte = 0; byte < 256; ++byte)
+      {
+        slicing[0][byte] = evf::crc_table[byte];
+        for (uint32_t k = 1; k < 16; ++k)
+        {
+          const uint16_t crc = slicing[k-1][byte];
+          slicing[k][byte] = evf::crc_table[crc >> 8] ^ static_cast<uint16_t>(crc << 8);
+        }
+      }
+
+      fold512[1] = getPowerOfX(512+64);
+      fold512[0] = getPowerOfX(512);
+      fold128[1] = getPowerOfX(128+64);
+      fold128[0] = getPowerOfX(128);
+      fold64[1] = getPowerOfX(64+64);
+      fold64[0] = getPowerOfX(64);
+    }
+  };
+
+  const Tables& getTables()
+  {
+    static const Tables tables;
+    return tables;
+  }
+
+  inline uint16_t updateSlicingBy8(const Tables& tables, const uint16_t crc, uint64_t word)
+  {
+    const uint16_t (*t)[256] = tables.slicing;
+    word ^= static_cast<uint64_t>(crc) << 48;
+    return
+      t[7][word >> 56] ^ t[6][(word >> 48) & 0xff] ^
+      t[5][(word >> 40) & 0xff] ^ t[4][(word >> 32) & 0xff] ^
+      t[3][(word >> 24) & 0xff] ^ t[2][(word >> 16) & 0xff] ^
+      t[1][(word >> 8) & 0xff] ^ t[0][word & 0xff];
+  }
+
+  uint16_t computeBytewise(uint16_t crc, const unsigned char* buffer, const size_t nbWords)
+  {
+    for (size_t i = 0; i < nbWords; ++i)
+      crc = evf::compute_crc_64bit(crc,&buffer[i*8]);
+    return crc;
+  }
+
+  uint16_t computeSlicingBy8(uint16_t crc, const unsigned char* buffer, const size_t nbWords)
+  {
+    const Tables& tables = getTables();
+    for (size_t i = 0; i < nbWords; ++i)
+      crc = updateSlicingBy8(tables, crc, loadWord(&buffer[i*8]));
+    return crc;
+  }
+
+  uint16_t computeSlicingBy16(uint16_t crc, const unsigned char* buffer, size_t nbWords)
+  {
+    const Tables& tables = getTables();
+    const uint16_t (*t)[256] = tables.slicing;
+
+    for ( ; nbWords >= 2; nbWords -= 2, buffer += 16)
+    {
+      const uint64_t first = loadWord(buffer) ^ (static_cast<uint64_t>(crc) << 48);
+      const uint64_t second = loadWord(buffer + 8);
+      crc =
+        t[15][first >> 56] ^ t[14][(first >> 48) & 0xff] ^
+        t[13][(first >> 40) & 0xff] ^ t[12][(first >> 32) & 0xff] ^
+        t[11][(first >> 24) & 0xff] ^ t[10][(first >> 16) & 0xff] ^
+        t[9][(first >> 8) & 0xff] ^ t[8][first & 0xff] ^
+        t[7][second >> 56] ^ t[6][(second >> 48) & 0xff] ^
+        t[5][(second >> 40) & 0xff] ^ t[4][(second >> 32) & 0xff] ^
+        t[3][(second >> 24) & 0xff] ^ t[2][(second >> 16) & 0xff] ^
+        t[1][(second >> 8) & 0xff] ^ t[0][second & 0xff];
+    }
+    if ( nbWords == 1 )
+      crc = updateSlicingBy8(tables, crc, loadWord(buffer));
+
+    return crc;
+  }
+
+  #ifdef RUBUILDER_CRC16_PCLMUL
+
+  bool hasPclmul()
+  {
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL);
+  }
+
+  // The 128 bits hold two words, where the first word
+  // in memory holds the higher powers of x
+  __attribute__((target("pclmul")))
+  inline __m128i loadBlock(const unsigned char* p)
+  {
+    return _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)p), 0x4e);
+  }
+
+  // Return a value congruent to the 128 bits multiplied by x^n,
+  // given the constants x^(n+64) and x^n modulo the polynomial
+  __attribute__((target("pclmul")))
+  inline __m128i fold(const __m128i bits, const __m128i constants)
+  {
+    return _mm_xor_si128(
+      _mm_clmulepi64_si128(bits, constants, 0x11),
+      _mm_clmulepi64_si128(bits, constants, 0x00));
+  }
+
+  __attribute__((target("pclmul")))
+  inline __m128i getConstants(const uint64_t constants[2])
+  {
+    return _mm_set_epi64x(constants[1], constants[0]);
+  }
+
+  // The buffer is reduced to 128 bits congruent to it modulo the polynomial,
+  // folding 4 blocks of 128 bits in parallel to hide the latency of the
+  // multiplication. The CRC of the remaining 128 bits is then looked up.
+  __attribute__((target("pclmul")))
+  uint16_t computePclmul(const uint16_t crc, const unsigned char* buffer, size_t nbWords)
+  {
+    if ( nbWords < 8 ) return computeSlicingBy16(crc, buffer, nbWords);
+
+    const Tables& tables = getTables();
+
+    // The CRC so far is added to the first 16 bits of the buffer
+    __m128i x0 = _mm_xor_si128(loadBlock(buffer),
+      _mm_set_epi64x(static_cast<uint64_t>(crc) << 48, 0));
+    __m128i x1 = loadBlock(buffer + 16);
+    __m128i x2 = loadBlock(buffer + 32);
+    __m128i x3 = loadBlock(buffer + 48);
+    buffer += 64;
+    nbWords -= 8;
+
+    const __m128i fold512 = getConstants(tables.fold512);
+    for ( ; nbWords >= 8; nbWords -= 8, buffer += 64)
+    {
+      x0 = _mm_xor_si128(fold(x0, fold512), loadBlock(buffer));
+      x1 = _mm_xor_si128(fold(x1, fold512), loadBlock(buffer + 16));
+      x2 = _mm_xor_si128(fold(x2, fold512), loadBlock(buffer + 32));
+      x3 = _mm_xor_si128(fold(x3, fold512), loadBlock(buffer + 48));
+    }
+
+    const __m128i fold128 = getConstants(tables.fold128);
+    x0 = _mm_xor_si128(fold(x0, fold128), x1);
+    x0 = _mm_xor_si128(fold(x0, fold128), x2);
+    x0 = _mm_xor_si128(fold(x0, fold128), x3);
+    for ( ; nbWords >= 2; nbWords -= 2, buffer += 16)
+      x0 = _mm_xor_si128(fold(x0, fold128), loadBlock(buffer));
+
+    if ( nbWords == 1 )
+      x0 = _mm_xor_si128(fold(x0, getConstants(tables.fold64)),
+        _mm_set_epi64x(0, loadWord(buffer)));
+
+    const uint64_t high = _mm_cvtsi128_si64(_mm_unpackhi_epi64(x0, x0));
+    const uint64_t low = _mm_cvtsi128_si64(x0);
+    return updateSlicingBy8(tables, updateSlicingBy8(tables, 0, high), low);
+  }
+
+  #endif // RUBUILDER_CRC16_PCLMUL
+
+  rubuilder::utils::CRC16Kernel getFastestKernel()
+  {
+    #ifdef RUBUILDER_CRC16_PCLMUL
+    if ( hasPclmul() ) return rubuilder::utils::CRC16_PCLMUL;
+    #endif
+    return rubuilder::utils::CRC16_SLICING_BY_16;
+  }
+
+  rubuilder::utils::CRC16Kernel& getSelectedKernel()
+  {
+    static rubuilder::utils::CRC16Kernel kernel = getFastestKernel();
+    return kernel;
+  }
+}
+
+
+uint16_t rubuilder::utils::computeFedCRC(const unsigned char* buffer, const size_t bufSize)
+{
+  return computeFedCRC(getSelectedKernel(), 0xffff, buffer, bufSize);
+}
+
+
+uint16_t rubuilder::utils::computeFedCRC(const uint16_t crc, const unsigned char* buffer, const size_t bufSize)
+{
+  return computeFedCRC(getSelectedKernel(), crc, buffer, bufSize);
+}
+
+
+uint16_t rubuilder::utils::computeFedCRC
+(
+  const CRC16Kernel kernel,
+  const uint16_t crc,
+  const unsigned char* buffer,
+  const size_t bufSize
+)
+{
+  assert( bufSize % 8 == 0 );
+  const size_t nbWords = bufSize / 8;
+
+  switch (kernel)
+  {
+    case CRC16_BYTEWISE:
+      return computeBytewise(crc, buffer, nbWords);
+
+    case CRC16_SLICING_BY_8:
+      return computeSlicingBy8(crc, buffer, nbWords);
+
+    case CRC16_SLICING_BY_16:
+      return computeSlicingBy16(crc, buffer, nbWords);
+
+    case CRC16_PCLMUL:
+      #ifdef RUBUILDER_CRC16_PCLMUL
+      return computePclmul(crc, buffer, nbWords);
+      #else
+      break;
+      #endif
+  }
+
+  assert( ! "Unsupported CRC16 kernel" );
+  return computeBytewise(crc, buffer, nbWords);
+}
+
+
+bool rubuilder::utils::isCRC16KernelSupported(const CRC16Kernel kernel)
+{
+  switch (kernel)
+  {
+    case CRC16_BYTEWISE:
+    case CRC16_SLICING_BY_8:
+    case CRC16_SLICING_BY_16:
+      return true;
+
+    case CRC16_PCLMUL:
+      #ifdef RUBUILDER_CRC16_PCLMUL
+      return hasPclmul();
+      #else
+      return false;
+      #endif
+  }
+  return false;
+}
+
+
+rubuilder::utils::CRC16Kernel rubuilder::utils::getCRC16Kernel()
+{
+  return getSelectedKernel();
+}
+
+
+void rubuilder::utils::setCRC16Kernel(const CRC16Kernel kernel)
+{
+  if ( ! isCRC16KernelSupported(kernel) )
+  {
+    std::ostringstream oss;
+
+    oss << "The CRC16 kernel " << getCRC16KernelName(kernel);
+    oss << " is not supported by this CPU";
+
+    XCEPT_RAISE(exception::Configuration, oss.str());
+  }
+
+  getSelectedKernel() = kernel;
+}
+
+
+const char* rubuilder::utils::getCRC16KernelName(const CRC16Kernel kernel)
+{
+  switch (kernel)
+  {
+    case CRC16_BYTEWISE:      return "bytewise";
+    case CRC16_SLICING_BY_8:  return "slicingBy8";
+    case CRC16_SLICING_BY_16: return "slicingBy16";
+    case CRC16_PCLMUL:        return "pclmul";
+  }
+  return "unknown";
+}
+
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -1,5 +1,6 @@
 #include "rubuilder/utils/CreateStrings.h"
 
+#include <ctype.h>
 #include <iostream>
 #include <sstream>
 
@@ -107,6 +108,25 @@ std::string rubuilder::utils::generateOldMsgSenderWorkLoopName
 }
 
 
+std::string rubuilder::utils::generateTraceFilePrefix
+(
+    const std::string   appClass,
+    const unsigned int  appInstance
+)
+{
+    std::stringstream oss;
+
+    for (std::string::const_iterator it = appClass.begin(), itEnd = appClass.end();
+         it != itEnd; ++it)
+    {
+        oss << ( isalnum(*it) ? *it : '_' );
+    }
+    oss << appInstance;
+
+    return oss.str();
+}
+
+
 std::string rubuilder::utils::generateOldMsgSenderActionName
 (
     const std::string   appClass,
@@ -0,0 +1,186 @@
+#include "rubuilder/utils/EventTracer.h"
+#include "rubuilder/utils/Exception.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+
+namespace
+{
+  bool isEarlier
+  (
+    const rubuilder::utils::EventTracer::Record& a,
+    const rubuilder::utils::EventTracer::Record& b
+  )
+  {
+    return a.timeNSec < b.timeNSec;
+  }
+
+  uint32_t roundUpToPowerOfTwo(const uint32_t value)
+  {
+    uint32_t result = 1;
+    while ( result < value && result < 0x80000000 ) result <<= 1;
+    return result;
+  }
+}
+
+
+rubuilder::utils::EventTracer::EventTracer() :
+threadRing_(&EventTracer::noCleanup),
+enabled_(false),
+samplingMask_(0),
+bufferSize_(65536),
+dumpDirectory_("/tmp")
+{}
+
+
+void rubuilder::utils::EventTracer::configure
+(
+  const uint32_t samplingPeriod,
+  const uint32_t bufferSize,
+  const std::string& dumpDirectory
+)
+{
+  boost::mutex::scoped_lock sl(ringsMutex_);
+
+  bufferSize_ = roundUpToPowerOfTwo( std::max(bufferSize, 2U) );
+  dumpDirectory_ = dumpDirectory;
+
+  if ( samplingPeriod == 0 )
+  {
+    storeRelaxed(enabled_, false);
+  }
+  else
+  {
+    storeRelaxed(samplingMask_, roundUpToPowerOfTwo(samplingPeriod) - 1);
+    storeRelaxed(enabled_, true);
+  }
+}
+
+
+rubuilder::utils::EventTracer::Ring* rubuilder::utils::EventTracer::registerThread()
+{
+  boost::shared_ptr<Ring> ring( new Ring() );
+  ring->writeIndex = 0;
+  ring->threadId = ::syscall(SYS_gettid);
+  {
+    boost::mutex::scoped_lock sl(ringsMutex_);
+    ring->records.resize(bufferSize_);
+    ring->mask = bufferSize_ - 1;
+    rings_.push_back(ring);
+  }
+  threadRing_.reset( ring.get() );
+  return ring.get();
+}
+
+
+void rubuilder::utils::EventTracer::record(const EvBid& evbId, const Stage stage)
+{
+  Ring* ring = threadRing_.get();
+  if ( ring == 0 ) ring = registerThread();
+
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  const uint64_t index = ring->writeIndex;
+  Record& record = ring->records[index & ring->mask];
+  record.timeNSec = static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+  record.resyncCount = evbId.resyncCount();
+  record.eventNumber = evbId.eventNumber();
+  record.stage = stage;
+  record.threadId = ring->threadId;
+
+  storeRelease(ring->writeIndex, index + 1);
+}
+
+
+void rubuilder::utils::EventTracer::dump(std::ostream& out) const
+{
+  std::vector<Record> records;
+  {
+    boost::mutex::scoped_lock sl(ringsMutex_);
+
+    for (Rings::const_iterator it = rings_.begin(), itEnd = rings_.end();
+         it != itEnd; ++it)
+    {
+      const Ring& ring = **it;
+      const uint64_t size = ring.records.size();
+      const uint64_t end = loadAcquire(ring.writeIndex);
+      const uint64_t begin = end > size ? end - size : 0;
+      const size_t first = records.size();
+
+      for (uint64_t index = begin; index < end; ++index)
+        records.push_back( ring.records[index & ring.mask] );
+
+      // The writer does not wait for us. Discard the records which
+      // were overwritten while copying, including the one being
+      // written right now.
+      __sync_synchronize();
+      const uint64_t endAfterCopy = loadAcquire(ring.writeIndex);
+      if ( endAfterCopy + 1 > begin + size )
+      {
+        const uint64_t overwritten =
+          std::min(endAfterCopy + 1 - size - begin, end - begin);
+        records.erase(records.begin() + first, records.begin() + first + overwritten);
+      }
+    }
+  }
+
+  std::stable_sort(records.begin(), records.end(), isEarlier);
+
+  out << "# rubuilder event trace" << std::endl;
+  out << "# timeNSec resyncCount eventNumber stage threadId" << std::endl;
+  for (std::vector<Record>::const_iterator it = records.begin(), itEnd = records.end();
+       it != itEnd; ++it)
+  {
+    out << it->timeNSec << " "
+      << it->resyncCount << " "
+      << it->eventNumber << " "
+      << getStageName(it->stage) << " "
+      << it->threadId << "\n";
+  }
+  out.flush();
+}
+
+
+std::string rubuilder::utils::EventTracer::dumpToFile(const std::string& prefix) const
+{
+  std::ostringstream fileName;
+  {
+    boost::mutex::scoped_lock sl(ringsMutex_);
+    fileName << dumpDirectory_;
+  }
+  fileName << "/" << prefix << "_" << ::getpid()
+    << "_" << ::time(0) << ".trace";
+
+  std::ofstream file(fileName.str().c_str());
+  if ( ! file.is_open() )
+  {
+    XCEPT_RAISE(exception::Monitoring,
+      "Failed to open trace file " + fileName.str());
+  }
+
+  dump(file);
+  file.close();
+
+  return fileName.str();
+}
+
+
+rubuilder::utils::EventTracer& rubuilder::utils::getEventTracer()
+{
+  static EventTracer eventTracer;
+  return eventTracer;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,130 @@
+#include "interface/shared/fed_trailer.h"
+#include "rubuilder/utils/CRC16.h"
+#include "rubuilder/utils/FedCRCUpdater.h"
+
+#include <assert.h>
+
+
+namespace
+{
+  // The FED size is given in 64-bit words by a 24-bit field of the trailer
+  const size_t nbShiftTables = 24;
+
+  // shiftTables[k][0][b] and shiftTables[k][1][b] hold the CRC obtained by
+  // continuing the CRC b, respectively b << 8, over 2^k words of zeros
+  struct ShiftTables
+  {
+    uint16_t tables[nbShiftTables][2][256];
+
+    ShiftTables()
+    {
+      const unsigned char zeros[8] = {0,0,0,0,0,0,0,0};
+
+      // Image of each CRC bit over 2^k zero words
+      uint16_t bitImages[16];
+      for (uint16_t bit = 0; bit < 16; ++bit)
+        bitImages[bit] = evf::compute_crc_64bit(1 << bit,zeros);
+
+      for (size_t k = 0; k < nbShiftTables; ++k)
+      {
+        for (uint16_t byte = 0; byte < 256; ++byte)
+        {
+          uint16_t low = 0;
+          uint16_t high = 0;
+          for (uint16_t bit = 0; bit < 8; ++bit)
+          {
+            if ( byte & (1 << bit) )
+            {
+              low ^= bitImages[bit];
+              high ^= bitImages[bit+8];
+            }
+          }
+          tables[k][0][byte] = low;
+          tables[k][1][byte] = high;
+        }
+
+        // 2^(k+1) zero words are twice 2^k zero words
+        for (uint16_t bit = 0; bit < 16; ++bit)
+        {
+          const uint16_t image = bitImages[bit];
+          bitImages[bit] = tables[k][0][image & 0xff] ^ tables[k][1][image >> 8];
+        }
+      }
+    }
+  };
+
+  const ShiftTables shiftTables;
+}
+
+
+uint16_t rubuilder::utils::FedCRCUpdater::propagate(uint16_t crc, size_t nbZeroWords)
+{
+  assert( nbZeroWords < (static_cast<size_t>(1) << nbShiftTables) );
+
+  for (size_t k = 0; nbZeroWords != 0; ++k, nbZeroWords >>= 1)
+  {
+    if ( nbZeroWords & 1 )
+      crc = shiftTables.tables[k][0][crc & 0xff] ^ shiftTables.tables[k][1][crc >> 8];
+  }
+
+  return crc;
+}
+
+
+uint16_t rubuilder::utils::FedCRCUpdater::update
+(
+  const uint16_t crc,
+  const unsigned char* oldWord,
+  const unsigned char* newWord,
+  const size_t nbFollowingWords
+)
+{
+  unsigned char changedBits[8];
+  for (size_t i = 0; i < 8; ++i)
+    changedBits[i] = oldWord[i] ^ newWord[i];
+
+  return crc ^ propagate(evf::compute_crc_64bit(0,changedBits), nbFollowingWords);
+}
+
+
+rubuilder::utils::FedCRCUpdater::FedCRCUpdater
+(
+  unsigned char* fedPtr,
+  const size_t fedSize
+) :
+fedPtr_(fedPtr),
+nbWords_(fedSize / 8)
+{
+  assert( fedSize % 8 == 0 );
+
+  const fedt_t* fedTrailer = (fedt_t*)(fedPtr_ + fedSize - sizeof(fedt_t));
+  crc_ = (fedTrailer->conscheck & FED_CRCS_MASK) >> FED_CRCS_SHIFT;
+}
+
+
+void rubuilder::utils::FedCRCUpdater::changeWord
+(
+  const size_t wordNb,
+  const unsigned char* oldWord
+)
+{
+  assert( wordNb < nbWords_ );
+
+  crc_ = update(crc_, oldWord, fedPtr_ + wordNb*8, nbWords_ - wordNb - 1);
+}
+
+
+void rubuilder::utils::FedCRCUpdater::updateTrailer() const
+{
+  fedt_t* fedTrailer = (fedt_t*)(fedPtr_ + nbWords_*8 - sizeof(fedt_t));
+  fedTrailer->conscheck = (crc_ << FED_CRCS_SHIFT);
+}
+
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
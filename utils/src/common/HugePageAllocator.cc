@@ -0,0 +1,285 @@
+#include "rubuilder/utils/HugePageAllocator.h"
+#include "rubuilder/utils/LatencyHistogram.h"
+#include "xcept/Exception.h"
+
+#include <errno.h>
+#include <linux/mempolicy.h>
+#include <sstream>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+
+
+namespace
+{
+  // Smallest buffer handed out is 2^minSizeClassShift bytes
+  const uint32_t minSizeClassShift = 6;
+  const uint32_t sizeClassCount = 48;
+}
+
+
+rubuilder::utils::HugePageAllocator::HugePageAllocator
+(
+  const size_t committedSize,
+  const size_t hugePageSize,
+  const int32_t numaNode
+) :
+committedSize_(committedSize),
+numaNode_(numaNode),
+region_(0),
+regionSize_(0),
+nextFree_(0),
+used_(0),
+prefaultTimeMSec_(0),
+freeLists_(sizeClassCount)
+{
+  mapRegion(hugePageSize);
+  bindRegion();
+  prefault();
+}
+
+
+rubuilder::utils::HugePageAllocator::~HugePageAllocator()
+{
+  if ( region_ ) ::munmap(region_, regionSize_);
+}
+
+
+void rubuilder::utils::HugePageAllocator::mapRegion(const size_t hugePageSize)
+{
+  std::ostringstream backing;
+
+  if ( hugePageSize > 0 && (hugePageSize & (hugePageSize - 1)) == 0 )
+  {
+    regionSize_ = (committedSize_ + hugePageSize - 1) & ~(hugePageSize - 1);
+
+    const int pageSizeShift = __builtin_ctzl(hugePageSize);
+    void* region = ::mmap(0, regionSize_, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (pageSizeShift << MAP_HUGE_SHIFT), -1, 0);
+
+    if ( region != MAP_FAILED )
+    {
+      region_ = static_cast<char*>(region);
+      backing << "hugetlb " << (hugePageSize >> 10) << " kB pages";
+      backing_ = backing.str();
+      return;
+    }
+    backing << "no hugetlb " << (hugePageSize >> 10) << " kB pages (" << strerror(errno) << "), ";
+  }
+
+  // Fall back to transparent huge pages
+  const size_t alignment = 2*1024*1024;
+  regionSize_ = (committedSize_ + alignment - 1) & ~(alignment - 1);
+
+  void* region = ::mmap(0, regionSize_, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if ( region == MAP_FAILED )
+  {
+    std::ostringstream oss;
+    oss << "Failed to map " << regionSize_ << " bytes for memory pool: " << strerror(errno);
+    XCEPT_RAISE(toolbox::mem::exception::FailedAllocation, oss.str());
+  }
+  region_ = static_cast<char*>(region);
+
+  if ( ::madvise(region_, regionSize_, MADV_HUGEPAGE) == 0 )
+    backing << "transparent huge pages";
+  else
+    backing << "small pages";
+  backing_ = backing.str();
+}
+
+
+void rubuilder::utils::HugePageAllocator::bindRegion()
+{
+  if ( numaNode_ < 0 ) return;
+
+  // Bind the whole mapping before any page is touched. A hugetlb
+  // mapping cannot be bound in parts smaller than its pages.
+  const unsigned long nodeMask = 1UL << numaNode_;
+  if ( ::syscall(SYS_mbind, region_, regionSize_, MPOL_BIND,
+      &nodeMask, sizeof(nodeMask)*8, 0) != 0 )
+  {
+    std::ostringstream oss;
+    oss << "Failed to bind " << regionSize_ << " bytes of " << backing_
+      << " to NUMA node " << numaNode_ << ": " << strerror(errno);
+    ::munmap(region_, regionSize_);
+    region_ = 0;
+    XCEPT_RAISE(toolbox::mem::exception::FailedAllocation, oss.str());
+  }
+
+  std::ostringstream backing;
+  backing << backing_ << " on NUMA node " << numaNode_;
+  backing_ = backing.str();
+}
+
+
+void rubuilder::utils::HugePageAllocator::prefault()
+{
+  const uint64_t startUSec = getMonotonicTimeUSec();
+
+  // Touch every small page, as transparent huge pages might not be used
+  const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+  for (size_t offset = 0; offset < regionSize_; offset += pageSize)
+  {
+    *static_cast<volatile char*>(region_ + offset) = 0;
+  }
+
+  prefaultTimeMSec_ = (getMonotonicTimeUSec() - startUSec) / 1000;
+}
+
+
+uint32_t rubuilder::utils::HugePageAllocator::getSizeClass(const size_t size)
+{
+  uint32_t sizeClass = 0;
+  while ( (static_cast<size_t>(1) << (sizeClass + minSizeClassShift)) < size ) ++sizeClass;
+  return sizeClass;
+}
+
+
+size_t rubuilder::utils::HugePageAllocator::getClassSize(const uint32_t sizeClass)
+{
+  return static_cast<size_t>(1) << (sizeClass + minSizeClassShift);
+}
+
+
+char* rubuilder::utils::HugePageAllocator::splitLargerBuffer(const uint32_t sizeClass)
+{
+  uint32_t largerClass = sizeClass + 1;
+  while ( largerClass < sizeClassCount && freeLists_[largerClass].empty() ) ++largerClass;
+  if ( largerClass == sizeClassCount ) return 0;
+
+  char* address = freeLists_[largerClass].back();
+  freeLists_[largerClass].pop_back();
+
+  // Keep the first part and put the upper halves onto the smaller free lists
+  while ( largerClass > sizeClass )
+  {
+    --largerClass;
+    freeLists_[largerClass].push_back(address + getClassSize(largerClass));
+  }
+
+  return address;
+}
+
+
+toolbox::mem::Buffer* rubuilder::utils::HugePageAllocator::alloc
+(
+  size_t size,
+  toolbox::mem::Pool* pool
+)
+throw (toolbox::mem::exception::FailedAllocation)
+{
+  const uint32_t sizeClass = getSizeClass(size);
+  if ( sizeClass >= sizeClassCount )
+  {
+    std::ostringstream oss;
+    oss << "Cannot allocate a buffer of " << size << " bytes";
+    XCEPT_RAISE(toolbox::mem::exception::FailedAllocation, oss.str());
+  }
+  const size_t classSize = getClassSize(sizeClass);
+
+  char* address = 0;
+  {
+    boost::mutex::scoped_lock sl(mutex_);
+
+    FreeList& freeList = freeLists_[sizeClass];
+    if ( ! freeList.empty() )
+    {
+      address = freeList.back();
+      freeList.pop_back();
+    }
+    else if ( nextFree_ + classSize <= regionSize_ )
+    {
+      address = region_ + nextFree_;
+      nextFree_ += classSize;
+    }
+    else
+    {
+      address = splitLargerBuffer(sizeClass);
+      if ( address == 0 )
+      {
+        std::ostringstream oss;
+        oss << "The committed size of " << committedSize_
+          << " bytes is exhausted while allocating " << size << " bytes";
+        XCEPT_RAISE(toolbox::mem::exception::FailedAllocation, oss.str());
+      }
+    }
+    used_ += classSize;
+  }
+
+  return new toolbox::mem::Buffer(pool, classSize, address);
+}
+
+
+void rubuilder::utils::HugePageAllocator::free(toolbox::mem::Buffer* buffer)
+throw (toolbox::mem::exception::FailedDispose)
+{
+  char* address = static_cast<char*>(buffer->getAddress());
+  const size_t classSize = buffer->getSize();
+
+  if ( address < region_ || address + classSize > region_ + regionSize_ )
+  {
+    XCEPT_RAISE(toolbox::mem::exception::FailedDispose,
+      "Buffer was not allocated by this allocator");
+  }
+
+  {
+    boost::mutex::scoped_lock sl(mutex_);
+    freeLists_[ getSizeClass(classSize) ].push_back(address);
+    used_ -= classSize;
+  }
+
+  delete buffer;
+}
+
+
+std::string rubuilder::utils::HugePageAllocator::type()
+{
+  return "hugepage";
+}
+
+
+bool rubuilder::utils::HugePageAllocator::isCommittedSizeSupported()
+{
+  return true;
+}
+
+
+size_t rubuilder::utils::HugePageAllocator::getCommittedSize()
+{
+  return committedSize_;
+}
+
+
+size_t rubuilder::utils::HugePageAllocator::getUsed()
+{
+  boost::mutex::scoped_lock sl(mutex_);
+  return used_;
+}
+
+
+std::string rubuilder::utils::HugePageAllocator::getBacking() const
+{
+  return backing_;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -101,6 +101,67 @@ std::ostream& operator<<
   s << "nbElements=";
   s << msg->nbElements << "\n";
   
+  s << "version=";
+  s << msg->version << "\n";
+  
+  for (unsigned int i=0; i<msg->nbElements; ++i)
+  {
+    s << "elements[" << i << "]: " << msg->elements[i] << "\n";
+  }
+  
+  return s;
+}
+
+
+std::ostream& operator<<
+(
+  std::ostream& s,
+  const rubuilder::msg::EvBidRange& range
+)
+{
+  s << range.first << " ";
+  s << "count=" << range.count;
+
+  return s;
+}
+
+
+std::ostream& operator<<
+(
+  std::ostream& s,
+  const rubuilder::msg::EvBidRangesMsg* msg
+)
+{
+  s << "EvBidRangesMsg\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.VersionOffset=";
+  s << msg->PvtMessageFrame.StdMessageFrame.VersionOffset << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.MsgFlags=";
+  s << msg->PvtMessageFrame.StdMessageFrame.MsgFlags << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.MessageSize=";
+  s << msg->PvtMessageFrame.StdMessageFrame.MessageSize << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.TargetAddress=";
+  s << msg->PvtMessageFrame.StdMessageFrame.TargetAddress << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.InitiatorAddress=";
+  s << msg->PvtMessageFrame.StdMessageFrame.InitiatorAddress << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.Function=";
+  s << msg->PvtMessageFrame.StdMessageFrame.Function << "\n";
+  
+  s << "PvtMessageFrame.XFunctionCode=";
+  s << msg->PvtMessageFrame.XFunctionCode << "\n";
+  
+  s << "PvtMessageFrame.OrganizationID=";
+  s << msg->PvtMessageFrame.OrganizationID << "\n";
+  
+  s << "nbElements=" << msg->nbElements << "\n";
+  s << "version="    << msg->version    << "\n";
+  s << "nbEvBids="   << msg->nbEvBids   << "\n";
+  
   for (unsigned int i=0; i<msg->nbElements; ++i)
   {
     s << "elements[" << i << "]: " << msg->elements[i] << "\n";
@@ -168,6 +229,66 @@ std::ostream& operator<<
 }
 
 
+std::ostream& operator<<
+(
+  std::ostream& s,
+  const rubuilder::msg::RqstForFragRange &range
+)
+{
+  s << range.first << " ";
+  s << "firstBuResourceId=" << range.firstBuResourceId << " ";
+  s << "count=" << range.count;
+
+  return s;
+}
+
+
+std::ostream& operator<<
+(
+  std::ostream& s,
+  const rubuilder::msg::RqstForFragRangesMsg *msg
+)
+{
+  s << "RqstForFragRangesMsg\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.VersionOffset=";
+  s << msg->PvtMessageFrame.StdMessageFrame.VersionOffset << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.MsgFlags=";
+  s << msg->PvtMessageFrame.StdMessageFrame.MsgFlags << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.MessageSize=";
+  s << msg->PvtMessageFrame.StdMessageFrame.MessageSize << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.TargetAddress=";
+  s << msg->PvtMessageFrame.StdMessageFrame.TargetAddress << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.InitiatorAddress=";
+  s << msg->PvtMessageFrame.StdMessageFrame.InitiatorAddress << "\n";
+  
+  s << "PvtMessageFrame.StdMessageFrame.Function=";
+  s << msg->PvtMessageFrame.StdMessageFrame.Function << "\n";
+  
+  s << "PvtMessageFrame.XFunctionCode=";
+  s << msg->PvtMessageFrame.XFunctionCode << "\n";
+  
+  s << "PvtMessageFrame.OrganizationID=";
+  s << msg->PvtMessageFrame.OrganizationID << "\n";
+  
+  s << "srcIndex="   << msg->srcIndex   << "\n";
+  s << "nbElements=" << msg->nbElements << "\n";
+  s << "version="    << msg->version    << "\n";
+  s << "nbRequests=" << msg->nbRequests << "\n";
+  
+  for (unsigned int i=0; i<msg->nbElements; ++i)
+  {
+    s << "elements[" << i << "]: " << msg->elements[i] << "\n";
+  }
+  
+  return s;
+}
+
+
 /// emacs configuration
 /// Local Variables: -
 /// mode: c++ -
@@ -0,0 +1,179 @@
+#include "rubuilder/utils/LatencyHistogram.h"
+
+
+rubuilder::utils::LatencyHistogram::LatencyHistogram() :
+counts_(BUCKET_COUNT, 0)
+{}
+
+
+void rubuilder::utils::LatencyHistogram::add(const LatencyHistogram& other)
+{
+  for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    counts_[i] += loadRelaxed(other.counts_[i]);
+}
+
+
+void rubuilder::utils::LatencyHistogram::subtract(const LatencyHistogram& other)
+{
+  for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    counts_[i] -= loadRelaxed(other.counts_[i]);
+}
+
+
+void rubuilder::utils::LatencyHistogram::reset()
+{
+  counts_.assign(BUCKET_COUNT, 0);
+}
+
+
+uint64_t rubuilder::utils::LatencyHistogram::getCount() const
+{
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+    count += counts_[i];
+  return count;
+}
+
+
+uint64_t rubuilder::utils::LatencyHistogram::getValueAtPercentile(const double percentile) const
+{
+  const uint64_t count = getCount();
+  if ( count == 0 ) return 0;
+
+  uint64_t threshold = static_cast<uint64_t>(percentile / 100 * count + 0.5);
+  if ( threshold == 0 ) threshold = 1;
+
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+  {
+    seen += counts_[i];
+    if ( seen >= threshold ) return highestEquivalentValue(i);
+  }
+  return getMax();
+}
+
+
+uint64_t rubuilder::utils::LatencyHistogram::getMax() const
+{
+  for (uint32_t i = BUCKET_COUNT; i > 0; --i)
+  {
+    if ( counts_[i-1] > 0 ) return highestEquivalentValue(i-1);
+  }
+  return 0;
+}
+
+
+uint64_t rubuilder::utils::LatencyHistogram::highestEquivalentValue(const uint32_t index)
+{
+  if ( index < 2*SUB_BUCKET_COUNT ) return index;
+
+  const uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+  const uint64_t top = index - shift * SUB_BUCKET_COUNT;
+  return ( (top + 1) << shift ) - 1;
+}
+
+
+rubuilder::utils::LatencyRecorder::LatencyRecorder(const std::string& name) :
+name_(name),
+threadHistogram_(&LatencyRecorder::noCleanup),
+count_(0),
+p50_(0),
+p99_(0),
+p999_(0),
+max_(0)
+{}
+
+
+rubuilder::utils::LatencyHistogram* rubuilder::utils::LatencyRecorder::registerThread()
+{
+  boost::shared_ptr<LatencyHistogram> histogram( new LatencyHistogram() );
+  {
+    boost::mutex::scoped_lock sl(mutex_);
+    threadHistograms_.push_back(histogram);
+  }
+  threadHistogram_.reset( histogram.get() );
+  return histogram.get();
+}
+
+
+void rubuilder::utils::LatencyRecorder::mergeThreadHistograms(LatencyHistogram& total)
+{
+  // mutex_ is taken by the calling method
+  for (ThreadHistograms::const_iterator it = threadHistograms_.begin(),
+         itEnd = threadHistograms_.end(); it != itEnd; ++it)
+  {
+    total.add(**it);
+  }
+}
+
+
+void rubuilder::utils::LatencyRecorder::appendMonitoringItems(InfoSpaceItems& items)
+{
+  count_ = 0;
+  p50_ = 0;
+  p99_ = 0;
+  p999_ = 0;
+  max_ = 0;
+
+  items.add(name_ + "Count", &count_);
+  items.add(name_ + "P50USec", &p50_);
+  items.add(name_ + "P99USec", &p99_);
+  items.add(name_ + "P999USec", &p999_);
+  items.add(name_ + "MaxUSec", &max_);
+}
+
+
+void rubuilder::utils::LatencyRecorder::updateMonitoringItems()
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  LatencyHistogram total;
+  mergeThreadHistograms(total);
+
+  LatencyHistogram interval = total;
+  interval.subtract(lastTotal_);
+  lastTotal_ = total;
+
+  count_.value_ = interval.getCount();
+  p50_.value_ = interval.getValueAtPercentile(50);
+  p99_.value_ = interval.getValueAtPercentile(99);
+  p999_.value_ = interval.getValueAtPercentile(99.9);
+  max_.value_ = interval.getMax();
+}
+
+
+void rubuilder::utils::LatencyRecorder::resetMonitoringCounters()
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  // The per-thread histograms are owned by their writers,
+  // thus move the baseline instead of clearing them
+  lastTotal_.reset();
+  mergeThreadHistograms(lastTotal_);
+
+  count_ = 0;
+  p50_ = 0;
+  p99_ = 0;
+  p999_ = 0;
+  max_ = 0;
+}
+
+
+void rubuilder::utils::LatencyRecorder::printHtml(xgi::Output *out)
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  *out << "<tr>"                                                  << std::endl;
+  *out << "<td>" << name_ << " p50/p99/p99.9/max (us)</td>"       << std::endl;
+  *out << "<td>" << p50_.value_ << " / " << p99_.value_ << " / "
+    << p999_.value_ << " / " << max_.value_ << "</td>"            << std::endl;
+  *out << "</tr>"                                                 << std::endl;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
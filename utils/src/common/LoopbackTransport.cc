@@ -0,0 +1,399 @@
+#include "i2o/i2o.h"
+#include "rubuilder/utils/LoopbackTransport.h"
+#include "xcept/tools.h"
+
+#include <iomanip>
+#include <sstream>
+#include <time.h>
+
+
+namespace
+{
+  uint64_t getTimeNSec(const clockid_t clockId)
+  {
+    struct timespec now;
+    clock_gettime(clockId, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+  }
+}
+
+
+rubuilder::utils::LoopbackTransport::LoopbackTransport() :
+boundCount_(0)
+{
+  componentMaps_.push_back( ComponentsPtr(new Components()) );
+  components_ = componentMaps_.back().get();
+}
+
+
+rubuilder::utils::LoopbackTransport::~LoopbackTransport()
+{
+  boost::mutex::scoped_lock sl(bindMutex_);
+
+  const Components* components = loadAcquire(components_);
+  for (Components::const_iterator it = components->begin(), itEnd = components->end();
+       it != itEnd; ++it)
+  {
+    stopDispatcher(it->second.get());
+  }
+}
+
+
+void rubuilder::utils::LoopbackTransport::bind
+(
+  xdaq::ApplicationDescriptor* descriptor,
+  const Callbacks& callbacks,
+  log4cplus::Logger& logger
+)
+{
+  boost::mutex::scoped_lock sl(bindMutex_);
+
+  Component* component = getComponent(descriptor);
+  stopDispatcher(component);
+
+  {
+    boost::mutex::scoped_lock componentLock(component->mutex);
+    component->callbacks = callbacks;
+    component->logger = logger;
+    component->sent = Statistics();
+    component->received = Statistics();
+    component->callbackCPUTimeNSec = 0;
+    component->unhandledFrames = 0;
+    component->dispatching = true;
+  }
+
+  component->dispatcher.reset( new boost::thread(
+      boost::bind(&LoopbackTransport::dispatch, this, component) ) );
+  storeRelaxed(boundCount_, boundCount_ + 1);
+}
+
+
+void rubuilder::utils::LoopbackTransport::unbind(xdaq::ApplicationDescriptor* descriptor)
+{
+  boost::mutex::scoped_lock sl(bindMutex_);
+
+  Component* component = findComponent(descriptor);
+  if ( component ) stopDispatcher(component);
+}
+
+
+bool rubuilder::utils::LoopbackTransport::isBound(xdaq::ApplicationDescriptor* descriptor) const
+{
+  const Component* component = findComponent(descriptor);
+  if ( ! component ) return false;
+
+  boost::mutex::scoped_lock sl(component->mutex);
+  return component->dispatching;
+}
+
+
+void rubuilder::utils::LoopbackTransport::stopDispatcher(Component* component)
+{
+  if ( ! component->dispatcher ) return;
+
+  std::deque<toolbox::mem::Reference*> frames;
+  {
+    boost::mutex::scoped_lock sl(component->mutex);
+    component->dispatching = false;
+    frames.swap(component->frames);
+  }
+  component->frameAvailable.notify_all();
+
+  component->dispatcher->join();
+  component->dispatcher.reset();
+  storeRelaxed(boundCount_, boundCount_ - 1);
+
+  releaseFrames(frames);
+}
+
+
+bool rubuilder::utils::LoopbackTransport::queueFrame
+(
+  toolbox::mem::Reference* bufRef,
+  xdaq::ApplicationDescriptor* source,
+  xdaq::ApplicationDescriptor* destination
+)
+{
+  Component* destinationComponent = findComponent(destination);
+  if ( ! destinationComponent ) return false;
+
+  Component* sourceComponent = getComponent(source);
+
+  // The frame belongs to the destination once it is queued
+  uint32_t frameCount;
+  uint64_t byteCount;
+  getFrameCountAndSize(bufRef, frameCount, byteCount);
+
+  {
+    boost::mutex::scoped_lock sl(destinationComponent->mutex);
+    if ( ! destinationComponent->dispatching ) return false;
+    destinationComponent->frames.push_back(bufRef);
+  }
+  destinationComponent->frameAvailable.notify_one();
+
+  boost::mutex::scoped_lock sl(sourceComponent->mutex);
+  sourceComponent->sent.add(frameCount, byteCount, getTimeNSec(CLOCK_MONOTONIC));
+
+  return true;
+}
+
+
+rubuilder::utils::LoopbackTransport::Component*
+rubuilder::utils::LoopbackTransport::findComponent(xdaq::ApplicationDescriptor* descriptor) const
+{
+  const Components* components = loadAcquire(components_);
+
+  const Components::const_iterator pos = components->find(descriptor);
+  if ( pos == components->end() ) return 0;
+
+  return pos->second.get();
+}
+
+
+rubuilder::utils::LoopbackTransport::Component*
+rubuilder::utils::LoopbackTransport::getComponent(xdaq::ApplicationDescriptor* descriptor)
+{
+  Component* component = findComponent(descriptor);
+  if ( component ) return component;
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  // Another thread might have added it in the meantime
+  component = findComponent(descriptor);
+  if ( component ) return component;
+
+  std::ostringstream name;
+  name << descriptor->getClassName() << ":" << descriptor->getInstance();
+  const ComponentPtr newComponent( new Component(name.str()) );
+
+  boost::shared_ptr<Components> components( new Components(*components_) );
+  components->insert( Components::value_type(descriptor, newComponent) );
+  componentMaps_.push_back(components);
+  storeRelease(components_, componentMaps_.back().get());
+
+  return newComponent.get();
+}
+
+
+void rubuilder::utils::LoopbackTransport::dispatch(Component* component)
+{
+  std::deque<toolbox::mem::Reference*> frames;
+
+  while (true)
+  {
+    {
+      boost::mutex::scoped_lock sl(component->mutex);
+      while ( component->dispatching && component->frames.empty() )
+        component->frameAvailable.wait(sl);
+      if ( ! component->dispatching ) return;
+      frames.swap(component->frames);
+    }
+
+    const uint64_t startNSec = getTimeNSec(CLOCK_MONOTONIC);
+    const uint64_t startCPUTimeNSec = getTimeNSec(CLOCK_THREAD_CPUTIME_ID);
+    uint32_t frameCount = 0;
+    uint64_t byteCount = 0;
+    uint64_t unhandledFrames = 0;
+
+    while ( ! frames.empty() )
+    {
+      toolbox::mem::Reference* bufRef = frames.front();
+      frames.pop_front();
+
+      uint32_t chainFrameCount;
+      uint64_t chainByteCount;
+      getFrameCountAndSize(bufRef, chainFrameCount, chainByteCount);
+      frameCount += chainFrameCount;
+      byteCount += chainByteCount;
+
+      if ( ! deliver(component, bufRef) ) ++unhandledFrames;
+    }
+
+    const uint64_t cpuTimeNSec = getTimeNSec(CLOCK_THREAD_CPUTIME_ID) - startCPUTimeNSec;
+
+    boost::mutex::scoped_lock sl(component->mutex);
+    component->received.add(frameCount, byteCount, startNSec);
+    component->callbackCPUTimeNSec += cpuTimeNSec;
+    component->unhandledFrames += unhandledFrames;
+  }
+}
+
+
+bool rubuilder::utils::LoopbackTransport::deliver
+(
+  Component* component,
+  toolbox::mem::Reference* bufRef
+)
+{
+  const I2O_PRIVATE_MESSAGE_FRAME* pvtMsg =
+    (I2O_PRIVATE_MESSAGE_FRAME*)bufRef->getDataLocation();
+
+  const Callbacks::const_iterator pos = component->callbacks.find(pvtMsg->XFunctionCode);
+  if ( pos == component->callbacks.end() )
+  {
+    bufRef->release();
+    return false;
+  }
+
+  // As for frames from the network, the callback owns the frame
+  try
+  {
+    pos->second(bufRef);
+  }
+  catch(xcept::Exception& e)
+  {
+    LOG4CPLUS_ERROR(component->logger,
+      "Failed to process I2O frame from loopback transport: "
+      << xcept::stdformat_exception_history(e));
+  }
+  catch(std::exception& e)
+  {
+    LOG4CPLUS_ERROR(component->logger,
+      "Failed to process I2O frame from loopback transport: " << e.what());
+  }
+  catch(...)
+  {
+    LOG4CPLUS_ERROR(component->logger,
+      "Failed to process I2O frame from loopback transport: Unknown exception");
+  }
+
+  return true;
+}
+
+
+void rubuilder::utils::LoopbackTransport::getFrameCountAndSize
+(
+  toolbox::mem::Reference* bufRef,
+  uint32_t& frameCount,
+  uint64_t& byteCount
+)
+{
+  frameCount = 0;
+  byteCount = 0;
+
+  // Chained references do not necessarily start with an I2O header,
+  // e.g. the shared elements of a broadcast message
+  while (bufRef)
+  {
+    ++frameCount;
+    byteCount += bufRef->getDataSize();
+    bufRef = bufRef->getNextReference();
+  }
+}
+
+
+void rubuilder::utils::LoopbackTransport::releaseFrames
+(
+  std::deque<toolbox::mem::Reference*>& frames
+)
+{
+  for (std::deque<toolbox::mem::Reference*>::const_iterator it = frames.begin(), itEnd = frames.end();
+       it != itEnd; ++it)
+  {
+    (*it)->release();
+  }
+  frames.clear();
+}
+
+
+void rubuilder::utils::LoopbackTransport::printStatistics(std::ostream& out) const
+{
+  out << "# component"
+    << " framesSent bytesSent sentFrames/s sentMB/s"
+    << " framesReceived bytesReceived receivedFrames/s receivedMB/s"
+    << " callbackCPU-ns/frame unhandledFrames queuedFrames" << std::endl;
+
+  const Components* components = loadAcquire(components_);
+
+  for (Components::const_iterator it = components->begin(), itEnd = components->end();
+       it != itEnd; ++it)
+  {
+    const Component* component = it->second.get();
+    boost::mutex::scoped_lock componentLock(component->mutex);
+
+    const Statistics& sent = component->sent;
+    const Statistics& received = component->received;
+    const double cpuTimePerFrame = received.frames > 0 ?
+      static_cast<double>(component->callbackCPUTimeNSec) / received.frames : 0;
+
+    out << component->name
+      << std::fixed << std::setprecision(1)
+      << " " << sent.frames
+      << " " << sent.bytes
+      << " " << sent.getFrameRate()
+      << " " << sent.getBandwidth() / 1e6
+      << " " << received.frames
+      << " " << received.bytes
+      << " " << received.getFrameRate()
+      << " " << received.getBandwidth() / 1e6
+      << " " << cpuTimePerFrame
+      << " " << component->unhandledFrames
+      << " " << component->frames.size()
+      << std::endl;
+  }
+}
+
+
+rubuilder::utils::LoopbackTransport::Component::Component(const std::string& name) :
+name(name),
+dispatching(false),
+callbackCPUTimeNSec(0),
+unhandledFrames(0)
+{}
+
+
+void rubuilder::utils::LoopbackTransport::Statistics::add
+(
+  const uint32_t frameCount,
+  const uint64_t byteCount,
+  const uint64_t nowNSec
+)
+{
+  if ( frames == 0 ) firstNSec = nowNSec;
+  lastNSec = nowNSec;
+  frames += frameCount;
+  bytes += byteCount;
+}
+
+
+double rubuilder::utils::LoopbackTransport::Statistics::getFrameRate() const
+{
+  if ( lastNSec <= firstNSec ) return 0;
+  return frames / ((lastNSec - firstNSec) / 1e9);
+}
+
+
+double rubuilder::utils::LoopbackTransport::Statistics::getBandwidth() const
+{
+  if ( lastNSec <= firstNSec ) return 0;
+  return bytes / ((lastNSec - firstNSec) / 1e9);
+}
+
+
+rubuilder::utils::LoopbackTransport& rubuilder::utils::getLoopbackTransport()
+{
+  static LoopbackTransport loopbackTransport;
+  return loopbackTransport;
+}
+
+
+void rubuilder::utils::postFrame
+(
+  xdaq::Application* app,
+  toolbox::mem::Reference* bufRef,
+  xdaq::ApplicationDescriptor* destination
+)
+{
+  if ( getLoopbackTransport().postFrame(bufRef, app->getApplicationDescriptor(), destination) )
+    return;
+
+  app->getApplicationContext()->postFrame(bufRef, app->getApplicationDescriptor(), destination);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
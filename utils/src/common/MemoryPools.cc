@@ -0,0 +1,135 @@
+#include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/HugePageAllocator.h"
+#include "rubuilder/utils/MemoryPools.h"
+#include "rubuilder/utils/ResourcePlacement.h"
+#include "toolbox/mem/HeapAllocator.h"
+#include "toolbox/mem/MemoryPoolFactory.h"
+#include "toolbox/net/URN.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <sstream>
+
+
+namespace
+{
+  typedef std::map<std::string,rubuilder::utils::HugePageAllocator*> HugePageAllocators;
+  HugePageAllocators hugePageAllocators;
+  boost::mutex hugePageAllocatorsMutex;
+}
+
+
+toolbox::mem::Pool* rubuilder::utils::getMemoryPool
+(
+  const std::string& baseName,
+  const PoolConfiguration& conf,
+  std::string& poolName
+)
+{
+  try
+  {
+    toolbox::net::URN urn("toolbox-mem-pool", "udapl");
+    toolbox::mem::Pool* pool = toolbox::mem::getMemoryPoolFactory()->findPool(urn);
+    poolName = "udapl";
+    return pool;
+  }
+  catch (toolbox::mem::exception::MemoryPoolNotFound)
+  {
+    // Use our own pool
+  }
+
+  if ( conf.hugePageSizeKB == 0 )
+  {
+    poolName = baseName;
+  }
+  else
+  {
+    if ( conf.committedSizeMB == 0 )
+    {
+      XCEPT_RAISE(exception::Configuration,
+        "A committed size is required for the huge page pool of " + baseName);
+    }
+    poolName = baseName + "/hugepages";
+  }
+
+  // Huge page pools are bound to their NUMA node by the allocator
+  int32_t numaNode = -1;
+  uint32_t node;
+  if ( conf.hugePageSizeKB > 0 && getResourcePlacement().getPoolNode(poolName, node) )
+    numaNode = node;
+
+  boost::mutex::scoped_lock sl(hugePageAllocatorsMutex);
+
+  toolbox::net::URN urn("toolbox-mem-pool", poolName);
+  try
+  {
+    // Pools cannot be destroyed. Thus the pool created at the
+    // first configure is reused when configuring again.
+    toolbox::mem::Pool* pool = toolbox::mem::getMemoryPoolFactory()->findPool(urn);
+
+    HugePageAllocators::const_iterator pos = hugePageAllocators.find(poolName);
+    if ( pos != hugePageAllocators.end() && pos->second->getNUMAnode() != numaNode )
+    {
+      std::ostringstream oss;
+      oss << "The huge page pool " << poolName << " was created with NUMA node "
+        << pos->second->getNUMAnode() << " and cannot be moved to node " << numaNode;
+      XCEPT_RAISE(exception::Configuration, oss.str());
+    }
+    return pool;
+  }
+  catch (toolbox::mem::exception::MemoryPoolNotFound)
+  {
+    // Create it below
+  }
+
+  try
+  {
+    if ( conf.hugePageSizeKB == 0 )
+    {
+      return toolbox::mem::getMemoryPoolFactory()->
+        createPool(urn, new toolbox::mem::HeapAllocator());
+    }
+
+    HugePageAllocator* allocator = new HugePageAllocator(
+      static_cast<size_t>(conf.committedSizeMB) << 20,
+      static_cast<size_t>(conf.hugePageSizeKB) << 10,
+      numaNode);
+    hugePageAllocators[poolName] = allocator;
+
+    if ( numaNode >= 0 )
+      getResourcePlacement().setAllocatorPlacement(poolName, numaNode, allocator->getCommittedSize());
+
+    return toolbox::mem::getMemoryPoolFactory()->createPool(urn, allocator);
+  }
+  catch (toolbox::mem::exception::Exception& e)
+  {
+    XCEPT_RETHROW(exception::OutOfMemory,
+      "Failed to create memory pool " + poolName, e);
+  }
+}
+
+
+std::string rubuilder::utils::getMemoryPoolBacking(const std::string& poolName)
+{
+  if ( poolName == "udapl" ) return "udapl";
+
+  boost::mutex::scoped_lock sl(hugePageAllocatorsMutex);
+
+  HugePageAllocators::const_iterator pos = hugePageAllocators.find(poolName);
+  if ( pos == hugePageAllocators.end() ) return "heap";
+
+  std::ostringstream oss;
+  oss << pos->second->getBacking() << ", "
+    << (pos->second->getCommittedSize() >> 20) << " MB pre-faulted in "
+    << pos->second->getPrefaultTimeMSec() << " ms";
+  return oss.str();
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -4,6 +4,7 @@
 #include "rubuilder/utils/Exception.h"
 #include "rubuilder/utils/Constants.h"
 #include "rubuilder/utils/FragmentSets.h"
+#include "rubuilder/utils/LoopbackTransport.h"
 #include "rubuilder/utils/RUbroadcaster.h"
 #include "rubuilder/utils/UnsignedInteger32Less.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
@@ -11,6 +12,7 @@
 #include "xdaq/ApplicationDescriptor.h"
 
 #include <string.h>
+#include <time.h>
 
 
 rubuilder::utils::RUbroadcaster::RUbroadcaster
@@ -22,8 +24,13 @@ app_(app),
 fastCtrlMsgPool_(fastCtrlMsgPool),
 logger_(app->getApplicationLogger()),
 tid_(0),
-ruCount_(0)
-{}
+ruCount_(0),
+useSharedFrame_(false)
+{
+  broadcastMonitoring_.broadcastCount = 0;
+  broadcastMonitoring_.frameCount = 0;
+  broadcastMonitoring_.cpuTimeNSec = 0;
+}
 
 
 void rubuilder::utils::RUbroadcaster::initRuInstances(InfoSpaceItems& params)
@@ -31,6 +38,7 @@ void rubuilder::utils::RUbroadcaster::initRuInstances(InfoSpaceItems& params)
   useFragmentSet_         = false;
   fragmentSetsUrl_        = "";
   fragmentSetId_          = 0;
+  sharedBroadcastFrame_   = false;
 
   getRuInstances();
 
@@ -38,6 +46,7 @@ void rubuilder::utils::RUbroadcaster::initRuInstances(InfoSpaceItems& params)
   params.add("useFragmentSet", &useFragmentSet_);
   params.add("fragmentSetsUrl", &fragmentSetsUrl_);
   params.add("fragmentSetId", &fragmentSetId_);
+  params.add("sharedBroadcastFrame", &sharedBroadcastFrame_);
 }
 
 
@@ -120,6 +129,29 @@ void rubuilder::utils::RUbroadcaster::getApplicationDescriptors()
         "Failed to fill RU descriptor list using \"ruInstances\"", e);
     }
   }
+
+  chooseBroadcastMode();
+}
+
+
+void rubuilder::utils::RUbroadcaster::chooseBroadcastMode()
+{
+  // The elements can only be shared with RUs in this process
+  useSharedFrame_ = sharedBroadcastFrame_ && ! participatingRUs_.empty();
+
+  for ( RUDescriptorsAndTids::const_iterator it = participatingRUs_.begin(),
+          itEnd = participatingRUs_.end();
+        useSharedFrame_ && it != itEnd; ++it)
+  {
+    useSharedFrame_ = getLoopbackTransport().isBound(it->descriptor);
+  }
+
+  if ( sharedBroadcastFrame_ && ! useSharedFrame_ )
+  {
+    LOG4CPLUS_WARN(logger_,
+      "Not all RUs are bound to the loopback transport: "
+      "each RU is sent a copy of the broadcast messages");
+  }
 }
 
 
@@ -254,6 +286,31 @@ void rubuilder::utils::RUbroadcaster::fillRUInstance(xdata::UnsignedInteger32 in
 }
 
 void rubuilder::utils::RUbroadcaster::sendToAllRUs
+(
+  toolbox::mem::Reference* bufRef,
+  const size_t bufSize,
+  const size_t headerSize
+)
+{
+  struct timespec start, stop;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+
+  if ( useSharedFrame_ && headerSize < bufRef->getDataSize() )
+    sendSharedFrameToAllRUs(bufRef, bufSize, headerSize);
+  else
+    sendCopiesToAllRUs(bufRef, bufSize);
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &stop);
+
+  boost::mutex::scoped_lock sl(broadcastMonitoringMutex_);
+  ++broadcastMonitoring_.broadcastCount;
+  broadcastMonitoring_.frameCount += participatingRUs_.size();
+  broadcastMonitoring_.cpuTimeNSec +=
+    (stop.tv_sec - start.tv_sec) * 1000000000LL + (stop.tv_nsec - start.tv_nsec);
+}
+
+
+void rubuilder::utils::RUbroadcaster::sendCopiesToAllRUs
 (
   toolbox::mem::Reference* bufRef,
   const size_t bufSize
@@ -268,48 +325,148 @@ void rubuilder::utils::RUbroadcaster::sendToAllRUs
           itEnd = participatingRUs_.end();
         it != itEnd; ++it)
   {
-    // Create an empty request message
-    toolbox::mem::Reference* copyBufRef =
-      toolbox::mem::getMemoryPoolFactory()->
-      getFrame(fastCtrlMsgPool_, bufSize);
-    char* copyFrame  = (char*)(copyBufRef->getDataLocation());
-
-    // Copy the message under construction into
-    // the newly created empty message
-    memcpy(
-      copyFrame,
-      bufRef->getDataLocation(),
-      bufRef->getDataSize()
-    );
-
-    // Set the size of the copy
-    copyBufRef->setDataSize(bufRef->getDataSize());
-
-    // Set the I2O TID target address
-    ((I2O_MESSAGE_FRAME*)copyFrame)->TargetAddress = it->tid;
-
-    // Send the pairs message to the RU
-    try
+    sendCopyToRU(bufRef, bufSize, *it);
+  }
+}
+
+
+void rubuilder::utils::RUbroadcaster::sendCopyToRU
+(
+  toolbox::mem::Reference* bufRef,
+  const size_t bufSize,
+  const ApplicationDescriptorAndTid& ru
+)
+{
+  // Create an empty request message
+  toolbox::mem::Reference* copyBufRef =
+    toolbox::mem::getMemoryPoolFactory()->
+    getFrame(fastCtrlMsgPool_, bufSize);
+  char* copyFrame  = (char*)(copyBufRef->getDataLocation());
+
+  // Copy the message under construction into
+  // the newly created empty message
+  memcpy(
+    copyFrame,
+    bufRef->getDataLocation(),
+    bufRef->getDataSize()
+  );
+
+  // Set the size of the copy
+  copyBufRef->setDataSize(bufRef->getDataSize());
+
+  // Set the I2O TID target address
+  ((I2O_MESSAGE_FRAME*)copyFrame)->TargetAddress = ru.tid;
+
+  // Send the pairs message to the RU
+  postFrameToRU(copyBufRef, ru);
+}
+
+
+void rubuilder::utils::RUbroadcaster::sendSharedFrameToAllRUs
+(
+  toolbox::mem::Reference* bufRef,
+  const size_t bufSize,
+  const size_t headerSize
+)
+{
+  ////////////////////////////////////////////////////////////
+  // The elements of the message under construction are     //
+  // shared by all RUs. The buffer is freed when the caller //
+  // and the last RU released their references.             //
+  ////////////////////////////////////////////////////////////
+
+  toolbox::mem::Reference* elementsBufRef = bufRef->duplicate();
+  elementsBufRef->setDataOffset(bufRef->getDataOffset() + headerSize);
+  elementsBufRef->setDataSize(bufRef->getDataSize() - headerSize);
+
+  try
+  {
+    for ( RUDescriptorsAndTids::const_iterator it = participatingRUs_.begin(),
+            itEnd = participatingRUs_.end();
+          it != itEnd; ++it)
     {
-      app_->getApplicationContext()->
-        postFrame(
-          copyBufRef,
-          app_->getApplicationDescriptor(),
-          it->descriptor //,
-          //i2oExceptionHandler_,
-          //it->descriptor
-        );
+      // Only the header is copied and gets the I2O TID of the RU
+      toolbox::mem::Reference* headerBufRef =
+        toolbox::mem::getMemoryPoolFactory()->
+        getFrame(fastCtrlMsgPool_, headerSize);
+      char* header = (char*)(headerBufRef->getDataLocation());
+      memcpy(header, bufRef->getDataLocation(), headerSize);
+      headerBufRef->setDataSize(headerSize);
+      ((I2O_MESSAGE_FRAME*)header)->TargetAddress = it->tid;
+      headerBufRef->setNextReference( elementsBufRef->duplicate() );
+
+      bool posted = false;
+      try
+      {
+        posted = utils::getLoopbackTransport().postFrame(headerBufRef,
+          app_->getApplicationDescriptor(), it->descriptor);
+      }
+      catch(...)
+      {
+        headerBufRef->release();
+        throw;
+      }
+
+      // The RU was unbound since configure
+      if ( ! posted )
+      {
+        headerBufRef->release();
+        sendCopyToRU(bufRef, bufSize, *it);
+      }
     }
-    catch(xcept::Exception &e)
-    {
-      std::stringstream oss;
-      
-      oss << "Failed to send message to RU";
-      oss << it->descriptor->getInstance();
+  }
+  catch(...)
+  {
+    elementsBufRef->release();
+    throw;
+  }
 
-      XCEPT_RETHROW(exception::I2O, oss.str(), e);
-    }
+  elementsBufRef->release();
+}
+
+
+void rubuilder::utils::RUbroadcaster::postFrameToRU
+(
+  toolbox::mem::Reference* bufRef,
+  const ApplicationDescriptorAndTid& ru
+)
+{
+  try
+  {
+    utils::postFrame(app_, bufRef, ru.descriptor);
   }
+  catch(xcept::Exception &e)
+  {
+    std::stringstream oss;
+    
+    oss << "Failed to send message to RU";
+    oss << ru.descriptor->getInstance();
+    
+    XCEPT_RETHROW(exception::I2O, oss.str(), e);
+  }
+}
+
+
+void rubuilder::utils::RUbroadcaster::printBroadcastHtml(xgi::Output *out)
+{
+  boost::mutex::scoped_lock sl(broadcastMonitoringMutex_);
+
+  const uint64_t broadcastCount = broadcastMonitoring_.broadcastCount;
+  const uint64_t frameCount = broadcastMonitoring_.frameCount;
+  const double cpuTimeUSec = broadcastMonitoring_.cpuTimeNSec / 1000.;
+
+  *out << "<tr>"                                                  << std::endl;
+  *out << "<td colspan=\"2\" style=\"text-align:center\">Broadcast to "
+    << ruCount_ << " RUs</td>"                                    << std::endl;
+  *out << "</tr>"                                                 << std::endl;
+  *out << "<tr>"                                                  << std::endl;
+  *out << "<td>CPU per msg (us)</td>"                             << std::endl;
+  *out << "<td>" << (broadcastCount > 0 ? cpuTimeUSec / broadcastCount : 0) << "</td>" << std::endl;
+  *out << "</tr>"                                                 << std::endl;
+  *out << "<tr>"                                                  << std::endl;
+  *out << "<td>CPU per RU (us)</td>"                              << std::endl;
+  *out << "<td>" << (frameCount > 0 ? cpuTimeUSec / frameCount : 0) << "</td>" << std::endl;
+  *out << "</tr>"                                                 << std::endl;
 }
 
 
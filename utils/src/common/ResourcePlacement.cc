@@ -0,0 +1,405 @@
+#include "rubuilder/utils/ResourcePlacement.h"
+#include "rubuilder/utils/Exception.h"
+#include "toolbox/mem/MemoryPoolFactory.h"
+#include "toolbox/mem/Reference.h"
+
+#include <errno.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace
+{
+  // The affinity of the process before any workloop was pinned. It is
+  // restored for workloops whose placement was removed.
+  cpu_set_t getInitialCPUSet()
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if ( ::sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet) != 0 )
+    {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &cpuSet);
+    }
+    return cpuSet;
+  }
+
+  const cpu_set_t initialCPUSet = getInitialCPUSet();
+}
+
+
+rubuilder::utils::ResourcePlacement::ResourcePlacement() :
+generation_(0)
+{}
+
+
+void rubuilder::utils::ResourcePlacement::configure
+(
+  const std::string& identifier,
+  const Mapping& workLoopCPUs,
+  const Mapping& poolNUMAnodes
+)
+{
+  WorkLoopCPUs newWorkLoopCPUs;
+  for (Mapping::const_iterator it = workLoopCPUs.begin(), itEnd = workLoopCPUs.end();
+       it != itEnd; ++it)
+  {
+    std::string name, cpuList;
+    splitEntry(it->toString(), name, cpuList);
+    cpu_set_t cpuSet;
+    parseCPUList(cpuList, cpuSet);
+    newWorkLoopCPUs[identifier + name] = cpuSet;
+  }
+
+  PoolNodes newPoolNodes;
+  for (Mapping::const_iterator it = poolNUMAnodes.begin(), itEnd = poolNUMAnodes.end();
+       it != itEnd; ++it)
+  {
+    std::string name, node;
+    splitEntry(it->toString(), name, node);
+    char* end = 0;
+    const unsigned long nodeId = strtoul(node.c_str(), &end, 10);
+    if ( node.empty() || *end != '\0' || nodeId >= sizeof(unsigned long)*8 )
+    {
+      XCEPT_RAISE(exception::Configuration,
+        "Invalid NUMA node for pool " + name + ": " + node);
+    }
+    newPoolNodes[name] = nodeId;
+  }
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  // Drop the previous placement of the workloops of this application
+  WorkLoopCPUs::iterator pos = workLoopCPUs_.lower_bound(identifier);
+  while ( pos != workLoopCPUs_.end() && pos->first.compare(0, identifier.size(), identifier) == 0 )
+  {
+    workLoopPlacements_.erase(pos->first);
+    workLoopCPUs_.erase(pos++);
+  }
+  workLoopCPUs_.insert(newWorkLoopCPUs.begin(), newWorkLoopCPUs.end());
+
+  for (PoolNodes::const_iterator it = newPoolNodes.begin(), itEnd = newPoolNodes.end();
+       it != itEnd; ++it)
+  {
+    poolNodes_[it->first] = it->second;
+  }
+
+  // Let each workloop apply its new placement on its next call
+  storeRelease(generation_, generation_ + 1);
+}
+
+
+void rubuilder::utils::ResourcePlacement::applyToCurrentThread(const std::string& workLoopName)
+{
+  uint32_t* threadGeneration = threadGeneration_.get();
+  if ( threadGeneration == 0 )
+  {
+    threadGeneration = new uint32_t(0);
+    threadGeneration_.reset(threadGeneration);
+  }
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  *threadGeneration = generation_;
+
+  WorkLoopCPUs::const_iterator pos = workLoopCPUs_.find(workLoopName);
+  const cpu_set_t& cpuSet = ( pos == workLoopCPUs_.end() ) ? initialCPUSet : pos->second;
+
+  const int status = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if ( status != 0 )
+  {
+    std::ostringstream oss;
+    oss << "Failed to set the affinity of workloop " << workLoopName
+      << " to CPUs " << formatCPUSet(cpuSet) << ": " << strerror(status);
+    XCEPT_RAISE(exception::Configuration, oss.str());
+  }
+
+  if ( pos == workLoopCPUs_.end() )
+  {
+    workLoopPlacements_.erase(workLoopName);
+  }
+  else
+  {
+    cpu_set_t actualCPUSet;
+    CPU_ZERO(&actualCPUSet);
+    ::pthread_getaffinity_np(::pthread_self(), sizeof(cpu_set_t), &actualCPUSet);
+    workLoopPlacements_[workLoopName] = formatCPUSet(actualCPUSet);
+  }
+}
+
+
+void rubuilder::utils::ResourcePlacement::placePool
+(
+  const std::string& poolName,
+  toolbox::mem::Pool* pool,
+  const size_t blockSize,
+  const uint32_t blockCount
+)
+{
+  uint32_t node;
+  {
+    boost::mutex::scoped_lock sl(mutex_);
+    if ( poolsPlacedByAllocator_.count(poolName) ) return;
+    PoolNodes::const_iterator pos = poolNodes_.find(poolName);
+    if ( pos == poolNodes_.end() ) return;
+    node = pos->second;
+  }
+
+  const unsigned long nodeMask = 1UL << node;
+  const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+
+  std::vector<toolbox::mem::Reference*> frames;
+  frames.reserve(blockCount);
+  std::string errorMsg;
+
+  try
+  {
+    for (uint32_t i = 0; i < blockCount; ++i)
+    {
+      toolbox::mem::Reference* bufRef =
+        toolbox::mem::getMemoryPoolFactory()->getFrame(pool, blockSize);
+      frames.push_back(bufRef);
+
+      // mbind works on whole pages
+      const uintptr_t start =
+        reinterpret_cast<uintptr_t>(bufRef->getDataLocation()) & ~(pageSize - 1);
+      const uintptr_t end =
+        reinterpret_cast<uintptr_t>(bufRef->getDataLocation()) + blockSize;
+
+      if ( ::syscall(SYS_mbind, start, end - start, MPOL_BIND,
+          &nodeMask, sizeof(nodeMask)*8, MPOL_MF_MOVE) != 0 )
+      {
+        std::ostringstream oss;
+        oss << "Failed to bind pool " << poolName << " to NUMA node "
+          << node << ": " << strerror(errno);
+        errorMsg = oss.str();
+        break;
+      }
+
+      // First touch allocates the pages on the node
+      memset(bufRef->getDataLocation(), 0, blockSize);
+    }
+  }
+  catch(toolbox::mem::exception::Exception& e)
+  {
+    // The pool reached its high threshold. Keep what we have.
+  }
+
+  for (std::vector<toolbox::mem::Reference*>::const_iterator it = frames.begin(),
+         itEnd = frames.end(); it != itEnd; ++it)
+  {
+    (*it)->release();
+  }
+
+  if ( ! errorMsg.empty() )
+    XCEPT_RAISE(exception::Configuration, errorMsg);
+
+  std::ostringstream placement;
+  placement << "node " << node << " (" << frames.size() << "x" << blockSize << " bytes)";
+
+  boost::mutex::scoped_lock sl(mutex_);
+  poolPlacements_[poolName] = placement.str();
+}
+
+
+void rubuilder::utils::ResourcePlacement::addPlaceablePool(const std::string& baseName)
+{
+  boost::mutex::scoped_lock sl(mutex_);
+  placeablePools_.insert(baseName);
+}
+
+
+void rubuilder::utils::ResourcePlacement::removePlaceablePool(const std::string& baseName)
+{
+  boost::mutex::scoped_lock sl(mutex_);
+  PlaceablePools::iterator pos = placeablePools_.find(baseName);
+  if ( pos != placeablePools_.end() ) placeablePools_.erase(pos);
+}
+
+
+void rubuilder::utils::ResourcePlacement::checkPoolNames(const Mapping& poolNUMAnodes) const
+{
+  const std::string hugePageSuffix = "/hugepages";
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  for (Mapping::const_iterator it = poolNUMAnodes.begin(), itEnd = poolNUMAnodes.end();
+       it != itEnd; ++it)
+  {
+    std::string name, node;
+    splitEntry(it->toString(), name, node);
+
+    std::string baseName = name;
+    if ( baseName.size() > hugePageSuffix.size() &&
+      baseName.compare(baseName.size() - hugePageSuffix.size(), hugePageSuffix.size(), hugePageSuffix) == 0 )
+      baseName.erase(baseName.size() - hugePageSuffix.size());
+
+    if ( placeablePools_.find(baseName) == placeablePools_.end() )
+    {
+      XCEPT_RAISE(exception::Configuration,
+        "The pool " + name + " cannot be bound to a NUMA node, as its owner does not place it");
+    }
+  }
+}
+
+
+bool rubuilder::utils::ResourcePlacement::getPoolNode
+(
+  const std::string& poolName,
+  uint32_t& node
+) const
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  PoolNodes::const_iterator pos = poolNodes_.find(poolName);
+  if ( pos == poolNodes_.end() ) return false;
+  node = pos->second;
+  return true;
+}
+
+
+void rubuilder::utils::ResourcePlacement::setAllocatorPlacement
+(
+  const std::string& poolName,
+  const uint32_t node,
+  const size_t size
+)
+{
+  std::ostringstream placement;
+  placement << "node " << node << " (" << (size >> 20) << " MB)";
+
+  boost::mutex::scoped_lock sl(mutex_);
+  poolsPlacedByAllocator_.insert(poolName);
+  poolPlacements_[poolName] = placement.str();
+}
+
+
+std::string rubuilder::utils::ResourcePlacement::getWorkLoopPlacement() const
+{
+  std::ostringstream oss;
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  for (Placements::const_iterator it = workLoopPlacements_.begin(),
+         itEnd = workLoopPlacements_.end(); it != itEnd; ++it)
+  {
+    if ( it != workLoopPlacements_.begin() ) oss << "; ";
+    oss << it->first << "=" << it->second;
+  }
+  return oss.str();
+}
+
+
+std::string rubuilder::utils::ResourcePlacement::getPoolPlacement() const
+{
+  std::ostringstream oss;
+
+  boost::mutex::scoped_lock sl(mutex_);
+
+  for (Placements::const_iterator it = poolPlacements_.begin(),
+         itEnd = poolPlacements_.end(); it != itEnd; ++it)
+  {
+    if ( it != poolPlacements_.begin() ) oss << "; ";
+    oss << it->first << "=" << it->second;
+  }
+  return oss.str();
+}
+
+
+void rubuilder::utils::ResourcePlacement::splitEntry
+(
+  const std::string& entry,
+  std::string& name,
+  std::string& value
+)
+{
+  // Pool names may contain colons, e.g. application URNs
+  const size_t pos = entry.rfind(':');
+  if ( pos == std::string::npos || pos == 0 )
+  {
+    XCEPT_RAISE(exception::Configuration,
+      "Placement '" + entry + "' is not of the form name:value");
+  }
+  name = entry.substr(0, pos);
+  value = entry.substr(pos + 1);
+}
+
+
+void rubuilder::utils::ResourcePlacement::parseCPUList
+(
+  const std::string& cpuList,
+  cpu_set_t& cpuSet
+)
+{
+  CPU_ZERO(&cpuSet);
+
+  const char* pos = cpuList.c_str();
+  while ( *pos != '\0' )
+  {
+    char* end = 0;
+    const long first = strtol(pos, &end, 10);
+    long last = first;
+    if ( end == pos ) break;
+    if ( *end == '-' )
+    {
+      pos = end + 1;
+      last = strtol(pos, &end, 10);
+      if ( end == pos ) break;
+    }
+    if ( first < 0 || last < first || last >= CPU_SETSIZE ) break;
+
+    for (long cpu = first; cpu <= last; ++cpu) CPU_SET(cpu, &cpuSet);
+
+    if ( *end == '\0' ) return;
+    if ( *end != ',' ) break;
+    pos = end + 1;
+  }
+
+  XCEPT_RAISE(exception::Configuration,
+    "Invalid CPU list '" + cpuList + "'");
+}
+
+
+std::string rubuilder::utils::ResourcePlacement::formatCPUSet(const cpu_set_t& cpuSet)
+{
+  std::ostringstream oss;
+  int cpu = 0;
+  bool first = true;
+
+  while ( cpu < CPU_SETSIZE )
+  {
+    if ( ! CPU_ISSET(cpu, &cpuSet) ) { ++cpu; continue; }
+
+    const int begin = cpu;
+    while ( cpu + 1 < CPU_SETSIZE && CPU_ISSET(cpu + 1, &cpuSet) ) ++cpu;
+
+    if ( ! first ) oss << ",";
+    oss << begin;
+    if ( cpu > begin ) oss << "-" << cpu;
+    first = false;
+    ++cpu;
+  }
+  return oss.str();
+}
+
+
+rubuilder::utils::ResourcePlacement& rubuilder::utils::getResourcePlacement()
+{
+  // Never destroyed, as the pool owners announcing their pools
+  // may be destroyed after the static objects of this process
+  static ResourcePlacement* resourcePlacement = new ResourcePlacement();
+  return *resourcePlacement;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
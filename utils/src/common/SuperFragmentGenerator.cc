@@ -4,58 +4,43 @@
 #include "interface/shared/fed_trailer.h"
 #include "interface/shared/frl_header.h"
 #include "interface/shared/i2oXFunctionCodes.h"
-#include "rubuilder/utils/CRC16.h"
+#include "rubuilder/utils/CRC16Kernels.h"
 #include "rubuilder/utils/Exception.h"
+#include "rubuilder/utils/FedCRCUpdater.h"
+#include "rubuilder/utils/ResourcePlacement.h"
 #include "rubuilder/utils/SuperFragmentGenerator.h"
-#include "toolbox/mem/HeapAllocator.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "xcept/tools.h"
 
 #include <assert.h>
 #include <math.h>
 #include <sstream>
+#include <string.h>
 #include <sys/time.h>
 
+
 rubuilder::utils::SuperFragmentGenerator::SuperFragmentGenerator(const std::string& poolName) :
+poolBaseName_(poolName),
+dummySuperFragmentPool_(0),
 dummyBlockSize_(0),
 dummyFedPayloadSize_(0),
 eventNumber_(1),
 fedCRC_(0),
-usePlayback_(false)
+usePlayback_(false),
+nextTemplate_(0)
 {
-  try
-  {
-    toolbox::net::URN urn("toolbox-mem-pool", "udapl");
-    dummySuperFragmentPool_ = toolbox::mem::getMemoryPoolFactory()->findPool(urn);
-  }
-  catch (toolbox::mem::exception::MemoryPoolNotFound)
-  {
-    toolbox::net::URN urn("toolbox-mem-pool", poolName);
-    try
-    {
-      dummySuperFragmentPool_ = toolbox::mem::getMemoryPoolFactory()->
-        createPool(urn, new toolbox::mem::HeapAllocator());
-    }
-    catch (toolbox::mem::exception::DuplicateMemoryPool)
-    {
-      // Pool already exists from a previous construction of this class
-      // Note that destroying the pool in the destructor is not working
-      // because the previous instance is destroyed after the new one
-      // is constructed.
-      dummySuperFragmentPool_ = toolbox::mem::getMemoryPoolFactory()->
-      findPool(urn);
-    }
-  }
-  catch (toolbox::mem::exception::Exception e)
-  {
-    XCEPT_RETHROW(exception::OutOfMemory,
-      "Failed to create memory pool for dummy super-fragments.", e);
-  }
-
+  getResourcePlacement().addPlaceablePool(poolBaseName_);
   reset();
 }
 
 
+rubuilder::utils::SuperFragmentGenerator::~SuperFragmentGenerator()
+{
+  releaseTemplates();
+  getResourcePlacement().removePlaceablePool(poolBaseName_);
+}
+
+
 void rubuilder::utils::SuperFragmentGenerator::configure
 (
   const xdata::Vector<xdata::UnsignedInteger32>& fedSourceIds,
@@ -64,9 +49,15 @@ void rubuilder::utils::SuperFragmentGenerator::configure
   const uint32_t dummyBlockSize,
   const uint32_t dummyFedPayloadSize,
   const uint32_t dummyFedPayloadStdDev,
-  const uint32_t maxFragmentsInMemory
+  const uint32_t maxFragmentsInMemory,
+  const PoolConfiguration& poolConfiguration,
+  const uint32_t nbTemplates
 )
 {
+  releaseTemplates();
+
+  dummySuperFragmentPool_ = getMemoryPool(poolBaseName_, poolConfiguration, poolName_);
+
   if ( fedSourceIds.empty() && !usePlayback )
   {
     XCEPT_RAISE(exception::Configuration,
@@ -116,6 +107,14 @@ void rubuilder::utils::SuperFragmentGenerator::configure
   if ( usePlayback )
     cacheData(playbackDataFile);
 
+  uint32_t numaNode;
+  if ( maxFragmentsInMemory == 0 && poolConfiguration.hugePageSizeKB == 0 &&
+    getResourcePlacement().getPoolNode(poolName_, numaNode) )
+  {
+    XCEPT_RAISE(exception::Configuration,
+      "The pool " + poolName_ + " cannot be bound to a NUMA node, as it keeps no fragments in memory");
+  }
+
   if ( maxFragmentsInMemory > 0 )
   {
     const size_t payload =
@@ -125,8 +124,56 @@ void rubuilder::utils::SuperFragmentGenerator::configure
       dummyFedPayloadSize                        + // FED payload
       sizeof(fedt_t);                              // FED trailer
     
-    dummySuperFragmentPool_->setHighThreshold(maxFragmentsInMemory*fedSourceIds_.size()*payload);
+    // The templates stay in the pool for the whole configuration
+    const size_t nbFragments = maxFragmentsInMemory + (usePlayback ? 0 : nbTemplates);
+
+    dummySuperFragmentPool_->setHighThreshold(nbFragments*fedSourceIds_.size()*payload);
+
+    getResourcePlacement().placePool(poolName_, dummySuperFragmentPool_,
+      dummyBlockSize_, nbFragments*fedSourceIds_.size());
+  }
+
+  if ( !usePlayback )
+    buildTemplates(nbTemplates);
+}
+
+
+void rubuilder::utils::SuperFragmentGenerator::buildTemplates(const uint32_t nbTemplates)
+{
+  EvBidFactory evbIdFactory;
+
+  templates_.reserve(nbTemplates);
+  for (uint32_t i = 0; i < nbTemplates; ++i)
+  {
+    SuperFragmentTemplate superFragmentTemplate;
+    const EvBid evbId = evbIdFactory.getEvBid(i+1);
+
+    if ( ! buildSuperFragment(superFragmentTemplate.bufRef, evbId, &superFragmentTemplate.fedLocations) )
+    {
+      releaseTemplates();
+
+      std::stringstream oss;
+
+      oss << "Failed to allocate memory for super-fragment template " << i;
+      oss << " of " << nbTemplates;
+
+      XCEPT_RAISE(exception::OutOfMemory, oss.str());
+    }
+    templates_.push_back(superFragmentTemplate);
   }
+  nextTemplate_ = 0;
+}
+
+
+void rubuilder::utils::SuperFragmentGenerator::releaseTemplates()
+{
+  for (SuperFragmentTemplates::const_iterator it = templates_.begin(), itEnd = templates_.end();
+       it != itEnd; ++it)
+  {
+    it->bufRef->release();
+  }
+  templates_.clear();
+  nextTemplate_ = 0;
 }
 
 
@@ -135,6 +182,7 @@ void rubuilder::utils::SuperFragmentGenerator::reset()
   playbackDataPos_ = playbackData_.begin();
   eventNumber_ = 1;
   evbIdFactory_.reset();
+  nextTemplate_ = 0;
 }
 
 
@@ -191,8 +239,6 @@ bool rubuilder::utils::SuperFragmentGenerator::getData
     
   fillTriggerPayload(fedPtr,evbId.eventNumber(),l1Info);
 
-  updateCRC(fedPtr);
-
   return true;
 }
 
@@ -229,9 +275,17 @@ toolbox::mem::Reference* rubuilder::utils::SuperFragmentGenerator::clone
   
   while (bufRef)
   {
-    toolbox::mem::Reference* copyBufRef =
-      toolbox::mem::getMemoryPoolFactory()->
-      getFrame(dummySuperFragmentPool_, bufRef->getDataSize());
+    toolbox::mem::Reference* copyBufRef = 0;
+    try
+    {
+      copyBufRef = toolbox::mem::getMemoryPoolFactory()->
+        getFrame(dummySuperFragmentPool_, bufRef->getDataSize());
+    }
+    catch(...)
+    {
+      if (head) head->release();
+      throw;
+    }
     
     memcpy(
       (char*)copyBufRef->getDataLocation(),
@@ -281,6 +335,92 @@ bool rubuilder::utils::SuperFragmentGenerator::getSuperFragment
   toolbox::mem::Reference*& bufRef,
   const EvBid& evbId
 )
+{
+  if ( templates_.empty() )
+    return buildSuperFragment(bufRef,evbId);
+  else
+    return getSuperFragmentFromTemplate(bufRef,evbId);
+}
+
+
+bool rubuilder::utils::SuperFragmentGenerator::getSuperFragmentFromTemplate
+(
+  toolbox::mem::Reference*& bufRef,
+  const EvBid& evbId
+)
+{
+  if ( dummySuperFragmentPool_->isHighThresholdExceeded() ) return false;
+
+  const SuperFragmentTemplate& superFragmentTemplate = templates_[nextTemplate_];
+
+  try
+  {
+    bufRef = clone(superFragmentTemplate.bufRef);
+  }
+  catch(toolbox::mem::exception::Exception& e)
+  {
+    return false;
+  }
+  catch(xcept::Exception& e)
+  {
+    XCEPT_RETHROW(exception::OutOfMemory,
+      "Failed to allocate memory for super-fragment block", e);
+  }
+
+  if ( ++nextTemplate_ == templates_.size() ) nextTemplate_ = 0;
+
+  templateBlocks_.clear();
+  for (toolbox::mem::Reference* ref = bufRef; ref; ref = ref->getNextReference())
+  {
+    unsigned char* blockAddr = (unsigned char*)ref->getDataLocation();
+    I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME* block = (I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME*)blockAddr;
+    frlh_t* frlHeader = (frlh_t*)(blockAddr + sizeof(I2O_EVENT_DATA_BLOCK_MESSAGE_FRAME));
+
+    block->eventNumber = evbId.eventNumber();
+    block->resyncCount = evbId.resyncCount();
+    frlHeader->trigno  = evbId.eventNumber();
+
+    templateBlocks_.push_back(blockAddr);
+  }
+
+  for (FedLocations::const_iterator it = superFragmentTemplate.fedLocations.begin(),
+         itEnd = superFragmentTemplate.fedLocations.end(); it != itEnd; ++it)
+  {
+    updateEventNumber(*it, evbId.eventNumber());
+  }
+
+  return true;
+}
+
+
+void rubuilder::utils::SuperFragmentGenerator::updateEventNumber
+(
+  const FedLocation& fedLocation,
+  const uint32_t eventNumber
+) const
+{
+  fedh_t* fedHeader = (fedh_t*)(templateBlocks_[fedLocation.headerBlockNb] + fedLocation.headerOffset);
+  fedt_t* fedTrailer = (fedt_t*)(templateBlocks_[fedLocation.trailerBlockNb] + fedLocation.trailerOffset);
+
+  const uint32_t eventId = (FED_SLINK_START_MARKER << FED_HCTRLID_SHIFT) | eventNumber;
+
+  fedh_t oldHeader = *fedHeader;
+  fedHeader->eventid = eventId;
+
+  const uint16_t crc = FedCRCUpdater::update(
+    (fedTrailer->conscheck & FED_CRCS_MASK) >> FED_CRCS_SHIFT,
+    (const unsigned char*)&oldHeader, (const unsigned char*)fedHeader,
+    fedLocation.nbWordsAfterHeader);
+  fedTrailer->conscheck = (crc << FED_CRCS_SHIFT);
+}
+
+
+bool rubuilder::utils::SuperFragmentGenerator::buildSuperFragment
+(
+  toolbox::mem::Reference*& bufRef,
+  const EvBid& evbId,
+  FedLocations* fedLocations
+)
 {
   if ( dummySuperFragmentPool_->isHighThresholdExceeded() ) return false;
 
@@ -301,15 +441,17 @@ bool rubuilder::utils::SuperFragmentGenerator::getSuperFragment
     }
     catch(toolbox::mem::exception::Exception& e)
     {
+      if (head) head->release();
       return false;
     }
     catch(xcept::Exception& e)
     {
+      if (head) head->release();
       XCEPT_RETHROW(exception::OutOfMemory,
         "Failed to allocate memory for super-fragment block", e);
     }
     
-    fillBlock(nextBlock,blockNb,evbId);
+    fillBlock(nextBlock,blockNb,evbId,fedLocations);
     
     // Append block to super-fragment
     if (head == 0)
@@ -337,7 +479,8 @@ void rubuilder::utils::SuperFragmentGenerator::fillBlock
 (
   toolbox::mem::Reference* bufRef,
   const uint16_t blockNb,
-  const EvBid& evbId
+  const EvBid& evbId,
+  FedLocations* fedLocations
 )
 {
   ///////////////////////////////////////////////////////////
@@ -375,6 +518,28 @@ void rubuilder::utils::SuperFragmentGenerator::fillBlock
       XCEPT_RETHROW(exception::OutOfMemory,
         "Failed to insert FED component", e);
     }
+
+    // Remember where the FEDs of a template are
+    if (fedLocations)
+    {
+      if (component.type == SuperFragmentTracker::FED_HEADER)
+      {
+        FedLocation fedLocation;
+        fedLocation.headerBlockNb = blockNb;
+        fedLocation.headerOffset = pos - blockAddr;
+        fedLocations->push_back(fedLocation);
+      }
+      else if (component.type == SuperFragmentTracker::FED_TRAILER)
+      {
+        FedLocation& fedLocation = fedLocations->back();
+        fedLocation.trailerBlockNb = blockNb;
+        fedLocation.trailerOffset = pos - blockAddr;
+
+        // The header is followed by the payload and the trailer
+        fedLocation.nbWordsAfterHeader =
+          (superFragmentTracker_->getFedPayloadSize() + sizeof(fedt_t)) / 8;
+      }
+    }
     
     // Update position within super-fragment
     superFragmentTracker_->moveToNextComponent(nbFreeBytes);
@@ -415,7 +580,6 @@ void rubuilder::utils::SuperFragmentGenerator::insertFedComponent
 {
   fedh_t* fedHeader = 0;
   fedt_t* fedTrailer = 0;
-  size_t bufSize = 0;
   
   switch (component.type)
   {
@@ -425,15 +589,13 @@ void rubuilder::utils::SuperFragmentGenerator::insertFedComponent
       fedHeader->sourceid = component.fedId << FED_SOID_SHIFT;
       fedHeader->eventid  = (FED_SLINK_START_MARKER << FED_HCTRLID_SHIFT) | eventNumber;
       
-      fedCRC_ = evf::compute_crc(startAddr,sizeof(fedh_t));
+      fedCRC_ = computeFedCRC(startAddr,sizeof(fedh_t));
       
       break;
       
     case SuperFragmentTracker::FED_PAYLOAD:
       assert( component.size % 8 == 0 );
-      bufSize = component.size / 8;
-      for (size_t i=0; i<bufSize; ++i)
-        fedCRC_ = evf::compute_crc_64bit(fedCRC_,&startAddr[i*8]);
+      fedCRC_ = computeFedCRC(fedCRC_,startAddr,component.size);
       
       break;
       
@@ -447,9 +609,7 @@ void rubuilder::utils::SuperFragmentGenerator::insertFedComponent
       // See http://people.web.psi.ch/kotlinski/CMS/Manuals/DAQ_IF_guide.html
       fedTrailer->conscheck = 0;
       
-      bufSize = sizeof(fedt_t) / 8;
-      for (size_t i=0; i<bufSize; ++i) 
-        fedCRC_ = evf::compute_crc_64bit(fedCRC_,&startAddr[i*8]);
+      fedCRC_ = computeFedCRC(fedCRC_,startAddr,sizeof(fedt_t));
       
       fedTrailer->conscheck = (fedCRC_ << FED_CRCS_SHIFT);
       
@@ -527,86 +687,76 @@ void rubuilder::utils::SuperFragmentGenerator::fillTriggerPayload
 {
   using namespace evtn;
   
+  const size_t fedSize = sizeof(fedh_t) + dummyFedPayloadSize_ + sizeof(fedt_t);
+
   //set offsets based on record scheme 
-  evm_board_setformat(dummyFedPayloadSize_+sizeof(fedh_t)+sizeof(fedt_t));
-  
-  unsigned char* ptr = fedPtr + sizeof(fedh_t);
+  evm_board_setformat(fedSize);
+
+  // The trailer holds the CRC of the FED as generated. Each field written
+  // below updates it without going over the whole FED again.
+  FedCRCUpdater crcUpdater(fedPtr,fedSize);
+  const size_t ptr = sizeof(fedh_t);
 
   //board id
-  unsigned char *pptr = ptr + EVM_BOARDID_OFFSET * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = (EVM_BOARDID_VALUE << EVM_BOARDID_SHIFT);
+  size_t pptr = ptr + EVM_BOARDID_OFFSET * SLINK_HALFWORD_SIZE;
+  crcUpdater.write<uint32_t>(pptr, (EVM_BOARDID_VALUE << EVM_BOARDID_SHIFT));
 
   //setup version
   pptr = ptr + EVM_GTFE_SETUPVERSION_OFFSET * SLINK_HALFWORD_SIZE;
   if (EVM_GTFE_BLOCK == EVM_GTFE_BLOCK_V0011)
-    *((uint32_t*)(pptr)) = 0xffffffff & EVM_GTFE_SETUPVERSION_MASK;
+    crcUpdater.write<uint32_t>(pptr, 0xffffffff & EVM_GTFE_SETUPVERSION_MASK);
   else
-    *((uint32_t*)(pptr)) = 0x00000000 & EVM_GTFE_SETUPVERSION_MASK;
+    crcUpdater.write<uint32_t>(pptr, 0x00000000 & EVM_GTFE_SETUPVERSION_MASK);
 
   //fdl mode
   pptr = ptr + EVM_GTFE_FDLMODE_OFFSET * SLINK_HALFWORD_SIZE;
   if (EVM_FDL_NOBX == 5)
-    *((uint32_t*)(pptr)) = 0xffffffff & EVM_GTFE_FDLMODE_MASK;
+    crcUpdater.write<uint32_t>(pptr, 0xffffffff & EVM_GTFE_FDLMODE_MASK);
   else
-    *((uint32_t*)(pptr)) = 0x00000000 & EVM_GTFE_FDLMODE_MASK;
+    crcUpdater.write<uint32_t>(pptr, 0x00000000 & EVM_GTFE_FDLMODE_MASK);
 
   //gps time
   timeval tv;
   gettimeofday(&tv,0);
   pptr = ptr + EVM_GTFE_BSTGPS_OFFSET * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = tv.tv_usec;
+  crcUpdater.write<uint32_t>(pptr, tv.tv_usec);
   pptr += SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = tv.tv_sec;
+  crcUpdater.write<uint32_t>(pptr, tv.tv_sec);
 
   //TCS chip id
   pptr = ptr + (EVM_GTFE_BLOCK*2 + EVM_TCS_BOARDID_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = ((EVM_TCS_BOARDID_VALUE << EVM_TCS_BOARDID_SHIFT) & EVM_TCS_BOARDID_MASK);
+  crcUpdater.write<uint32_t>(pptr, ((EVM_TCS_BOARDID_VALUE << EVM_TCS_BOARDID_SHIFT) & EVM_TCS_BOARDID_MASK));
 
   //event number
   pptr = ptr + (EVM_GTFE_BLOCK*2 + EVM_TCS_TRIGNR_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = eventNumber;
+  crcUpdater.write<uint32_t>(pptr, eventNumber);
 
   //orbit number
   pptr = ptr + (EVM_GTFE_BLOCK*2 + EVM_TCS_ORBTNR_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = l1Info.orbitNumber;
+  crcUpdater.write<uint32_t>(pptr, l1Info.orbitNumber);
 
   //lumi section
   pptr = ptr + (EVM_GTFE_BLOCK*2 + EVM_TCS_LSBLNR_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = l1Info.lsNumber + ((l1Info.eventType << EVM_TCS_EVNTYP_SHIFT) & EVM_TCS_EVNTYP_MASK);
+  crcUpdater.write<uint32_t>(pptr, l1Info.lsNumber + ((l1Info.eventType << EVM_TCS_EVNTYP_SHIFT) & EVM_TCS_EVNTYP_MASK));
 
   // bunch crossing in fdl bx+0 (-1,0,1) for nbx=3 i.e. offset by one full FDB block and leave -1/+1 alone (it will be full of zeros)
   // add also TCS chip Id
   pptr = ptr + ((EVM_GTFE_BLOCK + EVM_TCS_BLOCK + EVM_FDL_BLOCK * (EVM_FDL_NOBX/2))*2 + EVM_FDL_BCNRIN_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint32_t*)(pptr)) = (l1Info.bunchCrossing & EVM_TCS_BCNRIN_MASK) + ((EVM_FDL_BOARDID_VALUE << EVM_FDL_BOARDID_SHIFT) & EVM_FDL_BOARDID_MASK);
+  crcUpdater.write<uint32_t>(pptr, (l1Info.bunchCrossing & EVM_TCS_BCNRIN_MASK) + ((EVM_FDL_BOARDID_VALUE << EVM_FDL_BOARDID_SHIFT) & EVM_FDL_BOARDID_MASK));
 
   // tech trig 64-bit set
   pptr = ptr + ((EVM_GTFE_BLOCK + EVM_TCS_BLOCK + EVM_FDL_BLOCK * (EVM_FDL_NOBX/2))*2 + EVM_FDL_TECTRG_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint64_t*)(pptr)) = l1Info.l1Technical;
+  crcUpdater.write<uint64_t>(pptr, l1Info.l1Technical);
   pptr = ptr + ((EVM_GTFE_BLOCK + EVM_TCS_BLOCK + EVM_FDL_BLOCK * (EVM_FDL_NOBX/2))*2 + EVM_FDL_ALGOB1_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint64_t*)(pptr)) = l1Info.l1Decision_0_63;
+  crcUpdater.write<uint64_t>(pptr, l1Info.l1Decision_0_63);
   pptr = ptr + ((EVM_GTFE_BLOCK + EVM_TCS_BLOCK + EVM_FDL_BLOCK * (EVM_FDL_NOBX/2))*2 + EVM_FDL_ALGOB2_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint64_t*)(pptr)) = l1Info.l1Decision_64_127;
+  crcUpdater.write<uint64_t>(pptr, l1Info.l1Decision_64_127);
 
   // prescale version is 0
   pptr = ptr + ((EVM_GTFE_BLOCK + EVM_TCS_BLOCK + EVM_FDL_BLOCK * (EVM_FDL_NOBX/2))*2 + EVM_FDL_PSCVSN_OFFSET) * SLINK_HALFWORD_SIZE;
-  *((uint64_t*)(pptr)) = 0;
-}
-
+  crcUpdater.write<uint64_t>(pptr, 0);
 
-void rubuilder::utils::SuperFragmentGenerator::updateCRC
-(
-  const unsigned char* fedPtr
-) const
-{
-  const size_t fedSize = sizeof(fedh_t) + dummyFedPayloadSize_ + sizeof(fedt_t);
-  fedt_t* fedTrailer = (fedt_t*)(fedPtr + fedSize - sizeof(fedt_t));
-  
-  // Force CRC field to zero before re-computing the CRC.
-  // See http://people.web.psi.ch/kotlinski/CMS/Manuals/DAQ_IF_guide.html
-  fedTrailer->conscheck = 0;
-  
-  unsigned short crc = evf::compute_crc(fedPtr,fedSize);
-  fedTrailer->conscheck = (crc << FED_CRCS_SHIFT);
+  crcUpdater.updateTrailer();
 }
 
 
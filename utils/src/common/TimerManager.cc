@@ -1,128 +1,261 @@
 #include "rubuilder/utils/TimerManager.h"
 #include "rubuilder/utils/Exception.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdlib.h>
 #include <time.h>
 
 
-rubuilder::utils::TimerManager::TimerManager():
-timerListMax(5),
-nextFreeTimer(0)
+namespace
 {
-  timerList = new Timer[timerListMax]();
+  // Coarse clock resolution in msec, or 0 if the coarse clock is unavailable
+  uint32_t coarseClockResolutionMSec()
+  {
+    #ifdef CLOCK_MONOTONIC_COARSE
+    struct timespec res;
+    if ( clock_getres(CLOCK_MONOTONIC_COARSE, &res) == 0 )
+      return res.tv_sec * 1000 + (res.tv_nsec + 999999) / 1000000;
+    #endif
+    return 0;
+  }
+
+  const uint32_t coarseResolutionMSec = coarseClockResolutionMSec();
 }
 
 
-rubuilder::utils::TimerManager::~TimerManager()
+rubuilder::utils::TimerManager::TimerManager() :
+currentTick_(0),
+armedTimers_(0),
+clockId_(CLOCK_MONOTONIC)
 {
-  delete[] timerList;
+  for (uint32_t level = 0; level < WHEEL_LEVELS; ++level)
+    for (uint32_t slot = 0; slot < WHEEL_SIZE; ++slot)
+      wheel_[level][slot] = -1;
+  for (uint32_t i = 0; i < WHEEL_SIZE/64; ++i)
+    occupiedSlots_[i] = 0;
+
+  #ifdef CLOCK_MONOTONIC_COARSE
+  if ( coarseResolutionMSec > 0 ) clockId_ = CLOCK_MONOTONIC_COARSE;
+  #endif
+
+  currentTick_ = nowMSec();
 }
 
 
 int rubuilder::utils::TimerManager::getTimer()
 {
-  if( nextFreeTimer == timerListMax ) expandTimerList();
-  return nextFreeTimer++;
+  timers_.push_back( Timer() );
+  return timers_.size() - 1;
 }
 
 
 void rubuilder::utils::TimerManager::initTimer(int handle, int dt_msec)
 {
-  if( handle >= nextFreeTimer || handle < 0 )
+  if( handle >= static_cast<int>(timers_.size()) || handle < 0 )
   {
     XCEPT_RAISE(exception::Configuration,
       "Requested to initilize non existing timer");
   }
-  
-  timerList[handle].deltaTime.hi = (unsigned int )(dt_msec)/1000;
-  timerList[handle].deltaTime.lo = (unsigned int )(dt_msec)%1000;
-  timerList[handle].isFired = false;
-  //    cout << "Delta for timer " << handle << " Is " <<  
-  //   (int)(timerList[handle].deltaTime.hi) << " " << 
-  //(int)(timerList[handle].deltaTime.lo) << "\n";  
-  
-  return;
+
+  Timer& timer = timers_[handle];
+  if ( timer.isArmed ) unschedule(handle);
+  timer.deltaMSec = dt_msec > 0 ? dt_msec : 0;
+  timer.isFired = false;
+
+  // The coarse clock is too imprecise for short timers
+  if ( clockId_ != CLOCK_MONOTONIC &&
+    timer.deltaMSec < 10 * coarseResolutionMSec )
+  {
+    clockId_ = CLOCK_MONOTONIC;
+    currentTick_ = std::max(currentTick_, nowMSec());
+  }
 }
 
 
 void rubuilder::utils::TimerManager::restartTimer(int handle)
 {
-  timerList[handle].isFired = false;
-  gettimeofday(&theTimeOfDay, NULL);
-  
-  timerList[handle].startTime.hi =
-    (unsigned int )(theTimeOfDay.tv_sec);  
-  timerList[handle].startTime.lo =
-    (unsigned int )(theTimeOfDay.tv_usec);      
-  // cout << "start time " << timerList[handle].startTime.hi << ". "
-  //      << timerList[handle].startTime.lo << "\n";
+  checkHandle(handle);
+
+  Timer& timer = timers_[handle];
+  if ( timer.isArmed ) unschedule(handle);
+
+  advance( nowMSec() );
+
+  // Pad by the clock resolution such that the timer never fires early
+  const uint32_t resolutionMSec =
+    clockId_ == CLOCK_MONOTONIC ? 1 : coarseResolutionMSec;
+  timer.expiry = currentTick_ + timer.deltaMSec + resolutionMSec;
+  timer.isFired = false;
+  schedule(handle);
 }
 
 
 bool rubuilder::utils::TimerManager::isFired(int handle)
 {
-  gettimeofday(&theTimeOfDay, NULL);
-  theTime.hi = (unsigned int )(theTimeOfDay.tv_sec);
-  theTime.lo = (unsigned int )(theTimeOfDay.tv_usec);
-  
-  //cout << "time now is " << theTime.hi << ". " <<theTime.lo << "\n";
-  
-  unsigned int  carry = 0;
-  if(theTime.lo <  timerList[handle].startTime.lo) carry = 1;
-  timerList[handle].isFired =
-    timerList[handle].isFired
-    || 
-    theTime.hi - timerList[handle].startTime.hi - carry
-    > timerList[handle].deltaTime.hi
-    ||
-    (theTime.hi - timerList[handle].startTime.hi - carry
-      == timerList[handle].deltaTime.hi 
-      && theTime.lo- timerList[handle].startTime.lo > 
-      timerList[handle].deltaTime.lo);
-  
-  return timerList[handle].isFired;
+  checkHandle(handle);
+
+  Timer& timer = timers_[handle];
+  if ( timer.isFired ) return true;
+
+  if ( ! timer.isArmed )
+  {
+    timer.isFired = true; // initialized, but never started
+    return true;
+  }
+
+  // The wheel only needs to be advanced once this timer is due
+  const uint64_t now = nowMSec();
+  if ( now < timer.expiry ) return false;
+
+  advance(now);
+
+  return timer.isFired;
 }
 
 
-void rubuilder::utils::TimerManager::expandTimerList()
+void rubuilder::utils::TimerManager::checkHandle(const int handle) const
 {
-  int oldMax = timerListMax;
-  // cout << "initial size " << timerListMax << "\n";
-  timerListMax +=5;
-  Timer *newTimerList;
-  newTimerList = new Timer[timerListMax]();
-  
-  for(int i=0; i<oldMax;i++) {
-    newTimerList[i].isFired = timerList[i].isFired;
-    newTimerList[i].deltaTime.hi = timerList[i].deltaTime.hi;
-    newTimerList[i].deltaTime.lo = timerList[i].deltaTime.lo;
-    newTimerList[i].startTime.hi = timerList[i].startTime.hi;
-    newTimerList[i].startTime.lo = timerList[i].startTime.lo;
+  if( handle >= static_cast<int>(timers_.size()) || handle < 0 )
+  {
+    XCEPT_RAISE(exception::Configuration,
+      "Requested to use non existing timer");
   }
-  
-  delete[] timerList;
-  timerList = newTimerList;
 }
 
 
-int rubuilder::utils::TimerManager::get_cpu_khz()
+uint64_t rubuilder::utils::TimerManager::nowMSec() const
 {
-  FILE *in;
-  char str[200];
-  double cpu_mhz;
-  
-  if ((in = fopen("/proc/cpuinfo", "r")) == NULL) {
-    perror("fopen(/proc/cpuinfo)");
-    return 0;
+  struct timespec now;
+  clock_gettime(clockId_, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+
+void rubuilder::utils::TimerManager::advance(const uint64_t nowTick)
+{
+  while ( currentTick_ < nowTick )
+  {
+    if ( armedTimers_ == 0 )
+    {
+      currentTick_ = nowTick;
+      return;
+    }
+
+    // Skip the empty slots in between
+    currentTick_ = std::min(nextEventTick(), nowTick);
+
+    // Move the timers of the next higher level slot down
+    // whenever a lower level wheel completes a turn
+    for (uint32_t level = 1; level < WHEEL_LEVELS; ++level)
+    {
+      if ( ( currentTick_ >> (WHEEL_BITS*(level-1)) ) & WHEEL_MASK ) break;
+      cascade(level);
+    }
+
+    int& slot = wheel_[0][currentTick_ & WHEEL_MASK];
+    while ( slot != -1 )
+    {
+      const int handle = slot;
+      unschedule(handle);
+      timers_[handle].isFired = true;
+    }
   }
-  
-  while (fgets(str, sizeof(str), in) != NULL)
-    if (fscanf(in, "cpu MHz : %lf\n", &cpu_mhz) == 1)
-      break;
-  
-  fclose(in);
-  return (int)(cpu_mhz * 1000); //retun cpu in khz
+}
+
+
+uint64_t rubuilder::utils::TimerManager::nextEventTick() const
+{
+  // The next occupied slot of the lowest level before it completes a turn
+  const uint32_t first = (currentTick_ & WHEEL_MASK) + 1;
+  for (uint32_t word = first / 64; word < WHEEL_SIZE/64; ++word)
+  {
+    uint64_t bits = occupiedSlots_[word];
+    if ( word == first / 64 ) bits &= ~0ULL << (first % 64);
+    if ( bits )
+      return (currentTick_ & ~static_cast<uint64_t>(WHEEL_MASK)) +
+        word * 64 + __builtin_ctzll(bits);
+  }
+
+  // Otherwise, the next turn where higher levels may cascade down
+  return (currentTick_ | WHEEL_MASK) + 1;
+}
+
+
+void rubuilder::utils::TimerManager::cascade(const uint32_t level)
+{
+  int& slot = wheel_[level][ (currentTick_ >> (WHEEL_BITS*level)) & WHEEL_MASK ];
+  int handle = slot;
+  slot = -1;
+
+  while ( handle != -1 )
+  {
+    const int next = timers_[handle].next;
+    --armedTimers_;
+    timers_[handle].isArmed = false;
+    schedule(handle);
+    handle = next;
+  }
+}
+
+
+int& rubuilder::utils::TimerManager::slotFor(Timer& timer)
+{
+  const uint64_t delta = timer.expiry - currentTick_;
+
+  uint32_t level = 0;
+  while ( level < WHEEL_LEVELS-1 && ( delta >> (WHEEL_BITS*(level+1)) ) > 0 )
+    ++level;
+
+  timer.level = level;
+  timer.index = ( timer.expiry >> (WHEEL_BITS*level) ) & WHEEL_MASK;
+
+  return wheel_[timer.level][timer.index];
+}
+
+
+void rubuilder::utils::TimerManager::schedule(const int handle)
+{
+  Timer& timer = timers_[handle];
+  if ( timer.expiry <= currentTick_ )
+  {
+    timer.isFired = true;
+    return;
+  }
+
+  int& slot = slotFor(timer);
+  timer.prev = -1;
+  timer.next = slot;
+  if ( slot != -1 ) timers_[slot].prev = handle;
+  slot = handle;
+  if ( timer.level == 0 )
+    occupiedSlots_[timer.index / 64] |= 1ULL << (timer.index % 64);
+  timer.isArmed = true;
+  ++armedTimers_;
+}
+
+
+void rubuilder::utils::TimerManager::unschedule(const int handle)
+{
+  Timer& timer = timers_[handle];
+
+  if ( timer.prev != -1 )
+  {
+    timers_[timer.prev].next = timer.next;
+  }
+  else
+  {
+    wheel_[timer.level][timer.index] = timer.next;
+    if ( timer.level == 0 && timer.next == -1 )
+      occupiedSlots_[timer.index / 64] &= ~(1ULL << (timer.index % 64));
+  }
+
+  if ( timer.next != -1 )
+    timers_[timer.next].prev = timer.prev;
+
+  timer.next = timer.prev = -1;
+  timer.isArmed = false;
+  --armedTimers_;
 }
 
 
@@ -0,0 +1,71 @@
+#include "rubuilder/utils/WakeupSignal.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+
+namespace
+{
+  int futex(volatile uint32_t* addr, const int op, const uint32_t val, const struct timespec* timeout)
+  {
+    return ::syscall(SYS_futex, addr, op, val, timeout, 0, 0);
+  }
+}
+
+
+rubuilder::utils::WakeupSignal::WakeupSignal() :
+sequence_(0),
+waiters_(0),
+wakeupCount_(0)
+{}
+
+
+uint32_t rubuilder::utils::WakeupSignal::prepareWait()
+{
+  // The atomic increment is a full barrier: the caller's re-check of
+  // its queues cannot be reordered before the registration as waiter
+  __sync_fetch_and_add(&waiters_, 1);
+  return sequence_;
+}
+
+
+void rubuilder::utils::WakeupSignal::cancelWait()
+{
+  __sync_fetch_and_sub(&waiters_, 1);
+}
+
+
+bool rubuilder::utils::WakeupSignal::wait(const uint32_t ticket, const uint32_t timeoutUSec)
+{
+  struct timespec timeout;
+  timeout.tv_sec = timeoutUSec / 1000000;
+  timeout.tv_nsec = (timeoutUSec % 1000000) * 1000;
+
+  // Returns immediately if the sequence moved on since prepareWait
+  const int result = futex(&sequence_, FUTEX_WAIT_PRIVATE, ticket, &timeout);
+  const bool timedOut = ( result == -1 && errno == ETIMEDOUT );
+
+  __sync_fetch_and_sub(&waiters_, 1);
+
+  return !timedOut;
+}
+
+
+void rubuilder::utils::WakeupSignal::wakeAll()
+{
+  __sync_fetch_and_add(&sequence_, 1);
+  futex(&sequence_, FUTEX_WAKE_PRIVATE, INT_MAX, 0);
+  __sync_fetch_and_add(&wakeupCount_, 1);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -